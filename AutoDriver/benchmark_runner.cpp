@@ -1,7 +1,15 @@
 // benchmark_runner.cpp - Standalone benchmark executable
 
 #include <iostream>
+#include <iomanip>
+#include <string>
+#include <chrono>
 #include "benchmark/benchmark_suite.h"
+#include "benchmark/scenario_corpus.h"
+#include "core/cost_matrix.h"
+#include "core/instrumentation.h"
+#include "core/random.h"
+#include "core/simulation.h"
 
 int main(int argc, char** argv) {
     std::cout << "\n";
@@ -31,6 +39,155 @@ int main(int argc, char** argv) {
     
     config.obstacle_density = 0.2f;
     
+    std::string json_path = "benchmark_results.json";
+    std::string baseline_path;
+    std::string trace_path;
+    double threshold = 0.10;
+    int simulate_episodes = 0;
+    std::string sim_trace_path;
+    int cost_matrix_size = 0;
+    for (int i = 1; i + 1 < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--seed") {
+            config.seed = std::stoull(argv[i + 1]);
+        } else if (arg == "--repetitions") {
+            config.repetitions = std::stoi(argv[i + 1]);
+        } else if (arg == "--warmup") {
+            config.warmup_runs = std::stoi(argv[i + 1]);
+        } else if (arg == "--json") {
+            json_path = argv[i + 1];
+        } else if (arg == "--trace") {
+            trace_path = argv[i + 1];
+        } else if (arg == "--baseline") {
+            baseline_path = argv[i + 1];
+        } else if (arg == "--threshold") {
+            threshold = std::stod(argv[i + 1]);
+        } else if (arg == "--scen") {
+            config.scenario_files.push_back(argv[i + 1]);
+        } else if (arg == "--maps") {
+            config.maps_dir = argv[i + 1];
+        } else if (arg == "--scenario-threads") {
+            config.scenario_threads = std::stoi(argv[i + 1]);
+        } else if (arg == "--bucket-limit") {
+            config.max_scenarios_per_bucket = std::stoi(argv[i + 1]);
+        } else if (arg == "--simulate") {
+            simulate_episodes = std::stoi(argv[i + 1]);
+        } else if (arg == "--sim-trace") {
+            sim_trace_path = argv[i + 1];
+        } else if (arg == "--cost-matrix") {
+            cost_matrix_size = std::stoi(argv[i + 1]);
+        } else if (arg == "--generate-scen" && i + 2 < argc) {
+            // Write a local .scen for any .map, then exit
+            MapLoadResult map = MovingAI::loadMap(argv[i + 1]);
+            if (!map.success) {
+                std::cerr << "Could not read map: " << map.error << "\n";
+                return 2;
+            }
+            std::string map_name = argv[i + 1];
+            map_name = map_name.substr(map_name.find_last_of("/\\") + 1);
+            ScenarioGenerationOptions options;
+            options.seed = config.seed;
+            auto scenarios = MovingAI::generateScenarios(*map.grid, map_name, options);
+            if (!MovingAI::saveScenarios(scenarios, argv[i + 2])) {
+                std::cerr << "Could not write " << argv[i + 2] << "\n";
+                return 2;
+            }
+            std::cout << "Wrote " << scenarios.size() << " scenarios to " << argv[i + 2] << "\n";
+            return 0;
+        }
+    }
+    
+    if (simulate_episodes > 0) {
+        // Headless multi-agent batch on one seeded map, then exit
+        Grid grid(64, 64);
+        RandomStream rng(config.seed);
+        for (int y = 0; y < grid.getHeight(); y++) {
+            for (int x = 0; x < grid.getWidth(); x++) {
+                if (rng.uniform() < config.obstacle_density * 0.5f) grid.setObstacle(x, y, true);
+            }
+        }
+        
+        std::vector<EpisodeSpec> specs;
+        for (int e = 0; e < simulate_episodes; e++) {
+            specs.push_back(SimulationEngine::randomEpisode(grid, config.seed + e, 8, 6));
+        }
+        
+        SimulationConfig sim_config;
+        SimulationEngine engine(grid, sim_config);
+        SimulationSummary summary;
+        auto results = engine.runBatch(specs, 0, &summary);
+        
+        std::cout << "Simulated " << summary.episodes << " episodes (" << summary.total_steps << " steps) in "
+                  << std::fixed << std::setprecision(1) << summary.wall_ms << " ms\n";
+        std::cout << "  Episodes per minute: " << std::setprecision(0) << summary.episodes_per_minute << "\n";
+        std::cout << "  Real-time factor: " << summary.realtime_factor << "x\n";
+        std::cout << "  Successful episodes: " << summary.successes << " / " << summary.episodes << "\n";
+        std::cout << "  Agent / obstacle collisions: " << summary.agent_collisions << " / "
+                  << summary.obstacle_collisions << "\n";
+        
+        if (!sim_trace_path.empty() && !specs.empty()) {
+            sim_config.record_trace = true;
+            engine.setConfig(sim_config);
+            EpisodeResult traced = engine.runEpisode(specs.front());
+            if (!traced.trace.save(sim_trace_path)) {
+                std::cerr << "Could not write " << sim_trace_path << "\n";
+                return 2;
+            }
+            std::cout << "Trace of episode " << traced.seed << " saved to: " << sim_trace_path << "\n";
+        }
+        return 0;
+    }
+    
+    if (cost_matrix_size > 0) {
+        // Robots x tasks on one seeded 2k x 2k map, then exit
+        const int size = 2048;
+        Grid grid(size, size);
+        RandomStream rng(config.seed);
+        for (int y = 0; y < size; y++) {
+            for (int x = 0; x < size; x++) {
+                if (rng.uniform() < config.obstacle_density * 0.5f) grid.setObstacle(x, y, true);
+            }
+        }
+        auto freeCells = [&](int count) {
+            std::vector<Vec2i> cells;
+            while (static_cast<int>(cells.size()) < count) {
+                Vec2i p(static_cast<int>(rng() % size), static_cast<int>(rng() % size));
+                if (!grid.isObstacle(p.x, p.y)) cells.push_back(p);
+            }
+            return cells;
+        };
+        std::vector<Vec2i> robots = freeCells(cost_matrix_size);
+        std::vector<Vec2i> tasks = freeCells(cost_matrix_size);
+        
+        auto elapsedMs = [](std::chrono::steady_clock::time_point since) {
+            return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - since).count();
+        };
+        CostMatrixPlanner planner(grid);
+        planner.computeCostMatrix({robots.front()}, {tasks.front()});   // Sizes the search contexts
+        auto start = std::chrono::steady_clock::now();
+        CostMatrix matrix = planner.computeCostMatrix(robots, tasks);
+        double matrix_ms = elapsedMs(start);
+        
+        int reachable = 0;
+        for (float cost : matrix.costs) reachable += cost != CostMatrix::kUnreachable;
+        
+        // Per-pair A* on a sample of the pairs, scaled to the whole matrix
+        const int sampled = std::min(5, cost_matrix_size);
+        AStar astar(grid);
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < sampled; i++) astar.findPath(robots[i], tasks[(i * 7) % tasks.size()]);
+        double astar_ms = elapsedMs(start) / sampled * robots.size() * tasks.size();
+        
+        std::cout << "Cost matrix " << robots.size() << " x " << tasks.size() << " on " << size << "x" << size
+                  << " in " << std::fixed << std::setprecision(1) << matrix_ms << " ms\n";
+        std::cout << "  Searches: " << matrix.searches << " (" << (matrix.per_target ? "per task" : "per robot")
+                  << "), cells settled: " << matrix.cells_settled << "\n";
+        std::cout << "  Reachable pairs: " << reachable << " / " << matrix.costs.size() << "\n";
+        std::cout << "  Per-pair A* estimate: " << std::setprecision(0) << astar_ms << " ms ("
+                  << std::setprecision(1) << astar_ms / matrix_ms << "x slower)\n";
+        return 0;
+    }
+    
     std::cout << "Configuration:\n";
     std::cout << "  Grid sizes: ";
     for (size_t i = 0; i < config.grid_sizes.size(); i++) {
@@ -39,19 +196,64 @@ int main(int argc, char** argv) {
     }
     std::cout << "\n";
     std::cout << "  Trials per size: " << config.num_trials << "\n";
-    std::cout << "  Obstacle density: " << (config.obstacle_density * 100) << "%\n\n";
+    std::cout << "  Warm-up / timed runs per trial: " << config.warmup_runs << " / " << config.repetitions << "\n";
+    std::cout << "  Obstacle density: " << (config.obstacle_density * 100) << "%\n";
+    std::cout << "  Seed: " << config.seed << "\n";
+    for (const auto& scen : config.scenario_files) std::cout << "  Scenarios: " << scen << "\n";
+    std::cout << "\n";
     
     std::cout << "Starting benchmarks...\n";
     std::cout << "═══════════════════════════════════════════════════════════\n\n";
     
+    if (!trace_path.empty()) Instrumentation::startTrace();
+    
     BenchmarkSuite suite(config);
     suite.runAll();
     
+    if (!trace_path.empty()) {
+        Instrumentation::stopTrace();
+        std::cout << "\nHot-path probes:\n";
+        Instrumentation::printSummary(std::cout);
+        if (Instrumentation::enabled() && Instrumentation::writeChromeTrace(trace_path)) {
+            std::cout << "Chrome trace saved to: " << trace_path << "\n";
+        }
+    }
+    
     std::cout << "\n═══════════════════════════════════════════════════════════\n";
     std::cout << "Generating reports...\n\n";
     
     suite.generateReport("benchmark_report.txt");
     suite.generateCSV("benchmark_results.csv");
+    suite.generateJSON(json_path);
+    if (!suite.getScenarioResults().empty()) suite.generateScenarioCSV("scenario_results.csv");
+    
+    // Regression check against a previous --json output
+    int regressions = 0;
+    if (!baseline_path.empty()) {
+        std::vector<BenchmarkResult> baseline;
+        if (!BenchmarkSuite::loadJSON(baseline_path, baseline)) {
+            std::cerr << "Could not read baseline: " << baseline_path << "\n";
+            return 2;
+        }
+        
+        std::cout << "\nComparison against " << baseline_path << " (threshold "
+                  << threshold * 100.0 << "%):\n";
+        for (const auto& c : BenchmarkSuite::compare(baseline, suite.getResults(), threshold)) {
+            const char* verdict = "unchanged";
+            switch (c.verdict) {
+                case BenchmarkVerdict::IMPROVED: verdict = "improved"; break;
+                case BenchmarkVerdict::REGRESSED: verdict = "REGRESSED"; regressions++; break;
+                case BenchmarkVerdict::INCONCLUSIVE: verdict = "inconclusive (within noise)"; break;
+                case BenchmarkVerdict::MISSING: verdict = "missing"; break;
+                default: break;
+            }
+            std::cout << "  " << std::left << std::setw(30) << c.test_name << std::right << std::fixed
+                      << std::setprecision(3) << std::setw(10) << c.baseline_ms << " -> "
+                      << std::setw(10) << c.current_ms << " ms  " << std::showpos << std::setprecision(1)
+                      << c.change * 100.0 << std::noshowpos << "%  " << verdict << "\n";
+        }
+        std::cout << "  " << regressions << " regression(s)\n";
+    }
     
     std::cout << "\n╔════════════════════════════════════════════════════════════╗\n";
     std::cout << "║                 BENCHMARK COMPLETE!                        ║\n";
@@ -59,12 +261,23 @@ int main(int argc, char** argv) {
     
     std::cout << "Results saved:\n";
     std::cout << "  📄 benchmark_report.txt - Human-readable report\n";
-    std::cout << "  📊 benchmark_results.csv - Data for Excel/analysis\n\n";
+    std::cout << "  📊 benchmark_results.csv - Data for Excel/analysis\n";
+    std::cout << "  🧾 " << json_path << " - Full statistics for --baseline\n\n";
     
     std::cout << "Usage:\n";
     std::cout << "  benchmark              # Standard benchmarks\n";
     std::cout << "  benchmark --quick      # Quick test (2 sizes, 3 trials)\n";
-    std::cout << "  benchmark --comprehensive  # Full test (5 sizes, 10 trials)\n\n";
+    std::cout << "  benchmark --comprehensive  # Full test (5 sizes, 10 trials)\n";
+    std::cout << "  benchmark --seed 1234  # Reproduce a run with a given seed\n";
+    std::cout << "  benchmark --repetitions 50 --warmup 3  # Timed / warm-up runs per trial\n";
+    std::cout << "  benchmark --json out.json      # Where to write the JSON results\n";
+    std::cout << "  benchmark --baseline old.json  # Flag regressions (exit code 1)\n";
+    std::cout << "  benchmark --threshold 0.05     # Relative median change that counts\n";
+    std::cout << "  benchmark --scen a.scen --maps dir  # MovingAI corpus, per-bucket CSV\n";
+    std::cout << "  benchmark --trace out.json     # Probe totals + Chrome trace (AUTODRIVER_INSTRUMENTATION=ON)\n";
+    std::cout << "  benchmark --generate-scen m.map m.map.scen  # Local scenarios for any .map\n";
+    std::cout << "  benchmark --simulate 1000 --sim-trace ep.bin  # Headless multi-agent episodes\n";
+    std::cout << "  benchmark --cost-matrix 500    # Robots x tasks costs on a 2k x 2k map\n\n";
     
-    return 0;
+    return regressions > 0 ? 1 : 0;
 }
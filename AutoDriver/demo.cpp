@@ -58,6 +58,7 @@ void runDemo1() {
     
     Grid grid(10, 10);
     AStar planner(grid);
+    planner.setCapture(SearchCapture::intoResults());  // printGrid shows the closed set
     
     Vec2i start(0, 0);
     Vec2i goal(9, 9);
@@ -90,6 +91,7 @@ void runDemo2() {
     }
     
     AStar planner(grid);
+    planner.setCapture(SearchCapture::intoResults());  // printGrid shows the closed set
     Vec2i start(2, 5);
     Vec2i goal(8, 5);
     
@@ -121,6 +123,7 @@ void runDemo3() {
     }
     
     AStar planner(grid);
+    planner.setCapture(SearchCapture::intoResults());  // printGrid shows the closed set
     Vec2i start(2, 5);
     Vec2i goal(8, 5);
     
@@ -153,6 +156,7 @@ void runDemo4() {
     }
     
     AStar planner(grid);
+    planner.setCapture(SearchCapture::intoResults());  // printGrid shows the closed set
     Vec2i start(1, 7);
     Vec2i goal(13, 7);
     
@@ -138,20 +138,19 @@ void scenario3_ParkingLot() {
     
     std::cout << "Creating parking lot with occupied spots...\n";
     
-    // Create parking spaces (occupied)
-    for (int i = 0; i < 6; i++) {
-        for (int j = 0; j < 2; j++) {
-            if (i != 3) {  // Leave one spot empty
-                grid.setObstacle(10 + i, 10 + j * 4, true);
-                grid.setObstacle(10 + i, 11 + j * 4, true);
-            }
+    // Curb-side row of parallel spots (occupied except the middle one)
+    for (int i = 0; i < 3; i++) {
+        if (i == 1) continue;  // Leave one spot empty
+        for (int x = 2 + i * 9; x <= 7 + i * 9; x++) {
+            grid.setObstacle(x, 10, true);
+            grid.setObstacle(x, 11, true);
         }
     }
     
-    std::cout << "  ✓ Parking lot created (5 occupied, 1 free spot)\n\n";
+    std::cout << "  ✓ Parking lot created (2 occupied, 1 free spot)\n\n";
     
     ParkingPlanner planner(grid, params);
-    ParkingSpot target_spot(Vec2(13.0f, 10.5f), 2.5f, 5.0f, 0.0f, true);
+    ParkingSpot target_spot(Vec2(13.5f, 10.5f), 2.5f, 9.0f, 0.0f, true);
     
     Vec2 start(5.0f, 15.0f);
     std::cout << "Planning parallel parking maneuver...\n";
@@ -215,8 +214,8 @@ void scenario4_MultiVehicleIntersection() {
         
         // Check for collisions
         int collisions = 0;
-        for (size_t i = 0; i < planner.getAgents().size(); i++) {
-            for (size_t j = i + 1; j < planner.getAgents().size(); j++) {
+        for (size_t i = 0; i < planner.size(); i++) {
+            for (size_t j = i + 1; j < planner.size(); j++) {
                 if (planner.checkCollision(static_cast<int>(i), static_cast<int>(j))) {
                     collisions++;
                 }
@@ -51,6 +51,7 @@ void runRRTDemo() {
     }
     
     RRT planner(grid);
+    planner.setCapture(SearchCapture::intoResults());
     Vec2 start(2.0f, 10.0f);
     Vec2 goal(18.0f, 10.0f);
     
@@ -78,6 +79,7 @@ void runRRTStarDemo() {
     }
     
     RRTStar planner(grid);
+    planner.setCapture(SearchCapture::intoResults());
     Vec2 start(2.0f, 10.0f);
     Vec2 goal(18.0f, 10.0f);
     
@@ -198,6 +200,7 @@ void runComparisonDemo() {
     
     // RRT
     RRT rrt(grid);
+    rrt.setCapture(SearchCapture::intoResults());
     auto rrt_result = rrt.findPath(rrt_start, rrt_goal, 3000);
     std::cout << "RRT:\n";
     std::cout << "  Success: " << (rrt_result.success ? "Yes" : "No") << "\n";
@@ -211,6 +214,7 @@ void runComparisonDemo() {
     
     // RRT*
     RRTStar rrt_star(grid);
+    rrt_star.setCapture(SearchCapture::intoResults());
     auto rrt_star_result = rrt_star.findPath(rrt_start, rrt_goal, 3000);
     std::cout << "RRT*:\n";
     std::cout << "  Success: " << (rrt_star_result.success ? "Yes" : "No") << "\n";
@@ -153,7 +153,7 @@ void runParkingDemo() {
                   << perp_result.total_cost << "\n";
     }
     
-    std::cout << "\nNote: Simplified parking - full implementation would use Hybrid A*\n";
+    std::cout << "\nNote: Hybrid A* approach with an analytic Reeds-Shepp final segment\n";
 }
 
 void runMultiAgentDemo() {
@@ -191,8 +191,8 @@ void runMultiAgentDemo() {
         
         // Check for collisions
         bool collision = false;
-        for (size_t i = 0; i < planner.getAgents().size(); i++) {
-            for (size_t j = i + 1; j < planner.getAgents().size(); j++) {
+        for (size_t i = 0; i < planner.size(); i++) {
+            for (size_t j = i + 1; j < planner.size(); j++) {
                 if (planner.checkCollision(static_cast<int>(i), static_cast<int>(j))) {
                     collision = true;
                     break;
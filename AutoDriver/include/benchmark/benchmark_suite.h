@@ -7,6 +7,28 @@
 #include "core/grid.h"
 #include "core/astar.h"
 #include "core/rrt.h"
+#include "core/random.h"
+
+/**
+ * Distribution summary of repeated measurements. Quantiles are interpolated;
+ * their confidence intervals are distribution-free (order statistics), so
+ * they hold for skewed timing data.
+ */
+struct BenchmarkStats {
+    int samples;
+    double min, max, mean, stddev;
+    double median, p90, p99;
+    double median_ci_low, median_ci_high;
+    double p90_ci_low, p90_ci_high;
+    double p99_ci_low, p99_ci_high;
+    
+    BenchmarkStats()
+        : samples(0), min(0.0), max(0.0), mean(0.0), stddev(0.0), median(0.0), p90(0.0), p99(0.0),
+          median_ci_low(0.0), median_ci_high(0.0), p90_ci_low(0.0), p90_ci_high(0.0),
+          p99_ci_low(0.0), p99_ci_high(0.0) {}
+    
+    static BenchmarkStats compute(std::vector<double> values, double confidence = 0.95);
+};
 
 /**
  * Benchmark result for a single test.
@@ -15,15 +37,61 @@ struct BenchmarkResult {
     std::string test_name;
     std::string algorithm;
     int grid_size;
-    double time_ms;
-    int nodes_expanded;
-    float path_cost;
-    bool success;
-    int iterations;
+    double time_ms;            // Median of all timed runs
+    int nodes_expanded;        // Mean over successful runs
+    float path_cost;           // Mean over successful runs
+    bool success;              // At least one run succeeded
+    int iterations;            // Timed runs
+    double success_rate;
+    BenchmarkStats time_stats;         // Milliseconds per run
+    BenchmarkStats nodes_per_second;   // Per-run throughput
     
     BenchmarkResult(const std::string& name, const std::string& algo)
         : test_name(name), algorithm(algo), grid_size(0), time_ms(0.0),
-          nodes_expanded(0), path_cost(0.0f), success(false), iterations(1) {}
+          nodes_expanded(0), path_cost(0.0f), success(false), iterations(1), success_rate(0.0) {}
+};
+
+enum class BenchmarkVerdict {
+    UNCHANGED,      // Median moved less than the threshold
+    IMPROVED,       // Faster beyond the threshold, confidence intervals disjoint
+    REGRESSED,      // Slower beyond the threshold, confidence intervals disjoint
+    INCONCLUSIVE,   // Beyond the threshold but within noise
+    MISSING         // In the baseline but not in the current run
+};
+
+/**
+ * One test compared against a saved baseline.
+ */
+struct BenchmarkComparison {
+    std::string test_name;
+    double baseline_ms;
+    double current_ms;
+    double change;           // current / baseline - 1
+    BenchmarkVerdict verdict;
+    
+    BenchmarkComparison()
+        : baseline_ms(0.0), current_ms(0.0), change(0.0), verdict(BenchmarkVerdict::MISSING) {}
+};
+
+/**
+ * Corpus results for one planner on one scenario bucket of one map.
+ * Optimality is path cost over the exact shortest path length for the
+ * planner's 4-connected moves (the .scen lengths assume octile moves).
+ */
+struct ScenarioBucketResult {
+    std::string map_name;
+    std::string planner;
+    int bucket;
+    int scenarios;
+    int solved;
+    double total_time_ms;
+    double mean_time_ms;
+    double mean_optimality;   // Over solved scenarios
+    double max_optimality;
+    
+    ScenarioBucketResult()
+        : bucket(0), scenarios(0), solved(0), total_time_ms(0.0), mean_time_ms(0.0),
+          mean_optimality(0.0), max_optimality(0.0) {}
 };
 
 /**
@@ -31,9 +99,19 @@ struct BenchmarkResult {
  */
 struct BenchmarkConfig {
     std::vector<int> grid_sizes = {10, 20, 50, 100};
-    int num_trials = 5;
+    int num_trials = 5;          // Seeded scenarios per test
+    int warmup_runs = 2;         // Untimed runs per scenario
+    int repetitions = 20;        // Timed runs per scenario
+    double confidence = 0.95;    // Confidence level of reported intervals
     bool include_obstacles = true;
     float obstacle_density = 0.2f;
+    uint64_t seed = 42;  // Drives grid generation and planner sampling
+    
+    // MovingAI scenario corpus (benchmarkScenarios)
+    std::vector<std::string> scenario_files;   // .scen files
+    std::string maps_dir;                      // Where their .map files live (default: next to the .scen)
+    int scenario_threads = 0;                  // Reference-solution workers, 0 = hardware concurrency (planners are timed serially)
+    int max_scenarios_per_bucket = 0;          // 0 = all
     
     BenchmarkConfig() = default;
 };
@@ -52,24 +130,51 @@ public:
     void benchmarkAStar();
     void benchmarkRRT();
     void benchmarkRRTStar();
+    void benchmarkRRTConnect();
     void benchmarkComparison();
+    void benchmarkScenarios();   // Every grid planner on config_.scenario_files
     
     // Generate report
     void generateReport(const std::string& filename = "benchmark_report.txt");
     void generateCSV(const std::string& filename = "benchmark_results.csv");
+    bool generateJSON(const std::string& filename = "benchmark_results.json") const;
+    bool generateScenarioCSV(const std::string& filename = "scenario_results.csv") const;
+    
+    // Regression checking against a generateJSON() file
+    static bool loadJSON(const std::string& filename, std::vector<BenchmarkResult>& results);
+    static std::vector<BenchmarkComparison> compare(const std::vector<BenchmarkResult>& baseline,
+                                                    const std::vector<BenchmarkResult>& current,
+                                                    double threshold = 0.10);
     
     // Get results
     const std::vector<BenchmarkResult>& getResults() const { return results_; }
+    const std::vector<ScenarioBucketResult>& getScenarioResults() const { return scenario_results_; }
     
 private:
     BenchmarkConfig config_;
     std::vector<BenchmarkResult> results_;
+    std::vector<ScenarioBucketResult> scenario_results_;
+    uint64_t next_stream_;  // Next stream derived from config_.seed
+    
+    // Outcome of one planner run
+    struct RunOutcome {
+        bool success;
+        int nodes;
+        float cost;
+    };
     
     // Helper functions
+    RandomStream nextStream();
     Grid createTestGrid(int size, float obstacle_density);
+    Grid createNarrowPassageGrid(int size, int gap_width);
     void addResult(const BenchmarkResult& result);
     double measureTime(std::function<void()> func);
     void printProgress(const std::string& message);
+    
+    // Warm up and time every scenario, then summarise all timed runs.
+    // Each scenario must do identical work on every call.
+    BenchmarkResult runCase(const std::string& name, const std::string& algorithm, int grid_size,
+                            const std::vector<std::function<RunOutcome()>>& scenarios);
 };
 
 /**
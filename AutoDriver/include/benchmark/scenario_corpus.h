@@ -0,0 +1,76 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "core/grid.h"
+#include "core/map_io.h"
+#include "core/vec2.h"
+
+/**
+ * One start/goal query from a MovingAI .scen file.
+ *
+ * optimal_length is the corpus reference: octile distance (diagonal moves
+ * cost sqrt(2) and may not cut corners).
+ */
+struct Scenario {
+    int bucket;
+    std::string map_name;
+    int map_width, map_height;
+    Vec2i start;
+    Vec2i goal;
+    double optimal_length;
+    
+    Scenario() : bucket(0), map_width(0), map_height(0), optimal_length(0.0) {}
+};
+
+/**
+ * Result of reading a .scen file.
+ */
+struct ScenarioLoadResult {
+    std::vector<Scenario> scenarios;
+    bool success;
+    std::string error;
+    
+    ScenarioLoadResult() : success(false) {}
+};
+
+/**
+ * Settings for generating a local scenario file.
+ */
+struct ScenarioGenerationOptions {
+    int count;              // Scenarios to emit
+    uint64_t seed;
+    double bucket_width;    // Octile length per bucket (MovingAI uses 4)
+    int max_attempts;       // Random start/goal draws before giving up
+    
+    ScenarioGenerationOptions() : count(100), seed(42), bucket_width(4.0), max_attempts(100000) {}
+};
+
+/**
+ * Readers and writers for the MovingAI grid benchmark formats
+ * (https://movingai.com/benchmarks/formats.html).
+ *
+ * .map files: '.', 'G' and 'S' are passable; '@', 'O', 'T' and 'W' are
+ * obstacles. Headers may come in any order before the "map" line, so hand
+ * written and locally generated files load as well as corpus files.
+ */
+class MovingAI {
+public:
+    static MapLoadResult loadMap(const std::string& path);
+    static bool saveMap(const Grid& grid, const std::string& path);
+    
+    static ScenarioLoadResult loadScenarios(const std::string& path);
+    static bool saveScenarios(const std::vector<Scenario>& scenarios, const std::string& path);
+    
+    // Random reachable queries on grid, bucketed by octile optimal length
+    static std::vector<Scenario> generateScenarios(const Grid& grid, const std::string& map_name,
+                                                   const ScenarioGenerationOptions& options = ScenarioGenerationOptions());
+    
+    // Exact shortest path length (octile without corner cutting, or 4-connected); -1 if unreachable
+    static double shortestPathLength(const Grid& grid, Vec2i start, Vec2i goal, bool diagonal);
+    
+    // Map file named by a scenario, looked up in maps_dir or next to the .scen file
+    static std::string resolveMapPath(const std::string& scen_path, const std::string& map_name,
+                                      const std::string& maps_dir = "");
+};
@@ -3,8 +3,12 @@
 #include <vector>
 #include <unordered_set>
 #include <memory>
+#include <cstdint>
 #include "grid.h"
+#include "cost_map.h"
+#include "landmarks.h"
 #include "node.h"
+#include "search_capture.h"
 #include "vec2.h"
 
 /**
@@ -12,7 +16,9 @@
  */
 struct Vec2iHash {
     std::size_t operator()(const Vec2i& v) const {
-        return std::hash<int>()(v.x) ^ (std::hash<int>()(v.y) << 1);
+        // Both coordinates in full; x ^ (y << 1) collided for most of a grid
+        uint64_t key = (static_cast<uint64_t>(static_cast<uint32_t>(v.x)) << 32) | static_cast<uint32_t>(v.y);
+        return std::hash<uint64_t>()(key * 0x9e3779b97f4a7c15ull);
     }
 };
 
@@ -21,31 +27,88 @@ struct Vec2iHash {
  */
 struct AStarResult {
     std::vector<Vec2i> path;
-    std::vector<Vec2i> visited;    // Closed set (for visualization)
-    std::vector<Vec2i> explored;   // Open set at each step (for visualization)
+    std::vector<Vec2i> visited;    // Closed set (only with SearchCapture::results)
+    std::vector<Vec2i> explored;   // Open set at each step (only with SearchCapture::results)
     int nodes_expanded;
+    int coarse_nodes_expanded;     // Coarse-to-fine search only (included in nodes_expanded)
     float path_cost;
     bool success;
     
-    AStarResult() : nodes_expanded(0), path_cost(0.0f), success(false) {}
+    AStarResult() : nodes_expanded(0), coarse_nodes_expanded(0), path_cost(0.0f), success(false) {}
+};
+
+/**
+ * Settings for coarse-to-fine search over the grid's occupancy pyramid.
+ */
+struct CoarseToFineOptions {
+    int level;                // Pyramid level searched first (cells of 2^level)
+    int corridor_margin;      // Coarse cells added around the coarse path
+    float occupancy_weight;   // Extra coarse step cost per unit of occupancy
+    
+    CoarseToFineOptions() : level(3), corridor_margin(1), occupancy_weight(2.0f) {}
 };
 
 /**
  * A* pathfinding algorithm.
+ *
+ * With a non-uniform cost map attached, a step into a cell costs
+ * 1 + costs.getCost(cell); without one (or while it is uniform) the
+ * unit-cost search runs unchanged.
+ *
+ * With a LandmarkTable for the grid attached, the heuristic becomes the
+ * larger of the straight-line distance and the landmark (ALT) bound, which
+ * follows walls and cuts expansions sharply on maze-like maps.
  */
 class AStar {
 public:
     explicit AStar(const Grid& grid);
     
+    const Grid& getGrid() const { return grid_; }
+    
+    // Optional traversal costs (not owned; nullptr = uniform)
+    void setCostMap(const CostMap* costs) { costs_ = costs; }
+    const CostMap* getCostMap() const { return costs_; }
+    
+    // Optional ALT distance table (not owned; nullptr = straight-line only).
+    // Ignored unless built from this grid's current contents.
+    void setLandmarks(const LandmarkTable* landmarks) { landmarks_ = landmarks; }
+    const LandmarkTable* getLandmarks() const { return landmarks_; }
+    
+    // Visualization capture; nothing is recorded by default
+    void setCapture(const SearchCapture& capture) { capture_ = capture; }
+    const SearchCapture& getCapture() const { return capture_; }
+    
     // Find path from start to goal
     AStarResult findPath(Vec2i start, Vec2i goal);
     
+    /**
+     * Plan on a coarse pyramid level first, where a cell is passable unless
+     * fully blocked, then search the full-resolution grid only inside a
+     * corridor around the coarse path. Falls back to an unrestricted search
+     * if the corridor is too tight. Enable the grid's pyramid for O(1)
+     * coarse lookups; without it coarse cells are counted from the tiles.
+     */
+    AStarResult findPathCoarseToFine(Vec2i start, Vec2i goal,
+                                     const CoarseToFineOptions& options = CoarseToFineOptions());
+    
     // Heuristic functions
     static float euclideanDistance(Vec2i a, Vec2i b);
     static float manhattanDistance(Vec2i a, Vec2i b);
     
 private:
     const Grid& grid_;
+    const CostMap* costs_;
+    const LandmarkTable* landmarks_;
+    SearchCapture capture_;
+    
+    // Last landmark match check, redone when the grid version or table changes
+    mutable const LandmarkTable* checked_landmarks_;
+    mutable uint64_t checked_hash_;
+    mutable uint64_t checked_version_;
+    mutable bool landmarks_match_;
+    
+    const LandmarkTable* activeLandmarks() const;
+    AStarResult findPathWeighted(Vec2i start, Vec2i goal) const;
     
     std::vector<Vec2i> getNeighbors(Vec2i pos) const;
     std::vector<Vec2i> reconstructPath(Node* goal) const;
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <vector>
+#include "vec2.h"
+#include "grid.h"
+
+/**
+ * Distance from each grid cell to the nearest obstacle cell.
+ *
+ * Computed with an exact Euclidean distance transform (two separable 1D
+ * passes) over a window of the grid. Cells outside the grid count as
+ * obstacles, matching Grid::isObstacle. Distances are capped at max_distance,
+ * so the window only needs that much margin around the area of interest.
+ * Rows and columns of each pass are independent and are split across
+ * num_threads workers (0 = hardware concurrency).
+ */
+class ClearanceMap {
+public:
+    // Whole grid
+    explicit ClearanceMap(const Grid& grid, float max_distance = 8.0f, int num_threads = 1);
+    
+    // Cells in [min_x, max_x] x [min_y, max_y] (inclusive), plus margin
+    ClearanceMap(const Grid& grid, int min_x, int min_y, int max_x, int max_y,
+                 float max_distance = 8.0f, int num_threads = 1);
+    
+    bool contains(int x, int y) const {
+        return x >= origin_x_ && y >= origin_y_ &&
+               x < origin_x_ + width_ && y < origin_y_ + height_;
+    }
+    
+    // Distance in cells (0 = obstacle), or -1 outside the window
+    float at(int x, int y) const {
+        return contains(x, y) ? dist_[(y - origin_y_) * width_ + (x - origin_x_)] : -1.0f;
+    }
+    
+    /**
+     * Conservative free radius around a continuous point: every point closer
+     * than this rounds to a free cell. 0 if the point is in or next to an
+     * obstacle, or outside the window.
+     */
+    float clearance(Vec2 p) const;
+    
+    // True if the segment is covered by the free discs of its endpoints.
+    // False means "unknown", not "blocked".
+    bool isSegmentClear(Vec2 from, Vec2 to) const {
+        float c = clearance(from);
+        if (c <= 0.0f) return false;
+        return (to - from).length() <= c + clearance(to);
+    }
+    
+    // Central-difference gradient of the distance (points away from obstacles)
+    Vec2 gradient(int x, int y) const;
+    
+    // Bilinear interpolation of distance and gradient between cell centres;
+    // returns false if any of the four cells is outside the window
+    bool sample(Vec2 p, float& distance, Vec2& gradient) const;
+    
+    float getMaxDistance() const { return max_distance_; }
+    int getOriginX() const { return origin_x_; }
+    int getOriginY() const { return origin_y_; }
+    int getWidth() const { return width_; }
+    int getHeight() const { return height_; }
+
+private:
+    int origin_x_, origin_y_;
+    int width_, height_;
+    float max_distance_;
+    std::vector<float> dist_;  // Row-major, width_ * height_
+    
+    void build(const Grid& grid, int num_threads);
+};
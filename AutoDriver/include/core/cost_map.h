@@ -0,0 +1,156 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include "grid.h"
+
+#if defined(__F16C__)
+#include <immintrin.h>
+#endif
+
+enum class CostEncoding {
+    UINT8,   // max_cost / 255 quantisation, 1 byte per cell
+    HALF     // IEEE half float, 2 bytes per cell
+};
+
+/**
+ * Per-cell traversal cost stored compactly.
+ *
+ * Costs are extra cost per unit of distance on top of the unit base cost,
+ * clamped to [0, max_cost]. Cells outside the layer cost nothing.
+ */
+class CostLayer {
+public:
+    CostLayer(int width, int height, CostEncoding encoding = CostEncoding::UINT8, float max_cost = 10.0f);
+    
+    float get(int x, int y) const {
+        if (x < 0 || y < 0 || x >= width_ || y >= height_) return 0.0f;
+        size_t i = static_cast<size_t>(y) * width_ + x;
+        return encoding_ == CostEncoding::UINT8 ? bytes_[i] * step_ : halfToFloat(halves_[i]);
+    }
+    void set(int x, int y, float cost);
+    void fill(float cost);
+    
+    int getWidth() const { return width_; }
+    int getHeight() const { return height_; }
+    CostEncoding getEncoding() const { return encoding_; }
+    float getMaxCost() const { return max_cost_; }
+    size_t getNonZeroCells() const { return nonzero_; }
+    size_t getBytes() const { return bytes_.size() + halves_.size() * sizeof(uint16_t); }
+    
+    // Half-float conversion (F16C when available)
+    static uint16_t floatToHalf(float value);
+    static float halfToFloat(uint16_t half) {
+#if defined(__F16C__)
+        return _cvtsh_ss(half);
+#else
+        uint32_t sign = static_cast<uint32_t>(half & 0x8000u) << 16;
+        uint32_t exponent = (half >> 10) & 0x1fu;
+        uint32_t mantissa = half & 0x3ffu;
+        uint32_t bits;
+        if (exponent == 0) {
+            if (mantissa == 0) {
+                bits = sign;
+            } else {
+                // Subnormal: renormalise
+                exponent = 113;
+                while (!(mantissa & 0x400u)) {
+                    mantissa <<= 1;
+                    exponent--;
+                }
+                bits = sign | (exponent << 23) | ((mantissa & 0x3ffu) << 13);
+            }
+        } else if (exponent == 31) {
+            bits = sign | 0x7f800000u | (mantissa << 13);
+        } else {
+            bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+        }
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+#endif
+    }
+
+private:
+    friend class CostMap;
+    
+    int width_, height_;
+    CostEncoding encoding_;
+    float max_cost_;
+    float step_;                     // UINT8 quantisation step
+    std::vector<uint8_t> bytes_;     // UINT8 storage
+    std::vector<uint16_t> halves_;   // HALF storage
+    size_t nonzero_;
+    
+    // Bulk writes from CostMap; nonzero_ is fixed up by recount()
+    void store(size_t i, float cost);
+    void recount();
+};
+
+/**
+ * Obstacle inflation settings: cost decays exponentially with distance
+ * from the nearest obstacle and is zero from radius onwards, so planners
+ * prefer the middle of aisles.
+ */
+struct InflationOptions {
+    float radius;        // Distance (cells) at which the cost reaches zero
+    float max_cost;      // Cost next to an obstacle (distance 1)
+    float decay;         // Exponential falloff per cell
+    int num_threads;     // 0 = hardware concurrency
+    CostEncoding encoding;
+    
+    InflationOptions()
+        : radius(5.0f), max_cost(8.0f), decay(0.6f), num_threads(0),
+          encoding(CostEncoding::UINT8) {}
+};
+
+/**
+ * Named cost layers with weights, combined into one half-float layer that
+ * planners read. A planner step into cell c costs its length times
+ * 1 + sum(weight * layer(c)). While every combined cost is zero the map is
+ * uniform and planners keep their unit-cost fast paths.
+ *
+ * Every rebuild gives the combined layer a new version, unique across all
+ * cost maps, so caches can key results on (map, version) without comparing
+ * costs.
+ */
+class CostMap {
+public:
+    CostMap(int width, int height);
+    
+    // Add or replace a layer (false if its size differs); the combined layer is rebuilt
+    bool setLayer(const std::string& name, CostLayer layer, float weight = 1.0f);
+    bool setWeight(const std::string& name, float weight);
+    bool removeLayer(const std::string& name);
+    
+    const CostLayer* getLayer(const std::string& name) const;
+    CostLayer* getMutableLayer(const std::string& name);   // Call rebuild() after editing
+    
+    // Recombine all layers (rows split over num_threads, 0 = hardware concurrency)
+    void rebuild(int num_threads = 0);
+    
+    float getCost(int x, int y) const { return combined_.get(x, y); }
+    bool isUniform() const { return combined_.getNonZeroCells() == 0; }
+    uint64_t getVersion() const { return version_; }   // Changes on every rebuild
+    
+    int getWidth() const { return combined_.getWidth(); }
+    int getHeight() const { return combined_.getHeight(); }
+    size_t getLayerCount() const { return layers_.size(); }
+    
+    // Obstacle inflation layer from a separable (parallel) distance transform
+    static CostLayer buildInflationLayer(const Grid& grid, const InflationOptions& options = InflationOptions());
+
+private:
+    struct Entry {
+        std::string name;
+        CostLayer layer;
+        float weight;
+    };
+    
+    std::vector<Entry> layers_;
+    CostLayer combined_;
+    uint64_t version_;
+};
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <limits>
+#include <cstdint>
+#include <cstddef>
+#include "grid.h"
+#include "cost_map.h"
+#include "vec2.h"
+#include "worker_pool.h"
+
+/**
+ * Dense sources x targets path costs, row-major.
+ */
+struct CostMatrix {
+    static constexpr float kUnreachable = std::numeric_limits<float>::infinity();
+    
+    int rows;                  // One per source
+    int cols;                  // One per target
+    std::vector<float> costs;  // Same cost as AStar::findPath; kUnreachable if it would fail
+    int searches;              // Dijkstra passes run
+    bool per_target;           // Passes started from the targets (fewer targets than sources)
+    size_t cells_settled;      // Over all passes
+    
+    CostMatrix() : rows(0), cols(0), searches(0), per_target(false), cells_settled(0) {}
+    
+    float at(int source, int target) const { return costs[static_cast<size_t>(source) * cols + target]; }
+};
+
+/**
+ * Many-to-many 4-connected path costs, e.g. robots by tasks for dispatch.
+ *
+ * Instead of one A* per pair, each pass is a single Dijkstra from one side
+ * that settles cells until every cell of the other side is reached, so a
+ * whole row (or column) costs one search. Passes start from the sources, or
+ * from the targets when there are fewer of them; with a cost map, reverse
+ * passes charge each step at the cell being left, so both directions give
+ * the cost of the forward path. Uniform costs use a level-by-level
+ * breadth-first pass in place of the heap.
+ *
+ * Each call snapshots passability (and step costs) into flat arrays with a
+ * blocked border, so the inner loops need no bounds checks or tile lookups.
+ *
+ * Passes are spread over a persistent worker pool, each worker with its own
+ * search context (visited bits, distances, queues). Both are kept across
+ * calls, so a dispatcher calling every cycle neither starts threads nor
+ * allocates after the first one.
+ */
+class CostMatrixPlanner {
+public:
+    explicit CostMatrixPlanner(const Grid& grid);
+    ~CostMatrixPlanner();
+    
+    // Optional traversal costs (not owned; nullptr = uniform), as for AStar
+    void setCostMap(const CostMap* costs) { costs_ = costs; }
+    const CostMap* getCostMap() const { return costs_; }
+    
+    void setNumThreads(int num_threads) { num_threads_ = num_threads; }   // 0 = hardware threads
+    int getNumThreads() const { return num_threads_; }
+    
+    CostMatrix computeCostMatrix(const std::vector<Vec2i>& sources, const std::vector<Vec2i>& targets);
+
+private:
+    struct SearchContext;
+    
+    const Grid& grid_;
+    const CostMap* costs_;
+    int num_threads_;
+    std::vector<std::unique_ptr<SearchContext>> contexts_;   // One per worker, reused across calls
+    std::unique_ptr<WorkerPool> pool_;                       // Created lazily, rebuilt if the count changes
+    
+    // Per-call snapshot, indexed by padded cell (y + 1) * padded_width_ + x + 1
+    int padded_width_;
+    std::vector<uint8_t> passable_;     // Border cells are blocked
+    std::vector<uint64_t> blocked_bits_;   // The same as bits, inverted: seeds each uniform pass's visited set
+    std::vector<float> enter_cost_;     // 1 + cost of stepping into each cell (weighted calls only)
+    std::vector<uint64_t> goal_bits_;   // Cells holding at least one goal
+    std::vector<int32_t> cell_goal_;    // First goal index at each cell, -1 if none
+    std::vector<int32_t> next_goal_;    // Next goal index at the same cell, -1 if none
+    
+    int32_t paddedCell(Vec2i p) const { return (p.y + 1) * padded_width_ + p.x + 1; }
+    void snapshot(const CostMap* costs);
+    
+    // One pass from origin; goal g's cost lands in out[g * goal_stride]
+    void searchUniform(SearchContext& context, int32_t origin, int goal_count, float* out, size_t goal_stride) const;
+    void searchWeighted(SearchContext& context, int32_t origin, bool reverse, int goal_count,
+                        float* out, size_t goal_stride) const;
+};
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <vector>
+#include <cstddef>
+#include <cstdint>
 #include "vec2.h"
 
 /**
@@ -37,8 +39,71 @@ private:
     float radius_;
 };
 
+class DynamicObstacleManager;
+
+/**
+ * Read-only view of one obstacle stored inside a DynamicObstacleManager.
+ * Exposes the same queries as DynamicObstacle without owning any data.
+ */
+class DynamicObstacleView {
+public:
+    DynamicObstacleView(const DynamicObstacleManager* manager, size_t index)
+        : manager_(manager), index_(index) {}
+    
+    Vec2 getPosition() const;
+    Vec2 getVelocity() const;
+    float getRadius() const;
+    
+    Vec2 predictPosition(float time) const;
+    bool collides(Vec2 point, float time) const;
+    bool collidesWithPath(Vec2 from, Vec2 to, float start_time, float end_time) const;
+    
+    // Copy the viewed obstacle out of the manager
+    DynamicObstacle toObstacle() const;
+    
+private:
+    const DynamicObstacleManager* manager_;
+    size_t index_;
+};
+
+/**
+ * Iterable range of obstacle views (returned by DynamicObstacleManager::getObstacles).
+ */
+class DynamicObstacleRange {
+public:
+    class Iterator {
+    public:
+        Iterator(const DynamicObstacleManager* manager, size_t index)
+            : manager_(manager), index_(index) {}
+        
+        DynamicObstacleView operator*() const { return DynamicObstacleView(manager_, index_); }
+        Iterator& operator++() { ++index_; return *this; }
+        bool operator==(const Iterator& other) const { return index_ == other.index_; }
+        bool operator!=(const Iterator& other) const { return index_ != other.index_; }
+        
+    private:
+        const DynamicObstacleManager* manager_;
+        size_t index_;
+    };
+    
+    DynamicObstacleRange(const DynamicObstacleManager* manager, size_t count)
+        : manager_(manager), count_(count) {}
+    
+    DynamicObstacleView operator[](size_t index) const { return DynamicObstacleView(manager_, index); }
+    Iterator begin() const { return Iterator(manager_, 0); }
+    Iterator end() const { return Iterator(manager_, count_); }
+    size_t size() const { return count_; }
+    bool empty() const { return count_ == 0; }
+    
+private:
+    const DynamicObstacleManager* manager_;
+    size_t count_;
+};
+
 /**
  * Manager for multiple dynamic obstacles.
+ * Obstacles are stored as structure-of-arrays (x, y, vx, vy, radius) so that
+ * updates and collision queries run as straight vectorised loops.
  */
 class DynamicObstacleManager {
 public:
@@ -46,6 +111,7 @@ public:
     
     // Add/remove obstacles
     void addObstacle(const DynamicObstacle& obstacle);
+    void reserve(size_t count);
     void clear();
     
     // Update all obstacles
@@ -55,10 +121,28 @@ public:
     bool checkCollision(Vec2 point, float time) const;
     bool checkPathCollision(Vec2 from, Vec2 to, float start_time, float end_time) const;
     
+    // Batch queries: predicted positions of every obstacle at `time`, and
+    // one collision flag per query point (1 = inside some obstacle)
+    void predictPositions(float time, std::vector<Vec2>& out) const;
+    void checkCollisions(const std::vector<Vec2>& points, float time,
+                         std::vector<uint8_t>& out) const;
+    
     // Getters
-    const std::vector<DynamicObstacle>& getObstacles() const { return obstacles_; }
-    size_t size() const { return obstacles_.size(); }
+    DynamicObstacleRange getObstacles() const { return DynamicObstacleRange(this, size()); }
+    DynamicObstacleView getObstacle(size_t index) const { return DynamicObstacleView(this, index); }
+    size_t size() const { return pos_x_.size(); }
+    
+    // Raw SoA access
+    const std::vector<float>& positionsX() const { return pos_x_; }
+    const std::vector<float>& positionsY() const { return pos_y_; }
+    const std::vector<float>& velocitiesX() const { return vel_x_; }
+    const std::vector<float>& velocitiesY() const { return vel_y_; }
+    const std::vector<float>& radii() const { return radius_; }
     
 private:
-    std::vector<DynamicObstacle> obstacles_;
+    std::vector<float> pos_x_;
+    std::vector<float> pos_y_;
+    std::vector<float> vel_x_;
+    std::vector<float> vel_y_;
+    std::vector<float> radius_;
 };
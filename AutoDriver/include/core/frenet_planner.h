@@ -0,0 +1,171 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include "vec2.h"
+#include "lane_planner.h"
+#include "dynamic_obstacle.h"
+
+/**
+ * Quintic polynomial with position, velocity and acceleration fixed at both ends.
+ * Used for lateral motion d(t) (minimum jerk).
+ */
+struct QuinticPolynomial {
+    float c[6];
+    
+    QuinticPolynomial(float x0, float v0, float a0, float x1, float v1, float a1, float T);
+    
+    float position(float t) const { return c[0] + t * (c[1] + t * (c[2] + t * (c[3] + t * (c[4] + t * c[5])))); }
+    float velocity(float t) const { return c[1] + t * (2 * c[2] + t * (3 * c[3] + t * (4 * c[4] + t * 5 * c[5]))); }
+    float acceleration(float t) const { return 2 * c[2] + t * (6 * c[3] + t * (12 * c[4] + t * 20 * c[5])); }
+    float jerk(float t) const { return 6 * c[3] + t * (24 * c[4] + t * 60 * c[5]); }
+};
+
+/**
+ * Quartic polynomial with start state and end velocity/acceleration fixed.
+ * Used for longitudinal motion s(t) (velocity keeping).
+ */
+struct QuarticPolynomial {
+    float c[5];
+    
+    QuarticPolynomial(float x0, float v0, float a0, float v1, float a1, float T);
+    
+    float position(float t) const { return c[0] + t * (c[1] + t * (c[2] + t * (c[3] + t * c[4]))); }
+    float velocity(float t) const { return c[1] + t * (2 * c[2] + t * (3 * c[3] + t * 4 * c[4])); }
+    float acceleration(float t) const { return 2 * c[2] + t * (6 * c[3] + t * 12 * c[4]); }
+    float jerk(float t) const { return 6 * c[3] + t * 24 * c[4]; }
+};
+
+/**
+ * Vehicle state in the Frenet frame of a reference lane.
+ */
+struct FrenetState {
+    float s, s_d, s_dd;  // Arc length along the lane and its derivatives
+    float d, d_d, d_dd;  // Signed lateral offset (left positive) and its derivatives
+    
+    FrenetState(float s_ = 0.0f, float speed = 0.0f, float d_ = 0.0f)
+        : s(s_), s_d(speed), s_dd(0.0f), d(d_), d_d(0.0f), d_dd(0.0f) {}
+};
+
+/**
+ * Sampling and scoring parameters for the Frenet planner.
+ */
+struct FrenetConfig {
+    // Sampling grid: lateral offsets x horizons x target speeds
+    float max_lateral_offset;  // Offsets sampled in [-max, max]
+    int lateral_samples;
+    float min_horizon;         // Maneuver duration range (s)
+    float max_horizon;
+    int horizon_samples;
+    float speed_range;         // Target speeds sampled in [limit - range, limit]
+    int speed_samples;
+    
+    float dt;                  // Collision/limit check resolution (s)
+    float max_accel;           // Longitudinal acceleration limit
+    float max_lateral_accel;   // Lateral acceleration limit
+    float vehicle_radius;      // Circular footprint for obstacle checks
+    
+    // Cost weights
+    float w_jerk;
+    float w_time;
+    float w_speed;
+    float w_lateral;
+    
+    FrenetConfig()
+        : max_lateral_offset(3.5f), lateral_samples(9),
+          min_horizon(2.0f), max_horizon(5.0f), horizon_samples(5),
+          speed_range(10.0f), speed_samples(9),
+          dt(0.1f), max_accel(4.0f), max_lateral_accel(4.0f), vehicle_radius(1.0f),
+          w_jerk(0.1f), w_time(0.1f), w_speed(1.0f), w_lateral(1.0f) {}
+};
+
+/**
+ * Sampled trajectory in both Frenet and Cartesian coordinates.
+ */
+struct FrenetTrajectory {
+    std::vector<float> t;
+    std::vector<float> s;
+    std::vector<float> d;
+    std::vector<float> speed;
+    std::vector<Vec2> points;
+    float cost;
+    float duration;
+    float target_speed;
+    float target_offset;
+    
+    FrenetTrajectory() : cost(0.0f), duration(0.0f), target_speed(0.0f), target_offset(0.0f) {}
+};
+
+/**
+ * Result of a Frenet planning cycle.
+ */
+struct FrenetResult {
+    FrenetTrajectory trajectory;
+    bool success;
+    bool budget_exceeded;         // Stopped before every candidate was considered
+    int candidates_generated;
+    int candidates_checked;       // Candidates that went through limit/collision checks
+    int candidates_rejected;
+    double planning_time_ms;
+    
+    FrenetResult()
+        : success(false), budget_exceeded(false), candidates_generated(0),
+          candidates_checked(0), candidates_rejected(0), planning_time_ms(0.0) {}
+};
+
+/**
+ * Sampling-based trajectory planner in the Frenet frame of a lane.
+ *
+ * Each cycle generates lateral quintics and longitudinal quartics for every
+ * (offset, horizon, speed) sample and stores the coefficients as SoA arrays.
+ * Costs use closed-form jerk integrals, so all candidates are ranked before
+ * any is sampled. Candidates are then checked in cost order, in batches,
+ * against acceleration/speed limits and predicted dynamic obstacles. The
+ * first feasible one is the cheapest; the search stops early when the time
+ * budget runs out.
+ */
+class FrenetPlanner {
+public:
+    FrenetPlanner(const Lane& reference, const DynamicObstacleManager& obstacles);
+    
+    // Plan one cycle from the given state
+    FrenetResult plan(const FrenetState& state, double time_budget_ms = 100.0);
+    
+    // Coordinate conversion relative to the reference lane
+    Vec2 toCartesian(float s, float d) const;
+    FrenetState toFrenet(Vec2 pos, float speed = 0.0f) const;
+    
+    float getReferenceLength() const { return ref_s_.empty() ? 0.0f : ref_s_.back(); }
+    
+    void setConfig(const FrenetConfig& config) { config_ = config; }
+    const FrenetConfig& getConfig() const { return config_; }
+
+private:
+    const DynamicObstacleManager& obstacles_;
+    FrenetConfig config_;
+    float speed_limit_;
+    float max_speed_;  // Speed cap for the current cycle
+    
+    // Reference line: vertex arc lengths, vertices and unit segment directions
+    std::vector<float> ref_s_;
+    std::vector<float> ref_x_, ref_y_;
+    std::vector<float> ref_dx_, ref_dy_;
+    
+    // Candidate coefficients (SoA, one entry per candidate)
+    std::vector<float> lat_[6];
+    std::vector<float> lon_[5];
+    std::vector<float> horizon_;
+    std::vector<float> target_d_;
+    std::vector<float> target_v_;
+    std::vector<float> cost_;
+    
+    // Obstacles that can reach the planning corridor, predicted per time step
+    std::vector<float> obs_x_, obs_y_, obs_r_;  // [step * obs_count_ + i]
+    size_t obs_count_;
+    
+    int segmentAt(float s) const;
+    void generateCandidates(const FrenetState& state);
+    void predictObstacles(const FrenetState& state, int steps);
+    int checkBatch(const int* order, int count, int steps, std::vector<uint8_t>& feasible);
+    FrenetTrajectory sampleTrajectory(int candidate) const;
+};
@@ -1,29 +1,219 @@
 #pragma once
 
 #include <vector>
+#include <memory>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
 #include "vec2.h"
 
 /**
  * 2D grid environment with obstacles.
+ *
+ * Cells are stored as bit-packed 64x64 tiles shared between copies with
+ * copy-on-write: copying a Grid (or calling snapshot()) only copies the tile
+ * table, and a later edit clones just the tile it touches. A snapshot is
+ * therefore a cheap, immutable, consistent view that planners on other
+ * threads can read while the original keeps being edited. Untouched regions
+ * of a new grid all share one empty tile. Tiles may also alias read-only
+ * rows owned by someone else (a memory-mapped map file, see MapIO); those are
+ * cloned on first write like any shared tile. Bits outside the grid bounds
+ * are always zero.
+ *
+ * An optional occupancy pyramid (enablePyramid) keeps, for every coarse cell
+ * of 2x2, 4x4 and 8x8 base cells, the number of blocked cells beneath it.
+ * setObstacle updates it incrementally in O(levels). Pyramid blocks are
+ * stored per tile and shared copy-on-write exactly like the tiles.
+ *
+ * Every change bumps a monotonically increasing version, and each tile
+ * records the version of its last change, so a cache can tell whether a
+ * region changed since it was computed without keeping a copy of the map.
+ * Copies and snapshots carry both along, so versions from one snapshot can be
+ * compared against any later snapshot of the same map.
+ *
+ * Any number of threads may read a Grid concurrently; editing a Grid while
+ * another thread reads that same object still requires external
+ * synchronisation - hand readers a snapshot instead.
  */
 class Grid {
 public:
+    static constexpr int kTileShift = 6;
+    static constexpr int kTileSize = 1 << kTileShift;
+    static constexpr int kMaxPyramidLevels = 3;   // Coarsest level = 8x8 cells
+    
     Grid(int width, int height);
     
     // Obstacle management
-    bool isObstacle(int x, int y) const;
+    bool isObstacle(int x, int y) const {
+        if (!isValid(x, y)) return true;  // Out of bounds = obstacle
+        const uint64_t* rows = tiles_[(y >> kTileShift) * tiles_x_ + (x >> kTileShift)].rows();
+        return (rows[y & (kTileSize - 1)] >> (x & (kTileSize - 1))) & 1u;
+    }
     void setObstacle(int x, int y, bool blocked);
     void toggleObstacle(int x, int y);
     void clear();
     
     // Bounds checking
-    bool isValid(int x, int y) const;
+    bool isValid(int x, int y) const {
+        return x >= 0 && x < width_ && y >= 0 && y < height_;
+    }
     
     // Getters
     int getWidth() const { return width_; }
     int getHeight() const { return height_; }
     
+    // Snapshots: copies share tiles until either side edits them
+    Grid snapshot() const { return *this; }
+    uint64_t getVersion() const { return version_; }  // Bumped by every change
+    
+    // Change journal: version of the last change to each tile (0 = never)
+    uint64_t getTileVersion(int tx, int ty) const { return tile_versions_[static_cast<size_t>(ty) * tiles_x_ + tx]; }
+    bool changedSince(uint64_t version) const { return version_ > version; }
+    // True if any tile of the inclusive tile rectangle (clamped to the grid)
+    // changed after version
+    bool changedSince(uint64_t version, int min_tx, int min_ty, int max_tx, int max_ty) const;
+    // Tiles changed after version, as (tx, ty), in row-major order
+    std::vector<Vec2i> getChangedTiles(uint64_t version) const;
+    
+    // Hash of the dimensions and every cell, so tables precomputed for one
+    // map can tell it apart from another map of the same size. Equal grids
+    // hash alike whatever their version or tile sharing; O(cells / 64).
+    uint64_t contentHash() const;
+    
+    // Tile introspection
+    int getTilesX() const { return tiles_x_; }
+    int getTilesY() const { return tiles_y_; }
+    bool sharesTile(const Grid& other, int tx, int ty) const;
+    size_t countSharedTiles(const Grid& other) const;
+    size_t getTilesCloned() const { return tiles_cloned_; }
+    
+    // Occupancy pyramid. Level 0 is the grid itself, level l has cells of
+    // 2^l x 2^l base cells; coarse cells outside the grid count as blocked.
+    void enablePyramid(int levels = kMaxPyramidLevels);
+    void disablePyramid();
+    int getPyramidLevels() const { return pyramid_levels_; }
+    int getLevelWidth(int level) const { return (width_ + (1 << level) - 1) >> level; }
+    int getLevelHeight(int level) const { return (height_ + (1 << level) - 1) >> level; }
+    int getBlockedCount(int level, int cx, int cy) const;   // Requires level <= getPyramidLevels()
+    float getOccupancy(int level, int cx, int cy) const;    // Blocked fraction of in-bounds cells
+    bool isCoarseBlocked(int level, int cx, int cy) const { return getBlockedCount(level, cx, cy) > 0; }
+    
+    // True if every cell of the inclusive rectangle is inside the grid and
+    // free. Empty 8x8 blocks are skipped through the pyramid when enabled.
+    bool isRegionFree(int min_x, int min_y, int max_x, int max_y) const;
+
 private:
+    friend class MapIO;
+    
+    struct Tile {
+        std::atomic<int> refs;
+        std::shared_ptr<const void> backing;  // Set when aliased rows live elsewhere
+        uint64_t rows[kTileSize];  // Bit x of rows[y] = cell (x, y) within the tile
+        
+        Tile() : refs(1), rows() {}
+        explicit Tile(const uint64_t* source) : refs(1) {
+            for (int i = 0; i < kTileSize; i++) rows[i] = source[i];
+        }
+    };
+    
+    // Intrusive reference to a shared tile. rows_ normally points into the
+    // tile itself; an aliasing reference instead points at external rows
+    // and keeps them alive through the tile's backing.
+    class TileRef {
+    public:
+        TileRef() : tile_(new Tile()), rows_(tile_->rows) {}
+        explicit TileRef(Tile* adopt) : tile_(adopt), rows_(adopt->rows) {}
+        TileRef(const TileRef& owner, const uint64_t* rows) : tile_(owner.tile_), rows_(rows) { retain(); }
+        TileRef(const TileRef& other) : tile_(other.tile_), rows_(other.rows_) { retain(); }
+        TileRef& operator=(const TileRef& other) {
+            if (rows_ != other.rows_) {
+                other.retain();
+                release();
+                tile_ = other.tile_;
+                rows_ = other.rows_;
+            }
+            return *this;
+        }
+        ~TileRef() { release(); }
+        
+        const uint64_t* rows() const { return rows_; }
+        
+        // Tile for writing, cloned first if anyone else can see it
+        Tile* mutate(size_t& cloned) {
+            if (tile_->backing || tile_->refs.load(std::memory_order_acquire) != 1) {
+                Tile* copy = new Tile(rows_);
+                release();
+                tile_ = copy;
+                rows_ = copy->rows;
+                cloned++;
+            }
+            return tile_;
+        }
+    
+    private:
+        Tile* tile_;
+        const uint64_t* rows_;
+        
+        void retain() const { tile_->refs.fetch_add(1, std::memory_order_relaxed); }
+        void release() {
+            if (tile_->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) delete tile_;
+        }
+    };
+    
+    // Blocked-cell counts of one tile's pyramid levels, packed level by level
+    struct PyramidBlock {
+        static constexpr int kCells = 32 * 32 + 16 * 16 + 8 * 8;
+        
+        std::atomic<int> refs;
+        uint8_t counts[kCells];
+        
+        PyramidBlock() : refs(1), counts() {}
+        PyramidBlock(const PyramidBlock& other) : refs(1) {
+            for (int i = 0; i < kCells; i++) counts[i] = other.counts[i];
+        }
+        
+        static int offset(int level) { return level == 1 ? 0 : level == 2 ? 32 * 32 : 32 * 32 + 16 * 16; }
+    };
+    
+    class PyramidRef {
+    public:
+        PyramidRef() : block_(new PyramidBlock()) {}
+        PyramidRef(const PyramidRef& other) : block_(other.block_) { retain(); }
+        PyramidRef& operator=(const PyramidRef& other) {
+            if (block_ != other.block_) {
+                other.retain();
+                release();
+                block_ = other.block_;
+            }
+            return *this;
+        }
+        ~PyramidRef() { release(); }
+        
+        const PyramidBlock* get() const { return block_; }
+        PyramidBlock* mutate() {
+            if (block_->refs.load(std::memory_order_acquire) != 1) {
+                PyramidBlock* copy = new PyramidBlock(*block_);
+                release();
+                block_ = copy;
+            }
+            return block_;
+        }
+    
+    private:
+        PyramidBlock* block_;
+        
+        void retain() const { block_->refs.fetch_add(1, std::memory_order_relaxed); }
+        void release() {
+            if (block_->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) delete block_;
+        }
+    };
+    
     int width_, height_;
-    std::vector<std::vector<bool>> obstacles_;
+    int tiles_x_, tiles_y_;
+    std::vector<TileRef> tiles_;
+    std::vector<PyramidRef> pyramid_;   // Parallel to tiles_ when enabled
+    int pyramid_levels_;
+    uint64_t version_;
+    std::vector<uint64_t> tile_versions_;   // Parallel to tiles_
+    size_t tiles_cloned_;
 };
@@ -2,7 +2,10 @@
 
 #include <vector>
 #include <memory>
+#include <limits>
 #include "grid.h"
+#include "cost_map.h"
+#include "search_capture.h"
 #include "vec2.h"
 
 /**
@@ -57,12 +60,13 @@ struct VehicleParams {
  */
 struct HybridAStarResult {
     std::vector<HybridState> path;
-    std::vector<Vec2> explored;
-    int nodes_expanded;
+    std::vector<Vec2> explored;   // States added to the open set (only with SearchCapture::results)
+    int nodes_expanded;   // States expanded (distinct cells)
+    int iterations;       // Open-set pops, including superseded entries
     float path_cost;
     bool success;
     
-    HybridAStarResult() : nodes_expanded(0), path_cost(0.0f), success(false) {}
+    HybridAStarResult() : nodes_expanded(0), iterations(0), path_cost(0.0f), success(false) {}
 };
 
 /**
@@ -73,19 +77,37 @@ class HybridAStar {
 public:
     explicit HybridAStar(const Grid& grid, const VehicleParams& params = VehicleParams());
     
-    // Main planning function
+    // Main planning function. States that cannot reach the goal for less
+    // than max_cost (cost so far plus straight-line distance) are dropped,
+    // so a search that cannot beat a known alternative fails early.
     HybridAStarResult findPath(Vec2 start, float start_theta,
                                Vec2 goal, float goal_theta,
-                               int max_iterations = 10000);
+                               int max_iterations = 10000,
+                               float max_cost = std::numeric_limits<float>::infinity());
     
     // Configuration
     void setVehicleParams(const VehicleParams& params) { vehicle_params_ = params; }
     void setAngularResolution(int divisions) { angular_divisions_ = divisions; }
     
+    // Largest heading change per unit of path cost over the motion
+    // primitives; cost maps only add cost, so turning by dtheta always costs
+    // at least dtheta / getMaxTurnPerCost()
+    float getMaxTurnPerCost() const;
+    
+    // Optional traversal costs: a motion also pays its length times the cost
+    // of the cell it ends in (not owned; nullptr = uniform)
+    void setCostMap(const CostMap* costs) { costs_ = costs; }
+    
+    // Visualization capture; nothing is recorded by default
+    void setCapture(const SearchCapture& capture) { capture_ = capture; }
+    const SearchCapture& getCapture() const { return capture_; }
+    
 private:
     const Grid& grid_;
     VehicleParams vehicle_params_;
     int angular_divisions_;  // Number of angle divisions (e.g., 72 = 5° resolution)
+    const CostMap* costs_;
+    SearchCapture capture_;
     
     std::vector<MotionPrimitive> motion_primitives_;
     
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+// Build with -DAUTODRIVER_INSTRUMENTATION=1 (CMake option of the same name)
+// to compile the probes in; otherwise every probe macro expands to nothing.
+#ifndef AUTODRIVER_INSTRUMENTATION
+#define AUTODRIVER_INSTRUMENTATION 0
+#endif
+
+/**
+ * Hot-path probes. Each one accumulates a hit count and, when used as a
+ * scope, the time spent inside it. Search and smoothing phases also emit
+ * trace events while a trace is being recorded.
+ */
+enum class Probe : uint8_t {
+    ASTAR_SEARCH,
+    ASTAR_EXPAND,
+    ASTAR_HEAP_PUSH,
+    ASTAR_HEAP_POP,
+    ASTAR_NEIGHBORS,
+    HYBRID_SEARCH,
+    HYBRID_EXPAND,
+    HYBRID_HEAP_PUSH,
+    HYBRID_HEAP_POP,
+    HYBRID_COLLISION,
+    RRT_SEARCH,
+    RRT_NODE_ADDED,
+    RRT_NEAREST,
+    RRT_COLLISION,
+    RRT_REWIRE,
+    SMOOTH_SHORTCUT,
+    SMOOTH_GRADIENT,
+    SMOOTH_SPLINE,
+    SMOOTH_LINE_CHECK,
+    COUNT
+};
+
+/**
+ * Totals of one probe over all threads.
+ */
+struct ProbeStats {
+    Probe probe;
+    const char* name;
+    uint64_t count;
+    uint64_t total_ns;   // Zero for probes that only count
+};
+
+/**
+ * One thread's probe totals. Only the owning thread writes them.
+ */
+struct ProbeCounters {
+    static constexpr size_t kProbes = static_cast<size_t>(Probe::COUNT);
+    
+    std::atomic<uint64_t> counts[kProbes];
+    std::atomic<uint64_t> nanos[kProbes];
+    uint32_t thread_id;
+    
+    explicit ProbeCounters(uint32_t id);
+};
+
+/**
+ * Per-thread probe counters, scoped timers and Chrome trace export.
+ *
+ * Each thread writes only its own counters (relaxed atomics, no sharing),
+ * so probes never contend; snapshot() sums every thread that has ever hit
+ * a probe, including threads that have exited. An exiting thread folds its
+ * counters into retired totals and frees its slot for the next new thread,
+ * so code that starts threads per call does not grow the registry; probes
+ * hit after that point still count but leave no trace events. Traces are
+ * opt-in at run time because fine-grained events would swamp the buffer:
+ * only phase probes (searches and smoothing passes) become trace events,
+ * the rest are written as totals. Load the file in chrome://tracing or
+ * Perfetto.
+ */
+class Instrumentation {
+public:
+    static constexpr bool enabled() { return AUTODRIVER_INSTRUMENTATION != 0; }
+    
+    static const char* name(Probe probe);
+    static bool isPhase(Probe probe);
+    
+    static std::vector<ProbeStats> snapshot();
+    static void reset();
+    static size_t getThreadSlots();   // Counter slots allocated (live threads plus free slots)
+    static void printSummary(std::ostream& out);
+    
+    // Phase events are kept per thread, up to max_events_per_thread each
+    static void startTrace(size_t max_events_per_thread = 1u << 20);
+    static void stopTrace();
+    static bool isTracing() { return tracing_.load(std::memory_order_relaxed); }
+    static bool writeChromeTrace(const std::string& path);
+    
+    // Hot path (use the macros below)
+    static void count(Probe probe, uint64_t n = 1) {
+        std::atomic<uint64_t>& counter = local().counts[static_cast<size_t>(probe)];
+        counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+    static void record(Probe probe, std::chrono::steady_clock::time_point start,
+                       std::chrono::steady_clock::time_point end);
+
+private:
+    // Hands the calling thread a counter slot and arranges for it to be
+    // retired into the totals on thread exit, repointing home
+    static ProbeCounters& registerThread(ProbeCounters** home);
+    static ProbeCounters& local() {
+        static thread_local ProbeCounters* data = nullptr;
+        if (!data) data = &registerThread(&data);
+        return *data;
+    }
+    
+    static std::atomic<bool> tracing_;
+};
+
+/**
+ * Times the enclosing scope into a probe.
+ */
+class ScopedProbe {
+public:
+    explicit ScopedProbe(Probe probe) : probe_(probe), start_(std::chrono::steady_clock::now()) {}
+    ~ScopedProbe() { Instrumentation::record(probe_, start_, std::chrono::steady_clock::now()); }
+    
+    ScopedProbe(const ScopedProbe&) = delete;
+    ScopedProbe& operator=(const ScopedProbe&) = delete;
+
+private:
+    Probe probe_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+#define AUTODRIVER_PROBE_JOIN2(a, b) a##b
+#define AUTODRIVER_PROBE_JOIN(a, b) AUTODRIVER_PROBE_JOIN2(a, b)
+
+#if AUTODRIVER_INSTRUMENTATION
+#define AUTODRIVER_COUNT(probe) Instrumentation::count(Probe::probe)
+#define AUTODRIVER_COUNT_N(probe, n) Instrumentation::count(Probe::probe, static_cast<uint64_t>(n))
+#define AUTODRIVER_SCOPE(probe) ScopedProbe AUTODRIVER_PROBE_JOIN(autodriver_probe_, __LINE__)(Probe::probe)
+#else
+#define AUTODRIVER_COUNT(probe) ((void)0)
+#define AUTODRIVER_COUNT_N(probe, n) ((void)0)
+#define AUTODRIVER_SCOPE(probe) ((void)0)
+#endif
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+#include "grid.h"
+#include "vec2.h"
+
+enum class LandmarkSelection : uint8_t {
+    FARTHEST,    // Each landmark is the free cell farthest from those already chosen
+    PERIMETER    // Free cells spread evenly around the map border
+};
+
+/**
+ * Settings for LandmarkTable::build.
+ */
+struct LandmarkOptions {
+    int count;                    // Landmarks to place (fewer if the map runs out of cells)
+    LandmarkSelection selection;
+    int num_threads;              // Distance passes in parallel (0 = hardware threads)
+    
+    LandmarkOptions() : count(16), selection(LandmarkSelection::FARTHEST), num_threads(0) {}
+};
+
+/**
+ * Precomputed distances from K landmark cells to every cell of a static
+ * grid, for ALT (A*, landmarks, triangle inequality) lower bounds:
+ * d(a, b) >= |d(L, a) - d(L, b)| for every landmark L.
+ *
+ * Distances are 4-connected unit-step path lengths, stored as uint16 in
+ * units of a per-landmark step (1 unless a landmark's farthest cell is more
+ * than 65534 steps away), laid out cell-major so the K values a bound needs
+ * share a cache line. Tables save to a flat file that load() memory-maps,
+ * so a large table costs nothing until its pages are touched.
+ *
+ * A table records the content hash of the grid it was built from and only
+ * matches that exact map, so it must be rebuilt after any obstacle edit.
+ * Bounds stay admissible under cost maps (every step costs at least 1).
+ */
+class LandmarkTable {
+public:
+    static constexpr uint16_t kUnreachable = 0xFFFF;
+    
+    LandmarkTable();
+    
+    // Choose landmarks per options and run one distance pass from each
+    static LandmarkTable build(const Grid& grid, const LandmarkOptions& options = LandmarkOptions());
+    
+    // Distance passes from the given cells (blocked or invalid cells are skipped)
+    static LandmarkTable build(const Grid& grid, const std::vector<Vec2i>& landmarks, int num_threads = 0);
+    
+    bool save(const std::string& path) const;
+    static bool load(const std::string& path, LandmarkTable& out, bool memory_map = true);
+    
+    // The K quantized distances of cell (x, y); the cell must be on the grid
+    const uint16_t* distancesAt(int x, int y) const {
+        return data_ + (static_cast<size_t>(y) * width_ + x) * landmarks_.size();
+    }
+    
+    // Lower bound on the path length between two cells given their rows
+    float lowerBound(const uint16_t* from, const uint16_t* to) const {
+        uint32_t best = 0;
+        for (size_t k = 0; k < landmarks_.size(); k++) {
+            if (from[k] == kUnreachable || to[k] == kUnreachable) continue;
+            uint32_t diff = from[k] > to[k] ? from[k] - to[k] : to[k] - from[k];
+            if (diff == 0) continue;
+            
+            // Floor quantization loses up to step - 1 on each side
+            uint32_t bound = diff * steps_[k] - (steps_[k] - 1);
+            if (bound > best) best = bound;
+        }
+        return static_cast<float>(best);
+    }
+    
+    float lowerBound(Vec2i a, Vec2i b) const {
+        return lowerBound(distancesAt(a.x, a.y), distancesAt(b.x, b.y));
+    }
+    
+    // Distance from landmark k to (x, y), rounded down to its step; -1 if unreachable
+    int distance(size_t k, int x, int y) const {
+        uint16_t q = distancesAt(x, y)[k];
+        return q == kUnreachable ? -1 : static_cast<int>(q * steps_[k]);
+    }
+    
+    bool empty() const { return landmarks_.empty(); }
+    bool matches(const Grid& grid) const {
+        return !empty() && grid.getWidth() == width_ && grid.getHeight() == height_ &&
+               grid.contentHash() == grid_hash_;
+    }
+    
+    int getWidth() const { return width_; }
+    int getHeight() const { return height_; }
+    uint64_t getGridHash() const { return grid_hash_; }
+    size_t getLandmarkCount() const { return landmarks_.size(); }
+    const std::vector<Vec2i>& getLandmarks() const { return landmarks_; }
+    const std::vector<uint32_t>& getSteps() const { return steps_; }
+    size_t getBytes() const { return static_cast<size_t>(width_) * height_ * landmarks_.size() * sizeof(uint16_t); }
+    bool isMapped() const { return mapped_; }
+
+private:
+    int width_;
+    int height_;
+    uint64_t grid_hash_;                   // Grid::contentHash() of the source map
+    std::vector<Vec2i> landmarks_;
+    std::vector<uint32_t> steps_;          // Distance units per stored value, per landmark
+    std::shared_ptr<const void> storage_;  // Owns the values (built vector or mapped file)
+    const uint16_t* data_;
+    bool mapped_;
+    
+    // Interleave per-landmark columns into the cell-major layout
+    static LandmarkTable fromColumns(const Grid& grid, const std::vector<Vec2i>& landmarks,
+                                     const std::vector<std::vector<uint16_t>>& columns,
+                                     const std::vector<uint32_t>& steps);
+};
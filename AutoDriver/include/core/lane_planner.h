@@ -1,8 +1,10 @@
 #pragma once
 
 #include <vector>
+#include <unordered_map>
 #include "vec2.h"
 #include "grid.h"
+#include "spatial_index.h"
 
 /**
  * Lane representation for structured road planning.
@@ -14,6 +16,7 @@ struct Lane {
     float speed_limit;
     std::vector<int> left_lanes;   // IDs of lanes to the left
     std::vector<int> right_lanes;  // IDs of lanes to the right
+    std::vector<int> successors;   // IDs of lanes continuing from the end of this lane
     
     Lane(int lane_id, float w = 3.5f, float speed = 25.0f)
         : id(lane_id), width(w), speed_limit(speed) {}
@@ -44,8 +47,21 @@ struct LanePath {
     LanePath() : total_cost(0.0f) {}
 };
 
+/**
+ * Closest point on a lane centerline.
+ */
+struct LaneProjection {
+    int lane_id;
+    float s;         // Arc length along the lane
+    float distance;  // Distance from the query point to the centerline
+    
+    LaneProjection() : lane_id(-1), s(0.0f), distance(0.0f) {}
+};
+
 /**
  * Lane-based planner for highway/structured road scenarios.
+ * Lanes are cut into fixed-length segments; A* runs over the segment graph
+ * with edges along the lane, to left/right neighbours and to successor lanes.
  */
 class LanePlanner {
 public:
@@ -57,22 +73,72 @@ public:
     // Find lane-based path from start to goal
     LanePath findPath(Vec2 start, Vec2 goal);
     
-    // Generate waypoints for following a lane
+    // Generate waypoints for following a lane between two arc lengths
     std::vector<Vec2> generateLaneFollowingPath(int lane_id, float start_s, float end_s);
     
-    // Generate lane change trajectory
+    // Generate lane change trajectory (spans one planning segment)
     std::vector<Vec2> generateLaneChangeTrajectory(const LaneChangeManeuver& maneuver);
     
+    // Find which lane a point is closest to (R-tree lookup)
+    int findClosestLane(Vec2 pos) const;
+    
+    // Closest point on a given lane / on any lane
+    LaneProjection projectOntoLane(int lane_id, Vec2 pos) const;
+    LaneProjection projectOntoNetwork(Vec2 pos) const;
+    
+    // Get position along lane at arc length s (clamped to the lane)
+    Vec2 getLanePosition(int lane_id, float s) const;
+    
+    // Lane geometry
+    float getLaneLength(int lane_id) const;
+    const Lane* getLane(int lane_id) const;
+    
+    // Configuration
+    void setSegmentLength(float length) { segment_length_ = length; graph_dirty_ = true; }
+    void setLaneChangeCost(float cost) { lane_change_cost_ = cost; }
+    
 private:
     const Grid& grid_;
     std::vector<Lane> lanes_;
+    std::unordered_map<int, int> lane_index_;       // Lane ID -> index in lanes_
+    std::vector<std::vector<float>> arc_lengths_;   // Cumulative arc length per waypoint
     
-    // Find which lane a point is closest to
-    int findClosestLane(Vec2 pos) const;
+    // Spatial index over all centerline segments (built lazily)
+    struct SegmentRef {
+        int lane;      // Index in lanes_
+        int segment;   // Segment starts at centerline[segment]
+    };
+    mutable RTree segment_index_;
+    mutable std::vector<SegmentRef> segment_refs_;
+    mutable bool index_dirty_;
     
-    // Get position along lane at arc length s
-    Vec2 getLanePosition(int lane_id, float s) const;
+    // Lane segment graph: node = (lane, boundary k) at s = min(k * segment_length_, length)
+    struct LaneChangeEdges {
+        int to_lane;               // Index in lanes_
+        std::vector<int> target;   // Boundary reached on to_lane for each boundary k (-1 = none)
+    };
+    std::vector<int> node_offset_;                        // First node of each lane
+    std::vector<int> node_lane_;                          // Lane index of each node
+    std::vector<Vec2> node_pos_;                          // Position of each node
+    std::vector<std::vector<LaneChangeEdges>> lane_change_edges_;
+    float min_cost_per_meter_;
+    bool graph_dirty_;
+    
+    float segment_length_;     // Planning segment length along lanes
+    float lane_change_cost_;   // Fixed penalty per lane change
     
     // Calculate cost of being in a lane
     float getLaneCost(int lane_id, float s) const;
+    
+    int indexOf(int lane_id) const;
+    void buildIndex() const;
+    void buildGraph();
+    
+    int boundaryCount(int lane) const;
+    float boundaryS(int lane, int k) const;
+    Vec2 positionAt(int lane, float s) const;
+    LaneProjection projectIndex(int lane, Vec2 pos) const;
+    
+    std::vector<Vec2> followWaypoints(int lane, float start_s, float end_s) const;
+    std::vector<Vec2> laneChangeWaypoints(int from, float from_s, int to, float to_start_s, float to_end_s) const;
 };
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <string>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+#include "grid.h"
+
+/**
+ * Options for writing a binary map file.
+ */
+struct MapSaveOptions {
+    bool compress;   // Run-length encode tiles where that is smaller than raw bits
+    
+    MapSaveOptions() : compress(false) {}
+};
+
+/**
+ * Options for reading a binary map file.
+ */
+struct MapLoadOptions {
+    bool memory_map;   // Map the file and page raw tiles in lazily; otherwise read it all
+    
+    MapLoadOptions() : memory_map(true) {}
+};
+
+/**
+ * Options for importing an occupancy image.
+ */
+struct ImageImportOptions {
+    int occupied_threshold;   // Pixels darker than this (0-255) are obstacles
+    bool negate;              // Treat bright pixels as obstacles instead
+    
+    ImageImportOptions() : occupied_threshold(128), negate(false) {}
+};
+
+/**
+ * Layout summary of a map file.
+ */
+struct MapFileInfo {
+    int width, height;
+    int tiles_x, tiles_y;
+    size_t empty_tiles;
+    size_t full_tiles;
+    size_t raw_tiles;
+    size_t rle_tiles;
+    uint64_t file_bytes;
+    
+    MapFileInfo()
+        : width(0), height(0), tiles_x(0), tiles_y(0), empty_tiles(0), full_tiles(0),
+          raw_tiles(0), rle_tiles(0), file_bytes(0) {}
+};
+
+/**
+ * Result of loading or importing a map.
+ */
+struct MapLoadResult {
+    std::unique_ptr<Grid> grid;
+    bool success;
+    bool memory_mapped;   // Raw tiles alias the mapped file
+    std::string error;
+    MapFileInfo info;
+    
+    MapLoadResult() : success(false), memory_mapped(false) {}
+};
+
+/**
+ * Binary map files and occupancy image import.
+ *
+ * The map format stores the grid exactly as Grid keeps it in memory: a
+ * header, a tile index, then one record per 64x64 tile. Uniform tiles cost
+ * only their index entry, raw tiles are 512 bytes of bit rows aligned to 64
+ * bytes, and with compression enabled mixed tiles may be stored as
+ * alternating free/blocked run lengths. All fields are little-endian.
+ *
+ * load() maps the file and points the grid's raw tiles straight at it, so
+ * opening a map costs one pass over the index and pages are read only when a
+ * planner touches them. Edits clone the touched tile; the mapping stays
+ * alive as long as any grid or snapshot still references one of its tiles.
+ * Run-length tiles are decoded at load time.
+ */
+class MapIO {
+public:
+    static bool save(const Grid& grid, const std::string& path,
+                     const MapSaveOptions& options = MapSaveOptions(),
+                     MapFileInfo* info = nullptr);
+    
+    static MapLoadResult load(const std::string& path,
+                              const MapLoadOptions& options = MapLoadOptions());
+    
+    // PGM (P2/P5, 8 or 16 bit) always; PNG when built with libpng
+    static MapLoadResult importImage(const std::string& path,
+                                     const ImageImportOptions& options = ImageImportOptions());
+    
+    static bool pngSupported();
+
+private:
+    static MapLoadResult importPgm(const std::string& path, const ImageImportOptions& options);
+    static MapLoadResult importPng(const std::string& path, const ImageImportOptions& options);
+    
+    // Threshold one row of 8-bit gray pixels into the grid's tiles
+    static void storeImageRow(Grid& grid, int y, const unsigned char* pixels,
+                              const ImageImportOptions& options);
+    static void finishImport(MapLoadResult& result);
+};
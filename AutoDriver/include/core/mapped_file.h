@@ -0,0 +1,39 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Read-only view of a whole file, either memory-mapped or read into memory.
+ *
+ * A mapped view shares pages with the OS file cache, so several processes
+ * loading the same preprocessed data pay for it once. read() is the
+ * portable fallback; its buffer is 8-byte aligned.
+ */
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+    
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    
+    bool map(const std::string& path);
+    bool read(const std::string& path);
+    
+    const unsigned char* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool isMapped() const { return mapped_; }
+
+private:
+    const unsigned char* data_;
+    size_t size_;
+    bool mapped_;
+    std::vector<uint64_t> buffer_;
+#if defined(_WIN32)
+    void* file_;      // HANDLE
+    void* mapping_;   // HANDLE
+#endif
+};
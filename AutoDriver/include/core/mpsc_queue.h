@@ -0,0 +1,61 @@
+#pragma once
+
+#include <atomic>
+#include <utility>
+
+/**
+ * Unbounded lock-free multi-producer single-consumer queue (Vyukov).
+ *
+ * push() is wait-free and may be called from any thread; tryPop() must only
+ * be called from one consumer thread. A push that is still linking its node
+ * can briefly hide later items from the consumer; tryPop() then reports
+ * empty and the item shows up on a later call.
+ */
+template<typename T>
+class MpscQueue {
+public:
+    MpscQueue() : head_(new Node()), tail_(head_.load(std::memory_order_relaxed)) {}
+    
+    ~MpscQueue() {
+        T discarded;
+        while (tryPop(discarded)) {}
+        delete tail_;
+    }
+    
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+    
+    void push(T value) {
+        Node* node = new Node(std::move(value));
+        Node* prev = head_.exchange(node, std::memory_order_acq_rel);
+        prev->next.store(node, std::memory_order_release);
+    }
+    
+    // Consumer only
+    bool tryPop(T& out) {
+        Node* next = tail_->next.load(std::memory_order_acquire);
+        if (!next) return false;
+        
+        out = std::move(next->value);
+        delete tail_;
+        tail_ = next;
+        return true;
+    }
+    
+    // Consumer only; may miss items whose push is in progress
+    bool empty() const {
+        return tail_->next.load(std::memory_order_acquire) == nullptr;
+    }
+
+private:
+    struct Node {
+        std::atomic<Node*> next;
+        T value;
+        
+        Node() : next(nullptr), value() {}
+        explicit Node(T v) : next(nullptr), value(std::move(v)) {}
+    };
+    
+    std::atomic<Node*> head_;  // Most recently pushed (producers)
+    Node* tail_;               // Stub whose successor is the next item (consumer)
+};
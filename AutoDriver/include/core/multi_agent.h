@@ -4,6 +4,7 @@
 #include <memory>
 #include "vec2.h"
 #include "astar.h"
+#include "worker_pool.h"
 
 /**
  * Agent in multi-agent simulation.
@@ -24,6 +25,13 @@ struct Agent {
 
 /**
  * Multi-agent coordinator for collision-free path planning.
+ *
+ * Agents are stored as structure-of-arrays. update() is double-buffered:
+ * every agent computes its next velocity and position from a read-only
+ * snapshot of the current step, writing only its own slot of the next
+ * buffers, and the buffers are swapped once all agents are done. The result
+ * therefore does not depend on agent order or thread count, and the compute
+ * phase splits across a persistent worker pool without locks.
  */
 class MultiAgentPlanner {
 public:
@@ -31,6 +39,7 @@ public:
     
     // Add agent to simulation
     void addAgent(const Agent& agent);
+    void reserve(size_t count);
     
     // Plan paths for all agents with collision avoidance
     void planPaths();
@@ -38,23 +47,74 @@ public:
     // Update agent positions (one timestep)
     void update(float dt);
     
+    // Worker threads for update(); small crowds always run on the caller.
+    // The helpers are started on the first update that needs them and kept
+    // for later steps.
+    void setNumThreads(int n) { num_threads_ = n < 1 ? 1 : n; }
+    int getNumThreads() const { return num_threads_; }
+    
     // Check for potential collisions
     bool checkCollision(int agent1, int agent2, float time_horizon = 2.0f) const;
     
-    // Get all agents
-    const std::vector<Agent>& getAgents() const { return agents_; }
+    // Agents copied out of the SoA storage
+    std::vector<Agent> getAgents() const;
+    Agent getAgent(size_t index) const;
+    size_t size() const { return pos_x_.size(); }
+    
+    // True once an agent has no path or has used up its path
+    bool isFinished(size_t index) const {
+        return static_cast<size_t>(path_index_[index]) >= paths_[index].size();
+    }
     
     // Replan for specific agent (e.g., after collision detected)
     void replanAgent(int agent_id);
     
+    // Raw SoA access
+    const std::vector<float>& positionsX() const { return pos_x_; }
+    const std::vector<float>& positionsY() const { return pos_y_; }
+    const std::vector<float>& velocitiesX() const { return vel_x_; }
+    const std::vector<float>& velocitiesY() const { return vel_y_; }
+    const std::vector<float>& goalsX() const { return goal_x_; }
+    const std::vector<float>& goalsY() const { return goal_y_; }
+    const std::vector<float>& radii() const { return radius_; }
+    const std::vector<int>& pathIndices() const { return path_index_; }
+    const std::vector<Vec2>& getPath(size_t index) const { return paths_[index]; }
+    
 private:
     const Grid& grid_;
-    std::vector<Agent> agents_;
     std::unique_ptr<AStar> planner_;
+    int num_threads_;
+    std::unique_ptr<WorkerPool> pool_;   // num_threads_ participants, created lazily
+    
+    // Current step (read-only while update() computes the next one)
+    std::vector<int> ids_;
+    std::vector<float> pos_x_, pos_y_;
+    std::vector<float> vel_x_, vel_y_;
+    std::vector<float> goal_x_, goal_y_;
+    std::vector<float> radius_;
+    std::vector<int> path_index_;
+    std::vector<std::vector<Vec2>> paths_;
+    
+    // Next step, swapped in at the end of update()
+    std::vector<float> next_pos_x_, next_pos_y_;
+    std::vector<float> next_vel_x_, next_vel_y_;
+    std::vector<int> next_path_index_;
+    
+    // Snapshot positions bucketed by cell (avoidance radius sized), agents in
+    // index order within each bucket
+    float bucket_size_;
+    int bucket_cols_, bucket_rows_;
+    std::vector<int> bucket_start_;
+    std::vector<int> bucket_agents_;
+    
+    void buildBuckets();
+    int bucketCoord(float v, int count) const;
+    void computeNext(size_t index, float dt);
+    void planAgent(size_t index);
     
     // Check if path is collision-free with other agents
     bool isPathSafe(const std::vector<Vec2i>& path, int agent_id) const;
     
-    // Apply velocity obstacle avoidance
-    Vec2 calculateAvoidanceVelocity(int agent_id) const;
+    // Desired velocity plus repulsion from snapshot neighbours
+    Vec2 calculateAvoidanceVelocity(size_t index, Vec2 desired) const;
 };
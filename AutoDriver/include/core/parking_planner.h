@@ -1,8 +1,13 @@
 #pragma once
 
 #include <vector>
+#include <memory>
+#include <atomic>
+#include <cstdint>
 #include "vec2.h"
 #include "hybrid_astar.h"
+#include "reeds_shepp.h"
+#include "worker_pool.h"
 
 /**
  * Parking spot representation.
@@ -30,8 +35,27 @@ struct ParkingManeuver {
     ParkingManeuver() : total_cost(0.0f), success(false), num_reversals(0) {}
 };
 
+/**
+ * Result of scanning a lot for the best reachable spot.
+ */
+struct ParkingSearchResult {
+    ParkingManeuver maneuver;
+    int spot_index;        // Index into the candidate list (-1 if none reachable)
+    int spots_screened;    // Free spots with at least one analytic approach
+    int spots_planned;     // Spots that went through full maneuver planning
+    double planning_time_ms;
+    
+    ParkingSearchResult()
+        : spot_index(-1), spots_screened(0), spots_planned(0), planning_time_ms(0.0) {}
+};
+
 /**
  * Parking planner using Hybrid A* for parallel/perpendicular parking.
+ *
+ * A maneuver is a Hybrid A* approach to a pre-parking pose next to the spot
+ * followed by an analytic Reeds-Shepp segment into the spot. Footprint
+ * samples are precomputed per heading and pose collision results are
+ * memoised across spots, so scanning a lot in parallel stays cheap.
  */
 class ParkingPlanner {
 public:
@@ -43,14 +67,71 @@ public:
     // Plan perpendicular parking maneuver
     ParkingManeuver planPerpendicularParking(Vec2 start, float start_theta, const ParkingSpot& spot);
     
-    // Check if spot is accessible
+    // Evaluate all spots in parallel and return the cheapest reachable one
+    ParkingSearchResult findBestSpot(Vec2 start, float start_theta, const std::vector<ParkingSpot>& spots);
+    
+    // Check if spot is large enough and its final pose is collision-free
     bool isSpotAccessible(const ParkingSpot& spot) const;
     
+    // Vehicle footprint check at a pose (uses the cached footprint)
+    bool isPoseCollisionFree(Vec2 pos, float theta) const;
+    
+    // Configuration
+    void setNumThreads(int n) { num_threads_ = n; }
+    void setMaxApproachIterations(int n) { max_approach_iterations_ = n; }
+    
 private:
+    const Grid& grid_;
     HybridAStar hybrid_planner_;
     VehicleParams vehicle_params_;
+    int num_threads_;
+    int max_approach_iterations_;
+    std::unique_ptr<WorkerPool> pool_;   // num_threads_ participants, created lazily
+    
+    // Footprint sample offsets for each heading bin
+    static const int kHeadingBins = 72;
+    std::vector<std::vector<Vec2>> footprint_;
+    
+    // Direct-mapped memo of pose collision results: key << 2 | (1 + free)
+    static const size_t kCollisionCacheSize = 1 << 16;
+    std::unique_ptr<std::atomic<uint64_t>[]> collision_cache_;
+    
+    // Final approach from a pre-parking pose
+    struct Approach {
+        Vec2 pos;
+        float theta;
+        float estimate;   // Obstacle-free Reeds-Shepp approach plus final approach cost (ordering only)
+        float bound;      // Lower bound on any maneuver through this pose
+        float finish;     // Lower bound on its final approach alone
+    };
+    
+    // Per-spot screening outcome
+    struct SpotCandidate {
+        int spot;
+        std::vector<Approach> approaches;  // Sorted by estimate
+        ReedsSheppPath direct;             // Collision-free Reeds-Shepp straight from the start, if any
+        float direct_cost;                 // Its exact cost (infinity without one)
+        float estimate;                    // Best approach estimate (ordering only)
+        float bound;                       // Lower bound on any maneuver into the spot
+    };
+    
+    void buildFootprint();
+    void clearCollisionCache();
+    int headingBin(float theta) const;
+    bool isSegmentCollisionFree(const std::vector<HybridState>& states) const;
+    
+    // Reeds-Shepp from a pose into the spot; fails on collision
+    bool finalApproach(Vec2 from, float from_theta, const ParkingSpot& spot,
+                       ReedsSheppPath& path, std::vector<HybridState>& states) const;
+    
+    SpotCandidate screenSpot(Vec2 start, float start_theta, const ParkingSpot& spot, int index) const;
+    ParkingManeuver directManeuver(Vec2 start, float start_theta, const SpotCandidate& candidate) const;
+    
+    // Best maneuver into the spot; approaches that cannot beat cutoff are not searched
+    ParkingManeuver planSpot(Vec2 start, float start_theta, const ParkingSpot& spot,
+                             const SpotCandidate& candidate, float cutoff);
+    ParkingManeuver planParking(Vec2 start, float start_theta, const ParkingSpot& spot);
     
-    // Generate intermediate waypoints for parking
-    std::vector<HybridState> generateParkingWaypoints(Vec2 start, float start_theta,
-                                                      const ParkingSpot& spot, bool parallel);
+    // Candidate pre-parking poses in the aisle next to the spot
+    std::vector<HybridState> generatePreParkingPoses(const ParkingSpot& spot) const;
 };
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+#include "grid.h"
+#include "astar.h"
+#include "vec2.h"
+
+/**
+ * Cache lookup key. config tells apart planner setups that can answer the
+ * same query differently (cost map, search mode, ...); it is opaque to the
+ * cache.
+ */
+struct PathCacheKey {
+    Vec2i start;
+    Vec2i goal;
+    uint64_t config;
+    
+    PathCacheKey(Vec2i s = Vec2i(), Vec2i g = Vec2i(), uint64_t c = 0) : start(s), goal(g), config(c) {}
+    
+    bool operator==(const PathCacheKey& other) const {
+        return start == other.start && goal == other.goal && config == other.config;
+    }
+};
+
+/**
+ * Path cache counters (monotonic since construction or clear()).
+ */
+struct PathCacheStats {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t invalidations;   // Entries dropped because their tiles changed
+    uint64_t evictions;       // Entries dropped to stay within capacity
+    
+    PathCacheStats() : hits(0), misses(0), invalidations(0), evictions(0) {}
+};
+
+/**
+ * LRU cache of planned paths, for fleets that keep asking for the same routes
+ * between the same stations.
+ *
+ * Each entry remembers the grid version it was planned on and the tiles
+ * covering the path's bounding box (grown by one cell). A lookup checks the
+ * grid's per-tile change journal: the entry stays valid until one of those
+ * tiles changes, so edits elsewhere on the map do not flush it. A path that
+ * is still valid is always collision-free, but an edit outside its box that
+ * opens a shorter route will not be noticed. Failed searches depend on the
+ * whole map and are kept only until any tile changes.
+ *
+ * Versions are only comparable within one map's history, so use one cache per
+ * map; lookups may pass any snapshot of that map. A lookup on a snapshot older
+ * than the entry is a miss.
+ *
+ * All methods are thread-safe; findPath plans outside the lock, so workers
+ * with their own planners can share one cache.
+ */
+class PathCache {
+public:
+    explicit PathCache(size_t capacity = 1024);
+    
+    PathCache(const PathCache&) = delete;
+    PathCache& operator=(const PathCache&) = delete;
+    
+    // Copies a still-valid cached result into out; stale entries are dropped
+    bool lookup(const Grid& grid, const PathCacheKey& key, AStarResult& out);
+    
+    // result must have been planned on grid (search captures are not stored)
+    void insert(const Grid& grid, const PathCacheKey& key, const AStarResult& result);
+    
+    // Cached planner.findPath on planner.getGrid(); the planner's cost map
+    // and its version are folded into config, so rebuilt costs miss. A hit
+    // reports no nodes expanded.
+    AStarResult findPath(AStar& planner, Vec2i start, Vec2i goal, uint64_t config = 0);
+    
+    void setCapacity(size_t capacity);   // 0 disables caching
+    size_t getCapacity() const;
+    size_t size() const;
+    void clear();
+    PathCacheStats getStats() const;
+
+private:
+    struct KeyHash {
+        size_t operator()(const PathCacheKey& key) const;
+    };
+    
+    struct Entry {
+        PathCacheKey key;
+        AStarResult result;
+        uint64_t version;
+        int min_tx, min_ty, max_tx, max_ty;   // Tiles the result depends on
+    };
+    
+    using EntryList = std::list<Entry>;   // Most recently used first
+    
+    mutable std::mutex mutex_;
+    size_t capacity_;
+    EntryList entries_;
+    std::unordered_map<PathCacheKey, EntryList::iterator, KeyHash> index_;
+    PathCacheStats stats_;
+    
+    void evictOverflow();
+};
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+#include "grid.h"
+#include "astar.h"
+#include "vec2.h"
+
+/**
+ * Settings for PathDatabase::build.
+ */
+struct PathDatabaseOptions {
+    int num_threads;   // Sources searched in parallel (0 = hardware threads)
+    
+    PathDatabaseOptions() : num_threads(0) {}
+};
+
+/**
+ * Compressed path database: for every pair of free cells, the first move of
+ * a shortest 4-connected path, so a query just follows first moves from the
+ * start and never searches.
+ *
+ * Free cells are numbered in Z-order, and each source's first moves to all
+ * targets are run-length encoded in that order; nearby targets nearly always
+ * share a first move, so rows compress to a few runs. Targets in another
+ * connected component never need a move and are folded into neighbouring
+ * runs. A lookup is a binary search over one row.
+ *
+ * The build runs one breadth-first pass per free cell (quadratic in the free
+ * cells), so it suits static maps of up to some tens of thousands of free
+ * cells and belongs offline: save the result and load() it, memory-mapped,
+ * at startup. Rebuild whenever the map changes; a database only answers for
+ * the grid it was built from. It keeps a hash of that grid's cells (saved
+ * with it), and matches() rejects any other map, even one of the same size.
+ */
+class PathDatabase {
+public:
+    PathDatabase();
+    
+    static PathDatabase build(const Grid& grid, const PathDatabaseOptions& options = PathDatabaseOptions());
+    
+    bool save(const std::string& path) const;
+    static bool load(const std::string& path, PathDatabase& out, bool memory_map = true);
+    
+    // Shortest 4-connected path; nodes_expanded counts table lookups
+    AStarResult findPath(Vec2i start, Vec2i goal) const;
+    
+    // Path length in steps without building the path; -1 if there is none
+    int distance(Vec2i start, Vec2i goal) const;
+    
+    // Direction index of the first move (0 up, 1 down, 2 left, 3 right), -1 if
+    // start == goal or there is no path
+    int firstMove(Vec2i start, Vec2i goal) const;
+    
+    bool empty() const { return node_count_ == 0; }
+    bool matches(const Grid& grid) const {
+        return !empty() && grid.getWidth() == width_ && grid.getHeight() == height_ &&
+               grid.contentHash() == grid_hash_;
+    }
+    
+    int getWidth() const { return width_; }
+    int getHeight() const { return height_; }
+    size_t getNodeCount() const { return node_count_; }
+    size_t getRunCount() const { return run_count_; }
+    size_t getBytes() const;
+    bool isMapped() const { return mapped_; }
+
+private:
+    int width_;
+    int height_;
+    size_t node_count_;
+    size_t run_count_;
+    const uint32_t* node_cells_;    // Cell index (y * width + x) of each node, in Z-order
+    const uint32_t* components_;    // Connected component of each node
+    const uint64_t* row_offsets_;   // First run of each source row; node_count + 1 entries
+    const uint32_t* runs_;          // (first target << 2) | move, ascending within a row
+    std::vector<int32_t> node_of_cell_;     // -1 for blocked cells
+    std::shared_ptr<const void> storage_;   // Owns the arrays (built vectors or mapped file)
+    uint64_t grid_hash_;                    // Grid::contentHash of the map it was built from
+    bool mapped_;
+    
+    int nodeAt(Vec2i p) const;
+    int lookup(int source, int target) const;
+    void indexCells();
+};
@@ -1,8 +1,100 @@
 #pragma once
 
 #include <vector>
+#include <atomic>
+#include <memory>
+#include <cstdint>
 #include "vec2.h"
 #include "grid.h"
+#include "hybrid_astar.h"
+
+/**
+ * Memoised line-of-sight between the waypoints of one path.
+ * Results are keyed by waypoint index pair in a fixed-size lock-free table, so
+ * any number of threads can query the same cache. Pairs that do not fit in the
+ * table are computed without being stored.
+ */
+class VisibilityCache {
+public:
+    VisibilityCache(const std::vector<Vec2>& path, const Grid& grid);
+    
+    // True if the straight segment between waypoints i and j is collision-free
+    bool isVisible(size_t i, size_t j);
+    
+    const std::vector<Vec2>& getPath() const { return path_; }
+    size_t size() const { return path_.size(); }
+    
+    // Statistics
+    size_t getHits() const { return hits_.load(std::memory_order_relaxed); }
+    size_t getMisses() const { return misses_.load(std::memory_order_relaxed); }
+
+private:
+    const std::vector<Vec2>& path_;
+    const Grid& grid_;
+    
+    // Entry = (pair key << 2) | (1 + visible), 0 = empty
+    std::unique_ptr<std::atomic<uint64_t>[]> table_;
+    size_t mask_;
+    
+    std::atomic<size_t> hits_;
+    std::atomic<size_t> misses_;
+};
+
+/**
+ * Parameters for gradient descent smoothing.
+ */
+struct GradientSmoothOptions {
+    int max_iterations;
+    float alpha;              // Smoothness step (pull toward neighbour midpoint)
+    float obstacle_weight;    // Repulsion step per cell of missing clearance
+    float obstacle_distance;  // Clearance (cells) below which repulsion applies
+    float tolerance;          // Stop once no waypoint moves farther than this
+    
+    GradientSmoothOptions()
+        : max_iterations(50), alpha(0.1f), obstacle_weight(0.1f),
+          obstacle_distance(2.0f), tolerance(1e-3f) {}
+};
+
+/**
+ * Convergence and collision-check statistics of one gradient smoothing run.
+ */
+struct GradientSmoothStats {
+    int iterations;
+    bool converged;           // Stopped on tolerance rather than max_iterations
+    float max_displacement;   // Largest move in the last iteration
+    int segment_checks;
+    int exact_checks;         // Segments not covered by the clearance map
+    
+    GradientSmoothStats()
+        : iterations(0), converged(false), max_displacement(0.0f),
+          segment_checks(0), exact_checks(0) {}
+};
+
+/**
+ * Parameters for spline fitting.
+ */
+struct SplineOptions {
+    float spacing;          // Arc-length distance between output samples
+    float max_curvature;    // Curvature bound (1 / min turn radius), 0 = unbounded
+    int max_refinements;    // Control-point relaxation passes in bounded mode
+    
+    SplineOptions() : spacing(0.5f), max_curvature(0.0f), max_refinements(50) {}
+};
+
+/**
+ * Spline resampled at uniform arc length, with the curvature at each sample.
+ */
+struct SplineResult {
+    std::vector<Vec2> points;
+    std::vector<float> curvature;  // Signed, left turns positive
+    float length;
+    float max_curvature;           // Largest |curvature| over the samples
+    bool curvature_feasible;       // max_curvature within the bound (always true if unbounded)
+    int refinements;
+    
+    SplineResult()
+        : length(0.0f), max_curvature(0.0f), curvature_feasible(true), refinements(0) {}
+};
 
 /**
  * Path smoothing utilities for post-processing planned paths.
@@ -18,12 +110,32 @@ public:
     
     /**
      * Shortcut smoothing: Remove unnecessary waypoints using line-of-sight.
-     * Tries to connect non-adjacent waypoints directly if collision-free.
+     * Runs the greedy pass followed by up to max_iterations randomized rounds,
+     * both sharing one visibility cache.
      */
     static std::vector<Vec2> shortcutSmooth(const std::vector<Vec2>& path,
                                            const Grid& grid,
                                            int max_iterations = 100);
     
+    /**
+     * Greedy single-pass shortcutting. From each kept waypoint, jumps to the
+     * farthest visible waypoint found by galloping then binary search.
+     * Returns the indices of the kept waypoints (always includes both ends).
+     */
+    static std::vector<size_t> greedyShortcut(VisibilityCache& cache);
+    
+    /**
+     * Randomized shortcutting over the kept waypoints. Each round samples a
+     * batch of random pairs, checks them in parallel and applies the
+     * non-overlapping visible ones in one compaction pass. Results depend only
+     * on the seed, not on the thread count (num_threads <= 0 = all cores).
+     */
+    static std::vector<size_t> randomShortcut(VisibilityCache& cache,
+                                              const std::vector<size_t>& kept,
+                                              int rounds = 32,
+                                              int num_threads = 0,
+                                              uint64_t seed = 0);
+    
     /**
      * Gradient descent smoothing: Minimize path curvature while staying collision-free.
      * Iteratively adjusts waypoints to reduce sharp turns.
@@ -33,6 +145,46 @@ public:
                                            int iterations = 50,
                                            float alpha = 0.1f);
     
+    /**
+     * Gradient descent smoothing on SoA double buffers. Each iteration
+     * relaxes every waypoint toward its neighbours' midpoint and away from
+     * nearby obstacles, then validates all moves in one batch against a
+     * clearance map, falling back to exact segment checks only where the
+     * map cannot prove a segment clear. A move is rejected if it introduces
+     * a collision. Stops early once the largest accepted move drops below
+     * options.tolerance.
+     */
+    static std::vector<Vec2> gradientSmooth(const std::vector<Vec2>& path,
+                                           const Grid& grid,
+                                           const GradientSmoothOptions& options,
+                                           GradientSmoothStats* stats = nullptr);
+    
+    /**
+     * Interpolating cubic spline through the waypoints, parameterised by chord
+     * length with clamped end tangents (tridiagonal system solved in O(n)),
+     * resampled at uniform arc length through a precomputed arc-length table.
+     * The number of output points depends on path length, not on how many
+     * waypoints went in.
+     *
+     * With a curvature bound, long edges are subdivided and the control points
+     * around violations are relaxed toward their neighbours and refitted until
+     * the bound holds or max_refinements is reached. If a grid is given,
+     * relaxations that would make a control-polygon edge collide are rejected.
+     */
+    static SplineResult fitSpline(const std::vector<Vec2>& path,
+                                  const SplineOptions& options = SplineOptions(),
+                                  const Grid* grid = nullptr);
+    
+    // Curvature-bounded fit for a vehicle (bound = 1 / min_turn_radius)
+    static SplineResult fitSpline(const std::vector<Vec2>& path,
+                                  const VehicleParams& vehicle,
+                                  float spacing = 0.5f,
+                                  const Grid* grid = nullptr);
+    
+    // Unbounded spline resampled every `spacing` units of arc length
+    static std::vector<Vec2> splineSmooth(const std::vector<Vec2>& path,
+                                          float spacing = 0.5f);
+    
     /**
      * Combined smoothing: Apply multiple techniques in sequence.
      */
@@ -40,6 +192,8 @@ public:
                                        const Grid& grid);
 
 private:
+    friend class VisibilityCache;
+    
     // Helper: Check if line segment is collision-free
     static bool isLineCollisionFree(Vec2 from, Vec2 to, const Grid& grid);
     
@@ -0,0 +1,239 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <future>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <chrono>
+#include <cstdint>
+#include "grid.h"
+#include "path_cache.h"
+#include "vec2.h"
+#include "mpsc_queue.h"
+
+/**
+ * Single cell change in a map delta.
+ */
+struct CellEdit {
+    int x, y;
+    bool blocked;
+    
+    CellEdit(int x_ = 0, int y_ = 0, bool blocked_ = true) : x(x_), y(y_), blocked(blocked_) {}
+};
+
+/**
+ * Immutable published map version. Holding one keeps the grid alive.
+ */
+struct MapSnapshot {
+    std::shared_ptr<const Grid> grid;
+    uint64_t version;
+    
+    MapSnapshot() : version(0) {}
+    MapSnapshot(std::shared_ptr<const Grid> g, uint64_t v) : grid(std::move(g)), version(v) {}
+};
+
+enum class ServicePlanner {
+    ASTAR,
+    RRT_STAR
+};
+
+/**
+ * Planning query submitted to the service.
+ */
+struct PlanningRequest {
+    Vec2i start;
+    Vec2i goal;
+    ServicePlanner planner;
+    int max_iterations;  // RRT* only
+    
+    PlanningRequest(Vec2i s = Vec2i(), Vec2i g = Vec2i(), ServicePlanner p = ServicePlanner::ASTAR)
+        : start(s), goal(g), planner(p), max_iterations(3000) {}
+};
+
+/**
+ * Result of a planning query, tagged with the map version it was planned on.
+ */
+struct PlanningResponse {
+    std::vector<Vec2> path;
+    float path_cost;
+    bool success;
+    uint64_t request_id;
+    uint64_t map_version;
+    double queue_ms;      // Submission to start of planning
+    double planning_ms;
+    
+    PlanningResponse()
+        : path_cost(0.0f), success(false), request_id(0), map_version(0),
+          queue_ms(0.0), planning_ms(0.0) {}
+};
+
+/**
+ * Service counters (monotonic since construction).
+ */
+struct ServiceStats {
+    uint64_t queries_submitted;
+    uint64_t queries_completed;
+    uint64_t deltas_received;
+    uint64_t cells_edited;
+    uint64_t snapshots_published;
+    uint64_t tiles_copied;       // Copy-on-write tile clones caused by edits
+    PathCacheStats path_cache;   // A* queries answered from the path cache
+    
+    ServiceStats()
+        : queries_submitted(0), queries_completed(0), deltas_received(0),
+          cells_edited(0), snapshots_published(0), tiles_copied(0) {}
+};
+
+/**
+ * Load generator settings: closed-loop query clients plus map writers.
+ */
+struct LoadTestConfig {
+    int query_threads;
+    int queries_per_thread;
+    int update_threads;
+    int updates_per_second;   // Per update thread
+    int edits_per_update;
+    ServicePlanner planner;
+    uint64_t seed;
+    
+    LoadTestConfig()
+        : query_threads(4), queries_per_thread(50), update_threads(1),
+          updates_per_second(200), edits_per_update(16),
+          planner(ServicePlanner::ASTAR), seed(0) {}
+};
+
+/**
+ * Latency distribution measured by the load generator (submit to response).
+ */
+struct LoadTestReport {
+    size_t queries;
+    size_t successful;
+    size_t updates;
+    uint64_t versions_observed;   // Distinct map versions seen by queries
+    double p50_ms;
+    double p99_ms;
+    double max_ms;
+    double mean_ms;
+    double duration_ms;
+    double queries_per_second;
+    
+    LoadTestReport()
+        : queries(0), successful(0), updates(0), versions_observed(0), p50_ms(0.0),
+          p99_ms(0.0), max_ms(0.0), mean_ms(0.0), duration_ms(0.0), queries_per_second(0.0) {}
+};
+
+/**
+ * Long-running planning service that owns the map.
+ *
+ * Map deltas and planning requests from any thread go into one lock-free
+ * MPSC queue. A dispatcher thread drains it in order: consecutive deltas are
+ * applied as one batch and published as a new immutable snapshot, and
+ * requests are handed to a worker pool. Workers plan on whatever snapshot is
+ * current when they start, so a request always sees every delta its producer
+ * submitted before it.
+ *
+ * Snapshots are RCU-style: readers grab the current shared_ptr and never
+ * block the writer. Each published grid is a copy-on-write snapshot of the
+ * writer's grid, so publishing costs one tile table and an edit batch only
+ * clones the tiles it touches; unchanged tiles are shared by every version
+ * still in use.
+ *
+ * A* answers go through a shared PathCache, so repeated routes between the
+ * same stations skip the search until an edit touches their tiles.
+ */
+class PlanningService {
+public:
+    explicit PlanningService(const Grid& initial_map, int num_workers = 0);
+    ~PlanningService();
+    
+    PlanningService(const PlanningService&) = delete;
+    PlanningService& operator=(const PlanningService&) = delete;
+    
+    // Thread-safe, non-blocking
+    void updateMap(std::vector<CellEdit> edits);
+    std::future<PlanningResponse> submit(const PlanningRequest& request);
+    
+    // Current published map (never blocks on the writer)
+    MapSnapshot snapshot() const;
+    uint64_t getMapVersion() const { return snapshot().version; }
+    
+    // Block until everything submitted so far has been processed
+    void drain();
+    
+    // Stop accepting work, finish queued requests and join all threads
+    void stop();
+    
+    ServiceStats getStats() const;
+    
+    // Thread-safe; 0 disables the path cache
+    void setPathCacheCapacity(size_t capacity) { path_cache_.setCapacity(capacity); }
+    
+    int getNumWorkers() const { return static_cast<int>(workers_.size()); }
+    
+    /**
+     * Built-in load generator: query_threads clients each submit
+     * queries_per_thread random start/goal requests and wait for every answer,
+     * while update_threads writers toggle random cells at a fixed rate.
+     */
+    LoadTestReport runLoadTest(const LoadTestConfig& config);
+
+private:
+    struct Command {
+        enum Kind { MAP_DELTA, QUERY, FENCE } kind;
+        std::vector<CellEdit> edits;
+        PlanningRequest request;
+        uint64_t request_id;
+        std::chrono::steady_clock::time_point submitted;
+        std::shared_ptr<std::promise<PlanningResponse>> promise;
+        std::shared_ptr<std::promise<void>> fence;
+    };
+    
+    // Ingress
+    MpscQueue<Command*> inbox_;
+    std::atomic<bool> dispatcher_sleeping_;
+    std::mutex wake_mutex_;
+    std::condition_variable wake_cv_;
+    
+    // Published map
+    std::shared_ptr<const MapSnapshot> published_;
+    
+    // Writer-side state (dispatcher thread only)
+    Grid front_;                            // Latest map, shares tiles with published_
+    std::vector<CellEdit> pending_;         // Deltas not yet published
+    uint64_t version_;
+    
+    // Worker pool
+    std::vector<std::thread> workers_;
+    std::deque<Command*> jobs_;
+    std::mutex jobs_mutex_;
+    std::condition_variable jobs_cv_;
+    std::atomic<int> jobs_in_flight_;
+    PathCache path_cache_;                  // Shared by all workers
+    bool workers_stop_;                     // Guarded by jobs_mutex_
+    
+    std::thread dispatcher_;
+    std::atomic<bool> running_;
+    std::atomic<int> producers_;            // Producers between the running_ check and their push
+    std::atomic<uint64_t> next_request_id_;
+    
+    // Counters
+    std::atomic<uint64_t> queries_submitted_;
+    std::atomic<uint64_t> queries_completed_;
+    std::atomic<uint64_t> deltas_received_;
+    std::atomic<uint64_t> cells_edited_;
+    std::atomic<uint64_t> snapshots_published_;
+    std::atomic<uint64_t> tiles_copied_;
+    
+    bool beginProduce();   // Counts the caller in; false once stopped
+    void enqueue(Command* command);
+    void dispatcherLoop();
+    void handle(Command* command);
+    void workerLoop();
+    void publishPending();
+    void publish();
+    void runQuery(Command* command);
+};
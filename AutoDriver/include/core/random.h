@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Counter-based random number generator.
+ * The n-th output of a stream is a pure function of (seed, stream, n) using the
+ * SplitMix64 mixing function, so a single seed can be split into independent
+ * per-thread streams and buffers can be bulk-filled without a serial dependency
+ * between outputs. Results are identical on every platform.
+ */
+class RandomStream {
+public:
+    using result_type = uint64_t;
+    
+    explicit RandomStream(uint64_t seed = 0, uint64_t stream = 0);
+    
+    // UniformRandomBitGenerator interface (usable with <random> distributions)
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return UINT64_MAX; }
+    result_type operator()() { return at(counter_++); }
+    
+    // Output at an absolute counter position (does not advance the stream)
+    uint64_t at(uint64_t counter) const {
+        return mix(key_ + (counter + 1) * kGamma);
+    }
+    
+    // Uniform float in [0, 1) and [lo, hi)
+    float uniform() { return toUnit(at(counter_++)); }
+    float uniform(float lo, float hi) { return lo + (hi - lo) * uniform(); }
+    
+    // Independent stream derived from the same seed
+    RandomStream split(uint64_t stream) const { return RandomStream(seed_, stream); }
+    
+    // Bulk fill out[i] = uniform(lo, hi) for the next n counter positions
+    void fillUniform(float* out, size_t n, float lo = 0.0f, float hi = 1.0f);
+    
+    // Getters
+    uint64_t getSeed() const { return seed_; }
+    uint64_t getStream() const { return stream_; }
+    uint64_t getCounter() const { return counter_; }
+    
+    void setCounter(uint64_t counter) { counter_ = counter; }
+    
+    // SplitMix64 finaliser
+    static uint64_t mix(uint64_t z) {
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+    
+    // Top 24 bits as a float in [0, 1)
+    static float toUnit(uint64_t bits) {
+        return static_cast<float>(bits >> 40) * (1.0f / 16777216.0f);
+    }
+    
+private:
+    static constexpr uint64_t kGamma = 0x9E3779B97F4A7C15ULL;
+    
+    uint64_t seed_;
+    uint64_t stream_;
+    uint64_t key_;      // Per-stream key derived from (seed, stream)
+    uint64_t counter_;
+};
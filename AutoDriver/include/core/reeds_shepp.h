@@ -0,0 +1,50 @@
+#pragma once
+
+#include <vector>
+#include "vec2.h"
+#include "hybrid_astar.h"
+
+/**
+ * One arc or straight piece of a Reeds-Shepp path.
+ */
+struct ReedsSheppSegment {
+    char type;     // 'L' (left arc), 'S' (straight), 'R' (right arc)
+    float length;  // Signed arc length in world units (negative = reverse)
+    
+    ReedsSheppSegment(char t, float len) : type(t), length(len) {}
+};
+
+/**
+ * Reeds-Shepp path between two poses for a car that can drive both ways.
+ */
+struct ReedsSheppPath {
+    std::vector<ReedsSheppSegment> segments;
+    float length;  // Total unsigned length
+    bool valid;
+    
+    ReedsSheppPath() : length(0.0f), valid(false) {}
+    
+    // Number of direction changes along the path
+    int numCusps() const;
+};
+
+/**
+ * Analytic Reeds-Shepp curves.
+ * Covers the CSC and CCC families (with their time-flip, reflection and
+ * backward variants), which is enough for final parking approaches.
+ */
+class ReedsShepp {
+public:
+    // Shortest path found among the supported families
+    static ReedsSheppPath shortestPath(Vec2 start, float start_theta,
+                                       Vec2 goal, float goal_theta,
+                                       float turn_radius);
+    
+    // Pose reached after travelling distance along the path (clamped)
+    static HybridState interpolate(const ReedsSheppPath& path, Vec2 start, float start_theta,
+                                   float turn_radius, float distance);
+    
+    // Poses every step along the path, including both end poses
+    static std::vector<HybridState> sample(const ReedsSheppPath& path, Vec2 start, float start_theta,
+                                           float turn_radius, float step);
+};
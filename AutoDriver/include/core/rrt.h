@@ -2,9 +2,11 @@
 
 #include <vector>
 #include <memory>
-#include <random>
+#include <limits>
 #include "grid.h"
 #include "vec2.h"
+#include "random.h"
+#include "search_capture.h"
 
 /**
  * Node for RRT tree structure.
@@ -24,7 +26,7 @@ struct RRTNode {
  */
 struct RRTResult {
     std::vector<Vec2> path;
-    std::vector<Vec2> tree_nodes;  // All nodes in tree (for visualization)
+    std::vector<Vec2> tree_nodes;  // All nodes in tree (only with SearchCapture::results)
     int iterations;
     float path_cost;
     bool success;
@@ -49,16 +51,22 @@ public:
     void setGoalBias(float bias) { goal_bias_ = bias; }
     void setGoalThreshold(float threshold) { goal_threshold_ = threshold; }
     
+    // Seed the sampler; planners are seeded from std::random_device by default
+    void setSeed(uint64_t seed) { rng_ = RandomStream(seed); }
+    uint64_t getSeed() const { return rng_.getSeed(); }
+    
+    // Visualization capture; nothing is recorded by default
+    void setCapture(const SearchCapture& capture) { capture_ = capture; }
+    const SearchCapture& getCapture() const { return capture_; }
+    
 protected:
     const Grid& grid_;
     float step_size_;           // Maximum step distance
     float goal_bias_;           // Probability of sampling goal
     float goal_threshold_;      // Distance to consider goal reached
     
-    std::mt19937 rng_;
-    std::uniform_real_distribution<float> dist_x_;
-    std::uniform_real_distribution<float> dist_y_;
-    std::uniform_real_distribution<float> dist_prob_;
+    RandomStream rng_;
+    SearchCapture capture_;
     
     std::vector<std::unique_ptr<RRTNode>> nodes_;
     
@@ -70,6 +78,9 @@ protected:
     virtual RRTNode* addNode(Vec2 pos, RRTNode* parent);
     virtual std::vector<Vec2> reconstructPath(RRTNode* goal);
     
+    // Copies the tree into result.tree_nodes when results are captured
+    void collectTree(RRTResult& result) const;
+    
     // Helper functions
     float distance(Vec2 a, Vec2 b) const;
     bool isInBounds(Vec2 pos) const;
@@ -84,13 +95,69 @@ public:
     
     RRTResult findPath(Vec2 start, Vec2 goal, int max_iterations = 5000);
     
+    /**
+     * Anytime mode: keeps refining until the time budget (or iteration cap) runs out.
+     * Once a solution exists, samples are drawn from the informed ellipse and
+     * subtrees that cannot beat the incumbent are pruned. Sampling and collision
+     * checking run on num_threads_ workers, each drawing from its own stream
+     * split from the planner seed.
+     */
+    RRTResult findPathAnytime(Vec2 start, Vec2 goal, double time_budget_ms,
+                              int max_iterations = std::numeric_limits<int>::max());
+    
+    /**
+     * Reproducible anytime run of exactly `iterations` samples, with no time
+     * budget. Workers only see the tree as of the start of each round plus
+     * their own new nodes, and nodes are inserted in sample order, so a fixed
+     * seed, thread count and iteration count always give the same result.
+     */
+    RRTResult findPathDeterministic(Vec2 start, Vec2 goal, int iterations);
+    
     void setRewireRadius(float radius) { rewire_radius_ = radius; }
+    void setNumThreads(int n) { num_threads_ = n < 1 ? 1 : n; }
+    void setBatchSize(int samples_per_thread) { batch_size_ = samples_per_thread < 1 ? 1 : samples_per_thread; }
     
 private:
     float rewire_radius_;  // Radius for finding nearby nodes to rewire
+    int num_threads_;      // Worker threads for anytime mode
+    int batch_size_;       // Samples per worker per round in anytime mode
+    
+    // Shared by both anytime modes; deterministic runs use frozen-tree rounds
+    // with ordered insertion and ignore the time budget
+    RRTResult runAnytime(Vec2 start, Vec2 goal, double time_budget_ms, int max_iterations, bool deterministic);
     
     // RRT* specific operations
     std::vector<RRTNode*> findNearby(Vec2 pos, float radius);
     RRTNode* chooseBestParent(Vec2 pos, const std::vector<RRTNode*>& nearby);
     void rewire(RRTNode* new_node, const std::vector<RRTNode*>& nearby);
+    void reparent(RRTNode* node, RRTNode* new_parent, float new_cost);
+    
+    // Anytime helpers
+    Vec2 sampleInformed(Vec2 start, Vec2 goal, float best_cost, float u, float v,
+                        RandomStream& rng) const;
+    void pruneTree(Vec2 goal, float best_cost, RRTNode* best_goal_node);
+};
+
+/**
+ * RRT-Connect - bidirectional RRT. Grows one tree from the start and one from
+ * the goal, alternating which tree extends toward a random sample while the
+ * other greedily tries to connect to the new node. Converges much faster than
+ * goal-biased RRT through narrow passages.
+ */
+class RRTConnect : public RRT {
+public:
+    explicit RRTConnect(const Grid& grid);
+    
+    RRTResult findPath(Vec2 start, Vec2 goal, int max_iterations = 5000);
+    
+private:
+    // The inactive tree; swapped with nodes_ so the base RRT operations act on
+    // whichever tree is currently being grown
+    std::vector<std::unique_ptr<RRTNode>> other_tree_;
+    
+    // Single step of the active tree toward target (nullptr if blocked)
+    RRTNode* extend(Vec2 target);
+    
+    // Repeatedly extend the active tree toward target until reached or blocked
+    RRTNode* connect(Vec2 target);
 };
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "vec2.h"
+
+enum class SearchEventType : uint8_t {
+    VISITED,     // Cell closed / expanded
+    EXPLORED,    // Entry added to the open set
+    TREE_NODE    // Node added to a sampling tree
+};
+
+struct SearchEvent {
+    Vec2 pos;   // Cell coordinates for grid searches
+    SearchEventType type;
+};
+
+/**
+ * Receives search events as a planner produces them.
+ * Called on the planning thread; implementations need no locking unless
+ * they share a sink between planners on different threads.
+ */
+class SearchSink {
+public:
+    virtual ~SearchSink() = default;
+    virtual void record(const SearchEvent& event) = 0;
+};
+
+/**
+ * Keeps the most recent capacity events in a fixed buffer, so animating a
+ * search never allocates once the sink exists and memory stays bounded on
+ * any map size. Older events are overwritten.
+ */
+class RingBufferSink : public SearchSink {
+public:
+    explicit RingBufferSink(size_t capacity = 1 << 16);
+    
+    void record(const SearchEvent& event) override {
+        if (buffer_.empty()) return;
+        buffer_[head_] = event;
+        head_ = head_ + 1 == buffer_.size() ? 0 : head_ + 1;
+        total_++;
+    }
+    
+    void clear();
+    
+    size_t size() const { return total_ < buffer_.size() ? static_cast<size_t>(total_) : buffer_.size(); }
+    size_t capacity() const { return buffer_.size(); }
+    uint64_t getTotalRecorded() const { return total_; }
+    uint64_t getDropped() const { return total_ - size(); }
+    
+    // i-th retained event, oldest first
+    const SearchEvent& at(size_t i) const;
+    std::vector<SearchEvent> events() const;
+
+private:
+    std::vector<SearchEvent> buffer_;
+    size_t head_;       // Next slot to write
+    uint64_t total_;
+};
+
+/**
+ * What a planner records for visualization. The default records nothing,
+ * which keeps queries free of per-node allocations; the GUI turns on
+ * result vectors and/or streams events into a sink.
+ */
+struct SearchCapture {
+    bool results;       // Fill visited/explored/tree_nodes in the result
+    SearchSink* sink;   // Stream events as they happen (not owned)
+    
+    SearchCapture() : results(false), sink(nullptr) {}
+    
+    static SearchCapture intoResults() {
+        SearchCapture capture;
+        capture.results = true;
+        return capture;
+    }
+    static SearchCapture intoSink(SearchSink* sink) {
+        SearchCapture capture;
+        capture.sink = sink;
+        return capture;
+    }
+    
+    bool enabled() const { return results || sink; }
+    void emit(SearchEventType type, Vec2 pos) const {
+        if (sink) sink->record({pos, type});
+    }
+    void emit(SearchEventType type, Vec2i cell) const {
+        if (sink) sink->record({Vec2(static_cast<float>(cell.x), static_cast<float>(cell.y)), type});
+    }
+};
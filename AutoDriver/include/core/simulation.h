@@ -0,0 +1,132 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include "grid.h"
+#include "multi_agent.h"
+#include "dynamic_obstacle.h"
+#include "vec2.h"
+
+/**
+ * Initial state of one simulated episode.
+ */
+struct EpisodeSpec {
+    uint64_t seed;   // Identifies the episode in results and traces
+    std::vector<Agent> agents;
+    std::vector<DynamicObstacle> obstacles;
+    
+    EpisodeSpec() : seed(0) {}
+};
+
+/**
+ * Settings shared by every episode of a run.
+ */
+struct SimulationConfig {
+    float dt;               // Fixed timestep in seconds
+    int max_steps;          // Episode is cut off (and fails) after this many steps
+    float goal_tolerance;   // Agents closer than this to their goal have arrived
+    bool record_trace;      // Keep a SimulationTrace in each EpisodeResult
+    int trace_stride;       // Record every n-th step
+    
+    SimulationConfig()
+        : dt(0.05f), max_steps(4000), goal_tolerance(0.75f), record_trace(false), trace_stride(1) {}
+};
+
+/**
+ * Agent and obstacle positions over an episode, quantised to 16-bit fixed
+ * point (scale units per cell) so a frame of n bodies is 4n bytes.
+ */
+struct SimulationTrace {
+    uint32_t num_agents;
+    uint32_t num_obstacles;
+    float dt;               // Simulated time between recorded frames
+    float scale;            // Fixed-point units per cell
+    std::vector<uint32_t> steps;    // Step index of each frame
+    std::vector<int16_t> coords;    // Per frame: x, y of every agent, then every obstacle
+    
+    SimulationTrace() : num_agents(0), num_obstacles(0), dt(0.0f), scale(1.0f) {}
+    
+    size_t frameCount() const { return steps.size(); }
+    Vec2 position(size_t frame, size_t body) const;   // Agents first, then obstacles
+    
+    bool save(const std::string& path) const;
+    static bool load(const std::string& path, SimulationTrace& out);
+};
+
+/**
+ * Outcome of one episode.
+ */
+struct EpisodeResult {
+    uint64_t seed;
+    int steps;
+    float sim_time;
+    int agents_arrived;
+    int agents_unplanned;      // No path found at the start
+    int agent_collisions;      // Pairs of agents coming into contact
+    int obstacle_collisions;   // Agents coming into contact with any dynamic obstacle
+    double wall_ms;
+    bool success;              // Every agent arrived without any contact
+    SimulationTrace trace;     // Only with SimulationConfig::record_trace
+    
+    EpisodeResult()
+        : seed(0), steps(0), sim_time(0.0f), agents_arrived(0), agents_unplanned(0),
+          agent_collisions(0), obstacle_collisions(0), wall_ms(0.0), success(false) {}
+};
+
+/**
+ * Totals over a batch of episodes.
+ */
+struct SimulationSummary {
+    int episodes;
+    int successes;
+    int agent_collisions;
+    int obstacle_collisions;
+    uint64_t total_steps;
+    double sim_seconds;
+    double wall_ms;              // Elapsed time for the whole batch
+    double episodes_per_minute;
+    double realtime_factor;      // Simulated seconds per wall-clock second
+    
+    SimulationSummary()
+        : episodes(0), successes(0), agent_collisions(0), obstacle_collisions(0), total_steps(0),
+          sim_seconds(0.0), wall_ms(0.0), episodes_per_minute(0.0), realtime_factor(0.0) {}
+};
+
+/**
+ * Headless fixed-timestep simulation of MultiAgentPlanner agents among
+ * dynamic obstacles.
+ *
+ * Episodes advance as fast as the CPU allows, independent of any frame
+ * clock. An episode is a pure function of its spec, the grid and the
+ * config: stepping uses the fixed dt and no wall-clock or global random
+ * state, so batches give identical results on any thread count. The grid
+ * is shared read-only by every episode of a batch.
+ */
+class SimulationEngine {
+public:
+    explicit SimulationEngine(const Grid& grid, const SimulationConfig& config = SimulationConfig());
+    
+    EpisodeResult runEpisode(const EpisodeSpec& spec) const;
+    
+    // Episodes are spread over num_threads workers (0 = hardware threads);
+    // results are in spec order
+    std::vector<EpisodeResult> runBatch(const std::vector<EpisodeSpec>& specs, int num_threads = 0,
+                                        SimulationSummary* summary = nullptr) const;
+    
+    // Random episode on free cells of grid, fully determined by seed
+    static EpisodeSpec randomEpisode(const Grid& grid, uint64_t seed, int num_agents, int num_obstacles);
+    
+    static SimulationSummary summarize(const std::vector<EpisodeResult>& results, double wall_ms);
+    
+    void setConfig(const SimulationConfig& config) { config_ = config; }
+    const SimulationConfig& getConfig() const { return config_; }
+
+private:
+    const Grid& grid_;
+    SimulationConfig config_;
+    
+    void recordFrame(SimulationTrace& trace, int step, const MultiAgentPlanner& agents,
+                     const DynamicObstacleManager& obstacles) const;
+};
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <vector>
+#include <queue>
+#include <limits>
+#include <algorithm>
+#include <cmath>
+#include "vec2.h"
+
+/**
+ * Axis-aligned bounding box.
+ */
+struct BoundingBox {
+    float min_x, min_y, max_x, max_y;
+    
+    BoundingBox()
+        : min_x(std::numeric_limits<float>::max()), min_y(std::numeric_limits<float>::max()),
+          max_x(std::numeric_limits<float>::lowest()), max_y(std::numeric_limits<float>::lowest()) {}
+    
+    BoundingBox(float x0, float y0, float x1, float y1)
+        : min_x(std::min(x0, x1)), min_y(std::min(y0, y1)),
+          max_x(std::max(x0, x1)), max_y(std::max(y0, y1)) {}
+    
+    void expand(const BoundingBox& other) {
+        min_x = std::min(min_x, other.min_x);
+        min_y = std::min(min_y, other.min_y);
+        max_x = std::max(max_x, other.max_x);
+        max_y = std::max(max_y, other.max_y);
+    }
+    
+    bool intersects(const BoundingBox& other) const {
+        return min_x <= other.max_x && other.min_x <= max_x &&
+               min_y <= other.max_y && other.min_y <= max_y;
+    }
+    
+    // Distance from point to box (0 if inside)
+    float distanceTo(Vec2 p) const {
+        float dx = std::max(0.0f, std::max(min_x - p.x, p.x - max_x));
+        float dy = std::max(0.0f, std::max(min_y - p.y, p.y - max_y));
+        return std::sqrt(dx * dx + dy * dy);
+    }
+    
+    Vec2 center() const { return Vec2((min_x + max_x) * 0.5f, (min_y + max_y) * 0.5f); }
+};
+
+/**
+ * Static R-tree built with Sort-Tile-Recursive bulk loading.
+ * Stores (box, id) entries; rebuild with build() when the entry set changes.
+ */
+class RTree {
+public:
+    struct Entry {
+        BoundingBox box;
+        int id;
+        
+        Entry(const BoundingBox& b, int i) : box(b), id(i) {}
+    };
+    
+    explicit RTree(int node_capacity = 16);
+    
+    // Bulk load (replaces any previous contents)
+    void build(std::vector<Entry> entries);
+    
+    // Ids of all entries whose box intersects the query box
+    void query(const BoundingBox& box, std::vector<int>& out) const;
+    
+    /**
+     * Nearest entry to p under an exact distance (must be >= the box distance).
+     * exact_distance(id) may return infinity to skip an entry.
+     * Returns -1 if nothing qualifies.
+     */
+    template<typename DistanceFn>
+    int nearest(Vec2 p, DistanceFn exact_distance, float* out_distance = nullptr) const;
+    
+    size_t size() const { return entries_.size(); }
+    bool empty() const { return entries_.empty(); }
+    
+private:
+    struct TreeNode {
+        BoundingBox box;
+        int first;   // First child (nodes_ for internal nodes, entries_ for leaves)
+        int count;
+        bool leaf;
+    };
+    
+    int node_capacity_;
+    int root_;
+    std::vector<TreeNode> nodes_;
+    std::vector<Entry> entries_;
+};
+
+template<typename DistanceFn>
+int RTree::nearest(Vec2 p, DistanceFn exact_distance, float* out_distance) const {
+    int best_id = -1;
+    float best = std::numeric_limits<float>::infinity();
+    if (root_ < 0) return best_id;
+    
+    // Best-first traversal ordered by box distance
+    using QueueItem = std::pair<float, int>;
+    std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>> queue;
+    queue.emplace(nodes_[root_].box.distanceTo(p), root_);
+    
+    while (!queue.empty()) {
+        auto [bound, index] = queue.top();
+        queue.pop();
+        if (bound >= best) break;
+        
+        const TreeNode& node = nodes_[index];
+        for (int c = node.first; c < node.first + node.count; c++) {
+            if (node.leaf) {
+                const Entry& entry = entries_[c];
+                if (entry.box.distanceTo(p) >= best) continue;
+                float d = exact_distance(entry.id);
+                if (d < best) {
+                    best = d;
+                    best_id = entry.id;
+                }
+            } else {
+                float d = nodes_[c].box.distanceTo(p);
+                if (d < best) {
+                    queue.emplace(d, c);
+                }
+            }
+        }
+    }
+    
+    if (out_distance) *out_distance = best;
+    return best_id;
+}
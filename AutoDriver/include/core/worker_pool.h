@@ -0,0 +1,76 @@
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * Fixed set of helper threads that run one task at a time alongside the
+ * calling thread.
+ *
+ * The helpers are started once and sleep between rounds, so code that fans
+ * out every step or every batch (simulation updates, sampling rounds) pays
+ * a wake-up per round instead of creating and joining threads. run() is a
+ * barrier: it returns once every participant has finished the task.
+ *
+ * One round at a time; run() must not be called concurrently or from inside
+ * a task.
+ */
+class WorkerPool {
+public:
+    // Participants including the caller; 0 = hardware threads
+    explicit WorkerPool(int num_threads = 0);
+    ~WorkerPool();
+    
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+    
+    int getNumThreads() const { return static_cast<int>(helpers_.size()) + 1; }
+    
+    // Runs task(worker) for worker in [0, workers) and waits for all of them;
+    // the caller is worker 0. workers is clamped to [1, getNumThreads()].
+    void run(int workers, const std::function<void(int)>& task);
+
+private:
+    std::vector<std::thread> helpers_;
+    std::mutex mutex_;
+    std::condition_variable start_cv_;
+    std::condition_variable done_cv_;
+    const std::function<void(int)>* task_;   // Guarded by mutex_
+    uint64_t round_;
+    int active_;      // Participants of the current round
+    int pending_;     // Helpers still working on it
+    bool stop_;
+    
+    void helperLoop(int worker);
+};
+
+/**
+ * Splits [0, count) into chunks of chunk_size items that up to num_threads
+ * threads (0 = hardware threads, caller included) pull off a shared counter;
+ * body(worker, begin, end) runs once per chunk, with worker in
+ * [0, num_threads) so callers can keep per-worker scratch space. Threads are
+ * started for this call only; use a WorkerPool when fanning out repeatedly.
+ */
+template<typename Body>
+void parallelChunks(int count, int num_threads, int chunk_size, Body body) {
+    if (num_threads <= 0) num_threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    
+    std::atomic<int> next(0);
+    auto worker = [&](int index) {
+        for (int begin = next.fetch_add(chunk_size); begin < count; begin = next.fetch_add(chunk_size)) {
+            body(index, begin, std::min(count, begin + chunk_size));
+        }
+    };
+    
+    int workers = std::min(num_threads, (count + chunk_size - 1) / chunk_size);
+    std::vector<std::thread> threads;
+    for (int t = 1; t < workers; t++) threads.emplace_back(worker, t);
+    worker(0);
+    for (auto& thread : threads) thread.join();
+}
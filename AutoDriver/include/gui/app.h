@@ -7,6 +7,7 @@
 #include "core/astar.h"
 #include "core/rrt.h"
 #include "core/dynamic_obstacle.h"
+#include "core/search_capture.h"
 #include "core/vec2.h"
 
 /**
@@ -44,6 +45,8 @@ private:
     AStarResult astar_result_;
     RRTResult rrt_result_;
     PlannerType current_planner_;
+    RingBufferSink search_events_;   // Last search, replayed a few events per frame
+    size_t events_shown_;
     bool is_dragging_;
     bool is_erasing_;
     bool show_smoothed_;
@@ -69,4 +72,5 @@ private:
     // Rendering
     void render();
     void updateSimulation(float dt);
+    void advanceReplay();
 };
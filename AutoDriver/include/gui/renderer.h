@@ -8,6 +8,7 @@
 #include "core/astar.h"
 #include "core/rrt.h"
 #include "core/dynamic_obstacle.h"
+#include "core/search_capture.h"
 
 /**
  * SDL2-based renderer for the path planning visualization.
@@ -25,6 +26,8 @@ public:
     void drawRRTTree(const std::vector<Vec2>& tree_nodes);
     void drawSearchProgress(const std::vector<Vec2i>& visited, 
                            const std::vector<Vec2i>& exploring);
+    // First count recorded events, oldest first (for animating a search)
+    void drawSearchEvents(const RingBufferSink& events, size_t count);
     void drawDynamicObstacles(const DynamicObstacleManager& obstacles);
     void drawStart(Vec2i pos);
     void drawGoal(Vec2i pos);
@@ -1,26 +1,302 @@
 #include "benchmark/benchmark_suite.h"
+#include "benchmark/scenario_corpus.h"
 #include "core/rrt.h"
+#include "core/performance_optimizer.h"
 #include <iostream>
 #include <fstream>
 #include <iomanip>
-#include <random>
 #include <algorithm>
 #include <numeric>
+#include <cmath>
+#include <memory>
+#include <sstream>
+#include <chrono>
+#include <map>
+#include <atomic>
+#include <thread>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+// Inverse standard normal CDF (Acklam's rational approximation, |error| < 1.2e-9)
+double normalQuantile(double p) {
+    static const double a[] = {-3.969683028665376e+01, 2.209460984245205e+02, -2.759285104469687e+02,
+                               1.383577518672690e+02, -3.066479806614716e+01, 2.506628277459239e+00};
+    static const double b[] = {-5.447609879822406e+01, 1.615858368580409e+02, -1.556989798598866e+02,
+                               6.680131188771972e+01, -1.328068155288572e+01};
+    static const double c[] = {-7.784894002430293e-03, -3.223964580411365e-01, -2.400758277161838e+00,
+                               -2.549671010229528e+00, 4.374664141464968e+00, 2.938163982698783e+00};
+    static const double d[] = {7.784695709041462e-03, 3.224671290700398e-01, 2.445134137142996e+00,
+                               3.754408661907416e+00};
+    const double p_low = 0.02425;
+    
+    if (p <= 0.0) return -INFINITY;
+    if (p >= 1.0) return INFINITY;
+    if (p < p_low || p > 1.0 - p_low) {
+        double q = std::sqrt(-2.0 * std::log(p < p_low ? p : 1.0 - p));
+        double x = (((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) /
+                   ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1.0);
+        return p < p_low ? x : -x;
+    }
+    double q = p - 0.5;
+    double r = q * q;
+    return (((((a[0] * r + a[1]) * r + a[2]) * r + a[3]) * r + a[4]) * r + a[5]) * q /
+           (((((b[0] * r + b[1]) * r + b[2]) * r + b[3]) * r + b[4]) * r + 1.0);
+}
+
+// Linearly interpolated quantile of sorted values
+double interpolatedQuantile(const std::vector<double>& sorted, double p) {
+    double h = (sorted.size() - 1) * p;
+    size_t lo = static_cast<size_t>(h);
+    if (lo + 1 >= sorted.size()) return sorted.back();
+    return sorted[lo] + (h - lo) * (sorted[lo + 1] - sorted[lo]);
+}
+
+// Order-statistic confidence interval for the p quantile: the ranks come
+// from the normal approximation to Binomial(n, p)
+void quantileInterval(const std::vector<double>& sorted, double p, double z, double& low, double& high) {
+    double n = static_cast<double>(sorted.size());
+    double spread = z * std::sqrt(n * p * (1.0 - p));
+    long lo_rank = static_cast<long>(std::floor(n * p - spread));
+    long hi_rank = static_cast<long>(std::ceil(n * p + spread)) + 1;
+    lo_rank = std::max(1L, std::min(lo_rank, static_cast<long>(sorted.size())));
+    hi_rank = std::max(1L, std::min(hi_rank, static_cast<long>(sorted.size())));
+    low = sorted[lo_rank - 1];
+    high = sorted[hi_rank - 1];
+}
+
+std::string jsonEscape(const std::string& text) {
+    std::string out;
+    for (char ch : text) {
+        if (ch == '"' || ch == '\\') {
+            out += '\\';
+            out += ch;
+        } else if (static_cast<unsigned char>(ch) < 0x20) {
+            char buffer[8];
+            std::snprintf(buffer, sizeof(buffer), "\\u%04x", ch);
+            out += buffer;
+        } else {
+            out += ch;
+        }
+    }
+    return out;
+}
+
+/**
+ * Just enough JSON to read back generateJSON() output.
+ */
+struct JsonValue {
+    enum Type { NUL, BOOL, NUMBER, STRING, ARRAY, OBJECT } type = NUL;
+    double number = 0.0;
+    std::string text;
+    std::vector<JsonValue> items;
+    std::vector<std::pair<std::string, JsonValue>> members;
+    
+    const JsonValue* find(const std::string& key) const {
+        for (const auto& member : members) {
+            if (member.first == key) return &member.second;
+        }
+        return nullptr;
+    }
+    double numberAt(const std::string& key, double fallback = 0.0) const {
+        const JsonValue* value = find(key);
+        return value && value->type == NUMBER ? value->number : fallback;
+    }
+    std::string textAt(const std::string& key) const {
+        const JsonValue* value = find(key);
+        return value && value->type == STRING ? value->text : std::string();
+    }
+};
+
+class JsonParser {
+public:
+    explicit JsonParser(const std::string& text) : text_(text), pos_(0) {}
+    
+    bool parse(JsonValue& value) {
+        if (!parseValue(value, 0)) return false;
+        skipSpace();
+        return pos_ == text_.size();
+    }
+
+private:
+    const std::string& text_;
+    size_t pos_;
+    
+    void skipSpace() {
+        while (pos_ < text_.size() && std::isspace(static_cast<unsigned char>(text_[pos_]))) pos_++;
+    }
+    
+    bool consume(char ch) {
+        skipSpace();
+        if (pos_ < text_.size() && text_[pos_] == ch) {
+            pos_++;
+            return true;
+        }
+        return false;
+    }
+    
+    bool parseString(std::string& out) {
+        if (!consume('"')) return false;
+        while (pos_ < text_.size()) {
+            char ch = text_[pos_++];
+            if (ch == '"') return true;
+            if (ch == '\\') {
+                if (pos_ >= text_.size()) return false;
+                char esc = text_[pos_++];
+                switch (esc) {
+                    case 'n': out += '\n'; break;
+                    case 't': out += '\t'; break;
+                    case 'r': out += '\r'; break;
+                    case 'b': out += '\b'; break;
+                    case 'f': out += '\f'; break;
+                    case 'u':
+                        // Only the control characters jsonEscape() produces
+                        if (pos_ + 4 > text_.size()) return false;
+                        out += static_cast<char>(std::stoi(text_.substr(pos_, 4), nullptr, 16));
+                        pos_ += 4;
+                        break;
+                    default: out += esc; break;
+                }
+            } else {
+                out += ch;
+            }
+        }
+        return false;
+    }
+    
+    bool parseValue(JsonValue& value, int depth) {
+        if (depth > 32) return false;
+        skipSpace();
+        if (pos_ >= text_.size()) return false;
+        
+        char ch = text_[pos_];
+        if (ch == '{') {
+            pos_++;
+            value.type = JsonValue::OBJECT;
+            if (consume('}')) return true;
+            do {
+                std::pair<std::string, JsonValue> member;
+                if (!parseString(member.first) || !consume(':') || !parseValue(member.second, depth + 1)) return false;
+                value.members.push_back(std::move(member));
+            } while (consume(','));
+            return consume('}');
+        }
+        if (ch == '[') {
+            pos_++;
+            value.type = JsonValue::ARRAY;
+            if (consume(']')) return true;
+            do {
+                value.items.emplace_back();
+                if (!parseValue(value.items.back(), depth + 1)) return false;
+            } while (consume(','));
+            return consume(']');
+        }
+        if (ch == '"') {
+            value.type = JsonValue::STRING;
+            return parseString(value.text);
+        }
+        for (const char* word : {"true", "false", "null"}) {
+            if (text_.compare(pos_, std::strlen(word), word) == 0) {
+                pos_ += std::strlen(word);
+                value.type = word[0] == 'n' ? JsonValue::NUL : JsonValue::BOOL;
+                value.number = word[0] == 't' ? 1.0 : 0.0;
+                return true;
+            }
+        }
+        
+        const char* begin = text_.c_str() + pos_;
+        char* end = nullptr;
+        value.number = std::strtod(begin, &end);
+        if (end == begin) return false;
+        value.type = JsonValue::NUMBER;
+        pos_ += end - begin;
+        return true;
+    }
+};
+
+void writeStats(std::ostream& out, const BenchmarkStats& stats) {
+    out << "{\"samples\": " << stats.samples
+        << ", \"min\": " << stats.min << ", \"max\": " << stats.max
+        << ", \"mean\": " << stats.mean << ", \"stddev\": " << stats.stddev
+        << ", \"median\": " << stats.median
+        << ", \"median_ci\": [" << stats.median_ci_low << ", " << stats.median_ci_high << "]"
+        << ", \"p90\": " << stats.p90
+        << ", \"p90_ci\": [" << stats.p90_ci_low << ", " << stats.p90_ci_high << "]"
+        << ", \"p99\": " << stats.p99
+        << ", \"p99_ci\": [" << stats.p99_ci_low << ", " << stats.p99_ci_high << "]}";
+}
+
+bool readStats(const JsonValue* value, BenchmarkStats& stats) {
+    if (!value || value->type != JsonValue::OBJECT) return false;
+    auto interval = [&](const char* key, double& low, double& high) {
+        const JsonValue* pair = value->find(key);
+        if (!pair || pair->type != JsonValue::ARRAY || pair->items.size() != 2) return false;
+        low = pair->items[0].number;
+        high = pair->items[1].number;
+        return true;
+    };
+    stats.samples = static_cast<int>(value->numberAt("samples"));
+    stats.min = value->numberAt("min");
+    stats.max = value->numberAt("max");
+    stats.mean = value->numberAt("mean");
+    stats.stddev = value->numberAt("stddev");
+    stats.median = value->numberAt("median");
+    stats.p90 = value->numberAt("p90");
+    stats.p99 = value->numberAt("p99");
+    return interval("median_ci", stats.median_ci_low, stats.median_ci_high) &&
+           interval("p90_ci", stats.p90_ci_low, stats.p90_ci_high) &&
+           interval("p99_ci", stats.p99_ci_low, stats.p99_ci_high);
+}
+
+}  // namespace
+
+BenchmarkStats BenchmarkStats::compute(std::vector<double> values, double confidence) {
+    BenchmarkStats stats;
+    if (values.empty()) return stats;
+    
+    std::sort(values.begin(), values.end());
+    const double n = static_cast<double>(values.size());
+    stats.samples = static_cast<int>(values.size());
+    stats.min = values.front();
+    stats.max = values.back();
+    stats.mean = std::accumulate(values.begin(), values.end(), 0.0) / n;
+    
+    double squares = 0.0;
+    for (double v : values) squares += (v - stats.mean) * (v - stats.mean);
+    stats.stddev = values.size() > 1 ? std::sqrt(squares / (n - 1.0)) : 0.0;
+    
+    stats.median = interpolatedQuantile(values, 0.5);
+    stats.p90 = interpolatedQuantile(values, 0.9);
+    stats.p99 = interpolatedQuantile(values, 0.99);
+    
+    double z = normalQuantile(0.5 + 0.5 * std::max(0.0, std::min(confidence, 0.999999)));
+    quantileInterval(values, 0.5, z, stats.median_ci_low, stats.median_ci_high);
+    quantileInterval(values, 0.9, z, stats.p90_ci_low, stats.p90_ci_high);
+    quantileInterval(values, 0.99, z, stats.p99_ci_low, stats.p99_ci_high);
+    return stats;
+}
 
 BenchmarkSuite::BenchmarkSuite(const BenchmarkConfig& config)
-    : config_(config) {}
+    : config_(config), next_stream_(0) {}
+
+RandomStream BenchmarkSuite::nextStream() {
+    return RandomStream(config_.seed, next_stream_++);
+}
 
 Grid BenchmarkSuite::createTestGrid(int size, float obstacle_density) {
     Grid grid(size, size);
     
     if (config_.include_obstacles) {
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+        RandomStream rng = nextStream();
+        std::vector<float> row(size);
         
         for (int y = 0; y < size; y++) {
+            rng.fillUniform(row.data(), row.size());
             for (int x = 0; x < size; x++) {
-                if (dist(gen) < obstacle_density) {
+                if (row[x] < obstacle_density) {
                     grid.setObstacle(x, y, true);
                 }
             }
@@ -30,15 +306,87 @@ Grid BenchmarkSuite::createTestGrid(int size, float obstacle_density) {
     return grid;
 }
 
+Grid BenchmarkSuite::createNarrowPassageGrid(int size, int gap_width) {
+    // Two vertical walls, each with a small gap at opposite ends
+    Grid grid(size, size);
+    
+    int wall1 = size / 3;
+    int wall2 = size * 2 / 3;
+    for (int y = 0; y < size; y++) {
+        if (y < size - 2 - gap_width || y >= size - 2) {
+            grid.setObstacle(wall1, y, true);
+        }
+        if (y < 2 || y >= 2 + gap_width) {
+            grid.setObstacle(wall2, y, true);
+        }
+    }
+    
+    return grid;
+}
+
 double BenchmarkSuite::measureTime(std::function<void()> func) {
-    auto start = std::chrono::high_resolution_clock::now();
+    // steady_clock is monotonic; high_resolution_clock may follow wall-clock adjustments
+    auto start = std::chrono::steady_clock::now();
     func();
-    auto end = std::chrono::high_resolution_clock::now();
+    auto end = std::chrono::steady_clock::now();
     
     std::chrono::duration<double, std::milli> duration = end - start;
     return duration.count();
 }
 
+BenchmarkResult BenchmarkSuite::runCase(const std::string& name, const std::string& algorithm, int grid_size,
+                                        const std::vector<std::function<RunOutcome()>>& scenarios) {
+    std::vector<double> times;
+    std::vector<double> throughput;
+    double nodes_sum = 0.0;
+    double cost_sum = 0.0;
+    int successes = 0;
+    
+    const int repetitions = std::max(1, config_.repetitions);
+    for (const auto& scenario : scenarios) {
+        // Warm caches, the allocator and the branch predictors before timing
+        for (int i = 0; i < config_.warmup_runs; i++) scenario();
+        
+        for (int rep = 0; rep < repetitions; rep++) {
+            RunOutcome outcome{false, 0, 0.0f};
+            double time = measureTime([&]() {
+                outcome = scenario();
+            });
+            
+            // Failed runs are timed too: a planner that gives up slowly is slow
+            times.push_back(time);
+            throughput.push_back(PerformanceMetrics::calculateThroughput(outcome.nodes, time));
+            if (outcome.success) {
+                nodes_sum += outcome.nodes;
+                cost_sum += outcome.cost;
+                successes++;
+            }
+        }
+    }
+    
+    BenchmarkResult result(name, algorithm);
+    result.grid_size = grid_size;
+    result.iterations = static_cast<int>(times.size());
+    result.time_stats = BenchmarkStats::compute(times, config_.confidence);
+    result.nodes_per_second = BenchmarkStats::compute(throughput, config_.confidence);
+    result.time_ms = result.time_stats.median;
+    result.success = successes > 0;
+    result.success_rate = times.empty() ? 0.0 : static_cast<double>(successes) / times.size();
+    if (successes > 0) {
+        result.nodes_expanded = static_cast<int>(nodes_sum / successes);
+        result.path_cost = static_cast<float>(cost_sum / successes);
+    }
+    
+    const BenchmarkStats& t = result.time_stats;
+    std::cout << "  " << std::left << std::setw(12) << algorithm << std::right << std::fixed << std::setprecision(3)
+              << " median " << t.median << "ms [" << t.median_ci_low << ", " << t.median_ci_high << "]"
+              << ", p90 " << t.p90 << "ms, p99 " << t.p99 << "ms"
+              << ", " << std::setprecision(0) << result.nodes_per_second.median << " nodes/s"
+              << ", success " << successes << "/" << times.size() << std::endl;
+    
+    return result;
+}
+
 void BenchmarkSuite::addResult(const BenchmarkResult& result) {
     results_.push_back(result);
 }
@@ -53,50 +401,17 @@ void BenchmarkSuite::benchmarkAStar() {
     for (int size : config_.grid_sizes) {
         printProgress("Testing A* on " + std::to_string(size) + "x" + std::to_string(size) + " grid...");
         
-        std::vector<double> times;
-        std::vector<int> nodes;
-        std::vector<float> costs;
-        int successes = 0;
-        
+        std::vector<std::function<RunOutcome()>> scenarios;
         for (int trial = 0; trial < config_.num_trials; trial++) {
-            Grid grid = createTestGrid(size, config_.obstacle_density);
-            AStar planner(grid);
-            
-            Vec2i start(size / 4, size / 4);
-            Vec2i goal(size * 3 / 4, size * 3 / 4);
-            
-            AStarResult result;
-            double time = measureTime([&]() {
-                result = planner.findPath(start, goal);
+            auto grid = std::make_shared<Grid>(createTestGrid(size, config_.obstacle_density));
+            scenarios.push_back([grid, size]() {
+                AStar planner(*grid);
+                AStarResult result = planner.findPath(Vec2i(size / 4, size / 4), Vec2i(size * 3 / 4, size * 3 / 4));
+                return RunOutcome{result.success, result.nodes_expanded, result.path_cost};
             });
-            
-            if (result.success) {
-                times.push_back(time);
-                nodes.push_back(result.nodes_expanded);
-                costs.push_back(result.path_cost);
-                successes++;
-            }
         }
         
-        if (!times.empty()) {
-            double avg_time = std::accumulate(times.begin(), times.end(), 0.0) / times.size();
-            int avg_nodes = std::accumulate(nodes.begin(), nodes.end(), 0) / nodes.size();
-            float avg_cost = std::accumulate(costs.begin(), costs.end(), 0.0f) / costs.size();
-            
-            BenchmarkResult bench_result("A*_Grid_" + std::to_string(size), "A*");
-            bench_result.grid_size = size;
-            bench_result.time_ms = avg_time;
-            bench_result.nodes_expanded = avg_nodes;
-            bench_result.path_cost = avg_cost;
-            bench_result.success = true;
-            bench_result.iterations = config_.num_trials;
-            
-            addResult(bench_result);
-            
-            std::cout << "  Avg time: " << std::fixed << std::setprecision(2) 
-                      << avg_time << "ms, Nodes: " << avg_nodes 
-                      << ", Success rate: " << successes << "/" << config_.num_trials << std::endl;
-        }
+        addResult(runCase("A*_Grid_" + std::to_string(size), "A*", size, scenarios));
     }
 }
 
@@ -108,50 +423,21 @@ void BenchmarkSuite::benchmarkRRT() {
         
         printProgress("Testing RRT on " + std::to_string(size) + "x" + std::to_string(size) + " grid...");
         
-        std::vector<double> times;
-        std::vector<int> iters;
-        std::vector<float> costs;
-        int successes = 0;
-        
+        std::vector<std::function<RunOutcome()>> scenarios;
         for (int trial = 0; trial < config_.num_trials; trial++) {
-            Grid grid = createTestGrid(size, config_.obstacle_density * 0.5f); // Less obstacles for RRT
-            RRT planner(grid);
-            
-            Vec2 start(static_cast<float>(size) / 4.0f, static_cast<float>(size) / 4.0f);
-            Vec2 goal(static_cast<float>(size) * 3.0f / 4.0f, static_cast<float>(size) * 3.0f / 4.0f);
-            
-            RRTResult result;
-            double time = measureTime([&]() {
-                result = planner.findPath(start, goal, 2000);
+            auto grid = std::make_shared<Grid>(createTestGrid(size, config_.obstacle_density * 0.5f)); // Less obstacles for RRT
+            uint64_t seed = nextStream()();
+            scenarios.push_back([grid, size, seed]() {
+                RRT planner(*grid);
+                planner.setSeed(seed);
+                Vec2 start(static_cast<float>(size) / 4.0f, static_cast<float>(size) / 4.0f);
+                Vec2 goal(static_cast<float>(size) * 3.0f / 4.0f, static_cast<float>(size) * 3.0f / 4.0f);
+                RRTResult result = planner.findPath(start, goal, 2000);
+                return RunOutcome{result.success, result.iterations, result.path_cost};
             });
-            
-            if (result.success) {
-                times.push_back(time);
-                iters.push_back(result.iterations);
-                costs.push_back(result.path_cost);
-                successes++;
-            }
         }
         
-        if (!times.empty()) {
-            double avg_time = std::accumulate(times.begin(), times.end(), 0.0) / times.size();
-            int avg_iters = std::accumulate(iters.begin(), iters.end(), 0) / iters.size();
-            float avg_cost = std::accumulate(costs.begin(), costs.end(), 0.0f) / costs.size();
-            
-            BenchmarkResult bench_result("RRT_Grid_" + std::to_string(size), "RRT");
-            bench_result.grid_size = size;
-            bench_result.time_ms = avg_time;
-            bench_result.nodes_expanded = avg_iters;
-            bench_result.path_cost = avg_cost;
-            bench_result.success = true;
-            bench_result.iterations = config_.num_trials;
-            
-            addResult(bench_result);
-            
-            std::cout << "  Avg time: " << std::fixed << std::setprecision(2) 
-                      << avg_time << "ms, Iterations: " << avg_iters 
-                      << ", Success rate: " << successes << "/" << config_.num_trials << std::endl;
-        }
+        addResult(runCase("RRT_Grid_" + std::to_string(size), "RRT", size, scenarios));
     }
 }
 
@@ -163,49 +449,75 @@ void BenchmarkSuite::benchmarkRRTStar() {
         
         printProgress("Testing RRT* on " + std::to_string(size) + "x" + std::to_string(size) + " grid...");
         
-        std::vector<double> times;
-        std::vector<int> iters;
-        std::vector<float> costs;
-        int successes = 0;
-        
+        std::vector<std::function<RunOutcome()>> scenarios;
         for (int trial = 0; trial < config_.num_trials; trial++) {
-            Grid grid = createTestGrid(size, config_.obstacle_density * 0.5f);
-            RRTStar planner(grid);
-            
-            Vec2 start(static_cast<float>(size) / 4.0f, static_cast<float>(size) / 4.0f);
-            Vec2 goal(static_cast<float>(size) * 3.0f / 4.0f, static_cast<float>(size) * 3.0f / 4.0f);
-            
-            RRTResult result;
-            double time = measureTime([&]() {
-                result = planner.findPath(start, goal, 2000);
+            auto grid = std::make_shared<Grid>(createTestGrid(size, config_.obstacle_density * 0.5f));
+            uint64_t seed = nextStream()();
+            scenarios.push_back([grid, size, seed]() {
+                RRTStar planner(*grid);
+                planner.setSeed(seed);
+                Vec2 start(static_cast<float>(size) / 4.0f, static_cast<float>(size) / 4.0f);
+                Vec2 goal(static_cast<float>(size) * 3.0f / 4.0f, static_cast<float>(size) * 3.0f / 4.0f);
+                RRTResult result = planner.findPath(start, goal, 2000);
+                return RunOutcome{result.success, result.iterations, result.path_cost};
             });
-            
-            if (result.success) {
-                times.push_back(time);
-                iters.push_back(result.iterations);
-                costs.push_back(result.path_cost);
-                successes++;
-            }
         }
         
-        if (!times.empty()) {
-            double avg_time = std::accumulate(times.begin(), times.end(), 0.0) / times.size();
-            int avg_iters = std::accumulate(iters.begin(), iters.end(), 0) / iters.size();
-            float avg_cost = std::accumulate(costs.begin(), costs.end(), 0.0f) / costs.size();
-            
-            BenchmarkResult bench_result("RRTStar_Grid_" + std::to_string(size), "RRT*");
-            bench_result.grid_size = size;
-            bench_result.time_ms = avg_time;
-            bench_result.nodes_expanded = avg_iters;
-            bench_result.path_cost = avg_cost;
-            bench_result.success = true;
-            bench_result.iterations = config_.num_trials;
-            
-            addResult(bench_result);
+        addResult(runCase("RRTStar_Grid_" + std::to_string(size), "RRT*", size, scenarios));
+    }
+}
+
+void BenchmarkSuite::benchmarkRRTConnect() {
+    printProgress("Starting RRT-Connect narrow-passage benchmarks...");
+    
+    // Time until each planner returns its first solution
+    struct Planner {
+        std::string name;
+        std::string algorithm;
+        std::function<RRTResult(const Grid&, Vec2, Vec2, uint64_t)> run;
+    };
+    
+    const int max_iterations = 20000;
+    std::vector<Planner> planners = {
+        {"RRT", "RRT", [=](const Grid& g, Vec2 s, Vec2 e, uint64_t seed) {
+            RRT planner(g);
+            planner.setSeed(seed);
+            return planner.findPath(s, e, max_iterations);
+        }},
+        {"RRTStar", "RRT*", [=](const Grid& g, Vec2 s, Vec2 e, uint64_t seed) {
+            RRTStar planner(g);
+            planner.setSeed(seed);
+            return planner.findPath(s, e, max_iterations);
+        }},
+        {"RRTConnect", "RRT-Connect", [=](const Grid& g, Vec2 s, Vec2 e, uint64_t seed) {
+            RRTConnect planner(g);
+            planner.setSeed(seed);
+            return planner.findPath(s, e, max_iterations);
+        }},
+    };
+    
+    for (int size : config_.grid_sizes) {
+        if (size > 50) continue; // Linear nearest-neighbour search dominates beyond this
+        
+        auto grid = std::make_shared<Grid>(createNarrowPassageGrid(size, 2));
+        Vec2 start(2.0f, static_cast<float>(size) / 2.0f);
+        Vec2 goal(static_cast<float>(size) - 3.0f, static_cast<float>(size) / 2.0f);
+        
+        printProgress("Narrow passage " + std::to_string(size) + "x" + std::to_string(size) + "...");
+        
+        for (const auto& planner : planners) {
+            std::vector<std::function<RunOutcome()>> scenarios;
+            for (int trial = 0; trial < config_.num_trials; trial++) {
+                uint64_t seed = nextStream()();
+                auto run = planner.run;
+                scenarios.push_back([grid, start, goal, seed, run]() {
+                    RRTResult result = run(*grid, start, goal, seed);
+                    return RunOutcome{result.success, result.iterations, result.path_cost};
+                });
+            }
             
-            std::cout << "  Avg time: " << std::fixed << std::setprecision(2) 
-                      << avg_time << "ms, Iterations: " << avg_iters 
-                      << ", Success rate: " << successes << "/" << config_.num_trials << std::endl;
+            addResult(runCase("NarrowPassage_" + planner.name + "_" + std::to_string(size),
+                              planner.algorithm, size, scenarios));
         }
     }
 }
@@ -213,66 +525,248 @@ void BenchmarkSuite::benchmarkRRTStar() {
 void BenchmarkSuite::benchmarkComparison() {
     printProgress("Running comparison benchmark on 30x30 grid...");
     
-    Grid grid = createTestGrid(30, 0.2f);
+    auto grid = std::make_shared<Grid>(createTestGrid(30, 0.2f));
     
-    // A*
-    {
-        AStar planner(grid);
-        Vec2i start(5, 5);
-        Vec2i goal(25, 25);
-        
-        AStarResult result;
-        double time = measureTime([&]() {
-            result = planner.findPath(start, goal);
-        });
-        
-        BenchmarkResult bench_result("Comparison_AStar", "A*");
-        bench_result.grid_size = 30;
-        bench_result.time_ms = time;
-        bench_result.nodes_expanded = result.nodes_expanded;
-        bench_result.path_cost = result.path_cost;
-        bench_result.success = result.success;
-        addResult(bench_result);
-    }
-    
-    // RRT
-    {
-        RRT planner(grid);
-        Vec2 start(5.0f, 5.0f);
-        Vec2 goal(25.0f, 25.0f);
-        
-        RRTResult result;
-        double time = measureTime([&]() {
-            result = planner.findPath(start, goal, 3000);
-        });
-        
-        BenchmarkResult bench_result("Comparison_RRT", "RRT");
-        bench_result.grid_size = 30;
-        bench_result.time_ms = time;
-        bench_result.nodes_expanded = result.iterations;
-        bench_result.path_cost = result.path_cost;
-        bench_result.success = result.success;
-        addResult(bench_result);
-    }
-    
-    // RRT*
-    {
-        RRTStar planner(grid);
-        Vec2 start(5.0f, 5.0f);
-        Vec2 goal(25.0f, 25.0f);
-        
-        RRTResult result;
-        double time = measureTime([&]() {
-            result = planner.findPath(start, goal, 3000);
-        });
+    addResult(runCase("Comparison_AStar", "A*", 30, {[grid]() {
+        AStar planner(*grid);
+        AStarResult result = planner.findPath(Vec2i(5, 5), Vec2i(25, 25));
+        return RunOutcome{result.success, result.nodes_expanded, result.path_cost};
+    }}));
+    
+    uint64_t rrt_seed = nextStream()();
+    addResult(runCase("Comparison_RRT", "RRT", 30, {[grid, rrt_seed]() {
+        RRT planner(*grid);
+        planner.setSeed(rrt_seed);
+        RRTResult result = planner.findPath(Vec2(5.0f, 5.0f), Vec2(25.0f, 25.0f), 3000);
+        return RunOutcome{result.success, result.iterations, result.path_cost};
+    }}));
+    
+    uint64_t rrt_star_seed = nextStream()();
+    addResult(runCase("Comparison_RRTStar", "RRT*", 30, {[grid, rrt_star_seed]() {
+        RRTStar planner(*grid);
+        planner.setSeed(rrt_star_seed);
+        RRTResult result = planner.findPath(Vec2(5.0f, 5.0f), Vec2(25.0f, 25.0f), 3000);
+        return RunOutcome{result.success, result.iterations, result.path_cost};
+    }}));
+}
+
+void BenchmarkSuite::benchmarkScenarios() {
+    printProgress("Starting scenario corpus benchmarks...");
+    scenario_results_.clear();
+    
+    struct GridPlanner {
+        std::string name;
+        std::function<AStarResult(const Grid&, Vec2i, Vec2i)> run;
+    };
+    std::map<const Grid*, LandmarkTable> landmark_tables;   // Filled once the maps are loaded
+    const std::vector<GridPlanner> planners = {
+        {"A*", [](const Grid& g, Vec2i s, Vec2i e) {
+            AStar planner(g);
+            return planner.findPath(s, e);
+        }},
+        {"A* (coarse-to-fine)", [](const Grid& g, Vec2i s, Vec2i e) {
+            AStar planner(g);
+            return planner.findPathCoarseToFine(s, e);
+        }},
+        {"A* (ALT)", [&landmark_tables](const Grid& g, Vec2i s, Vec2i e) {
+            AStar planner(g);
+            planner.setLandmarks(&landmark_tables.at(&g));
+            return planner.findPath(s, e);
+        }},
+        {"Parallel A*", [](const Grid& g, Vec2i s, Vec2i e) {
+            ParallelAStar planner(g);
+            return planner.findPath(s, e);
+        }},
+    };
+    
+    // Load every map once and group scenarios into (map, bucket) work items
+    std::vector<std::unique_ptr<Grid>> grids;
+    std::vector<std::string> map_names;
+    std::map<std::string, int> map_index;   // Resolved path -> grids index, -1 if it failed to load
+    std::map<std::pair<int, int>, std::vector<Scenario>> grouped;
+    
+    for (const auto& scen_path : config_.scenario_files) {
+        ScenarioLoadResult loaded = MovingAI::loadScenarios(scen_path);
+        if (!loaded.success) {
+            std::cout << "  Skipping " << scen_path << ": " << loaded.error << std::endl;
+            continue;
+        }
         
-        BenchmarkResult bench_result("Comparison_RRTStar", "RRT*");
-        bench_result.grid_size = 30;
-        bench_result.time_ms = time;
-        bench_result.nodes_expanded = result.iterations;
-        bench_result.path_cost = result.path_cost;
-        bench_result.success = result.success;
-        addResult(bench_result);
+        for (const Scenario& scenario : loaded.scenarios) {
+            std::string map_path = MovingAI::resolveMapPath(scen_path, scenario.map_name, config_.maps_dir);
+            auto found = map_index.find(map_path);
+            if (found == map_index.end()) {
+                MapLoadResult map = MovingAI::loadMap(map_path);
+                int index = -1;
+                if (map.success) {
+                    map.grid->enablePyramid();   // Coarse-to-fine lookups; read-only from here on
+                    index = static_cast<int>(grids.size());
+                    grids.push_back(std::move(map.grid));
+                    std::string name = scenario.map_name.substr(scenario.map_name.find_last_of("/\\") + 1);
+                    map_names.push_back(name.substr(0, name.rfind(".map")));
+                } else {
+                    std::cout << "  Skipping map " << map_path << ": " << map.error << std::endl;
+                }
+                found = map_index.emplace(map_path, index).first;
+            }
+            
+            int index = found->second;
+            if (index < 0) continue;
+            const Grid& grid = *grids[index];
+            if (grid.getWidth() != scenario.map_width || grid.getHeight() != scenario.map_height ||
+                grid.isObstacle(scenario.start.x, scenario.start.y) || grid.isObstacle(scenario.goal.x, scenario.goal.y)) {
+                continue;  // Scenario does not match the map
+            }
+            
+            auto& bucket = grouped[{index, scenario.bucket}];
+            if (config_.max_scenarios_per_bucket <= 0 ||
+                static_cast<int>(bucket.size()) < config_.max_scenarios_per_bucket) {
+                bucket.push_back(scenario);
+            }
+        }
+    }
+    
+    if (grouped.empty()) {
+        printProgress("No runnable scenarios");
+        return;
+    }
+    
+    // Landmark preprocessing is per map and not part of the timed queries
+    for (const auto& grid : grids) {
+        landmark_tables[grid.get()] = LandmarkTable::build(*grid);
+    }
+    
+    struct Sample {
+        double time_ms;
+        bool success;
+        int nodes;
+        float cost;
+    };
+    struct Bucket {
+        int map;
+        int bucket;
+        const std::vector<Scenario>* scenarios;
+        std::vector<double> reference;              // Optimal length per scenario
+        std::vector<std::vector<Sample>> samples;   // [planner][scenario]
+        std::vector<ScenarioBucketResult> results;  // [planner]
+    };
+    std::vector<Bucket> buckets;
+    for (const auto& entry : grouped) {
+        buckets.push_back({entry.first.first, entry.first.second, &entry.second, {}, {}, {}});
+    }
+    
+    // Reference solutions are untimed, so buckets are solved in parallel:
+    // workers pull them off a shared counter
+    std::atomic<size_t> next(0);
+    auto solveReferences = [&]() {
+        for (size_t b = next.fetch_add(1); b < buckets.size(); b = next.fetch_add(1)) {
+            Bucket& bucket = buckets[b];
+            const Grid& grid = *grids[bucket.map];
+            for (const Scenario& scenario : *bucket.scenarios) {
+                bucket.reference.push_back(MovingAI::shortestPathLength(grid, scenario.start, scenario.goal, false));
+            }
+        }
+    };
+    
+    int threads = config_.scenario_threads > 0 ?
+        config_.scenario_threads : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    threads = std::min<int>(threads, static_cast<int>(buckets.size()));
+    printProgress(std::to_string(buckets.size()) + " buckets from " + std::to_string(grids.size()) +
+                  " maps; references on " + std::to_string(threads) + " workers, planners timed serially...");
+    
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threads; t++) pool.emplace_back(solveReferences);
+    solveReferences();
+    for (auto& thread : pool) thread.join();
+    
+    // Planner timings feed the regression check, so they run one at a time
+    // on an otherwise idle machine
+    for (Bucket& bucket : buckets) {
+        const Grid& grid = *grids[bucket.map];
+        for (const auto& planner : planners) {
+            ScenarioBucketResult result;
+            result.map_name = map_names[bucket.map];
+            result.planner = planner.name;
+            result.bucket = bucket.bucket;
+            result.scenarios = static_cast<int>(bucket.scenarios->size());
+            
+            std::vector<Sample> samples;
+            double ratio_sum = 0.0;
+            for (size_t i = 0; i < bucket.scenarios->size(); i++) {
+                const Scenario& scenario = (*bucket.scenarios)[i];
+                AStarResult path;
+                double time = measureTime([&]() {
+                    path = planner.run(grid, scenario.start, scenario.goal);
+                });
+                samples.push_back({time, path.success, path.nodes_expanded, path.path_cost});
+                result.total_time_ms += time;
+                
+                if (path.success && bucket.reference[i] > 0.0) {
+                    double ratio = path.path_cost / bucket.reference[i];
+                    ratio_sum += ratio;
+                    result.max_optimality = std::max(result.max_optimality, ratio);
+                    result.solved++;
+                } else if (path.success) {
+                    result.solved++;  // Start == goal
+                    ratio_sum += 1.0;
+                    result.max_optimality = std::max(result.max_optimality, 1.0);
+                }
+            }
+            result.mean_time_ms = result.scenarios > 0 ? result.total_time_ms / result.scenarios : 0.0;
+            result.mean_optimality = result.solved > 0 ? ratio_sum / result.solved : 0.0;
+            
+            bucket.samples.push_back(std::move(samples));
+            bucket.results.push_back(result);
+        }
+    }
+    
+    // One summary result per (map, planner) so the corpus joins the report and regression checks
+    for (size_t m = 0; m < grids.size(); m++) {
+        for (size_t p = 0; p < planners.size(); p++) {
+            std::vector<double> times;
+            std::vector<double> throughput;
+            double nodes_sum = 0.0, cost_sum = 0.0, ratio_sum = 0.0, max_ratio = 0.0;
+            int solved = 0;
+            
+            for (const Bucket& bucket : buckets) {
+                if (bucket.map != static_cast<int>(m)) continue;
+                scenario_results_.push_back(bucket.results[p]);
+                const ScenarioBucketResult& r = bucket.results[p];
+                ratio_sum += r.mean_optimality * r.solved;
+                max_ratio = std::max(max_ratio, r.max_optimality);
+                
+                for (const Sample& sample : bucket.samples[p]) {
+                    times.push_back(sample.time_ms);
+                    throughput.push_back(PerformanceMetrics::calculateThroughput(sample.nodes, sample.time_ms));
+                    if (sample.success) {
+                        nodes_sum += sample.nodes;
+                        cost_sum += sample.cost;
+                        solved++;
+                    }
+                }
+            }
+            if (times.empty()) continue;
+            
+            BenchmarkResult result("Scenario_" + map_names[m] + "_" + planners[p].name, planners[p].name);
+            result.grid_size = std::max(grids[m]->getWidth(), grids[m]->getHeight());
+            result.iterations = static_cast<int>(times.size());
+            result.time_stats = BenchmarkStats::compute(times, config_.confidence);
+            result.nodes_per_second = BenchmarkStats::compute(throughput, config_.confidence);
+            result.time_ms = result.time_stats.median;
+            result.success = solved > 0;
+            result.success_rate = static_cast<double>(solved) / times.size();
+            if (solved > 0) {
+                result.nodes_expanded = static_cast<int>(nodes_sum / solved);
+                result.path_cost = static_cast<float>(cost_sum / solved);
+            }
+            addResult(result);
+            
+            double total_ms = std::accumulate(times.begin(), times.end(), 0.0);
+            std::cout << "  " << std::left << std::setw(24) << map_names[m] << std::setw(22) << planners[p].name
+                      << std::right << std::fixed << std::setprecision(2) << "solved " << solved << "/" << times.size()
+                      << ", optimality mean " << std::setprecision(3) << (solved ? ratio_sum / solved : 0.0)
+                      << " max " << max_ratio << ", total " << std::setprecision(1) << total_ms << "ms" << std::endl;
+        }
     }
 }
 
@@ -280,6 +774,7 @@ void BenchmarkSuite::runAll() {
     printProgress("=== Starting Automated Benchmark Suite ===\n");
     
     results_.clear();
+    next_stream_ = 0;
     
     benchmarkAStar();
     std::cout << std::endl;
@@ -290,9 +785,18 @@ void BenchmarkSuite::runAll() {
     benchmarkRRTStar();
     std::cout << std::endl;
     
+    benchmarkRRTConnect();
+    std::cout << std::endl;
+    
     benchmarkComparison();
     std::cout << std::endl;
     
+    scenario_results_.clear();
+    if (!config_.scenario_files.empty()) {
+        benchmarkScenarios();
+        std::cout << std::endl;
+    }
+    
     printProgress("=== Benchmark Suite Complete ===\n");
     
     PerformanceMetrics::printSummary(results_);
@@ -307,22 +811,29 @@ void BenchmarkSuite::generateReport(const std::string& filename) {
     
     file << "Configuration:\n";
     file << "  Trials per test: " << config_.num_trials << "\n";
+    file << "  Warm-up runs: " << config_.warmup_runs << "\n";
+    file << "  Repetitions per trial: " << config_.repetitions << "\n";
     file << "  Grid sizes: ";
     for (size_t i = 0; i < config_.grid_sizes.size(); i++) {
         file << config_.grid_sizes[i];
         if (i < config_.grid_sizes.size() - 1) file << ", ";
     }
     file << "\n";
-    file << "  Obstacle density: " << config_.obstacle_density << "\n\n";
+    file << "  Obstacle density: " << config_.obstacle_density << "\n";
+    file << "  Seed: " << config_.seed << "\n\n";
     
     file << "Results:\n";
+    file << "Times are medians over all timed runs; p90/p99 are tail latencies.\n";
     file << "-------------------------------------------------\n";
     file << std::left << std::setw(30) << "Test Name" 
          << std::setw(10) << "Algorithm" 
          << std::setw(10) << "Grid" 
          << std::setw(12) << "Time (ms)" 
+         << std::setw(12) << "p90 (ms)" 
+         << std::setw(12) << "p99 (ms)" 
          << std::setw(12) << "Nodes" 
-         << std::setw(12) << "Cost" << "\n";
+         << std::setw(12) << "Cost" 
+         << std::setw(10) << "Success" << "\n";
     file << "-------------------------------------------------\n";
     
     for (const auto& result : results_) {
@@ -330,8 +841,11 @@ void BenchmarkSuite::generateReport(const std::string& filename) {
              << std::setw(10) << result.algorithm
              << std::setw(10) << result.grid_size
              << std::setw(12) << std::fixed << std::setprecision(2) << result.time_ms
+             << std::setw(12) << result.time_stats.p90
+             << std::setw(12) << result.time_stats.p99
              << std::setw(12) << result.nodes_expanded
-             << std::setw(12) << std::fixed << std::setprecision(2) << result.path_cost << "\n";
+             << std::setw(12) << std::fixed << std::setprecision(2) << result.path_cost
+             << std::setw(10) << std::setprecision(0) << result.success_rate * 100.0 << "%" << "\n";
     }
     
     file << "\n";
@@ -343,7 +857,8 @@ void BenchmarkSuite::generateReport(const std::string& filename) {
 void BenchmarkSuite::generateCSV(const std::string& filename) {
     std::ofstream file(filename);
     
-    file << "TestName,Algorithm,GridSize,TimeMs,NodesExpanded,PathCost,Success\n";
+    file << "TestName,Algorithm,GridSize,TimeMs,NodesExpanded,PathCost,Success,"
+            "Runs,SuccessRate,MedianCILowMs,MedianCIHighMs,P90Ms,P99Ms,NodesPerSec\n";
     
     for (const auto& result : results_) {
         file << result.test_name << ","
@@ -352,13 +867,167 @@ void BenchmarkSuite::generateCSV(const std::string& filename) {
              << std::fixed << std::setprecision(4) << result.time_ms << ","
              << result.nodes_expanded << ","
              << std::fixed << std::setprecision(4) << result.path_cost << ","
-             << (result.success ? "1" : "0") << "\n";
+             << (result.success ? "1" : "0") << ","
+             << result.iterations << ","
+             << result.success_rate << ","
+             << result.time_stats.median_ci_low << ","
+             << result.time_stats.median_ci_high << ","
+             << result.time_stats.p90 << ","
+             << result.time_stats.p99 << ","
+             << std::setprecision(0) << result.nodes_per_second.median << "\n";
     }
     
     file.close();
     std::cout << "CSV saved to: " << filename << std::endl;
 }
 
+bool BenchmarkSuite::generateJSON(const std::string& filename) const {
+    std::ofstream file(filename);
+    if (!file) return false;
+    
+    file << std::setprecision(9);
+    file << "{\n  \"config\": {\"seed\": " << config_.seed
+         << ", \"num_trials\": " << config_.num_trials
+         << ", \"warmup_runs\": " << config_.warmup_runs
+         << ", \"repetitions\": " << config_.repetitions
+         << ", \"confidence\": " << config_.confidence
+         << ", \"obstacle_density\": " << config_.obstacle_density
+         << ", \"grid_sizes\": [";
+    for (size_t i = 0; i < config_.grid_sizes.size(); i++) {
+        file << (i ? ", " : "") << config_.grid_sizes[i];
+    }
+    file << "]},\n  \"results\": [";
+    
+    for (size_t i = 0; i < results_.size(); i++) {
+        const BenchmarkResult& result = results_[i];
+        file << (i ? ",\n" : "\n")
+             << "    {\"test_name\": \"" << jsonEscape(result.test_name) << "\""
+             << ", \"algorithm\": \"" << jsonEscape(result.algorithm) << "\""
+             << ", \"grid_size\": " << result.grid_size
+             << ", \"runs\": " << result.iterations
+             << ", \"success_rate\": " << result.success_rate
+             << ", \"nodes_expanded\": " << result.nodes_expanded
+             << ", \"path_cost\": " << result.path_cost
+             << ",\n     \"time_ms\": ";
+        writeStats(file, result.time_stats);
+        file << ",\n     \"nodes_per_second\": ";
+        writeStats(file, result.nodes_per_second);
+        file << "}";
+    }
+    file << "\n  ],\n  \"scenario_buckets\": [";
+    
+    for (size_t i = 0; i < scenario_results_.size(); i++) {
+        const ScenarioBucketResult& bucket = scenario_results_[i];
+        file << (i ? ",\n" : "\n")
+             << "    {\"map\": \"" << jsonEscape(bucket.map_name) << "\""
+             << ", \"planner\": \"" << jsonEscape(bucket.planner) << "\""
+             << ", \"bucket\": " << bucket.bucket
+             << ", \"scenarios\": " << bucket.scenarios
+             << ", \"solved\": " << bucket.solved
+             << ", \"total_time_ms\": " << bucket.total_time_ms
+             << ", \"mean_time_ms\": " << bucket.mean_time_ms
+             << ", \"mean_optimality\": " << bucket.mean_optimality
+             << ", \"max_optimality\": " << bucket.max_optimality << "}";
+    }
+    file << "\n  ]\n}\n";
+    
+    file.close();
+    std::cout << "JSON saved to: " << filename << std::endl;
+    return static_cast<bool>(file);
+}
+
+bool BenchmarkSuite::generateScenarioCSV(const std::string& filename) const {
+    std::ofstream file(filename);
+    if (!file) return false;
+    
+    file << "Map,Planner,Bucket,Scenarios,Solved,TotalTimeMs,MeanTimeMs,MeanOptimality,MaxOptimality\n";
+    for (const auto& bucket : scenario_results_) {
+        file << bucket.map_name << ","
+             << bucket.planner << ","
+             << bucket.bucket << ","
+             << bucket.scenarios << ","
+             << bucket.solved << ","
+             << std::fixed << std::setprecision(4) << bucket.total_time_ms << ","
+             << bucket.mean_time_ms << ","
+             << bucket.mean_optimality << ","
+             << bucket.max_optimality << "\n";
+    }
+    
+    file.close();
+    std::cout << "Scenario CSV saved to: " << filename << std::endl;
+    return static_cast<bool>(file);
+}
+
+bool BenchmarkSuite::loadJSON(const std::string& filename, std::vector<BenchmarkResult>& results) {
+    std::ifstream file(filename);
+    if (!file) return false;
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    std::string text = buffer.str();
+    
+    JsonValue root;
+    if (!JsonParser(text).parse(root) || root.type != JsonValue::OBJECT) return false;
+    const JsonValue* entries = root.find("results");
+    if (!entries || entries->type != JsonValue::ARRAY) return false;
+    
+    results.clear();
+    for (const JsonValue& entry : entries->items) {
+        BenchmarkResult result(entry.textAt("test_name"), entry.textAt("algorithm"));
+        if (result.test_name.empty()) return false;
+        result.grid_size = static_cast<int>(entry.numberAt("grid_size"));
+        result.iterations = static_cast<int>(entry.numberAt("runs"));
+        result.success_rate = entry.numberAt("success_rate");
+        result.success = result.success_rate > 0.0;
+        result.nodes_expanded = static_cast<int>(entry.numberAt("nodes_expanded"));
+        result.path_cost = static_cast<float>(entry.numberAt("path_cost"));
+        if (!readStats(entry.find("time_ms"), result.time_stats) ||
+            !readStats(entry.find("nodes_per_second"), result.nodes_per_second)) {
+            return false;
+        }
+        result.time_ms = result.time_stats.median;
+        results.push_back(result);
+    }
+    return true;
+}
+
+std::vector<BenchmarkComparison> BenchmarkSuite::compare(const std::vector<BenchmarkResult>& baseline,
+                                                         const std::vector<BenchmarkResult>& current,
+                                                         double threshold) {
+    std::vector<BenchmarkComparison> comparisons;
+    
+    for (const auto& base : baseline) {
+        BenchmarkComparison comparison;
+        comparison.test_name = base.test_name;
+        comparison.baseline_ms = base.time_stats.median;
+        
+        auto it = std::find_if(current.begin(), current.end(),
+                               [&](const BenchmarkResult& r) { return r.test_name == base.test_name; });
+        if (it == current.end()) {
+            comparisons.push_back(comparison);
+            continue;
+        }
+        
+        const BenchmarkStats& before = base.time_stats;
+        const BenchmarkStats& after = it->time_stats;
+        comparison.current_ms = after.median;
+        comparison.change = before.median > 0.0 ? after.median / before.median - 1.0 : 0.0;
+        
+        // A shift only counts when it is both large and outside the noise
+        if (std::abs(comparison.change) < threshold) {
+            comparison.verdict = BenchmarkVerdict::UNCHANGED;
+        } else if (comparison.change > 0.0) {
+            comparison.verdict = after.median_ci_low > before.median_ci_high ?
+                BenchmarkVerdict::REGRESSED : BenchmarkVerdict::INCONCLUSIVE;
+        } else {
+            comparison.verdict = after.median_ci_high < before.median_ci_low ?
+                BenchmarkVerdict::IMPROVED : BenchmarkVerdict::INCONCLUSIVE;
+        }
+        comparisons.push_back(comparison);
+    }
+    
+    return comparisons;
+}
+
 // PerformanceMetrics implementation
 
 double PerformanceMetrics::calculateThroughput(int nodes, double time_ms) {
@@ -384,7 +1053,7 @@ void PerformanceMetrics::printSummary(const std::vector<BenchmarkResult>& result
     std::cout << "\n=== Performance Summary ===\n\n";
     
     // Group by algorithm
-    std::vector<std::string> algorithms = {"A*", "RRT", "RRT*"};
+    std::vector<std::string> algorithms = {"A*", "RRT", "RRT*", "RRT-Connect"};
     
     for (const auto& algo : algorithms) {
         std::vector<BenchmarkResult> algo_results;
@@ -0,0 +1,279 @@
+#include "benchmark/scenario_corpus.h"
+#include "core/random.h"
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <queue>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+bool isPassableTerrain(char c) {
+    return c == '.' || c == 'G' || c == 'S';
+}
+
+bool isKnownTerrain(char c) {
+    return isPassableTerrain(c) || c == '@' || c == 'O' || c == 'T' || c == 'W';
+}
+
+void stripCarriageReturn(std::string& line) {
+    if (!line.empty() && line.back() == '\r') line.pop_back();
+}
+
+std::string directoryOf(const std::string& path) {
+    size_t slash = path.find_last_of("/\\");
+    return slash == std::string::npos ? std::string() : path.substr(0, slash + 1);
+}
+
+std::string baseName(const std::string& path) {
+    size_t slash = path.find_last_of("/\\");
+    return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+bool fileExists(const std::string& path) {
+    return static_cast<bool>(std::ifstream(path));
+}
+
+}  // namespace
+
+// ============================================================================
+// Maps
+// ============================================================================
+
+MapLoadResult MovingAI::loadMap(const std::string& path) {
+    MapLoadResult result;
+    std::ifstream in(path);
+    if (!in) {
+        result.error = "cannot open " + path;
+        return result;
+    }
+    
+    int width = -1, height = -1;
+    std::string line;
+    bool in_map = false;
+    while (!in_map && std::getline(in, line)) {
+        stripCarriageReturn(line);
+        std::istringstream fields(line);
+        std::string key;
+        if (!(fields >> key)) continue;
+        if (key == "map") {
+            in_map = true;
+        } else if (key == "width") {
+            fields >> width;
+        } else if (key == "height") {
+            fields >> height;
+        } else if (key == "type") {
+            // Only octile maps are published; the type does not change the cells
+        } else {
+            result.error = "unexpected header line: " + line;
+            return result;
+        }
+    }
+    if (!in_map || width <= 0 || height <= 0) {
+        result.error = "missing width, height or map header";
+        return result;
+    }
+    
+    // Rows are read and checked before the grid exists, so the header alone
+    // cannot make us allocate more than the file holds
+    std::vector<std::string> rows;
+    for (int y = 0; y < height; y++) {
+        if (!std::getline(in, line)) {
+            result.error = "map ends after " + std::to_string(y) + " of " + std::to_string(height) + " rows";
+            return result;
+        }
+        stripCarriageReturn(line);
+        if (static_cast<int>(line.size()) < width) {
+            result.error = "row " + std::to_string(y) + " is shorter than the width";
+            return result;
+        }
+        for (int x = 0; x < width; x++) {
+            if (!isKnownTerrain(line[x])) {
+                result.error = std::string("unknown terrain '") + line[x] + "' in row " + std::to_string(y);
+                return result;
+            }
+        }
+        line.resize(width);
+        rows.push_back(std::move(line));
+    }
+    
+    auto grid = std::make_unique<Grid>(width, height);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            if (!isPassableTerrain(rows[y][x])) grid->setObstacle(x, y, true);
+        }
+    }
+    
+    result.info.width = width;
+    result.info.height = height;
+    result.grid = std::move(grid);
+    result.success = true;
+    return result;
+}
+
+bool MovingAI::saveMap(const Grid& grid, const std::string& path) {
+    std::ofstream out(path);
+    if (!out) return false;
+    
+    out << "type octile\nheight " << grid.getHeight() << "\nwidth " << grid.getWidth() << "\nmap\n";
+    std::string row(grid.getWidth(), '.');
+    for (int y = 0; y < grid.getHeight(); y++) {
+        for (int x = 0; x < grid.getWidth(); x++) row[x] = grid.isObstacle(x, y) ? '@' : '.';
+        out << row << '\n';
+    }
+    return static_cast<bool>(out);
+}
+
+// ============================================================================
+// Scenarios
+// ============================================================================
+
+ScenarioLoadResult MovingAI::loadScenarios(const std::string& path) {
+    ScenarioLoadResult result;
+    std::ifstream in(path);
+    if (!in) {
+        result.error = "cannot open " + path;
+        return result;
+    }
+    
+    std::string line;
+    int line_number = 0;
+    while (std::getline(in, line)) {
+        line_number++;
+        stripCarriageReturn(line);
+        std::istringstream fields(line);
+        std::string first;
+        if (!(fields >> first)) continue;
+        if (first == "version") continue;  // "version 1" or "version 1.0"
+        
+        Scenario scenario;
+        std::istringstream row(line);
+        if (!(row >> scenario.bucket >> scenario.map_name >> scenario.map_width >> scenario.map_height
+                  >> scenario.start.x >> scenario.start.y >> scenario.goal.x >> scenario.goal.y
+                  >> scenario.optimal_length)) {
+            result.error = "malformed scenario on line " + std::to_string(line_number);
+            return result;
+        }
+        result.scenarios.push_back(scenario);
+    }
+    
+    result.success = true;
+    return result;
+}
+
+bool MovingAI::saveScenarios(const std::vector<Scenario>& scenarios, const std::string& path) {
+    std::ofstream out(path);
+    if (!out) return false;
+    
+    out << "version 1\n" << std::fixed << std::setprecision(8);
+    for (const Scenario& s : scenarios) {
+        out << s.bucket << '\t' << s.map_name << '\t' << s.map_width << '\t' << s.map_height << '\t'
+            << s.start.x << '\t' << s.start.y << '\t' << s.goal.x << '\t' << s.goal.y << '\t'
+            << s.optimal_length << '\n';
+    }
+    return static_cast<bool>(out);
+}
+
+std::vector<Scenario> MovingAI::generateScenarios(const Grid& grid, const std::string& map_name,
+                                                  const ScenarioGenerationOptions& options) {
+    std::vector<Scenario> scenarios;
+    RandomStream rng(options.seed);
+    const int width = grid.getWidth();
+    const int height = grid.getHeight();
+    if (width <= 0 || height <= 0) return scenarios;
+    
+    auto randomFreeCell = [&](Vec2i& cell) {
+        for (int tries = 0; tries < 64; tries++) {
+            cell = Vec2i(static_cast<int>(rng() % width), static_cast<int>(rng() % height));
+            if (!grid.isObstacle(cell.x, cell.y)) return true;
+        }
+        return false;
+    };
+    
+    for (int attempt = 0; attempt < options.max_attempts && static_cast<int>(scenarios.size()) < options.count; attempt++) {
+        Scenario scenario;
+        if (!randomFreeCell(scenario.start) || !randomFreeCell(scenario.goal)) continue;
+        if (scenario.start == scenario.goal) continue;
+        
+        double length = shortestPathLength(grid, scenario.start, scenario.goal, true);
+        if (length < 0.0) continue;
+        
+        scenario.bucket = static_cast<int>(length / options.bucket_width);
+        scenario.map_name = map_name;
+        scenario.map_width = width;
+        scenario.map_height = height;
+        scenario.optimal_length = length;
+        scenarios.push_back(scenario);
+    }
+    
+    // Corpus files list scenarios by bucket
+    std::stable_sort(scenarios.begin(), scenarios.end(),
+                     [](const Scenario& a, const Scenario& b) { return a.bucket < b.bucket; });
+    return scenarios;
+}
+
+double MovingAI::shortestPathLength(const Grid& grid, Vec2i start, Vec2i goal, bool diagonal) {
+    const int width = grid.getWidth();
+    const int height = grid.getHeight();
+    if (grid.isObstacle(start.x, start.y) || grid.isObstacle(goal.x, goal.y)) return -1.0;
+    
+    const double kDiagonal = std::sqrt(2.0);
+    const int dx[] = {0, 0, -1, 1, -1, 1, -1, 1};
+    const int dy[] = {-1, 1, 0, 0, -1, -1, 1, 1};
+    const int directions = diagonal ? 8 : 4;
+    
+    std::vector<double> dist(static_cast<size_t>(width) * height, std::numeric_limits<double>::infinity());
+    using Entry = std::pair<double, int>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+    
+    int start_index = start.y * width + start.x;
+    int goal_index = goal.y * width + goal.x;
+    dist[start_index] = 0.0;
+    open.push({0.0, start_index});
+    
+    while (!open.empty()) {
+        Entry top = open.top();
+        open.pop();
+        if (top.first > dist[top.second]) continue;
+        if (top.second == goal_index) return top.first;
+        
+        int x = top.second % width;
+        int y = top.second / width;
+        for (int i = 0; i < directions; i++) {
+            int nx = x + dx[i];
+            int ny = y + dy[i];
+            if (grid.isObstacle(nx, ny)) continue;
+            // No corner cutting: both orthogonal cells must be free
+            if (i >= 4 && (grid.isObstacle(nx, y) || grid.isObstacle(x, ny))) continue;
+            
+            double next = top.first + (i >= 4 ? kDiagonal : 1.0);
+            int index = ny * width + nx;
+            if (next < dist[index]) {
+                dist[index] = next;
+                open.push({next, index});
+            }
+        }
+    }
+    return -1.0;
+}
+
+std::string MovingAI::resolveMapPath(const std::string& scen_path, const std::string& map_name,
+                                     const std::string& maps_dir) {
+    std::vector<std::string> candidates;
+    if (!maps_dir.empty()) {
+        std::string dir = maps_dir;
+        if (dir.back() != '/' && dir.back() != '\\') dir += '/';
+        candidates.push_back(dir + map_name);
+        candidates.push_back(dir + baseName(map_name));
+    }
+    candidates.push_back(directoryOf(scen_path) + map_name);
+    candidates.push_back(directoryOf(scen_path) + baseName(map_name));
+    candidates.push_back(map_name);
+    
+    for (const auto& candidate : candidates) {
+        if (fileExists(candidate)) return candidate;
+    }
+    return candidates.front();
+}
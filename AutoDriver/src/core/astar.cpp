@@ -1,12 +1,115 @@
 #include "core/astar.h"
+#include "core/instrumentation.h"
 #include <queue>
 #include <unordered_map>
 #include <algorithm>
 #include <cmath>
 
-AStar::AStar(const Grid& grid) : grid_(grid) {}
+namespace {
+
+struct OpenEntry {
+    float f;
+    float g;
+    Vec2i pos;
+    
+    bool operator>(const OpenEntry& other) const { return f > other.f; }
+};
+
+// Straight-line distance to the goal, raised to the landmark bound when a table is attached
+struct GoalHeuristic {
+    const LandmarkTable* landmarks;
+    const uint16_t* goal_row;
+    Vec2i goal;
+    
+    GoalHeuristic(const LandmarkTable* table, Vec2i goal_cell)
+        : landmarks(table), goal_row(table ? table->distancesAt(goal_cell.x, goal_cell.y) : nullptr),
+          goal(goal_cell) {}
+    
+    float operator()(Vec2i p) const {
+        float h = AStar::euclideanDistance(p, goal);
+        if (!landmarks) return h;
+        return std::max(h, landmarks->lowerBound(landmarks->distancesAt(p.x, p.y), goal_row));
+    }
+};
+
+// 4-connected A* with lazy deletion over any passability/step-cost/heuristic set
+template<typename Passable, typename StepCost, typename Heuristic>
+bool gridSearch(Vec2i start, Vec2i goal, Passable passable, StepCost step_cost, Heuristic heuristic,
+                std::vector<Vec2i>& path, float& path_cost, int& expanded,
+                const SearchCapture& capture, std::vector<Vec2i>& visited) {
+    std::priority_queue<OpenEntry, std::vector<OpenEntry>, std::greater<OpenEntry>> open_set;
+    std::unordered_map<Vec2i, float, Vec2iHash> g_cost;
+    std::unordered_map<Vec2i, Vec2i, Vec2iHash> parent;
+    std::unordered_set<Vec2i, Vec2iHash> closed_set;
+    
+    g_cost[start] = 0.0f;
+    open_set.push({heuristic(start), 0.0f, start});
+    
+    const int dx[] = {0, 0, -1, 1};
+    const int dy[] = {-1, 1, 0, 0};
+    
+    while (!open_set.empty()) {
+        OpenEntry current;
+        {
+            AUTODRIVER_SCOPE(ASTAR_HEAP_POP);
+            current = open_set.top();
+            open_set.pop();
+        }
+        if (!closed_set.insert(current.pos).second) continue;
+        expanded++;
+        AUTODRIVER_COUNT(ASTAR_EXPAND);
+        if (capture.results) visited.push_back(current.pos);
+        capture.emit(SearchEventType::VISITED, current.pos);
+        
+        if (current.pos == goal) {
+            path_cost = current.g;
+            path.clear();
+            for (Vec2i p = goal; ; p = parent[p]) {
+                path.push_back(p);
+                if (p == start) break;
+            }
+            std::reverse(path.begin(), path.end());
+            return true;
+        }
+        
+        for (int i = 0; i < 4; i++) {
+            Vec2i next(current.pos.x + dx[i], current.pos.y + dy[i]);
+            if (closed_set.count(next) || !passable(next)) continue;
+            
+            float g = current.g + step_cost(next);
+            auto it = g_cost.find(next);
+            if (it != g_cost.end() && it->second <= g) continue;
+            g_cost[next] = g;
+            parent[next] = current.pos;
+            AUTODRIVER_SCOPE(ASTAR_HEAP_PUSH);
+            open_set.push({g + heuristic(next), g, next});
+        }
+    }
+    return false;
+}
+
+}  // namespace
+
+AStar::AStar(const Grid& grid)
+    : grid_(grid), costs_(nullptr), landmarks_(nullptr),
+      checked_landmarks_(nullptr), checked_hash_(0), checked_version_(0), landmarks_match_(false) {}
+
+const LandmarkTable* AStar::activeLandmarks() const {
+    if (!landmarks_) return nullptr;
+    
+    // matches() hashes the whole grid, so only recheck after an edit or a new table
+    if (landmarks_ != checked_landmarks_ || landmarks_->getGridHash() != checked_hash_ ||
+        grid_.getVersion() != checked_version_) {
+        checked_landmarks_ = landmarks_;
+        checked_hash_ = landmarks_->getGridHash();
+        checked_version_ = grid_.getVersion();
+        landmarks_match_ = landmarks_->matches(grid_);
+    }
+    return landmarks_match_ ? landmarks_ : nullptr;
+}
 
 AStarResult AStar::findPath(Vec2i start, Vec2i goal) {
+    AUTODRIVER_SCOPE(ASTAR_SEARCH);
     AStarResult result;
     
     // Validate start and goal
@@ -15,6 +118,12 @@ AStarResult AStar::findPath(Vec2i start, Vec2i goal) {
         return result;  // Invalid positions
     }
     
+    if (costs_ && !costs_->isUniform()) {
+        return findPathWeighted(start, goal);
+    }
+    
+    GoalHeuristic heuristic(activeLandmarks(), goal);
+    
     // Priority queue for open set (min-heap by f_cost)
     auto cmp = [](Node* a, Node* b) { return *a > *b; };
     std::priority_queue<Node*, std::vector<Node*>, decltype(cmp)> open_set(cmp);
@@ -32,7 +141,7 @@ AStarResult AStar::findPath(Vec2i start, Vec2i goal) {
     auto start_node = std::make_unique<Node>(
         start, 
         0.0f, 
-        euclideanDistance(start, goal),
+        heuristic(start),
         nullptr
     );
     Node* start_ptr = start_node.get();
@@ -43,8 +152,12 @@ AStarResult AStar::findPath(Vec2i start, Vec2i goal) {
     Node* goal_node = nullptr;
     
     while (!open_set.empty()) {
-        Node* current = open_set.top();
-        open_set.pop();
+        Node* current;
+        {
+            AUTODRIVER_SCOPE(ASTAR_HEAP_POP);
+            current = open_set.top();
+            open_set.pop();
+        }
         
         // Skip if already visited
         if (closed_set.count(current->pos)) {
@@ -53,8 +166,10 @@ AStarResult AStar::findPath(Vec2i start, Vec2i goal) {
         
         // Mark as visited
         closed_set.insert(current->pos);
-        result.visited.push_back(current->pos);
+        if (capture_.results) result.visited.push_back(current->pos);
+        capture_.emit(SearchEventType::VISITED, current->pos);
         result.nodes_expanded++;
+        AUTODRIVER_COUNT(ASTAR_EXPAND);
         
         // Check if we reached the goal
         if (current->pos == goal) {
@@ -73,27 +188,31 @@ AStarResult AStar::findPath(Vec2i start, Vec2i goal) {
             // Calculate costs
             float tentative_g = current->g_cost + 1.0f;  // Uniform cost
             
-            // Check if we already have this neighbor in open set
+            // Skip unless this is the first or a better path to the neighbor
             auto it = node_map.find(neighbor_pos);
-            if (it != node_map.end()) {
-                // Update if we found a better path
-                if (tentative_g < it->second->g_cost) {
-                    it->second->g_cost = tentative_g;
-                    it->second->parent = current;
-                }
-            } else {
-                // Create new node
-                auto neighbor_node = std::make_unique<Node>(
-                    neighbor_pos,
-                    tentative_g,
-                    euclideanDistance(neighbor_pos, goal),
-                    current
-                );
-                Node* neighbor_ptr = neighbor_node.get();
-                node_map[neighbor_pos] = neighbor_ptr;
+            bool discovered = it == node_map.end();
+            if (!discovered && tentative_g >= it->second->g_cost) {
+                continue;
+            }
+            
+            // A better path gets a fresh entry rather than mutating one already in
+            // the heap; the stale entry is skipped once the position is closed
+            auto neighbor_node = std::make_unique<Node>(
+                neighbor_pos,
+                tentative_g,
+                heuristic(neighbor_pos),
+                current
+            );
+            Node* neighbor_ptr = neighbor_node.get();
+            node_map[neighbor_pos] = neighbor_ptr;
+            {
+                AUTODRIVER_SCOPE(ASTAR_HEAP_PUSH);
                 open_set.push(neighbor_ptr);
-                all_nodes.push_back(std::move(neighbor_node));
-                result.explored.push_back(neighbor_pos);
+            }
+            all_nodes.push_back(std::move(neighbor_node));
+            if (discovered) {
+                if (capture_.results) result.explored.push_back(neighbor_pos);
+                capture_.emit(SearchEventType::EXPLORED, neighbor_pos);
             }
         }
     }
@@ -106,7 +225,88 @@ AStarResult AStar::findPath(Vec2i start, Vec2i goal) {
     return result;
 }
 
+AStarResult AStar::findPathCoarseToFine(Vec2i start, Vec2i goal, const CoarseToFineOptions& options) {
+    AUTODRIVER_SCOPE(ASTAR_SEARCH);
+    AStarResult result;
+    
+    if (!grid_.isValid(start.x, start.y) || grid_.isObstacle(start.x, start.y) ||
+        !grid_.isValid(goal.x, goal.y) || grid_.isObstacle(goal.x, goal.y)) {
+        return result;
+    }
+    
+    const int level = std::max(0, std::min(options.level, static_cast<int>(Grid::kMaxPyramidLevels)));
+    
+    // Coarse pass: a coarse path exists whenever a fine one does, so failing
+    // here proves the goal unreachable
+    auto coarsePassable = [&](Vec2i c) {
+        return grid_.getOccupancy(level, c.x, c.y) < 1.0f;
+    };
+    auto coarseCost = [&](Vec2i c) {
+        return 1.0f + options.occupancy_weight * grid_.getOccupancy(level, c.x, c.y);
+    };
+    std::vector<Vec2i> coarse_path;
+    std::vector<Vec2i> coarse_visited;   // Stays empty: coarse cells are not captured
+    float coarse_cost = 0.0f;
+    const Vec2i coarse_goal(goal.x >> level, goal.y >> level);
+    auto coarseHeuristic = [coarse_goal](Vec2i c) {
+        return euclideanDistance(c, coarse_goal);
+    };
+    bool coarse_found = gridSearch(Vec2i(start.x >> level, start.y >> level), coarse_goal,
+                                   coarsePassable, coarseCost, coarseHeuristic, coarse_path, coarse_cost,
+                                   result.coarse_nodes_expanded, SearchCapture(), coarse_visited);
+    result.nodes_expanded = result.coarse_nodes_expanded;
+    if (!coarse_found) return result;
+    
+    // Fine pass inside the corridor around the coarse path
+    std::unordered_set<Vec2i, Vec2iHash> corridor;
+    for (const Vec2i& c : coarse_path) {
+        for (int oy = -options.corridor_margin; oy <= options.corridor_margin; oy++) {
+            for (int ox = -options.corridor_margin; ox <= options.corridor_margin; ox++) {
+                corridor.insert(Vec2i(c.x + ox, c.y + oy));
+            }
+        }
+    }
+    auto freeCell = [&](Vec2i p) {
+        return grid_.isValid(p.x, p.y) && !grid_.isObstacle(p.x, p.y);
+    };
+    auto inCorridor = [&](Vec2i p) {
+        return freeCell(p) && corridor.count(Vec2i(p.x >> level, p.y >> level)) > 0;
+    };
+    const CostMap* costs = costs_ && !costs_->isUniform() ? costs_ : nullptr;
+    auto stepCost = [costs](Vec2i p) {
+        return costs ? 1.0f + costs->getCost(p.x, p.y) : 1.0f;
+    };
+    GoalHeuristic heuristic(activeLandmarks(), goal);   // A corridor only lengthens paths
+    
+    result.success = gridSearch(start, goal, inCorridor, stepCost, heuristic, result.path, result.path_cost,
+                                result.nodes_expanded, capture_, result.visited);
+    if (!result.success) {
+        result.visited.clear();
+        result.success = gridSearch(start, goal, freeCell, stepCost, heuristic, result.path, result.path_cost,
+                                    result.nodes_expanded, capture_, result.visited);
+    }
+    return result;
+}
+
+AStarResult AStar::findPathWeighted(Vec2i start, Vec2i goal) const {
+    AStarResult result;
+    const CostMap& costs = *costs_;
+    
+    // Every step costs at least 1, so both the Euclidean and landmark bounds stay admissible
+    auto freeCell = [&](Vec2i p) {
+        return grid_.isValid(p.x, p.y) && !grid_.isObstacle(p.x, p.y);
+    };
+    auto stepCost = [&](Vec2i p) {
+        return 1.0f + costs.getCost(p.x, p.y);
+    };
+    GoalHeuristic heuristic(activeLandmarks(), goal);
+    result.success = gridSearch(start, goal, freeCell, stepCost, heuristic, result.path, result.path_cost,
+                                result.nodes_expanded, capture_, result.visited);
+    return result;
+}
+
 std::vector<Vec2i> AStar::getNeighbors(Vec2i pos) const {
+    AUTODRIVER_SCOPE(ASTAR_NEIGHBORS);
     std::vector<Vec2i> neighbors;
     
     // 4-directional movement (up, down, left, right)
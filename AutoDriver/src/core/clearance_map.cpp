@@ -0,0 +1,195 @@
+#include "core/clearance_map.h"
+#include "core/worker_pool.h"
+#include <cmath>
+#include <algorithm>
+#include <thread>
+
+// ============================================================================
+// Distance Transform
+// ============================================================================
+
+namespace {
+
+const float kFar = 1e20f;
+
+// 1D squared-distance transform (Felzenszwalb & Huttenlocher): lower envelope
+// of parabolas rooted at every sample. f and d may not alias.
+void distanceTransform1D(const float* f, float* d, int n,
+                         std::vector<int>& v, std::vector<float>& z) {
+    v.resize(n);
+    z.resize(n + 1);
+    
+    int k = 0;
+    v[0] = 0;
+    z[0] = -kFar;
+    z[1] = kFar;
+    
+    for (int q = 1; q < n; q++) {
+        float s;
+        while (true) {
+            int p = v[k];
+            s = ((f[q] + static_cast<float>(q) * q) - (f[p] + static_cast<float>(p) * p)) / (2.0f * (q - p));
+            if (s > z[k]) break;
+            k--;
+        }
+        k++;
+        v[k] = q;
+        z[k] = s;
+        z[k + 1] = kFar;
+    }
+    
+    k = 0;
+    for (int q = 0; q < n; q++) {
+        while (z[k + 1] < q) k++;
+        float dq = static_cast<float>(q - v[k]);
+        d[q] = dq * dq + f[v[k]];
+    }
+}
+
+}  // namespace
+
+// ============================================================================
+// ClearanceMap Implementation
+// ============================================================================
+
+ClearanceMap::ClearanceMap(const Grid& grid, float max_distance, int num_threads)
+    : ClearanceMap(grid, 0, 0, grid.getWidth() - 1, grid.getHeight() - 1, max_distance, num_threads) {
+}
+
+ClearanceMap::ClearanceMap(const Grid& grid, int min_x, int min_y, int max_x, int max_y,
+                           float max_distance, int num_threads)
+    : max_distance_(max_distance) {
+    
+    // Obstacles farther than max_distance from the area do not matter; one
+    // ring of out-of-grid cells is enough to represent the border
+    int margin = static_cast<int>(std::ceil(max_distance)) + 1;
+    int x0 = std::max(min_x - margin, -1);
+    int y0 = std::max(min_y - margin, -1);
+    int x1 = std::min(max_x + margin, grid.getWidth());
+    int y1 = std::min(max_y + margin, grid.getHeight());
+    
+    origin_x_ = x0;
+    origin_y_ = y0;
+    width_ = std::max(0, x1 - x0 + 1);
+    height_ = std::max(0, y1 - y0 + 1);
+    
+    build(grid, num_threads);
+}
+
+void ClearanceMap::build(const Grid& grid, int num_threads) {
+    dist_.assign(static_cast<size_t>(width_) * height_, kFar);
+    if (dist_.empty()) return;
+    
+    for (int y = 0; y < height_; y++) {
+        for (int x = 0; x < width_; x++) {
+            if (grid.isObstacle(origin_x_ + x, origin_y_ + y)) {
+                dist_[y * width_ + x] = 0.0f;
+            }
+        }
+    }
+    
+    if (num_threads <= 0) num_threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    
+    // Runs pass(line, f, d, v, z) for every line, spread over the workers
+    // in chunks; each worker owns its scratch buffers
+    struct Scratch {
+        std::vector<float> f, d, z;
+        std::vector<int> v;
+    };
+    std::vector<Scratch> scratch(num_threads);
+    auto forEachLine = [&](int lines, auto pass) {
+        parallelChunks(lines, num_threads, 16, [&](int worker, int begin, int end) {
+            Scratch& s = scratch[worker];
+            if (s.f.empty()) {
+                s.f.resize(std::max(width_, height_));
+                s.d.resize(std::max(width_, height_));
+            }
+            for (int line = begin; line < end; line++) pass(line, s.f, s.d, s.v, s.z);
+        });
+    };
+    
+    // Rows
+    forEachLine(height_, [&](int y, std::vector<float>& f, std::vector<float>&,
+                             std::vector<int>& v, std::vector<float>& z) {
+        float* row = &dist_[y * width_];
+        std::copy(row, row + width_, f.begin());
+        distanceTransform1D(f.data(), row, width_, v, z);
+    });
+    
+    // Columns, then squared distance -> capped distance
+    const float cap2 = max_distance_ * max_distance_;
+    forEachLine(width_, [&](int x, std::vector<float>& f, std::vector<float>& d,
+                            std::vector<int>& v, std::vector<float>& z) {
+        for (int y = 0; y < height_; y++) f[y] = dist_[y * width_ + x];
+        distanceTransform1D(f.data(), d.data(), height_, v, z);
+        for (int y = 0; y < height_; y++) {
+            dist_[y * width_ + x] = d[y] >= cap2 ? max_distance_ : std::sqrt(d[y]);
+        }
+    });
+    
+    // Obstacles beyond a window edge inside the grid were not seen; stay
+    // conservative by never reporting more than the distance to that edge
+    const bool open_left = origin_x_ > -1;
+    const bool open_bottom = origin_y_ > -1;
+    const bool open_right = origin_x_ + width_ - 1 < grid.getWidth();
+    const bool open_top = origin_y_ + height_ - 1 < grid.getHeight();
+    
+    for (int y = 0; y < height_; y++) {
+        for (int x = 0; x < width_; x++) {
+            float edge = max_distance_;
+            if (open_left) edge = std::min(edge, static_cast<float>(x + 1));
+            if (open_right) edge = std::min(edge, static_cast<float>(width_ - x));
+            if (open_bottom) edge = std::min(edge, static_cast<float>(y + 1));
+            if (open_top) edge = std::min(edge, static_cast<float>(height_ - y));
+            
+            float& cell = dist_[y * width_ + x];
+            cell = std::min(cell, edge);
+        }
+    }
+}
+
+float ClearanceMap::clearance(Vec2 p) const {
+    int cx = static_cast<int>(std::round(p.x));
+    int cy = static_cast<int>(std::round(p.y));
+    
+    float d = at(cx, cy);
+    if (d <= 0.0f) return 0.0f;
+    
+    // A point rounds to an obstacle cell only within half a cell diagonal of
+    // its centre; distance to any obstacle centre is at least d - |p - c|
+    float offset = std::hypot(p.x - cx, p.y - cy);
+    return std::max(0.0f, d - offset - 0.7072f);
+}
+
+Vec2 ClearanceMap::gradient(int x, int y) const {
+    float left = at(x - 1, y), right = at(x + 1, y);
+    float down = at(x, y - 1), up = at(x, y + 1);
+    
+    if (left < 0.0f || right < 0.0f || down < 0.0f || up < 0.0f) {
+        return Vec2(0.0f, 0.0f);
+    }
+    
+    return Vec2(0.5f * (right - left), 0.5f * (up - down));
+}
+
+bool ClearanceMap::sample(Vec2 p, float& distance, Vec2& grad) const {
+    int x0 = static_cast<int>(std::floor(p.x));
+    int y0 = static_cast<int>(std::floor(p.y));
+    float tx = p.x - x0;
+    float ty = p.y - y0;
+    
+    if (!contains(x0 - 1, y0 - 1) || !contains(x0 + 2, y0 + 2)) return false;
+    
+    float w[4] = {(1 - tx) * (1 - ty), tx * (1 - ty), (1 - tx) * ty, tx * ty};
+    int cx[4] = {x0, x0 + 1, x0, x0 + 1};
+    int cy[4] = {y0, y0, y0 + 1, y0 + 1};
+    
+    distance = 0.0f;
+    grad = Vec2(0.0f, 0.0f);
+    for (int k = 0; k < 4; k++) {
+        distance += w[k] * at(cx[k], cy[k]);
+        grad = grad + gradient(cx[k], cy[k]) * w[k];
+    }
+    
+    return true;
+}
@@ -0,0 +1,216 @@
+#include "core/cost_map.h"
+#include "core/clearance_map.h"
+#include "core/worker_pool.h"
+#include <cmath>
+#include <algorithm>
+#include <atomic>
+
+namespace {
+
+const float kCombinedMaxCost = 1000.0f;
+
+// Shared by every CostMap so a version never repeats, even at a reused address
+std::atomic<uint64_t> next_cost_map_version(1);
+
+// Runs body(row) for every row, spread over num_threads workers
+template<typename Body>
+void parallelRows(int rows, int num_threads, Body body) {
+    parallelChunks(rows, num_threads, 16, [&](int, int begin, int end) {
+        for (int row = begin; row < end; row++) body(row);
+    });
+}
+
+}  // namespace
+
+// ============================================================================
+// CostLayer Implementation
+// ============================================================================
+
+CostLayer::CostLayer(int width, int height, CostEncoding encoding, float max_cost)
+    : width_(std::max(0, width)), height_(std::max(0, height)), encoding_(encoding),
+      max_cost_(max_cost), step_(max_cost / 255.0f), nonzero_(0) {
+    
+    size_t cells = static_cast<size_t>(width_) * height_;
+    if (encoding_ == CostEncoding::UINT8) {
+        bytes_.assign(cells, 0);
+    } else {
+        halves_.assign(cells, 0);
+    }
+}
+
+void CostLayer::store(size_t i, float cost) {
+    cost = std::max(0.0f, std::min(cost, max_cost_));
+    if (encoding_ == CostEncoding::UINT8) {
+        bytes_[i] = static_cast<uint8_t>(std::lround(cost / step_));
+    } else {
+        halves_[i] = floatToHalf(cost);
+    }
+}
+
+void CostLayer::set(int x, int y, float cost) {
+    if (x < 0 || y < 0 || x >= width_ || y >= height_) return;
+    size_t i = static_cast<size_t>(y) * width_ + x;
+    
+    bool was_zero = get(x, y) == 0.0f;
+    store(i, cost);
+    bool is_zero = get(x, y) == 0.0f;
+    if (was_zero && !is_zero) nonzero_++;
+    if (!was_zero && is_zero) nonzero_--;
+}
+
+void CostLayer::fill(float cost) {
+    if (width_ == 0 || height_ == 0) return;
+    store(0, cost);
+    if (encoding_ == CostEncoding::UINT8) {
+        std::fill(bytes_.begin(), bytes_.end(), bytes_[0]);
+    } else {
+        std::fill(halves_.begin(), halves_.end(), halves_[0]);
+    }
+    recount();
+}
+
+void CostLayer::recount() {
+    if (encoding_ == CostEncoding::UINT8) {
+        nonzero_ = bytes_.size() - std::count(bytes_.begin(), bytes_.end(), 0);
+    } else {
+        // +0 and -0 both encode zero cost; store() never produces -0
+        nonzero_ = halves_.size() - std::count(halves_.begin(), halves_.end(), 0);
+    }
+}
+
+uint16_t CostLayer::floatToHalf(float value) {
+#if defined(__F16C__)
+    return _cvtss_sh(value, 0);  // Round to nearest even
+#else
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    
+    uint32_t sign = (bits >> 16) & 0x8000u;
+    uint32_t raw_exponent = (bits >> 23) & 0xffu;
+    uint32_t mantissa = bits & 0x7fffffu;
+    int exponent = static_cast<int>(raw_exponent) - 127 + 15;
+    
+    if (raw_exponent == 0xffu) return static_cast<uint16_t>(sign | 0x7c00u | (mantissa ? 0x200u : 0u));
+    if (exponent >= 31) return static_cast<uint16_t>(sign | 0x7c00u);
+    
+    if (exponent <= 0) {
+        // Subnormal or underflow
+        if (exponent < -10) return static_cast<uint16_t>(sign);
+        mantissa |= 0x800000u;
+        int shift = 14 - exponent;
+        uint32_t half = mantissa >> shift;
+        uint32_t rest = mantissa & ((1u << shift) - 1);
+        uint32_t halfway = 1u << (shift - 1);
+        if (rest > halfway || (rest == halfway && (half & 1u))) half++;
+        return static_cast<uint16_t>(sign | half);
+    }
+    
+    uint32_t half = sign | (static_cast<uint32_t>(exponent) << 10) | (mantissa >> 13);
+    uint32_t rest = mantissa & 0x1fffu;
+    if (rest > 0x1000u || (rest == 0x1000u && (half & 1u))) half++;  // May carry into the exponent
+    return static_cast<uint16_t>(half);
+#endif
+}
+
+// ============================================================================
+// CostMap Implementation
+// ============================================================================
+
+CostMap::CostMap(int width, int height)
+    : combined_(width, height, CostEncoding::HALF, kCombinedMaxCost)
+    , version_(next_cost_map_version.fetch_add(1)) {
+}
+
+bool CostMap::setLayer(const std::string& name, CostLayer layer, float weight) {
+    if (layer.getWidth() != getWidth() || layer.getHeight() != getHeight()) return false;
+    
+    for (auto& entry : layers_) {
+        if (entry.name == name) {
+            entry.layer = std::move(layer);
+            entry.weight = weight;
+            rebuild();
+            return true;
+        }
+    }
+    layers_.push_back({name, std::move(layer), weight});
+    rebuild();
+    return true;
+}
+
+bool CostMap::setWeight(const std::string& name, float weight) {
+    for (auto& entry : layers_) {
+        if (entry.name == name) {
+            entry.weight = weight;
+            rebuild();
+            return true;
+        }
+    }
+    return false;
+}
+
+bool CostMap::removeLayer(const std::string& name) {
+    for (size_t i = 0; i < layers_.size(); i++) {
+        if (layers_[i].name == name) {
+            layers_.erase(layers_.begin() + i);
+            rebuild();
+            return true;
+        }
+    }
+    return false;
+}
+
+const CostLayer* CostMap::getLayer(const std::string& name) const {
+    for (const auto& entry : layers_) {
+        if (entry.name == name) return &entry.layer;
+    }
+    return nullptr;
+}
+
+CostLayer* CostMap::getMutableLayer(const std::string& name) {
+    for (auto& entry : layers_) {
+        if (entry.name == name) return &entry.layer;
+    }
+    return nullptr;
+}
+
+void CostMap::rebuild(int num_threads) {
+    const int width = getWidth();
+    parallelRows(getHeight(), num_threads, [&](int y) {
+        size_t base = static_cast<size_t>(y) * width;
+        for (int x = 0; x < width; x++) {
+            float cost = 0.0f;
+            for (const auto& entry : layers_) {
+                if (entry.weight != 0.0f) cost += entry.weight * entry.layer.get(x, y);
+            }
+            combined_.store(base + x, cost);
+        }
+    });
+    combined_.recount();
+    version_ = next_cost_map_version.fetch_add(1);
+}
+
+CostLayer CostMap::buildInflationLayer(const Grid& grid, const InflationOptions& options) {
+    CostLayer layer(grid.getWidth(), grid.getHeight(), options.encoding, options.max_cost);
+    if (options.radius <= 1.0f) return layer;
+    
+    // Distances are only needed up to the radius; both passes of the
+    // transform are split over the worker threads
+    ClearanceMap distance(grid, options.radius, options.num_threads);
+    
+    const int width = grid.getWidth();
+    parallelRows(grid.getHeight(), options.num_threads, [&](int y) {
+        size_t base = static_cast<size_t>(y) * width;
+        for (int x = 0; x < width; x++) {
+            float d = distance.at(x, y);
+            float cost = 0.0f;
+            if (d <= 0.0f) {
+                cost = options.max_cost;  // Obstacle cell itself
+            } else if (d < options.radius) {
+                cost = options.max_cost * std::exp(-options.decay * (d - 1.0f));
+            }
+            layer.store(base + x, cost);
+        }
+    });
+    layer.recount();
+    return layer;
+}
@@ -0,0 +1,246 @@
+#include "core/cost_matrix.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <thread>
+
+// ============================================================================
+// Search Context
+// ============================================================================
+
+struct CostMatrixPlanner::SearchContext {
+    struct HeapEntry {
+        float cost;
+        int32_t cell;
+        
+        bool operator>(const HeapEntry& other) const { return cost > other.cost; }
+    };
+    
+    std::vector<uint64_t> visited;    // Uniform passes: one bit per padded cell, blocked cells preset
+    std::vector<int32_t> frontier;
+    std::vector<int32_t> next_frontier;
+    
+    // Weighted passes: a cell is reached in the current pass when stamp ==
+    // generation and settled when stamp == generation + 1, so passes never
+    // clear the arrays
+    std::vector<float> dist;
+    std::vector<uint32_t> stamp;
+    uint32_t generation;
+    std::vector<HeapEntry> heap;
+    
+    int searches;
+    size_t settled;
+    
+    SearchContext() : generation(0), searches(0), settled(0) {}
+    
+    void beginUniform(const std::vector<uint64_t>& blocked) {
+        visited = blocked;
+        frontier.clear();
+        searches++;
+    }
+    
+    void beginWeighted(size_t cells) {
+        if (stamp.size() != cells) {
+            stamp.assign(cells, 0);
+            dist.resize(cells);
+            generation = 0;
+        } else if (generation >= 0xFFFFFFFFu - 2) {
+            std::fill(stamp.begin(), stamp.end(), 0u);
+            generation = 0;
+        }
+        generation += 2;
+        heap.clear();
+        searches++;
+    }
+};
+
+// ============================================================================
+// CostMatrixPlanner Implementation
+// ============================================================================
+
+CostMatrixPlanner::CostMatrixPlanner(const Grid& grid)
+    : grid_(grid), costs_(nullptr), num_threads_(0), padded_width_(0) {}
+
+CostMatrixPlanner::~CostMatrixPlanner() = default;
+
+void CostMatrixPlanner::snapshot(const CostMap* costs) {
+    const int width = grid_.getWidth();
+    const int height = grid_.getHeight();
+    padded_width_ = width + 2;
+    const size_t cells = static_cast<size_t>(padded_width_) * (height + 2);
+    
+    passable_.assign(cells, 0);
+    blocked_bits_.assign((cells + 63) / 64, ~uint64_t(0));
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            if (grid_.isObstacle(x, y)) continue;
+            int32_t cell = paddedCell(Vec2i(x, y));
+            passable_[cell] = 1;
+            blocked_bits_[cell >> 6] &= ~(uint64_t(1) << (cell & 63));
+        }
+    }
+    
+    if (costs) {
+        enter_cost_.assign(cells, 1.0f);
+        for (int y = 0; y < height; y++) {
+            float* row = &enter_cost_[paddedCell(Vec2i(0, y))];
+            for (int x = 0; x < width; x++) row[x] = 1.0f + costs->getCost(x, y);
+        }
+    }
+    
+    if (cell_goal_.size() != cells) cell_goal_.assign(cells, -1);
+    goal_bits_.assign((cells + 63) / 64, 0);
+}
+
+CostMatrix CostMatrixPlanner::computeCostMatrix(const std::vector<Vec2i>& sources, const std::vector<Vec2i>& targets) {
+    CostMatrix result;
+    result.rows = static_cast<int>(sources.size());
+    result.cols = static_cast<int>(targets.size());
+    result.costs.assign(sources.size() * targets.size(), CostMatrix::kUnreachable);
+    if (sources.empty() || targets.empty()) return result;
+    
+    // Search from the smaller side; the other side becomes the goal set
+    result.per_target = targets.size() < sources.size();
+    const std::vector<Vec2i>& origins = result.per_target ? targets : sources;
+    const std::vector<Vec2i>& goals = result.per_target ? sources : targets;
+    const size_t cols = targets.size();
+    
+    const CostMap* costs = costs_ && !costs_->isUniform() ? costs_ : nullptr;
+    snapshot(costs);
+    
+    next_goal_.assign(goals.size(), -1);
+    int goal_count = 0;
+    for (size_t g = 0; g < goals.size(); g++) {
+        const Vec2i& p = goals[g];
+        if (!grid_.isValid(p.x, p.y) || grid_.isObstacle(p.x, p.y)) continue;
+        int32_t cell = paddedCell(p);
+        next_goal_[g] = cell_goal_[cell];
+        cell_goal_[cell] = static_cast<int32_t>(g);
+        goal_bits_[cell >> 6] |= uint64_t(1) << (cell & 63);
+        goal_count++;
+    }
+    
+    const int threads = num_threads_ > 0 ? num_threads_
+                                         : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    int workers = static_cast<int>(std::min<size_t>(threads, origins.size()));
+    while (static_cast<int>(contexts_.size()) < workers) contexts_.push_back(std::make_unique<SearchContext>());
+    for (auto& context : contexts_) {
+        context->searches = 0;
+        context->settled = 0;
+    }
+    
+    // Passes are independent: workers pull origins off a shared counter and
+    // each writes only its own row or column
+    std::atomic<size_t> next(0);
+    auto worker = [&](int index) {
+        SearchContext& context = *contexts_[index];
+        for (size_t o = next.fetch_add(1); o < origins.size(); o = next.fetch_add(1)) {
+            const Vec2i& p = origins[o];
+            if (goal_count == 0 || !grid_.isValid(p.x, p.y) || grid_.isObstacle(p.x, p.y)) continue;
+            float* out = result.per_target ? &result.costs[o] : &result.costs[o * cols];
+            size_t stride = result.per_target ? cols : 1;
+            if (costs) {
+                searchWeighted(context, paddedCell(p), result.per_target, goal_count, out, stride);
+            } else {
+                searchUniform(context, paddedCell(p), goal_count, out, stride);
+            }
+        }
+    };
+    
+    if (workers > 1) {
+        if (!pool_ || pool_->getNumThreads() != threads) pool_ = std::make_unique<WorkerPool>(threads);
+        pool_->run(workers, worker);
+    } else {
+        worker(0);
+    }
+    
+    for (const Vec2i& p : goals) {
+        if (grid_.isValid(p.x, p.y)) cell_goal_[paddedCell(p)] = -1;
+    }
+    for (const auto& context : contexts_) {
+        result.searches += context->searches;
+        result.cells_settled += context->settled;
+    }
+    return result;
+}
+
+void CostMatrixPlanner::searchUniform(SearchContext& context, int32_t origin, int goal_count,
+                                      float* out, size_t goal_stride) const {
+    context.beginUniform(blocked_bits_);
+    uint64_t* visited = context.visited.data();
+    const uint64_t* goal_bits = goal_bits_.data();
+    const int32_t offsets[] = {-padded_width_, padded_width_, -1, 1};
+    int remaining = goal_count;
+    
+    // Every cell of a level has the same cost, so levels settle in cost order
+    visited[origin >> 6] |= uint64_t(1) << (origin & 63);
+    context.frontier.push_back(origin);
+    for (float level = 0.0f; !context.frontier.empty(); level += 1.0f) {
+        context.settled += context.frontier.size();
+        context.next_frontier.clear();
+        for (int32_t cell : context.frontier) {
+            if (goal_bits[cell >> 6] >> (cell & 63) & 1u) {
+                for (int32_t g = cell_goal_[cell]; g >= 0; g = next_goal_[g]) {
+                    out[g * goal_stride] = level;
+                    remaining--;
+                }
+                if (remaining == 0) return;
+            }
+            
+            for (int32_t offset : offsets) {
+                int32_t next = cell + offset;
+                uint64_t bit = uint64_t(1) << (next & 63);
+                if (visited[next >> 6] & bit) continue;   // Seen or blocked
+                visited[next >> 6] |= bit;
+                context.next_frontier.push_back(next);
+            }
+        }
+        context.frontier.swap(context.next_frontier);
+    }
+}
+
+void CostMatrixPlanner::searchWeighted(SearchContext& context, int32_t origin, bool reverse, int goal_count,
+                                       float* out, size_t goal_stride) const {
+    context.beginWeighted(passable_.size());
+    const uint32_t reached = context.generation;
+    const uint32_t settled = context.generation + 1;
+    const uint8_t* passable = passable_.data();
+    const float* enter_cost = enter_cost_.data();
+    const int32_t offsets[] = {-padded_width_, padded_width_, -1, 1};
+    int remaining = goal_count;
+    
+    auto& heap = context.heap;
+    std::greater<SearchContext::HeapEntry> later;
+    context.dist[origin] = 0.0f;
+    context.stamp[origin] = reached;
+    heap.push_back({0.0f, origin});
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end(), later);
+        SearchContext::HeapEntry top = heap.back();
+        heap.pop_back();
+        if (context.stamp[top.cell] == settled || top.cost > context.dist[top.cell]) continue;
+        context.stamp[top.cell] = settled;
+        context.settled++;
+        if (goal_bits_[top.cell >> 6] >> (top.cell & 63) & 1u) {
+            for (int32_t g = cell_goal_[top.cell]; g >= 0; g = next_goal_[g]) {
+                out[g * goal_stride] = top.cost;
+                remaining--;
+            }
+            if (remaining == 0) return;
+        }
+        
+        // Reverse passes walk paths backwards, so a step pays for the cell it leaves
+        for (int32_t offset : offsets) {
+            int32_t next = top.cell + offset;
+            if (!passable[next] || context.stamp[next] == settled) continue;
+            
+            float cost = top.cost + (reverse ? enter_cost[top.cell] : enter_cost[next]);
+            if (context.stamp[next] == reached && cost >= context.dist[next]) continue;
+            context.stamp[next] = reached;
+            context.dist[next] = cost;
+            heap.push_back({cost, next});
+            std::push_heap(heap.begin(), heap.end(), later);
+        }
+    }
+}
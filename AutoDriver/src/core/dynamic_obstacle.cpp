@@ -2,6 +2,10 @@
 #include <cmath>
 #include <algorithm>
 
+#if defined(__AVX__)
+#include <immintrin.h>
+#endif
+
 // ============================================================================
 // DynamicObstacle Implementation
 // ============================================================================
@@ -44,38 +48,156 @@ bool DynamicObstacle::collidesWithPath(Vec2 from, Vec2 to,
 }
 
 // ============================================================================
-// DynamicObstacleManager Implementation
+// DynamicObstacleView Implementation
 // ============================================================================
 
-void DynamicObstacleManager::addObstacle(const DynamicObstacle& obstacle) {
-    obstacles_.push_back(obstacle);
+Vec2 DynamicObstacleView::getPosition() const {
+    return Vec2(manager_->positionsX()[index_], manager_->positionsY()[index_]);
 }
 
-void DynamicObstacleManager::clear() {
-    obstacles_.clear();
+Vec2 DynamicObstacleView::getVelocity() const {
+    return Vec2(manager_->velocitiesX()[index_], manager_->velocitiesY()[index_]);
 }
 
-void DynamicObstacleManager::updateAll(float dt) {
-    for (auto& obstacle : obstacles_) {
-        obstacle.update(dt);
+float DynamicObstacleView::getRadius() const {
+    return manager_->radii()[index_];
+}
+
+Vec2 DynamicObstacleView::predictPosition(float time) const {
+    return getPosition() + getVelocity() * time;
+}
+
+bool DynamicObstacleView::collides(Vec2 point, float time) const {
+    return toObstacle().collides(point, time);
+}
+
+bool DynamicObstacleView::collidesWithPath(Vec2 from, Vec2 to,
+                                           float start_time, float end_time) const {
+    return toObstacle().collidesWithPath(from, to, start_time, end_time);
+}
+
+DynamicObstacle DynamicObstacleView::toObstacle() const {
+    return DynamicObstacle(getPosition(), getVelocity(), getRadius());
+}
+
+// ============================================================================
+// SoA kernels
+// ============================================================================
+
+namespace {
+
+// pos[i] += vel[i] * dt
+void integrateAxis(float* pos, const float* vel, size_t n, float dt) {
+    size_t i = 0;
+#if defined(__AVX__)
+    const __m256 vdt = _mm256_set1_ps(dt);
+    for (; i + 8 <= n; i += 8) {
+        __m256 p = _mm256_loadu_ps(pos + i);
+        __m256 v = _mm256_loadu_ps(vel + i);
+        _mm256_storeu_ps(pos + i, _mm256_add_ps(p, _mm256_mul_ps(v, vdt)));
+    }
+#endif
+    for (; i < n; i++) {
+        pos[i] += vel[i] * dt;
     }
 }
 
-bool DynamicObstacleManager::checkCollision(Vec2 point, float time) const {
-    for (const auto& obstacle : obstacles_) {
-        if (obstacle.collides(point, time)) {
+// True if (qx, qy) lies strictly inside any obstacle predicted to `time`
+bool anyContains(const float* px, const float* py, const float* vx, const float* vy,
+                 const float* r, size_t n, float qx, float qy, float time) {
+    size_t i = 0;
+#if defined(__AVX__)
+    const __m256 vt = _mm256_set1_ps(time);
+    const __m256 vqx = _mm256_set1_ps(qx);
+    const __m256 vqy = _mm256_set1_ps(qy);
+    for (; i + 8 <= n; i += 8) {
+        __m256 dx = _mm256_sub_ps(
+            _mm256_add_ps(_mm256_loadu_ps(px + i), _mm256_mul_ps(_mm256_loadu_ps(vx + i), vt)), vqx);
+        __m256 dy = _mm256_sub_ps(
+            _mm256_add_ps(_mm256_loadu_ps(py + i), _mm256_mul_ps(_mm256_loadu_ps(vy + i), vt)), vqy);
+        __m256 d2 = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+        __m256 rad = _mm256_loadu_ps(r + i);
+        __m256 hit = _mm256_cmp_ps(d2, _mm256_mul_ps(rad, rad), _CMP_LT_OQ);
+        if (_mm256_movemask_ps(hit) != 0) {
+            return true;
+        }
+    }
+#endif
+    for (; i < n; i++) {
+        float dx = px[i] + vx[i] * time - qx;
+        float dy = py[i] + vy[i] * time - qy;
+        if (dx * dx + dy * dy < r[i] * r[i]) {
             return true;
         }
     }
     return false;
 }
 
+}  // namespace
+
+// ============================================================================
+// DynamicObstacleManager Implementation
+// ============================================================================
+
+void DynamicObstacleManager::addObstacle(const DynamicObstacle& obstacle) {
+    Vec2 pos = obstacle.getPosition();
+    Vec2 vel = obstacle.getVelocity();
+    pos_x_.push_back(pos.x);
+    pos_y_.push_back(pos.y);
+    vel_x_.push_back(vel.x);
+    vel_y_.push_back(vel.y);
+    radius_.push_back(obstacle.getRadius());
+}
+
+void DynamicObstacleManager::reserve(size_t count) {
+    pos_x_.reserve(count);
+    pos_y_.reserve(count);
+    vel_x_.reserve(count);
+    vel_y_.reserve(count);
+    radius_.reserve(count);
+}
+
+void DynamicObstacleManager::clear() {
+    pos_x_.clear();
+    pos_y_.clear();
+    vel_x_.clear();
+    vel_y_.clear();
+    radius_.clear();
+}
+
+void DynamicObstacleManager::updateAll(float dt) {
+    integrateAxis(pos_x_.data(), vel_x_.data(), size(), dt);
+    integrateAxis(pos_y_.data(), vel_y_.data(), size(), dt);
+}
+
+bool DynamicObstacleManager::checkCollision(Vec2 point, float time) const {
+    return anyContains(pos_x_.data(), pos_y_.data(), vel_x_.data(), vel_y_.data(),
+                       radius_.data(), size(), point.x, point.y, time);
+}
+
 bool DynamicObstacleManager::checkPathCollision(Vec2 from, Vec2 to, 
                                                 float start_time, float end_time) const {
-    for (const auto& obstacle : obstacles_) {
-        if (obstacle.collidesWithPath(from, to, start_time, end_time)) {
+    for (size_t i = 0; i < size(); i++) {
+        if (getObstacle(i).collidesWithPath(from, to, start_time, end_time)) {
             return true;
         }
     }
     return false;
 }
+
+void DynamicObstacleManager::predictPositions(float time, std::vector<Vec2>& out) const {
+    const size_t n = size();
+    out.resize(n);
+    for (size_t i = 0; i < n; i++) {
+        out[i] = Vec2(pos_x_[i] + vel_x_[i] * time, pos_y_[i] + vel_y_[i] * time);
+    }
+}
+
+void DynamicObstacleManager::checkCollisions(const std::vector<Vec2>& points, float time,
+                                             std::vector<uint8_t>& out) const {
+    out.resize(points.size());
+    for (size_t q = 0; q < points.size(); q++) {
+        out[q] = anyContains(pos_x_.data(), pos_y_.data(), vel_x_.data(), vel_y_.data(),
+                             radius_.data(), size(), points[q].x, points[q].y, time) ? 1 : 0;
+    }
+}
@@ -0,0 +1,377 @@
+#include "core/frenet_planner.h"
+#include <cmath>
+#include <algorithm>
+#include <numeric>
+#include <chrono>
+#include <limits>
+#include <cstdint>
+
+namespace {
+
+// Candidates checked together; per-step evaluation runs over this many lanes
+const int kBatchSize = 64;
+
+// Integral of (p + q t + r t^2)^2 over [0, T]
+float squaredJerkIntegral(float p, float q, float r, float T) {
+    float T2 = T * T;
+    float T3 = T2 * T;
+    return p * p * T + p * q * T2 + (q * q + 2.0f * p * r) * T3 / 3.0f +
+           q * r * T2 * T2 / 2.0f + r * r * T3 * T2 / 5.0f;
+}
+
+}  // namespace
+
+// ============================================================================
+// Polynomials
+// ============================================================================
+
+QuinticPolynomial::QuinticPolynomial(float x0, float v0, float a0, float x1, float v1, float a1, float T) {
+    c[0] = x0;
+    c[1] = v0;
+    c[2] = a0 / 2.0f;
+    
+    // Residuals of the end conditions after the fixed start terms
+    float T2 = T * T;
+    float r0 = x1 - (c[0] + c[1] * T + c[2] * T2);
+    float r1 = v1 - (c[1] + 2.0f * c[2] * T);
+    float r2 = a1 - 2.0f * c[2];
+    
+    c[3] = (10.0f * r0 - 4.0f * r1 * T + 0.5f * r2 * T2) / (T2 * T);
+    c[4] = (-15.0f * r0 + 7.0f * r1 * T - r2 * T2) / (T2 * T2);
+    c[5] = (6.0f * r0 - 3.0f * r1 * T + 0.5f * r2 * T2) / (T2 * T2 * T);
+}
+
+QuarticPolynomial::QuarticPolynomial(float x0, float v0, float a0, float v1, float a1, float T) {
+    c[0] = x0;
+    c[1] = v0;
+    c[2] = a0 / 2.0f;
+    
+    float r1 = v1 - (c[1] + 2.0f * c[2] * T);
+    float r2 = a1 - 2.0f * c[2];
+    
+    c[3] = (3.0f * r1 - r2 * T) / (3.0f * T * T);
+    c[4] = (r2 * T - 2.0f * r1) / (4.0f * T * T * T);
+}
+
+// ============================================================================
+// Reference line
+// ============================================================================
+
+FrenetPlanner::FrenetPlanner(const Lane& reference, const DynamicObstacleManager& obstacles)
+    : obstacles_(obstacles)
+    , speed_limit_(reference.speed_limit)
+    , max_speed_(reference.speed_limit)
+    , obs_count_(0) {
+    
+    // Drop repeated vertices so every segment has a direction
+    for (const Vec2& p : reference.centerline) {
+        if (!ref_x_.empty() && p.distanceTo(Vec2(ref_x_.back(), ref_y_.back())) < 1e-6f) continue;
+        
+        float s = ref_s_.empty() ? 0.0f : ref_s_.back() + p.distanceTo(Vec2(ref_x_.back(), ref_y_.back()));
+        ref_s_.push_back(s);
+        ref_x_.push_back(p.x);
+        ref_y_.push_back(p.y);
+    }
+    
+    for (size_t i = 0; i + 1 < ref_s_.size(); i++) {
+        float len = ref_s_[i + 1] - ref_s_[i];
+        ref_dx_.push_back((ref_x_[i + 1] - ref_x_[i]) / len);
+        ref_dy_.push_back((ref_y_[i + 1] - ref_y_[i]) / len);
+    }
+}
+
+int FrenetPlanner::segmentAt(float s) const {
+    int i = static_cast<int>(std::upper_bound(ref_s_.begin(), ref_s_.end(), s) - ref_s_.begin()) - 1;
+    return std::max(0, std::min(i, static_cast<int>(ref_dx_.size()) - 1));
+}
+
+Vec2 FrenetPlanner::toCartesian(float s, float d) const {
+    if (ref_dx_.empty()) {
+        return ref_s_.empty() ? Vec2(0, 0) : Vec2(ref_x_[0], ref_y_[0]);
+    }
+    
+    // Past either end the first/last segment is extended
+    int i = segmentAt(s);
+    float ds = s - ref_s_[i];
+    return Vec2(ref_x_[i] + ref_dx_[i] * ds - ref_dy_[i] * d,
+                ref_y_[i] + ref_dy_[i] * ds + ref_dx_[i] * d);
+}
+
+FrenetState FrenetPlanner::toFrenet(Vec2 pos, float speed) const {
+    FrenetState state(0.0f, speed, 0.0f);
+    float best = std::numeric_limits<float>::max();
+    
+    for (size_t i = 0; i < ref_dx_.size(); i++) {
+        float len = ref_s_[i + 1] - ref_s_[i];
+        float px = pos.x - ref_x_[i];
+        float py = pos.y - ref_y_[i];
+        float along = std::max(0.0f, std::min(len, px * ref_dx_[i] + py * ref_dy_[i]));
+        
+        float ex = px - ref_dx_[i] * along;
+        float ey = py - ref_dy_[i] * along;
+        float dist = ex * ex + ey * ey;
+        if (dist < best) {
+            best = dist;
+            state.s = ref_s_[i] + along;
+            state.d = ref_dx_[i] * py - ref_dy_[i] * px;  // Left of the lane is positive
+        }
+    }
+    
+    return state;
+}
+
+// ============================================================================
+// Planning
+// ============================================================================
+
+void FrenetPlanner::generateCandidates(const FrenetState& state) {
+    const FrenetConfig& cfg = config_;
+    const int lateral = std::max(1, cfg.lateral_samples);
+    const int horizons = std::max(1, cfg.horizon_samples);
+    const int speeds = std::max(1, cfg.speed_samples);
+    const size_t total = static_cast<size_t>(lateral) * horizons * speeds;
+    
+    for (auto& coeffs : lat_) coeffs.clear();
+    for (auto& coeffs : lon_) coeffs.clear();
+    horizon_.clear();
+    target_d_.clear();
+    target_v_.clear();
+    cost_.clear();
+    
+    for (auto& coeffs : lat_) coeffs.reserve(total);
+    for (auto& coeffs : lon_) coeffs.reserve(total);
+    horizon_.reserve(total);
+    target_d_.reserve(total);
+    target_v_.reserve(total);
+    cost_.reserve(total);
+    
+    for (int h = 0; h < horizons; h++) {
+        float T = horizons == 1 ? cfg.max_horizon
+                                : cfg.min_horizon + (cfg.max_horizon - cfg.min_horizon) * h / (horizons - 1);
+        
+        for (int l = 0; l < lateral; l++) {
+            float d1 = lateral == 1 ? 0.0f
+                                    : -cfg.max_lateral_offset + 2.0f * cfg.max_lateral_offset * l / (lateral - 1);
+            
+            QuinticPolynomial lat(state.d, state.d_d, state.d_dd, d1, 0.0f, 0.0f, T);
+            float lat_jerk = squaredJerkIntegral(6.0f * lat.c[3], 24.0f * lat.c[4], 60.0f * lat.c[5], T);
+            
+            for (int v = 0; v < speeds; v++) {
+                float v1 = speeds == 1 ? speed_limit_
+                                       : speed_limit_ - cfg.speed_range + cfg.speed_range * v / (speeds - 1);
+                v1 = std::max(0.0f, v1);
+                
+                QuarticPolynomial lon(state.s, state.s_d, state.s_dd, v1, 0.0f, T);
+                float lon_jerk = squaredJerkIntegral(6.0f * lon.c[3], 24.0f * lon.c[4], 0.0f, T);
+                
+                float speed_error = speed_limit_ - v1;
+                float cost = cfg.w_jerk * (lat_jerk + lon_jerk) + cfg.w_time * T +
+                             cfg.w_speed * speed_error * speed_error + cfg.w_lateral * d1 * d1;
+                
+                for (int k = 0; k < 6; k++) lat_[k].push_back(lat.c[k]);
+                for (int k = 0; k < 5; k++) lon_[k].push_back(lon.c[k]);
+                horizon_.push_back(T);
+                target_d_.push_back(d1);
+                target_v_.push_back(v1);
+                cost_.push_back(cost);
+            }
+        }
+    }
+}
+
+void FrenetPlanner::predictObstacles(const FrenetState& state, int steps) {
+    const FrenetConfig& cfg = config_;
+    const Vec2 origin = toCartesian(state.s, state.d);
+    const float horizon = cfg.max_horizon;
+    
+    // Farthest the vehicle can get from its current position this cycle
+    float reach = max_speed_ * horizon + 0.5f * cfg.max_accel * horizon * horizon +
+                  cfg.max_lateral_offset + std::abs(state.d) + cfg.vehicle_radius;
+    
+    const auto& px = obstacles_.positionsX();
+    const auto& py = obstacles_.positionsY();
+    const auto& vx = obstacles_.velocitiesX();
+    const auto& vy = obstacles_.velocitiesY();
+    const auto& radius = obstacles_.radii();
+    
+    std::vector<size_t> relevant;
+    for (size_t i = 0; i < obstacles_.size(); i++) {
+        float dx = px[i] - origin.x;
+        float dy = py[i] - origin.y;
+        float travel = std::sqrt(vx[i] * vx[i] + vy[i] * vy[i]) * horizon;
+        float limit = reach + travel + radius[i];
+        if (dx * dx + dy * dy <= limit * limit) {
+            relevant.push_back(i);
+        }
+    }
+    
+    obs_count_ = relevant.size();
+    obs_x_.resize(obs_count_ * steps);
+    obs_y_.resize(obs_count_ * steps);
+    obs_r_.resize(obs_count_);
+    
+    for (size_t j = 0; j < obs_count_; j++) {
+        obs_r_[j] = radius[relevant[j]] + cfg.vehicle_radius;
+    }
+    for (int k = 0; k < steps; k++) {
+        float t = k * cfg.dt;
+        float* xs = obs_x_.data() + k * obs_count_;
+        float* ys = obs_y_.data() + k * obs_count_;
+        for (size_t j = 0; j < obs_count_; j++) {
+            size_t i = relevant[j];
+            xs[j] = px[i] + vx[i] * t;
+            ys[j] = py[i] + vy[i] * t;
+        }
+    }
+}
+
+int FrenetPlanner::checkBatch(const int* order, int count, int steps, std::vector<uint8_t>& feasible) {
+    const FrenetConfig& cfg = config_;
+    
+    // Gather the batch into contiguous coefficient lanes
+    float la[6][kBatchSize], lo[5][kBatchSize], T[kBatchSize];
+    for (int c = 0; c < count; c++) {
+        int id = order[c];
+        for (int k = 0; k < 6; k++) la[k][c] = lat_[k][id];
+        for (int k = 0; k < 5; k++) lo[k][c] = lon_[k][id];
+        T[c] = horizon_[id];
+    }
+    
+    float s[kBatchSize], sv[kBatchSize], sa[kBatchSize];
+    float d[kBatchSize], da[kBatchSize];
+    feasible.assign(count, 1);
+    
+    for (int k = 0; k < steps; k++) {
+        const float t = k * cfg.dt;
+        
+        // Evaluate every candidate at t; past its horizon a candidate holds
+        // its final offset and speed
+        for (int c = 0; c < count; c++) {
+            float tc = std::min(t, T[c]);
+            float tail = t - tc;
+            
+            float sv_c = lo[1][c] + tc * (2 * lo[2][c] + tc * (3 * lo[3][c] + tc * 4 * lo[4][c]));
+            float sa_c = 2 * lo[2][c] + tc * (6 * lo[3][c] + tc * 12 * lo[4][c]);
+            float s_c = lo[0][c] + tc * (lo[1][c] + tc * (lo[2][c] + tc * (lo[3][c] + tc * lo[4][c])));
+            
+            s[c] = s_c + sv_c * tail;
+            sv[c] = sv_c;
+            sa[c] = tail > 0.0f ? 0.0f : sa_c;
+            d[c] = la[0][c] + tc * (la[1][c] + tc * (la[2][c] + tc * (la[3][c] + tc * (la[4][c] + tc * la[5][c]))));
+            da[c] = tail > 0.0f ? 0.0f
+                                : 2 * la[2][c] + tc * (6 * la[3][c] + tc * (12 * la[4][c] + tc * 20 * la[5][c]));
+        }
+        
+        const float* xs = obs_x_.data() + k * obs_count_;
+        const float* ys = obs_y_.data() + k * obs_count_;
+        bool any_alive = false;
+        
+        for (int c = 0; c < count; c++) {
+            if (!feasible[c]) continue;
+            
+            if (sv[c] < -0.1f || sv[c] > max_speed_ + 0.1f ||
+                std::abs(sa[c]) > cfg.max_accel || std::abs(da[c]) > cfg.max_lateral_accel) {
+                feasible[c] = 0;
+                continue;
+            }
+            
+            Vec2 p = toCartesian(s[c], d[c]);
+            for (size_t j = 0; j < obs_count_; j++) {
+                float dx = xs[j] - p.x;
+                float dy = ys[j] - p.y;
+                if (dx * dx + dy * dy <= obs_r_[j] * obs_r_[j]) {
+                    feasible[c] = 0;
+                    break;
+                }
+            }
+            any_alive |= feasible[c] != 0;
+        }
+        
+        if (!any_alive) return -1;
+    }
+    
+    // Batch is in cost order, so the first survivor is the cheapest
+    for (int c = 0; c < count; c++) {
+        if (feasible[c]) return c;
+    }
+    return -1;
+}
+
+FrenetTrajectory FrenetPlanner::sampleTrajectory(int candidate) const {
+    FrenetTrajectory trajectory;
+    const float T = horizon_[candidate];
+    const float* la[6];
+    const float* lo[5];
+    for (int k = 0; k < 6; k++) la[k] = &lat_[k][candidate];
+    for (int k = 0; k < 5; k++) lo[k] = &lon_[k][candidate];
+    
+    int samples = static_cast<int>(std::ceil(T / config_.dt - 1e-4f));
+    for (int i = 0; i <= samples; i++) {
+        float t = std::min(i * config_.dt, T);
+        float s = *lo[0] + t * (*lo[1] + t * (*lo[2] + t * (*lo[3] + t * *lo[4])));
+        float v = *lo[1] + t * (2 * *lo[2] + t * (3 * *lo[3] + t * 4 * *lo[4]));
+        float d = *la[0] + t * (*la[1] + t * (*la[2] + t * (*la[3] + t * (*la[4] + t * *la[5]))));
+        
+        trajectory.t.push_back(t);
+        trajectory.s.push_back(s);
+        trajectory.d.push_back(d);
+        trajectory.speed.push_back(v);
+        trajectory.points.push_back(toCartesian(s, d));
+    }
+    
+    trajectory.cost = cost_[candidate];
+    trajectory.duration = T;
+    trajectory.target_speed = target_v_[candidate];
+    trajectory.target_offset = target_d_[candidate];
+    return trajectory;
+}
+
+FrenetResult FrenetPlanner::plan(const FrenetState& state, double time_budget_ms) {
+    auto start_time = std::chrono::high_resolution_clock::now();
+    auto elapsedMs = [&]() {
+        return std::chrono::duration<double, std::milli>(
+            std::chrono::high_resolution_clock::now() - start_time).count();
+    };
+    
+    FrenetResult result;
+    if (ref_dx_.empty() || config_.dt <= 0.0f || config_.min_horizon <= 0.0f) {
+        return result;
+    }
+    
+    max_speed_ = std::max(speed_limit_, state.s_d) * 1.05f;
+    
+    generateCandidates(state);
+    const int total = static_cast<int>(cost_.size());
+    result.candidates_generated = total;
+    
+    const int steps = static_cast<int>(std::ceil(config_.max_horizon / config_.dt - 1e-4f)) + 1;
+    predictObstacles(state, steps);
+    
+    std::vector<int> order(total);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](int a, int b) { return cost_[a] < cost_[b]; });
+    
+    std::vector<uint8_t> feasible;
+    for (int begin = 0; begin < total; begin += kBatchSize) {
+        // Always check at least one batch
+        if (begin > 0 && elapsedMs() > time_budget_ms) {
+            result.budget_exceeded = true;
+            break;
+        }
+        
+        int count = std::min(kBatchSize, total - begin);
+        int winner = checkBatch(order.data() + begin, count, steps, feasible);
+        
+        result.candidates_checked += count;
+        result.candidates_rejected += static_cast<int>(std::count(feasible.begin(), feasible.end(), 0));
+        
+        if (winner >= 0) {
+            result.trajectory = sampleTrajectory(order[begin + winner]);
+            result.success = true;
+            break;
+        }
+    }
+    
+    result.planning_time_ms = elapsedMs();
+    return result;
+}
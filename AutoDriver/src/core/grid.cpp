@@ -1,33 +1,240 @@
 #include "core/grid.h"
+#include <algorithm>
 
-Grid::Grid(int width, int height) 
-    : width_(width), height_(height) {
-    obstacles_.resize(height, std::vector<bool>(width, false));
+namespace {
+
+int countBits(uint64_t v) {
+    int count = 0;
+    for (; v; v &= v - 1) count++;
+    return count;
+}
+
+// Bits lo..hi (inclusive) of a 64-bit row
+uint64_t spanMask(int lo, int hi) {
+    uint64_t upper = hi >= 63 ? ~uint64_t(0) : (uint64_t(1) << (hi + 1)) - 1;
+    return upper & ~((uint64_t(1) << lo) - 1);
 }
 
-bool Grid::isObstacle(int x, int y) const {
-    if (!isValid(x, y)) return true;  // Out of bounds = obstacle
-    return obstacles_[y][x];
+uint64_t mixHash(uint64_t h, uint64_t value) {
+    h = (h ^ value) * 0x9E3779B97F4A7C15ull;
+    return h ^ (h >> 29);
+}
+
+}  // namespace
+
+Grid::Grid(int width, int height)
+    : width_(width), height_(height)
+    , tiles_x_((width + kTileSize - 1) >> kTileShift)
+    , tiles_y_((height + kTileSize - 1) >> kTileShift)
+    , pyramid_levels_(0)
+    , version_(0)
+    , tiles_cloned_(0) {
+    
+    // Every tile starts as the same shared empty tile
+    TileRef empty;
+    tiles_.assign(static_cast<size_t>(tiles_x_) * tiles_y_, empty);
+    tile_versions_.assign(tiles_.size(), 0);
 }
 
 void Grid::setObstacle(int x, int y, bool blocked) {
-    if (isValid(x, y)) {
-        obstacles_[y][x] = blocked;
+    if (!isValid(x, y) || isObstacle(x, y) == blocked) return;
+    
+    const size_t t = static_cast<size_t>(y >> kTileShift) * tiles_x_ + (x >> kTileShift);
+    const int lx = x & (kTileSize - 1);
+    const int ly = y & (kTileSize - 1);
+    Tile* tile = tiles_[t].mutate(tiles_cloned_);
+    uint64_t bit = uint64_t(1) << lx;
+    if (blocked) {
+        tile->rows[ly] |= bit;
+    } else {
+        tile->rows[ly] &= ~bit;
     }
+    
+    if (pyramid_levels_ > 0) {
+        PyramidBlock* block = pyramid_[t].mutate();
+        for (int level = 1; level <= pyramid_levels_; level++) {
+            int side = kTileSize >> level;
+            uint8_t& count = block->counts[PyramidBlock::offset(level) + (ly >> level) * side + (lx >> level)];
+            count = static_cast<uint8_t>(blocked ? count + 1 : count - 1);
+        }
+    }
+    tile_versions_[t] = ++version_;
 }
 
 void Grid::toggleObstacle(int x, int y) {
     if (isValid(x, y)) {
-        obstacles_[y][x] = !obstacles_[y][x];
+        setObstacle(x, y, !isObstacle(x, y));
     }
 }
 
 void Grid::clear() {
-    for (auto& row : obstacles_) {
-        std::fill(row.begin(), row.end(), false);
+    TileRef empty;
+    for (auto& tile : tiles_) tile = empty;
+    if (pyramid_levels_ > 0) {
+        PyramidRef zero;
+        for (auto& block : pyramid_) block = zero;
+    }
+    version_++;
+    std::fill(tile_versions_.begin(), tile_versions_.end(), version_);
+}
+
+bool Grid::changedSince(uint64_t version, int min_tx, int min_ty, int max_tx, int max_ty) const {
+    if (version_ <= version) return false;
+    min_tx = std::max(min_tx, 0);
+    min_ty = std::max(min_ty, 0);
+    max_tx = std::min(max_tx, tiles_x_ - 1);
+    max_ty = std::min(max_ty, tiles_y_ - 1);
+    for (int ty = min_ty; ty <= max_ty; ty++) {
+        const uint64_t* row = &tile_versions_[static_cast<size_t>(ty) * tiles_x_];
+        for (int tx = min_tx; tx <= max_tx; tx++) {
+            if (row[tx] > version) return true;
+        }
+    }
+    return false;
+}
+
+std::vector<Vec2i> Grid::getChangedTiles(uint64_t version) const {
+    std::vector<Vec2i> changed;
+    if (version_ <= version) return changed;
+    for (size_t t = 0; t < tile_versions_.size(); t++) {
+        if (tile_versions_[t] > version) {
+            changed.emplace_back(static_cast<int>(t % tiles_x_), static_cast<int>(t / tiles_x_));
+        }
     }
+    return changed;
 }
 
-bool Grid::isValid(int x, int y) const {
-    return x >= 0 && x < width_ && y >= 0 && y < height_;
+bool Grid::sharesTile(const Grid& other, int tx, int ty) const {
+    if (other.tiles_x_ != tiles_x_ || other.tiles_y_ != tiles_y_) return false;
+    if (tx < 0 || ty < 0 || tx >= tiles_x_ || ty >= tiles_y_) return false;
+    size_t index = static_cast<size_t>(ty) * tiles_x_ + tx;
+    return tiles_[index].rows() == other.tiles_[index].rows();
+}
+
+size_t Grid::countSharedTiles(const Grid& other) const {
+    if (other.tiles_x_ != tiles_x_ || other.tiles_y_ != tiles_y_) return 0;
+    size_t shared = 0;
+    for (size_t i = 0; i < tiles_.size(); i++) {
+        if (tiles_[i].rows() == other.tiles_[i].rows()) shared++;
+    }
+    return shared;
+}
+
+uint64_t Grid::contentHash() const {
+    uint64_t h = mixHash(static_cast<uint64_t>(width_), static_cast<uint64_t>(height_));
+    for (const auto& tile : tiles_) {
+        const uint64_t* rows = tile.rows();
+        for (int r = 0; r < kTileSize; r++) h = mixHash(h, rows[r]);
+    }
+    return h;
+}
+
+// ============================================================================
+// Occupancy Pyramid
+// ============================================================================
+
+void Grid::enablePyramid(int levels) {
+    pyramid_levels_ = std::max(1, std::min(levels, static_cast<int>(kMaxPyramidLevels)));
+    
+    // Tiles without obstacles all share one zero block
+    PyramidRef zero;
+    pyramid_.assign(tiles_.size(), zero);
+    
+    for (size_t t = 0; t < tiles_.size(); t++) {
+        const uint64_t* rows = tiles_[t].rows();
+        bool empty = true;
+        for (int r = 0; r < kTileSize && empty; r++) empty = rows[r] == 0;
+        if (empty) continue;
+        
+        PyramidBlock* block = pyramid_[t].mutate();
+        uint8_t* level1 = block->counts + PyramidBlock::offset(1);
+        for (int cy = 0; cy < 32; cy++) {
+            for (int cx = 0; cx < 32; cx++) {
+                uint64_t pair = uint64_t(3) << (2 * cx);
+                level1[cy * 32 + cx] = static_cast<uint8_t>(countBits(rows[2 * cy] & pair) +
+                                                            countBits(rows[2 * cy + 1] & pair));
+            }
+        }
+        for (int level = 2; level <= kMaxPyramidLevels; level++) {
+            const uint8_t* fine = block->counts + PyramidBlock::offset(level - 1);
+            uint8_t* coarse = block->counts + PyramidBlock::offset(level);
+            int side = kTileSize >> level;
+            for (int cy = 0; cy < side; cy++) {
+                for (int cx = 0; cx < side; cx++) {
+                    const uint8_t* child = fine + (2 * cy) * (2 * side) + 2 * cx;
+                    coarse[cy * side + cx] = static_cast<uint8_t>(child[0] + child[1] +
+                                                                  child[2 * side] + child[2 * side + 1]);
+                }
+            }
+        }
+    }
+}
+
+void Grid::disablePyramid() {
+    pyramid_.clear();
+    pyramid_levels_ = 0;
+}
+
+int Grid::getBlockedCount(int level, int cx, int cy) const {
+    if (level <= 0) return isObstacle(cx, cy) ? 1 : 0;
+    if (cx < 0 || cy < 0 || cx >= getLevelWidth(level) || cy >= getLevelHeight(level)) {
+        return 1 << (2 * level);
+    }
+    
+    const int shift = kTileShift - level;
+    const int side = kTileSize >> level;
+    const size_t t = static_cast<size_t>(cy >> shift) * tiles_x_ + (cx >> shift);
+    const int lx = cx & (side - 1);
+    const int ly = cy & (side - 1);
+    
+    if (level <= pyramid_levels_) {
+        return pyramid_[t].get()->counts[PyramidBlock::offset(level) + ly * side + lx];
+    }
+    
+    // No pyramid at this level: count the tile bits directly
+    const uint64_t* rows = tiles_[t].rows();
+    const int size = 1 << level;
+    const uint64_t mask = spanMask(lx * size, lx * size + size - 1);
+    int count = 0;
+    for (int r = ly * size; r < ly * size + size; r++) count += countBits(rows[r] & mask);
+    return count;
+}
+
+float Grid::getOccupancy(int level, int cx, int cy) const {
+    const int size = 1 << std::max(level, 0);
+    const int cells_x = std::min(size, width_ - cx * size);
+    const int cells_y = std::min(size, height_ - cy * size);
+    if (cx < 0 || cy < 0 || cells_x <= 0 || cells_y <= 0) return 1.0f;
+    return static_cast<float>(getBlockedCount(level, cx, cy)) / (cells_x * cells_y);
+}
+
+bool Grid::isRegionFree(int min_x, int min_y, int max_x, int max_y) const {
+    if (min_x > max_x || min_y > max_y) return true;
+    if (min_x < 0 || min_y < 0 || max_x >= width_ || max_y >= height_) return false;
+    
+    // Walk the region in blocks that never straddle a tile: pyramid cells
+    // when available (empty ones are skipped outright), whole tiles otherwise
+    const int level = pyramid_levels_;
+    const int step = level > 0 ? 1 << level : kTileSize;
+    for (int by = min_y / step; by <= max_y / step; by++) {
+        const int y0 = std::max(min_y, by * step);
+        const int y1 = std::min(max_y, by * step + step - 1);
+        for (int bx = min_x / step; bx <= max_x / step; bx++) {
+            const int x0 = std::max(min_x, bx * step);
+            const int x1 = std::min(max_x, bx * step + step - 1);
+            
+            if (level > 0) {
+                int blocked = getBlockedCount(level, bx, by);
+                if (blocked == 0) continue;
+                if (x1 - x0 + 1 == step && y1 - y0 + 1 == step) return false;
+            }
+            
+            const uint64_t* rows = tiles_[static_cast<size_t>(y0 >> kTileShift) * tiles_x_ + (x0 >> kTileShift)].rows();
+            const uint64_t mask = spanMask(x0 & (kTileSize - 1), x1 & (kTileSize - 1));
+            for (int y = y0; y <= y1; y++) {
+                if (rows[y & (kTileSize - 1)] & mask) return false;
+            }
+        }
+    }
+    return true;
 }
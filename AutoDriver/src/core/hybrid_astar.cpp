@@ -1,13 +1,22 @@
 #include "core/hybrid_astar.h"
+#include "core/instrumentation.h"
 #include <cmath>
 #include <queue>
 #include <unordered_map>
+#include <unordered_set>
 #include <algorithm>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
 
+namespace {
+
+const float kGoalTolerance = 1.0f;          // Position tolerance of the goal check
+const float kGoalHeadingTolerance = 0.2f;   // Heading tolerance of the goal check (radians)
+
+}  // namespace
+
 // Helper for priority queue comparison
 struct HybridStateCompare {
     bool operator()(const HybridState* a, const HybridState* b) const {
@@ -16,7 +25,7 @@ struct HybridStateCompare {
 };
 
 HybridAStar::HybridAStar(const Grid& grid, const VehicleParams& params)
-    : grid_(grid), vehicle_params_(params), angular_divisions_(72) {
+    : grid_(grid), vehicle_params_(params), angular_divisions_(72), costs_(nullptr) {
     generateMotionPrimitives();
 }
 
@@ -51,23 +60,34 @@ void HybridAStar::generateMotionPrimitives() {
     motion_primitives_.emplace_back(dx_rev, 0.0f, 0.0f, std::abs(dx_rev) * 1.5f, 0.0f);
 }
 
+float HybridAStar::getMaxTurnPerCost() const {
+    float rate = 0.0f;
+    for (const auto& motion : motion_primitives_) {
+        rate = std::max(rate, std::abs(motion.delta_theta) / motion.cost);
+    }
+    return rate;
+}
+
 bool HybridAStar::isCollisionFree(Vec2 pos, float theta) const {
+    AUTODRIVER_SCOPE(HYBRID_COLLISION);
+    
     // Check vehicle footprint (simplified as rectangle)
     float half_length = vehicle_params_.length / 2.0f;
     float half_width = vehicle_params_.width / 2.0f;
     
     // Sample points around vehicle perimeter
-    std::vector<Vec2> corners = {
+    const Vec2 corners[4] = {
         Vec2(half_length, half_width),
         Vec2(half_length, -half_width),
         Vec2(-half_length, half_width),
         Vec2(-half_length, -half_width)
     };
     
+    float cos_theta = std::cos(theta);
+    float sin_theta = std::sin(theta);
+    
     for (const auto& corner : corners) {
         // Rotate corner by theta
-        float cos_theta = std::cos(theta);
-        float sin_theta = std::sin(theta);
         Vec2 rotated(
             corner.x * cos_theta - corner.y * sin_theta,
             corner.x * sin_theta + corner.y * cos_theta
@@ -156,7 +176,8 @@ std::vector<HybridState> HybridAStar::reconstructPath(HybridState* goal) const {
 
 HybridAStarResult HybridAStar::findPath(Vec2 start, float start_theta,
                                        Vec2 goal, float goal_theta,
-                                       int max_iterations) {
+                                       int max_iterations, float max_cost) {
+    AUTODRIVER_SCOPE(HYBRID_SEARCH);
     HybridAStarResult result;
     
     // Validate start and goal
@@ -165,9 +186,12 @@ HybridAStarResult HybridAStar::findPath(Vec2 start, float start_theta,
     }
     
     // Priority queue and visited set
+    // States are owned by all_states for the whole search: parents and
+    // open-set entries keep pointing at superseded states
     std::priority_queue<HybridState*, std::vector<HybridState*>, HybridStateCompare> open_set;
-    std::unordered_map<int, std::unique_ptr<HybridState>> all_states;
+    std::vector<std::unique_ptr<HybridState>> all_states;
     std::unordered_map<int, float> best_costs;
+    std::unordered_set<int> closed_set;
     
     // Initialize start state
     auto start_state = std::make_unique<HybridState>(start, start_theta);
@@ -176,17 +200,28 @@ HybridAStarResult HybridAStar::findPath(Vec2 start, float start_theta,
     
     int start_idx = getStateIndex(start, start_theta);
     HybridState* start_ptr = start_state.get();
-    all_states[start_idx] = std::move(start_state);
+    all_states.push_back(std::move(start_state));
     open_set.push(start_ptr);
     best_costs[start_idx] = 0.0f;
     
     int iterations = 0;
     
     while (!open_set.empty() && iterations < max_iterations) {
-        iterations++;
+        HybridState* current;
+        {
+            AUTODRIVER_SCOPE(HYBRID_HEAP_POP);
+            current = open_set.top();
+            open_set.pop();
+        }
+        result.iterations++;
         
-        HybridState* current = open_set.top();
-        open_set.pop();
+        // Skip superseded entries and cells that were already expanded
+        int current_idx = getStateIndex(current->pos, current->theta);
+        if (current->g_cost > best_costs[current_idx] || !closed_set.insert(current_idx).second) {
+            continue;
+        }
+        iterations++;
+        AUTODRIVER_COUNT(HYBRID_EXPAND);
         
         // Check if goal reached
         float dist_to_goal = current->pos.distanceTo(goal);
@@ -194,7 +229,7 @@ HybridAStarResult HybridAStar::findPath(Vec2 start, float start_theta,
         while (angle_diff > M_PI) angle_diff -= 2.0f * M_PI;
         angle_diff = std::abs(angle_diff);
         
-        if (dist_to_goal < 1.0f && angle_diff < 0.2f) {
+        if (dist_to_goal < kGoalTolerance && angle_diff < kGoalHeadingTolerance) {
             result.success = true;
             result.path = reconstructPath(current);
             result.nodes_expanded = iterations;
@@ -212,6 +247,18 @@ HybridAStarResult HybridAStar::findPath(Vec2 start, float start_theta,
                 continue;
             }
             
+            float new_g_cost = current->g_cost + motion.cost;
+            if (costs_ && !costs_->isUniform()) {
+                float length = std::sqrt(motion.delta_x * motion.delta_x + motion.delta_y * motion.delta_y);
+                new_g_cost += length * costs_->getCost(static_cast<int>(std::round(next.pos.x)),
+                                                       static_cast<int>(std::round(next.pos.y)));
+            }
+            
+            // Every unit of travel costs at least one
+            if (new_g_cost + std::max(0.0f, next.pos.distanceTo(goal) - kGoalTolerance) >= max_cost) {
+                continue;
+            }
+            
             // Check collision
             if (!isCollisionFree(next.pos, next.theta)) {
                 continue;
@@ -221,23 +268,27 @@ HybridAStarResult HybridAStar::findPath(Vec2 start, float start_theta,
                 continue;
             }
             
-            float new_g_cost = current->g_cost + motion.cost;
             int next_idx = getStateIndex(next.pos, next.theta);
             
             // Check if this is a better path
-            if (best_costs.find(next_idx) == best_costs.end() ||
-                new_g_cost < best_costs[next_idx]) {
+            if (closed_set.count(next_idx) == 0 &&
+                (best_costs.find(next_idx) == best_costs.end() ||
+                 new_g_cost < best_costs[next_idx])) {
                 
                 auto next_state = std::make_unique<HybridState>(next.pos, next.theta, current);
                 next_state->g_cost = new_g_cost;
                 next_state->h_cost = calculateHeuristic(next.pos, next.theta, goal, goal_theta);
                 
                 HybridState* next_ptr = next_state.get();
-                all_states[next_idx] = std::move(next_state);
-                open_set.push(next_ptr);
+                all_states.push_back(std::move(next_state));
+                {
+                    AUTODRIVER_SCOPE(HYBRID_HEAP_PUSH);
+                    open_set.push(next_ptr);
+                }
                 best_costs[next_idx] = new_g_cost;
                 
-                result.explored.push_back(next_ptr->pos);
+                if (capture_.results) result.explored.push_back(next_ptr->pos);
+                capture_.emit(SearchEventType::EXPLORED, next_ptr->pos);
             }
         }
     }
@@ -0,0 +1,255 @@
+#include "core/instrumentation.h"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <ostream>
+
+namespace {
+
+struct ProbeInfo {
+    const char* name;
+    bool phase;   // Emitted as a trace event
+};
+
+const ProbeInfo kProbeInfo[] = {
+    {"astar.search", true},
+    {"astar.expand", false},
+    {"astar.heap_push", false},
+    {"astar.heap_pop", false},
+    {"astar.neighbors", false},
+    {"hybrid_astar.search", true},
+    {"hybrid_astar.expand", false},
+    {"hybrid_astar.heap_push", false},
+    {"hybrid_astar.heap_pop", false},
+    {"hybrid_astar.collision", false},
+    {"rrt.search", true},
+    {"rrt.node_added", false},
+    {"rrt.nearest", false},
+    {"rrt.collision", false},
+    {"rrt.rewire", false},
+    {"smoothing.shortcut", true},
+    {"smoothing.gradient", true},
+    {"smoothing.spline", true},
+    {"smoothing.line_check", false},
+};
+static_assert(sizeof(kProbeInfo) / sizeof(kProbeInfo[0]) == ProbeCounters::kProbes, "every probe needs a name");
+
+struct TraceEvent {
+    Probe probe;
+    uint32_t thread_id;
+    int64_t start_ns;   // Since the trace started
+    int64_t duration_ns;
+};
+
+/**
+ * Thread registry and trace buffers. Slots are never freed, only recycled
+ * once their thread exits, so hot paths can hold plain pointers.
+ */
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ProbeCounters>> threads;
+    std::vector<ProbeCounters*> free_slots;   // Slots of exited threads, zeroed
+    ProbeCounters retired{0};                 // Totals of exited threads
+    std::vector<TraceEvent> events;
+    size_t max_events_per_thread = 0;
+    std::vector<size_t> events_per_thread;
+    std::chrono::steady_clock::time_point trace_start;
+};
+
+Registry& registry() {
+    static Registry* instance = new Registry();   // Outlives thread_local destructors
+    return *instance;
+}
+
+void addCounters(ProbeCounters& to, const ProbeCounters& from) {
+    for (size_t i = 0; i < ProbeCounters::kProbes; i++) {
+        to.counts[i].fetch_add(from.counts[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+        to.nanos[i].fetch_add(from.nanos[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+}
+
+void zeroCounters(ProbeCounters& data) {
+    for (size_t i = 0; i < ProbeCounters::kProbes; i++) {
+        data.counts[i].store(0, std::memory_order_relaxed);
+        data.nanos[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * Retires the thread's slot when the thread exits. Probes hit later in the
+ * thread's teardown land in the shared retired totals.
+ */
+struct SlotOwner {
+    ProbeCounters* slot = nullptr;
+    ProbeCounters** home = nullptr;
+    
+    ~SlotOwner() {
+        if (!slot) return;
+        Registry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        addCounters(reg.retired, *slot);
+        zeroCounters(*slot);
+        reg.free_slots.push_back(slot);
+        *home = &reg.retired;
+    }
+};
+
+int64_t nanosBetween(std::chrono::steady_clock::time_point a, std::chrono::steady_clock::time_point b) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(b - a).count();
+}
+
+}  // namespace
+
+std::atomic<bool> Instrumentation::tracing_(false);
+
+ProbeCounters::ProbeCounters(uint32_t id) : thread_id(id) {
+    zeroCounters(*this);
+}
+
+ProbeCounters& Instrumentation::registerThread(ProbeCounters** home) {
+    static thread_local SlotOwner owner;
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    if (!reg.free_slots.empty()) {
+        owner.slot = reg.free_slots.back();
+        reg.free_slots.pop_back();
+    } else {
+        reg.threads.push_back(std::make_unique<ProbeCounters>(static_cast<uint32_t>(reg.threads.size() + 1)));
+        reg.events_per_thread.push_back(0);
+        owner.slot = reg.threads.back().get();
+    }
+    owner.home = home;
+    return *owner.slot;
+}
+
+const char* Instrumentation::name(Probe probe) {
+    size_t i = static_cast<size_t>(probe);
+    return i < ProbeCounters::kProbes ? kProbeInfo[i].name : "unknown";
+}
+
+bool Instrumentation::isPhase(Probe probe) {
+    size_t i = static_cast<size_t>(probe);
+    return i < ProbeCounters::kProbes && kProbeInfo[i].phase;
+}
+
+void Instrumentation::record(Probe probe, std::chrono::steady_clock::time_point start,
+                             std::chrono::steady_clock::time_point end) {
+    ProbeCounters& data = local();
+    size_t i = static_cast<size_t>(probe);
+    int64_t ns = nanosBetween(start, end);
+    data.counts[i].store(data.counts[i].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    data.nanos[i].store(data.nanos[i].load(std::memory_order_relaxed) + ns, std::memory_order_relaxed);
+    
+    // Phases are coarse (one per search), so taking the lock here is cheap.
+    // The retired totals (thread_id 0) belong to no thread and get no events.
+    if (kProbeInfo[i].phase && data.thread_id != 0 && isTracing()) {
+        Registry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        size_t& used = reg.events_per_thread[data.thread_id - 1];
+        if (tracing_.load(std::memory_order_relaxed) && used < reg.max_events_per_thread) {
+            reg.events.push_back({probe, data.thread_id, nanosBetween(reg.trace_start, start), ns});
+            used++;
+        }
+    }
+}
+
+std::vector<ProbeStats> Instrumentation::snapshot() {
+    std::vector<ProbeStats> stats;
+    for (size_t i = 0; i < ProbeCounters::kProbes; i++) stats.push_back({static_cast<Probe>(i), kProbeInfo[i].name, 0, 0});
+    
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    auto add = [&](const ProbeCounters& data) {
+        for (size_t i = 0; i < ProbeCounters::kProbes; i++) {
+            stats[i].count += data.counts[i].load(std::memory_order_relaxed);
+            stats[i].total_ns += data.nanos[i].load(std::memory_order_relaxed);
+        }
+    };
+    add(reg.retired);
+    for (const auto& owner : reg.threads) add(*owner);
+    return stats;
+}
+
+size_t Instrumentation::getThreadSlots() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    return reg.threads.size();
+}
+
+void Instrumentation::reset() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    // Racing with a thread mid-probe only loses that thread's update
+    zeroCounters(reg.retired);
+    for (const auto& owner : reg.threads) zeroCounters(*owner);
+    reg.events.clear();
+    std::fill(reg.events_per_thread.begin(), reg.events_per_thread.end(), 0);
+}
+
+void Instrumentation::printSummary(std::ostream& out) {
+    if (!enabled()) {
+        out << "Instrumentation disabled (build with AUTODRIVER_INSTRUMENTATION=ON)\n";
+        return;
+    }
+    
+    out << std::left << std::setw(26) << "Probe" << std::right << std::setw(14) << "Count"
+        << std::setw(14) << "Total (ms)" << std::setw(12) << "Avg (ns)" << "\n";
+    for (const ProbeStats& s : snapshot()) {
+        if (s.count == 0) continue;
+        out << std::left << std::setw(26) << s.name << std::right << std::setw(14) << s.count;
+        if (s.total_ns > 0) {
+            out << std::setw(14) << std::fixed << std::setprecision(3) << s.total_ns / 1e6
+                << std::setw(12) << std::setprecision(0) << static_cast<double>(s.total_ns) / s.count;
+        }
+        out << "\n";
+    }
+}
+
+void Instrumentation::startTrace(size_t max_events_per_thread) {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    reg.events.clear();
+    std::fill(reg.events_per_thread.begin(), reg.events_per_thread.end(), 0);
+    reg.max_events_per_thread = max_events_per_thread;
+    reg.trace_start = std::chrono::steady_clock::now();
+    tracing_.store(true, std::memory_order_relaxed);
+}
+
+void Instrumentation::stopTrace() {
+    tracing_.store(false, std::memory_order_relaxed);
+}
+
+bool Instrumentation::writeChromeTrace(const std::string& path) {
+    std::ofstream out(path);
+    if (!out) return false;
+    
+    std::vector<ProbeStats> totals = snapshot();
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    
+    // Trace Event Format: complete ("X") events in microseconds
+    out << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [";
+    bool first = true;
+    int64_t last_ns = 0;
+    out << std::fixed << std::setprecision(3);
+    for (const TraceEvent& e : reg.events) {
+        out << (first ? "\n" : ",\n") << "  {\"name\": \"" << kProbeInfo[static_cast<size_t>(e.probe)].name
+            << "\", \"cat\": \"planner\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << e.thread_id
+            << ", \"ts\": " << e.start_ns / 1e3 << ", \"dur\": " << e.duration_ns / 1e3 << "}";
+        last_ns = std::max(last_ns, e.start_ns + e.duration_ns);
+        first = false;
+    }
+    
+    // Fine-grained probes appear as counter tracks holding their totals
+    for (const ProbeStats& s : totals) {
+        if (s.count == 0) continue;
+        out << (first ? "\n" : ",\n") << "  {\"name\": \"" << s.name
+            << "\", \"cat\": \"totals\", \"ph\": \"C\", \"pid\": 1, \"ts\": " << last_ns / 1e3
+            << ", \"args\": {\"count\": " << s.count << ", \"total_ms\": " << s.total_ns / 1e6 << "}}";
+        first = false;
+    }
+    out << "\n]}\n";
+    return static_cast<bool>(out);
+}
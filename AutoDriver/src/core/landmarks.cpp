@@ -0,0 +1,330 @@
+#include "core/landmarks.h"
+#include "core/mapped_file.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <thread>
+
+namespace {
+
+const char kLandmarkMagic[8] = {'A', 'D', 'A', 'L', 'T', '\r', '\n', '\0'};
+const uint32_t kLandmarkVersion = 2;      // 2: grid content hash in the header
+const size_t kLandmarkHeaderBytes = 40;
+const size_t kLandmarkEntryBytes = 12;
+const size_t kDataAlignment = 64;
+const uint32_t kUnreached = 0xFFFFFFFFu;
+const uint32_t kMaxStored = LandmarkTable::kUnreachable - 1;
+
+void putU32(unsigned char* out, uint32_t v) {
+    for (int i = 0; i < 4; i++) out[i] = static_cast<unsigned char>(v >> (8 * i));
+}
+
+void putU64(unsigned char* out, uint64_t v) {
+    for (int i = 0; i < 8; i++) out[i] = static_cast<unsigned char>(v >> (8 * i));
+}
+
+uint32_t getU32(const unsigned char* in) {
+    uint32_t v = 0;
+    for (int i = 0; i < 4; i++) v |= static_cast<uint32_t>(in[i]) << (8 * i);
+    return v;
+}
+
+uint64_t getU64(const unsigned char* in) {
+    uint64_t v = 0;
+    for (int i = 0; i < 8; i++) v |= static_cast<uint64_t>(in[i]) << (8 * i);
+    return v;
+}
+
+bool hostIsLittleEndian() {
+    uint16_t probe = 1;
+    unsigned char first;
+    std::memcpy(&first, &probe, 1);
+    return first == 1;
+}
+
+bool freeCell(const Grid& grid, int x, int y) {
+    return grid.isValid(x, y) && !grid.isObstacle(x, y);
+}
+
+// 4-connected unit-step distances from source; kUnreached where unreachable.
+// queue is scratch space reused across passes.
+void distancePass(const Grid& grid, Vec2i source, std::vector<uint32_t>& dist, std::vector<int>& queue) {
+    const int width = grid.getWidth();
+    const int height = grid.getHeight();
+    dist.assign(static_cast<size_t>(width) * height, kUnreached);
+    queue.clear();
+    
+    dist[static_cast<size_t>(source.y) * width + source.x] = 0;
+    queue.push_back(source.y * width + source.x);
+    
+    const int dx[] = {0, 0, -1, 1};
+    const int dy[] = {-1, 1, 0, 0};
+    for (size_t head = 0; head < queue.size(); head++) {
+        int index = queue[head];
+        int x = index % width;
+        int y = index / width;
+        uint32_t next = dist[index] + 1;
+        for (int i = 0; i < 4; i++) {
+            int nx = x + dx[i];
+            int ny = y + dy[i];
+            if (!freeCell(grid, nx, ny)) continue;
+            int n = ny * width + nx;
+            if (dist[n] != kUnreached) continue;
+            dist[n] = next;
+            queue.push_back(n);
+        }
+    }
+}
+
+// Smallest step that fits the farthest reached cell into 16 bits, then floor-quantize
+uint32_t quantize(const std::vector<uint32_t>& dist, std::vector<uint16_t>& column) {
+    uint32_t farthest = 0;
+    for (uint32_t d : dist) {
+        if (d != kUnreached) farthest = std::max(farthest, d);
+    }
+    uint32_t step = std::max(1u, (farthest + kMaxStored - 1) / kMaxStored);
+    
+    column.resize(dist.size());
+    for (size_t i = 0; i < dist.size(); i++) {
+        column[i] = dist[i] == kUnreached ? LandmarkTable::kUnreachable : static_cast<uint16_t>(dist[i] / step);
+    }
+    return step;
+}
+
+// Free cells spaced evenly along the border, each found by walking in toward the centre
+std::vector<Vec2i> perimeterLandmarks(const Grid& grid, int count) {
+    const int width = grid.getWidth();
+    const int height = grid.getHeight();
+    const float cx = (width - 1) * 0.5f;
+    const float cy = (height - 1) * 0.5f;
+    const int perimeter = std::max(1, 2 * (width + height) - 4);
+    const int samples = std::max(width, height);
+    
+    std::vector<Vec2i> landmarks;
+    for (int k = 0; k < count; k++) {
+        int t = static_cast<int>(static_cast<int64_t>(k) * perimeter / count);
+        Vec2i border;
+        if (t < width) {
+            border = Vec2i(t, 0);
+        } else if ((t -= width) < height - 1) {
+            border = Vec2i(width - 1, t + 1);
+        } else if ((t -= height - 1) < width - 1) {
+            border = Vec2i(width - 2 - t, height - 1);
+        } else {
+            border = Vec2i(0, std::max(1, height - 2 - (t - (width - 1))));
+        }
+        
+        for (int s = 0; s <= samples; s++) {
+            float f = static_cast<float>(s) / samples;
+            int x = static_cast<int>(border.x + (cx - border.x) * f + 0.5f);
+            int y = static_cast<int>(border.y + (cy - border.y) * f + 0.5f);
+            if (!freeCell(grid, x, y)) continue;
+            if (std::find(landmarks.begin(), landmarks.end(), Vec2i(x, y)) == landmarks.end()) {
+                landmarks.push_back(Vec2i(x, y));
+            }
+            break;
+        }
+    }
+    return landmarks;
+}
+
+}  // namespace
+
+// ============================================================================
+// Building
+// ============================================================================
+
+LandmarkTable::LandmarkTable() : width_(0), height_(0), grid_hash_(0), data_(nullptr), mapped_(false) {}
+
+LandmarkTable LandmarkTable::build(const Grid& grid, const LandmarkOptions& options) {
+    const int count = std::max(0, options.count);
+    if (options.selection == LandmarkSelection::PERIMETER) {
+        return build(grid, perimeterLandmarks(grid, count), options.num_threads);
+    }
+    
+    const int width = grid.getWidth();
+    const size_t cells = static_cast<size_t>(width) * grid.getHeight();
+    
+    // Farthest-point selection needs every earlier pass to pick the next
+    // landmark, so the passes run in sequence and double as the table columns
+    size_t seed = 0;
+    while (seed < cells && !freeCell(grid, static_cast<int>(seed % width), static_cast<int>(seed / width))) seed++;
+    if (count == 0 || seed == cells) return LandmarkTable();
+    
+    std::vector<uint32_t> dist;
+    std::vector<int> queue;
+    distancePass(grid, Vec2i(static_cast<int>(seed % width), static_cast<int>(seed / width)), dist, queue);
+    size_t farthest = queue.back();   // BFS order ends on a farthest cell
+    
+    std::vector<Vec2i> landmarks;
+    std::vector<std::vector<uint16_t>> columns;
+    std::vector<uint32_t> steps;
+    std::vector<uint32_t> min_dist(cells, kUnreached);
+    while (true) {
+        Vec2i landmark(static_cast<int>(farthest % width), static_cast<int>(farthest / width));
+        distancePass(grid, landmark, dist, queue);
+        landmarks.push_back(landmark);
+        columns.emplace_back();
+        steps.push_back(quantize(dist, columns.back()));
+        if (static_cast<int>(landmarks.size()) == count) break;
+        
+        // Next landmark: free cell farthest from all chosen so far; cells no
+        // landmark reaches yet (other components) come first
+        uint32_t best = 0;
+        for (size_t i = 0; i < cells; i++) {
+            min_dist[i] = std::min(min_dist[i], dist[i]);
+            if (min_dist[i] > best && freeCell(grid, static_cast<int>(i % width), static_cast<int>(i / width))) {
+                best = min_dist[i];
+                farthest = i;
+            }
+        }
+        if (best == 0) break;   // Every free cell is already a landmark
+    }
+    return fromColumns(grid, landmarks, columns, steps);
+}
+
+LandmarkTable LandmarkTable::build(const Grid& grid, const std::vector<Vec2i>& landmarks, int num_threads) {
+    std::vector<Vec2i> valid;
+    for (const Vec2i& p : landmarks) {
+        if (freeCell(grid, p.x, p.y)) valid.push_back(p);
+    }
+    if (valid.empty()) return LandmarkTable();
+    
+    // One pass per landmark, pulled by the workers; columns are written per landmark
+    std::vector<std::vector<uint16_t>> columns(valid.size());
+    std::vector<uint32_t> steps(valid.size());
+    std::atomic<size_t> next(0);
+    auto worker = [&]() {
+        std::vector<uint32_t> dist;
+        std::vector<int> queue;
+        for (size_t k = next.fetch_add(1); k < valid.size(); k = next.fetch_add(1)) {
+            distancePass(grid, valid[k], dist, queue);
+            steps[k] = quantize(dist, columns[k]);
+        }
+    };
+    
+    if (num_threads <= 0) num_threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    int workers = static_cast<int>(std::min<size_t>(num_threads, valid.size()));
+    std::vector<std::thread> threads;
+    for (int t = 1; t < workers; t++) threads.emplace_back(worker);
+    worker();
+    for (auto& thread : threads) thread.join();
+    
+    return fromColumns(grid, valid, columns, steps);
+}
+
+LandmarkTable LandmarkTable::fromColumns(const Grid& grid, const std::vector<Vec2i>& landmarks,
+                                         const std::vector<std::vector<uint16_t>>& columns,
+                                         const std::vector<uint32_t>& steps) {
+    LandmarkTable table;
+    table.width_ = grid.getWidth();
+    table.height_ = grid.getHeight();
+    table.grid_hash_ = grid.contentHash();
+    table.landmarks_ = landmarks;
+    table.steps_ = steps;
+    
+    const size_t k_count = landmarks.size();
+    const size_t cells = static_cast<size_t>(table.width_) * table.height_;
+    auto values = std::make_shared<std::vector<uint16_t>>(cells * k_count);
+    uint16_t* out = values->data();
+    for (size_t i = 0; i < cells; i++) {
+        for (size_t k = 0; k < k_count; k++) *out++ = columns[k][i];
+    }
+    table.data_ = values->data();
+    table.storage_ = values;
+    return table;
+}
+
+// ============================================================================
+// File I/O
+// ============================================================================
+
+bool LandmarkTable::save(const std::string& path) const {
+    if (empty()) return false;
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) return false;
+    
+    // Header, landmark entries, then the values aligned for direct mapping
+    const size_t entries_end = kLandmarkHeaderBytes + landmarks_.size() * kLandmarkEntryBytes;
+    const size_t data_offset = (entries_end + kDataAlignment - 1) / kDataAlignment * kDataAlignment;
+    std::vector<unsigned char> head(data_offset, 0);
+    std::memcpy(head.data(), kLandmarkMagic, sizeof(kLandmarkMagic));
+    putU32(head.data() + 8, kLandmarkVersion);
+    putU32(head.data() + 12, static_cast<uint32_t>(width_));
+    putU32(head.data() + 16, static_cast<uint32_t>(height_));
+    putU32(head.data() + 20, static_cast<uint32_t>(landmarks_.size()));
+    putU64(head.data() + 24, data_offset);
+    putU64(head.data() + 32, grid_hash_);
+    for (size_t k = 0; k < landmarks_.size(); k++) {
+        unsigned char* entry = head.data() + kLandmarkHeaderBytes + k * kLandmarkEntryBytes;
+        putU32(entry, static_cast<uint32_t>(landmarks_[k].x));
+        putU32(entry + 4, static_cast<uint32_t>(landmarks_[k].y));
+        putU32(entry + 8, steps_[k]);
+    }
+    file.write(reinterpret_cast<const char*>(head.data()), head.size());
+    
+    // Little-endian regardless of host, a row of cells at a time
+    const size_t row_values = static_cast<size_t>(width_) * landmarks_.size();
+    std::vector<unsigned char> row(row_values * 2);
+    for (int y = 0; y < height_; y++) {
+        const uint16_t* in = distancesAt(0, y);
+        for (size_t i = 0; i < row_values; i++) {
+            row[2 * i] = static_cast<unsigned char>(in[i]);
+            row[2 * i + 1] = static_cast<unsigned char>(in[i] >> 8);
+        }
+        file.write(reinterpret_cast<const char*>(row.data()), row.size());
+    }
+    return static_cast<bool>(file);
+}
+
+bool LandmarkTable::load(const std::string& path, LandmarkTable& out, bool memory_map) {
+    // Values are used in place, so they must already be in host order
+    if (!hostIsLittleEndian()) return false;
+    
+    auto region = std::make_shared<MappedFile>();
+    bool opened = memory_map ? region->map(path) : region->read(path);
+    if (!opened) return false;
+    
+    const unsigned char* data = region->data();
+    const size_t size = region->size();
+    if (size < kLandmarkHeaderBytes || std::memcmp(data, kLandmarkMagic, sizeof(kLandmarkMagic)) != 0 ||
+        getU32(data + 8) != kLandmarkVersion) {
+        return false;
+    }
+    
+    const uint32_t width = getU32(data + 12);
+    const uint32_t height = getU32(data + 16);
+    const uint32_t k_count = getU32(data + 20);
+    const uint64_t data_offset = getU64(data + 24);
+    if (width == 0 || height == 0 || width > 0x7fffffffu || height > 0x7fffffffu || k_count == 0 ||
+        data_offset % kDataAlignment != 0 ||
+        data_offset < kLandmarkHeaderBytes + static_cast<uint64_t>(k_count) * kLandmarkEntryBytes ||
+        data_offset > size) {
+        return false;
+    }
+    const uint64_t values = static_cast<uint64_t>(width) * height * k_count;
+    if ((size - data_offset) / sizeof(uint16_t) < values) return false;
+    
+    LandmarkTable table;
+    table.width_ = static_cast<int>(width);
+    table.height_ = static_cast<int>(height);
+    table.grid_hash_ = getU64(data + 32);
+    for (uint32_t k = 0; k < k_count; k++) {
+        const unsigned char* entry = data + kLandmarkHeaderBytes + k * kLandmarkEntryBytes;
+        Vec2i landmark(static_cast<int>(getU32(entry)), static_cast<int>(getU32(entry + 4)));
+        uint32_t step = getU32(entry + 8);
+        if (landmark.x < 0 || landmark.y < 0 || landmark.x >= table.width_ || landmark.y >= table.height_ ||
+            step == 0) {
+            return false;
+        }
+        table.landmarks_.push_back(landmark);
+        table.steps_.push_back(step);
+    }
+    table.data_ = reinterpret_cast<const uint16_t*>(data + data_offset);
+    table.mapped_ = region->isMapped();
+    table.storage_ = region;
+    
+    out = std::move(table);
+    return true;
+}
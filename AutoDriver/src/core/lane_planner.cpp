@@ -1,45 +1,202 @@
 #include "core/lane_planner.h"
 #include <cmath>
 #include <algorithm>
+#include <limits>
+#include <queue>
+#include <cstdint>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
 
-LanePlanner::LanePlanner(const Grid& grid) : grid_(grid) {}
+namespace {
+
+const float kLaneChangeDuration = 3.0f;
+
+enum EdgeKind : uint8_t { EDGE_NONE, EDGE_FOLLOW, EDGE_CHANGE, EDGE_SUCCESSOR };
+
+// Distance from p to segment ab; t receives the clamped segment parameter
+float segmentDistance(Vec2 p, Vec2 a, Vec2 b, float& t) {
+    Vec2 ab = b - a;
+    float len_sq = ab.x * ab.x + ab.y * ab.y;
+    t = 0.0f;
+    if (len_sq > 1e-12f) {
+        Vec2 ap = p - a;
+        t = std::max(0.0f, std::min(1.0f, (ap.x * ab.x + ap.y * ab.y) / len_sq));
+    }
+    return p.distanceTo(a + ab * t);
+}
+
+// Append points, dropping the first if it repeats the current last point
+void appendWaypoints(std::vector<Vec2>& dst, const std::vector<Vec2>& src) {
+    for (size_t i = 0; i < src.size(); i++) {
+        if (i == 0 && !dst.empty() && dst.back().distanceTo(src[0]) < 1e-4f) continue;
+        dst.push_back(src[i]);
+    }
+}
+
+}  // namespace
+
+LanePlanner::LanePlanner(const Grid& grid)
+    : grid_(grid)
+    , index_dirty_(true)
+    , min_cost_per_meter_(1.0f)
+    , graph_dirty_(true)
+    , segment_length_(5.0f)
+    , lane_change_cost_(5.0f) {}
 
 void LanePlanner::addLane(const Lane& lane) {
+    lane_index_[lane.id] = static_cast<int>(lanes_.size());
     lanes_.push_back(lane);
+    
+    // Cumulative arc length at each centerline waypoint
+    std::vector<float> arc(lane.centerline.size(), 0.0f);
+    for (size_t i = 1; i < lane.centerline.size(); i++) {
+        arc[i] = arc[i - 1] + lane.centerline[i - 1].distanceTo(lane.centerline[i]);
+    }
+    arc_lengths_.push_back(std::move(arc));
+    
+    index_dirty_ = true;
+    graph_dirty_ = true;
 }
 
-int LanePlanner::findClosestLane(Vec2 pos) const {
-    int closest = -1;
-    float min_dist = std::numeric_limits<float>::max();
-    
-    for (size_t i = 0; i < lanes_.size(); i++) {
-        for (const auto& wp : lanes_[i].centerline) {
-            float dist = pos.distanceTo(wp);
-            if (dist < min_dist) {
-                min_dist = dist;
-                closest = static_cast<int>(i);
-            }
-        }
-    }
+int LanePlanner::indexOf(int lane_id) const {
+    auto it = lane_index_.find(lane_id);
+    return it == lane_index_.end() ? -1 : it->second;
+}
+
+const Lane* LanePlanner::getLane(int lane_id) const {
+    int index = indexOf(lane_id);
+    return index < 0 ? nullptr : &lanes_[index];
+}
+
+float LanePlanner::getLaneLength(int lane_id) const {
+    int index = indexOf(lane_id);
+    if (index < 0 || arc_lengths_[index].empty()) return 0.0f;
+    return arc_lengths_[index].back();
+}
+
+// ============================================================================
+// Geometry
+// ============================================================================
+
+Vec2 LanePlanner::positionAt(int lane, float s) const {
+    const auto& points = lanes_[lane].centerline;
+    const auto& arc = arc_lengths_[lane];
+    if (points.empty()) return Vec2(0, 0);
+    if (points.size() == 1) return points[0];
+    
+    s = std::max(0.0f, std::min(s, arc.back()));
     
-    return closest;
+    // Segment containing s by binary search over the arc-length table
+    size_t i = static_cast<size_t>(std::upper_bound(arc.begin(), arc.end(), s) - arc.begin());
+    i = std::min(std::max<size_t>(i, 1), points.size() - 1) - 1;
+    
+    float seg_len = arc[i + 1] - arc[i];
+    float t = seg_len > 0.0f ? (s - arc[i]) / seg_len : 0.0f;
+    return points[i] + (points[i + 1] - points[i]) * t;
 }
 
 Vec2 LanePlanner::getLanePosition(int lane_id, float s) const {
-    if (lane_id < 0 || lane_id >= static_cast<int>(lanes_.size())) {
+    int index = indexOf(lane_id);
+    if (index < 0) {
         return Vec2(0, 0);
     }
+    return positionAt(index, s);
+}
+
+void LanePlanner::buildIndex() const {
+    if (!index_dirty_) return;
     
-    const auto& lane = lanes_[lane_id];
-    if (lane.centerline.empty()) return Vec2(0, 0);
+    std::vector<RTree::Entry> entries;
+    segment_refs_.clear();
     
-    // Simple interpolation along waypoints
-    size_t idx = static_cast<size_t>(s) % lane.centerline.size();
-    return lane.centerline[idx];
+    for (size_t l = 0; l < lanes_.size(); l++) {
+        const auto& points = lanes_[l].centerline;
+        for (size_t i = 0; i + 1 < points.size(); i++) {
+            BoundingBox box(points[i].x, points[i].y, points[i + 1].x, points[i + 1].y);
+            entries.emplace_back(box, static_cast<int>(segment_refs_.size()));
+            segment_refs_.push_back({static_cast<int>(l), static_cast<int>(i)});
+        }
+    }
+    
+    segment_index_.build(std::move(entries));
+    index_dirty_ = false;
+}
+
+LaneProjection LanePlanner::projectIndex(int lane, Vec2 pos) const {
+    LaneProjection projection;
+    projection.lane_id = lanes_[lane].id;
+    
+    const auto& points = lanes_[lane].centerline;
+    if (points.size() < 2) {
+        projection.distance = points.empty() ? std::numeric_limits<float>::max() : pos.distanceTo(points[0]);
+        return projection;
+    }
+    
+    buildIndex();
+    float best_t = 0.0f;
+    int best = segment_index_.nearest(pos, [&](int id) {
+        const SegmentRef& ref = segment_refs_[id];
+        if (ref.lane != lane) return std::numeric_limits<float>::infinity();
+        float t;
+        return segmentDistance(pos, points[ref.segment], points[ref.segment + 1], t);
+    }, &projection.distance);
+    if (best < 0) return projection;
+    
+    const SegmentRef& ref = segment_refs_[best];
+    segmentDistance(pos, points[ref.segment], points[ref.segment + 1], best_t);
+    const auto& arc = arc_lengths_[lane];
+    projection.s = arc[ref.segment] + (arc[ref.segment + 1] - arc[ref.segment]) * best_t;
+    return projection;
+}
+
+LaneProjection LanePlanner::projectOntoLane(int lane_id, Vec2 pos) const {
+    int index = indexOf(lane_id);
+    if (index < 0) return LaneProjection();
+    return projectIndex(index, pos);
+}
+
+LaneProjection LanePlanner::projectOntoNetwork(Vec2 pos) const {
+    LaneProjection projection;
+    buildIndex();
+    
+    float distance = 0.0f;
+    int best = segment_index_.nearest(pos, [&](int id) {
+        const SegmentRef& ref = segment_refs_[id];
+        const auto& points = lanes_[ref.lane].centerline;
+        float t;
+        return segmentDistance(pos, points[ref.segment], points[ref.segment + 1], t);
+    }, &distance);
+    
+    if (best >= 0) {
+        const SegmentRef& ref = segment_refs_[best];
+        const auto& points = lanes_[ref.lane].centerline;
+        const auto& arc = arc_lengths_[ref.lane];
+        float t;
+        segmentDistance(pos, points[ref.segment], points[ref.segment + 1], t);
+        
+        projection.lane_id = lanes_[ref.lane].id;
+        projection.s = arc[ref.segment] + (arc[ref.segment + 1] - arc[ref.segment]) * t;
+        projection.distance = distance;
+        return projection;
+    }
+    
+    // Only single-point lanes (no segments) left to consider
+    for (size_t l = 0; l < lanes_.size(); l++) {
+        if (lanes_[l].centerline.size() != 1) continue;
+        float d = pos.distanceTo(lanes_[l].centerline[0]);
+        if (projection.lane_id < 0 || d < projection.distance) {
+            projection.lane_id = lanes_[l].id;
+            projection.s = 0.0f;
+            projection.distance = d;
+        }
+    }
+    return projection;
+}
+
+int LanePlanner::findClosestLane(Vec2 pos) const {
+    return projectOntoNetwork(pos).lane_id;
 }
 
 float LanePlanner::getLaneCost(int lane_id, float s) const {
@@ -47,60 +204,285 @@ float LanePlanner::getLaneCost(int lane_id, float s) const {
     return 1.0f + std::abs(lane_id - static_cast<int>(lanes_.size()) / 2) * 0.5f;
 }
 
+// ============================================================================
+// Lane segment graph
+// ============================================================================
+
+int LanePlanner::boundaryCount(int lane) const {
+    float length = arc_lengths_[lane].empty() ? 0.0f : arc_lengths_[lane].back();
+    int segments = std::max(1, static_cast<int>(std::ceil(length / segment_length_ - 1e-4f)));
+    return segments + 1;
+}
+
+float LanePlanner::boundaryS(int lane, int k) const {
+    float length = arc_lengths_[lane].empty() ? 0.0f : arc_lengths_[lane].back();
+    return std::min(k * segment_length_, length);
+}
+
+void LanePlanner::buildGraph() {
+    buildIndex();
+    
+    const int num_lanes = static_cast<int>(lanes_.size());
+    node_offset_.assign(num_lanes + 1, 0);
+    for (int l = 0; l < num_lanes; l++) {
+        node_offset_[l + 1] = node_offset_[l] + boundaryCount(l);
+    }
+    
+    node_lane_.resize(node_offset_.back());
+    node_pos_.resize(node_offset_.back());
+    min_cost_per_meter_ = std::numeric_limits<float>::max();
+    
+    for (int l = 0; l < num_lanes; l++) {
+        for (int k = 0; k < boundaryCount(l); k++) {
+            node_lane_[node_offset_[l] + k] = l;
+            node_pos_[node_offset_[l] + k] = positionAt(l, boundaryS(l, k));
+        }
+        min_cost_per_meter_ = std::min(min_cost_per_meter_, getLaneCost(lanes_[l].id, 0.0f));
+    }
+    
+    // A lane change from boundary k lands one segment further along the
+    // neighbour, at the boundary after the projection of the start point
+    lane_change_edges_.assign(num_lanes, {});
+    for (int l = 0; l < num_lanes; l++) {
+        std::vector<int> neighbours = lanes_[l].left_lanes;
+        neighbours.insert(neighbours.end(), lanes_[l].right_lanes.begin(), lanes_[l].right_lanes.end());
+        
+        for (int neighbour_id : neighbours) {
+            int m = indexOf(neighbour_id);
+            if (m < 0 || m == l) continue;
+            
+            float max_offset = 2.0f * std::max(lanes_[l].width, lanes_[m].width);
+            LaneChangeEdges edges;
+            edges.to_lane = m;
+            edges.target.assign(boundaryCount(l), -1);
+            
+            for (int k = 0; k < boundaryCount(l); k++) {
+                LaneProjection projection = projectIndex(m, node_pos_[node_offset_[l] + k]);
+                if (projection.distance > max_offset) continue;
+                
+                int target = static_cast<int>(std::round(projection.s / segment_length_)) + 1;
+                if (target < boundaryCount(m)) {
+                    edges.target[k] = target;
+                }
+            }
+            lane_change_edges_[l].push_back(std::move(edges));
+        }
+    }
+    
+    graph_dirty_ = false;
+}
+
+// ============================================================================
+// Planning
+// ============================================================================
+
 LanePath LanePlanner::findPath(Vec2 start, Vec2 goal) {
     LanePath path;
+    if (lanes_.empty()) return path;
+    if (graph_dirty_) buildGraph();
+    
+    LaneProjection start_proj = projectOntoNetwork(start);
+    LaneProjection goal_proj = projectOntoNetwork(goal);
+    if (start_proj.lane_id < 0 || goal_proj.lane_id < 0) return path;
+    
+    const int start_lane = indexOf(start_proj.lane_id);
+    const int goal_lane = indexOf(goal_proj.lane_id);
+    
+    auto laneCost = [&](int lane) { return getLaneCost(lanes_[lane].id, 0.0f); };
+    
+    // Enter the graph at the first boundary at/after the start, leave it at
+    // the last boundary at/before the goal
+    int start_k = std::min(boundaryCount(start_lane) - 1,
+                           static_cast<int>(std::ceil(start_proj.s / segment_length_ - 1e-4f)));
+    int goal_k = std::min(boundaryCount(goal_lane) - 1,
+                          static_cast<int>(std::floor(goal_proj.s / segment_length_ + 1e-4f)));
+    start_k = std::max(start_k, 0);
+    goal_k = std::max(goal_k, 0);
+    
+    const int start_node = node_offset_[start_lane] + start_k;
+    const int goal_node = node_offset_[goal_lane] + goal_k;
+    const float entry_cost = std::max(0.0f, boundaryS(start_lane, start_k) - start_proj.s) * laneCost(start_lane);
+    const float exit_cost = std::max(0.0f, goal_proj.s - boundaryS(goal_lane, goal_k)) * laneCost(goal_lane);
+    const Vec2 goal_node_pos = node_pos_[goal_node];
     
-    int start_lane = findClosestLane(start);
-    int goal_lane = findClosestLane(goal);
+    // A* over lane boundaries. Every edge costs at least its straight-line
+    // length times the cheapest lane cost, so the heuristic is consistent.
+    const int num_nodes = node_offset_.back();
+    std::vector<float> g_cost(num_nodes, std::numeric_limits<float>::max());
+    std::vector<int> parent(num_nodes, -1);
+    std::vector<uint8_t> edge_kind(num_nodes, EDGE_NONE);
+    std::vector<uint8_t> closed(num_nodes, 0);
     
-    if (start_lane < 0 || goal_lane < 0) return path;
+    using QueueItem = std::pair<float, int>;
+    std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>> open_set;
     
-    // Simple lane sequence: stay in start lane, then change to goal lane
-    path.lane_sequence.push_back(start_lane);
-    if (start_lane != goal_lane) {
-        path.lane_sequence.push_back(goal_lane);
-        path.lane_changes.emplace_back(start_lane, goal_lane, 5.0f, 3.0f);
+    auto heuristic = [&](int node) {
+        return node_pos_[node].distanceTo(goal_node_pos) * min_cost_per_meter_;
+    };
+    auto relax = [&](int from, int to, float cost, EdgeKind kind) {
+        float g = g_cost[from] + cost;
+        if (g < g_cost[to]) {
+            g_cost[to] = g;
+            parent[to] = from;
+            edge_kind[to] = kind;
+            open_set.emplace(g + heuristic(to), to);
+        }
+    };
+    
+    g_cost[start_node] = entry_cost;
+    open_set.emplace(entry_cost + heuristic(start_node), start_node);
+    
+    bool found = false;
+    while (!open_set.empty()) {
+        int u = open_set.top().second;
+        open_set.pop();
+        if (closed[u]) continue;
+        closed[u] = 1;
+        
+        if (u == goal_node) {
+            found = true;
+            break;
+        }
+        
+        int lane = node_lane_[u];
+        int k = u - node_offset_[lane];
+        int count = boundaryCount(lane);
+        
+        if (k + 1 < count) {
+            float length = boundaryS(lane, k + 1) - boundaryS(lane, k);
+            relax(u, u + 1, length * laneCost(lane), EDGE_FOLLOW);
+        }
+        
+        for (const auto& edges : lane_change_edges_[lane]) {
+            int target = edges.target[k];
+            if (target < 0) continue;
+            int v = node_offset_[edges.to_lane] + target;
+            relax(u, v, node_pos_[u].distanceTo(node_pos_[v]) * laneCost(edges.to_lane) + lane_change_cost_,
+                  EDGE_CHANGE);
+        }
+        
+        if (k == count - 1) {
+            for (int successor_id : lanes_[lane].successors) {
+                int m = indexOf(successor_id);
+                if (m < 0) continue;
+                int v = node_offset_[m];
+                relax(u, v, node_pos_[u].distanceTo(node_pos_[v]) * laneCost(m), EDGE_SUCCESSOR);
+            }
+        }
+    }
+    
+    // Staying in the start lane may beat the graph route when both points
+    // fall inside the same segment
+    float direct_cost = std::numeric_limits<float>::max();
+    if (start_lane == goal_lane && start_proj.s <= goal_proj.s) {
+        direct_cost = (goal_proj.s - start_proj.s) * laneCost(start_lane);
+    }
+    float graph_cost = found ? g_cost[goal_node] + exit_cost : std::numeric_limits<float>::max();
+    
+    if (direct_cost <= graph_cost) {
+        if (direct_cost == std::numeric_limits<float>::max()) return path;
+        path.lane_sequence.push_back(lanes_[start_lane].id);
+        path.waypoints = followWaypoints(start_lane, start_proj.s, goal_proj.s);
+        path.total_cost = direct_cost;
+        return path;
     }
     
-    // Generate waypoints
-    path.waypoints = generateLaneFollowingPath(start_lane, 0, 10);
-    if (start_lane != goal_lane) {
-        auto change_waypoints = generateLaneChangeTrajectory(path.lane_changes[0]);
-        path.waypoints.insert(path.waypoints.end(), change_waypoints.begin(), change_waypoints.end());
+    std::vector<int> chain;
+    for (int node = goal_node; node != -1; node = parent[node]) {
+        chain.push_back(node);
+        if (node == start_node) break;
     }
+    std::reverse(chain.begin(), chain.end());
+    
+    // Turn the node chain into lane-following pieces and lane changes
+    int current_lane = start_lane;
+    float current_s = start_proj.s;
+    path.lane_sequence.push_back(lanes_[start_lane].id);
     
-    path.total_cost = static_cast<float>(path.waypoints.size());
+    for (size_t i = 1; i < chain.size(); i++) {
+        int u = chain[i - 1];
+        int v = chain[i];
+        int lane_u = node_lane_[u];
+        int lane_v = node_lane_[v];
+        
+        if (edge_kind[v] == EDGE_CHANGE) {
+            float from_s = boundaryS(lane_u, u - node_offset_[lane_u]);
+            float to_start = projectIndex(lane_v, node_pos_[u]).s;
+            float to_end = boundaryS(lane_v, v - node_offset_[lane_v]);
+            
+            appendWaypoints(path.waypoints, followWaypoints(current_lane, current_s, from_s));
+            appendWaypoints(path.waypoints, laneChangeWaypoints(lane_u, from_s, lane_v, to_start, to_end));
+            path.lane_changes.emplace_back(lanes_[lane_u].id, lanes_[lane_v].id, from_s, kLaneChangeDuration);
+            path.lane_sequence.push_back(lanes_[lane_v].id);
+            
+            current_lane = lane_v;
+            current_s = to_end;
+        } else if (edge_kind[v] == EDGE_SUCCESSOR) {
+            appendWaypoints(path.waypoints,
+                            followWaypoints(current_lane, current_s, arc_lengths_[lane_u].back()));
+            path.lane_sequence.push_back(lanes_[lane_v].id);
+            
+            current_lane = lane_v;
+            current_s = 0.0f;
+        }
+    }
+    appendWaypoints(path.waypoints, followWaypoints(current_lane, current_s, goal_proj.s));
+    
+    path.total_cost = graph_cost;
     return path;
 }
 
-std::vector<Vec2> LanePlanner::generateLaneFollowingPath(int lane_id, float start_s, float end_s) {
+std::vector<Vec2> LanePlanner::followWaypoints(int lane, float start_s, float end_s) const {
     std::vector<Vec2> waypoints;
+    waypoints.push_back(positionAt(lane, start_s));
     
-    if (lane_id < 0 || lane_id >= static_cast<int>(lanes_.size())) {
-        return waypoints;
+    // Interior centerline vertices strictly between start_s and end_s
+    const auto& arc = arc_lengths_[lane];
+    const auto& points = lanes_[lane].centerline;
+    auto first = std::upper_bound(arc.begin(), arc.end(), start_s);
+    for (auto it = first; it != arc.end() && *it < end_s; ++it) {
+        waypoints.push_back(points[it - arc.begin()]);
     }
     
-    const auto& lane = lanes_[lane_id];
-    for (const auto& wp : lane.centerline) {
-        waypoints.push_back(wp);
+    if (end_s > start_s) {
+        waypoints.push_back(positionAt(lane, end_s));
     }
-    
     return waypoints;
 }
 
-std::vector<Vec2> LanePlanner::generateLaneChangeTrajectory(const LaneChangeManeuver& maneuver) {
+std::vector<Vec2> LanePlanner::generateLaneFollowingPath(int lane_id, float start_s, float end_s) {
+    int index = indexOf(lane_id);
+    if (index < 0 || lanes_[index].centerline.empty()) {
+        return std::vector<Vec2>();
+    }
+    return followWaypoints(index, start_s, end_s);
+}
+
+std::vector<Vec2> LanePlanner::laneChangeWaypoints(int from, float from_s, int to,
+                                                   float to_start_s, float to_end_s) const {
     std::vector<Vec2> waypoints;
+    float span = to_end_s - to_start_s;
     
-    // Simple S-curve for lane change
+    // Smooth S-curve blending the two centerlines
     for (int i = 0; i <= 10; i++) {
         float t = i / 10.0f;
-        Vec2 from_pos = getLanePosition(maneuver.from_lane, maneuver.start_s + t * 5.0f);
-        Vec2 to_pos = getLanePosition(maneuver.to_lane, maneuver.start_s + t * 5.0f);
+        Vec2 from_pos = positionAt(from, from_s + t * span);
+        Vec2 to_pos = positionAt(to, to_start_s + t * span);
         
-        // Smooth interpolation
-        float s = 0.5f * (1.0f - std::cos(t * M_PI));
-        waypoints.push_back(from_pos + (to_pos - from_pos) * s);
+        float blend = 0.5f * (1.0f - std::cos(t * M_PI));
+        waypoints.push_back(from_pos + (to_pos - from_pos) * blend);
     }
     
     return waypoints;
 }
+
+std::vector<Vec2> LanePlanner::generateLaneChangeTrajectory(const LaneChangeManeuver& maneuver) {
+    int from = indexOf(maneuver.from_lane);
+    int to = indexOf(maneuver.to_lane);
+    if (from < 0 || to < 0) {
+        return std::vector<Vec2>();
+    }
+    
+    float to_start = projectIndex(to, positionAt(from, maneuver.start_s)).s;
+    return laneChangeWaypoints(from, maneuver.start_s, to, to_start, to_start + segment_length_);
+}
@@ -0,0 +1,628 @@
+#include "core/map_io.h"
+#include "core/mapped_file.h"
+#include <fstream>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <cctype>
+
+#ifdef AUTODRIVER_HAVE_PNG
+#include <png.h>
+#include <csetjmp>
+#endif
+
+// ============================================================================
+// File Layout
+// ============================================================================
+
+namespace {
+
+const char kMagic[8] = {'A', 'D', 'M', 'A', 'P', '\r', '\n', '\0'};
+const uint32_t kFormatVersion = 1;
+const size_t kHeaderBytes = 64;
+const size_t kIndexEntryBytes = 16;
+const size_t kTileBytes = Grid::kTileSize * sizeof(uint64_t);
+const size_t kRawAlignment = 64;
+const int kTileCells = Grid::kTileSize * Grid::kTileSize;
+
+enum TileEncoding : uint32_t {
+    TILE_EMPTY = 0,
+    TILE_FULL = 1,
+    TILE_RAW = 2,   // kTileBytes of little-endian bit rows
+    TILE_RLE = 3    // uint16 run lengths over the tile's cells in row-major order, free first
+};
+
+struct Header {
+    uint32_t version;
+    uint32_t width, height;
+    uint32_t tile_shift;
+    uint32_t tiles_x, tiles_y;
+    uint32_t flags;
+    uint64_t index_offset;
+    uint64_t data_offset;
+};
+
+void putU32(unsigned char* out, uint32_t v) {
+    for (int i = 0; i < 4; i++) out[i] = static_cast<unsigned char>(v >> (8 * i));
+}
+
+void putU64(unsigned char* out, uint64_t v) {
+    for (int i = 0; i < 8; i++) out[i] = static_cast<unsigned char>(v >> (8 * i));
+}
+
+uint32_t getU32(const unsigned char* in) {
+    uint32_t v = 0;
+    for (int i = 0; i < 4; i++) v |= static_cast<uint32_t>(in[i]) << (8 * i);
+    return v;
+}
+
+uint64_t getU64(const unsigned char* in) {
+    uint64_t v = 0;
+    for (int i = 0; i < 8; i++) v |= static_cast<uint64_t>(in[i]) << (8 * i);
+    return v;
+}
+
+bool hostIsLittleEndian() {
+    uint16_t probe = 1;
+    unsigned char first;
+    std::memcpy(&first, &probe, 1);
+    return first == 1;
+}
+
+// Valid-cell masks of tile (tx, ty): column bits, and number of rows inside the grid
+uint64_t columnMask(int width, int tx) {
+    int cols = width - (tx << Grid::kTileShift);
+    return cols >= Grid::kTileSize ? ~uint64_t(0) : (uint64_t(1) << cols) - 1;
+}
+
+int validRows(int height, int ty) {
+    int rows = height - (ty << Grid::kTileShift);
+    return rows >= Grid::kTileSize ? Grid::kTileSize : rows;
+}
+
+// Run lengths of alternating free/blocked cells, starting with free. Returns
+// false once the encoding would be no smaller than the raw tile.
+bool encodeRuns(const uint64_t* rows, std::vector<uint16_t>& runs) {
+    runs.clear();
+    bool current = false;
+    int length = 0;
+    for (int cell = 0; cell < kTileCells; cell++) {
+        bool bit = (rows[cell >> Grid::kTileShift] >> (cell & (Grid::kTileSize - 1))) & 1u;
+        if (bit != current) {
+            runs.push_back(static_cast<uint16_t>(length));
+            if (runs.size() * sizeof(uint16_t) >= kTileBytes) return false;
+            current = bit;
+            length = 0;
+        }
+        length++;
+    }
+    runs.push_back(static_cast<uint16_t>(length));
+    return runs.size() * sizeof(uint16_t) < kTileBytes;
+}
+
+bool decodeRuns(const unsigned char* data, size_t bytes, uint64_t* rows) {
+    if (bytes % 2 != 0) return false;
+    for (int i = 0; i < Grid::kTileSize; i++) rows[i] = 0;
+    
+    int cell = 0;
+    bool blocked = false;
+    for (size_t i = 0; i < bytes; i += 2) {
+        int length = data[i] | (data[i + 1] << 8);
+        if (length > kTileCells - cell) return false;
+        if (blocked) {
+            for (int c = cell; c < cell + length; c++) {
+                rows[c >> Grid::kTileShift] |= uint64_t(1) << (c & (Grid::kTileSize - 1));
+            }
+        }
+        cell += length;
+        blocked = !blocked;
+    }
+    return cell == kTileCells;
+}
+
+}  // namespace
+
+// ============================================================================
+// Writing
+// ============================================================================
+
+bool MapIO::save(const Grid& grid, const std::string& path,
+                 const MapSaveOptions& options, MapFileInfo* info) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) return false;
+    
+    const int tiles_x = grid.getTilesX();
+    const int tiles_y = grid.getTilesY();
+    const size_t tile_count = static_cast<size_t>(tiles_x) * tiles_y;
+    const uint64_t index_offset = kHeaderBytes;
+    const uint64_t index_end = index_offset + tile_count * kIndexEntryBytes;
+    const uint64_t data_offset = (index_end + kRawAlignment - 1) / kRawAlignment * kRawAlignment;
+    
+    unsigned char header[kHeaderBytes] = {};
+    std::memcpy(header, kMagic, sizeof(kMagic));
+    putU32(header + 8, kFormatVersion);
+    putU32(header + 12, static_cast<uint32_t>(grid.getWidth()));
+    putU32(header + 16, static_cast<uint32_t>(grid.getHeight()));
+    putU32(header + 20, Grid::kTileShift);
+    putU32(header + 24, static_cast<uint32_t>(tiles_x));
+    putU32(header + 28, static_cast<uint32_t>(tiles_y));
+    putU32(header + 32, options.compress ? 1u : 0u);
+    putU64(header + 40, index_offset);
+    putU64(header + 48, data_offset);
+    file.write(reinterpret_cast<const char*>(header), kHeaderBytes);
+    
+    // Tile records are streamed after the index, which is filled in on the way
+    std::vector<unsigned char> index(tile_count * kIndexEntryBytes);
+    file.write(reinterpret_cast<const char*>(index.data()), index.size());
+    const char padding[kRawAlignment] = {};
+    file.write(padding, data_offset - index_end);
+    
+    MapFileInfo summary;
+    summary.width = grid.getWidth();
+    summary.height = grid.getHeight();
+    summary.tiles_x = tiles_x;
+    summary.tiles_y = tiles_y;
+    
+    uint64_t offset = data_offset;
+    std::vector<uint16_t> runs;
+    unsigned char record[kTileBytes];
+    
+    for (int ty = 0; ty < tiles_y; ty++) {
+        const int rows_valid = validRows(grid.getHeight(), ty);
+        for (int tx = 0; tx < tiles_x; tx++) {
+            const size_t t = static_cast<size_t>(ty) * tiles_x + tx;
+            const uint64_t* rows = grid.tiles_[t].rows();
+            const uint64_t mask = columnMask(grid.getWidth(), tx);
+            
+            bool empty = true, full = true;
+            for (int r = 0; r < Grid::kTileSize; r++) {
+                if (rows[r] != 0) empty = false;
+                if (r < rows_valid && (rows[r] & mask) != mask) full = false;
+            }
+            
+            uint32_t encoding;
+            uint64_t length = 0;
+            if (empty) {
+                encoding = TILE_EMPTY;
+                summary.empty_tiles++;
+            } else if (full) {
+                encoding = TILE_FULL;
+                summary.full_tiles++;
+            } else if (options.compress && encodeRuns(rows, runs)) {
+                encoding = TILE_RLE;
+                length = runs.size() * sizeof(uint16_t);
+                for (size_t i = 0; i < runs.size(); i++) {
+                    record[2 * i] = static_cast<unsigned char>(runs[i]);
+                    record[2 * i + 1] = static_cast<unsigned char>(runs[i] >> 8);
+                }
+                summary.rle_tiles++;
+            } else {
+                // Raw records stay aligned so a mapped file can be read in place
+                uint64_t aligned = (offset + kRawAlignment - 1) / kRawAlignment * kRawAlignment;
+                file.write(padding, aligned - offset);
+                offset = aligned;
+                encoding = TILE_RAW;
+                length = kTileBytes;
+                for (int r = 0; r < Grid::kTileSize; r++) putU64(record + 8 * r, rows[r]);
+                summary.raw_tiles++;
+            }
+            
+            putU64(&index[t * kIndexEntryBytes], length ? offset : 0);
+            putU32(&index[t * kIndexEntryBytes + 8], static_cast<uint32_t>(length));
+            putU32(&index[t * kIndexEntryBytes + 12], encoding);
+            if (length) {
+                file.write(reinterpret_cast<const char*>(record), length);
+                offset += length;
+            }
+        }
+    }
+    
+    file.seekp(static_cast<std::streamoff>(index_offset));
+    file.write(reinterpret_cast<const char*>(index.data()), index.size());
+    file.flush();
+    if (!file) return false;
+    
+    summary.file_bytes = offset;
+    if (info) *info = summary;
+    return true;
+}
+
+// ============================================================================
+// Loading
+// ============================================================================
+
+MapLoadResult MapIO::load(const std::string& path, const MapLoadOptions& options) {
+    MapLoadResult result;
+    
+    if (!hostIsLittleEndian()) {
+        result.error = "map files can only be loaded on little-endian hosts";
+        return result;
+    }
+    
+    auto region = std::make_shared<MappedFile>();
+    bool opened = options.memory_map ? region->map(path) : region->read(path);
+    if (!opened) {
+        result.error = "cannot open " + path;
+        return result;
+    }
+    
+    const unsigned char* data = region->data();
+    const size_t size = region->size();
+    if (size < kHeaderBytes || std::memcmp(data, kMagic, sizeof(kMagic)) != 0) {
+        result.error = "not a map file";
+        return result;
+    }
+    
+    Header header;
+    header.version = getU32(data + 8);
+    header.width = getU32(data + 12);
+    header.height = getU32(data + 16);
+    header.tile_shift = getU32(data + 20);
+    header.tiles_x = getU32(data + 24);
+    header.tiles_y = getU32(data + 28);
+    header.flags = getU32(data + 32);
+    header.index_offset = getU64(data + 40);
+    header.data_offset = getU64(data + 48);
+    
+    if (header.version != kFormatVersion) {
+        result.error = "unsupported map format version";
+        return result;
+    }
+    if (header.tile_shift != static_cast<uint32_t>(Grid::kTileShift) ||
+        header.width == 0 || header.height == 0 ||
+        header.width > 0x7fffffffu || header.height > 0x7fffffffu ||
+        header.tiles_x != (header.width + Grid::kTileSize - 1) >> Grid::kTileShift ||
+        header.tiles_y != (header.height + Grid::kTileSize - 1) >> Grid::kTileShift) {
+        result.error = "inconsistent map header";
+        return result;
+    }
+    
+    const size_t tile_count = static_cast<size_t>(header.tiles_x) * header.tiles_y;
+    if (header.index_offset > size || (size - header.index_offset) / kIndexEntryBytes < tile_count) {
+        result.error = "truncated tile index";
+        return result;
+    }
+    
+    auto grid = std::make_unique<Grid>(static_cast<int>(header.width), static_cast<int>(header.height));
+    
+    // One holder tile pins the region for every tile that aliases it
+    Grid::Tile* holder = new Grid::Tile();
+    holder->backing = region;
+    Grid::TileRef mapped(holder);
+    Grid::Tile* full_tile = new Grid::Tile();
+    for (int r = 0; r < Grid::kTileSize; r++) full_tile->rows[r] = ~uint64_t(0);
+    Grid::TileRef full(full_tile);
+    
+    MapFileInfo& info = result.info;
+    info.width = grid->getWidth();
+    info.height = grid->getHeight();
+    info.tiles_x = grid->getTilesX();
+    info.tiles_y = grid->getTilesY();
+    info.file_bytes = size;
+    
+    const unsigned char* index = data + header.index_offset;
+    for (size_t t = 0; t < tile_count; t++) {
+        const unsigned char* entry = index + t * kIndexEntryBytes;
+        const uint64_t offset = getU64(entry);
+        const uint32_t length = getU32(entry + 8);
+        const uint32_t encoding = getU32(entry + 12);
+        const int tx = static_cast<int>(t % header.tiles_x);
+        const int ty = static_cast<int>(t / header.tiles_x);
+        const uint64_t mask = columnMask(grid->getWidth(), tx);
+        const int rows_valid = validRows(grid->getHeight(), ty);
+        const bool edge = mask != ~uint64_t(0) || rows_valid != Grid::kTileSize;
+        
+        if (encoding != TILE_EMPTY && encoding != TILE_FULL &&
+            (offset > size || length > size - offset)) {
+            result.error = "tile record outside the file";
+            return result;
+        }
+        
+        Grid::TileRef& slot = grid->tiles_[t];
+        if (encoding == TILE_EMPTY) {
+            info.empty_tiles++;
+        } else if (encoding == TILE_FULL) {
+            slot = full;
+            info.full_tiles++;
+        } else if (encoding == TILE_RAW) {
+            if (length != kTileBytes || offset % sizeof(uint64_t) != 0) {
+                result.error = "malformed raw tile";
+                return result;
+            }
+            slot = Grid::TileRef(mapped, reinterpret_cast<const uint64_t*>(data + offset));
+            info.raw_tiles++;
+        } else if (encoding == TILE_RLE) {
+            Grid::Tile* tile = slot.mutate(grid->tiles_cloned_);
+            if (!decodeRuns(data + offset, length, tile->rows)) {
+                result.error = "malformed run-length tile";
+                return result;
+            }
+            info.rle_tiles++;
+        } else {
+            result.error = "unknown tile encoding";
+            return result;
+        }
+        
+        // Keep the invariant that cells outside the grid are free. Only edge
+        // tiles need checking, so interior raw tiles are never touched here.
+        if (edge && encoding != TILE_EMPTY) {
+            const uint64_t* rows = slot.rows();
+            bool clean = true;
+            for (int r = 0; r < Grid::kTileSize; r++) {
+                uint64_t allowed = r < rows_valid ? mask : 0;
+                if (rows[r] & ~allowed) clean = false;
+            }
+            if (!clean) {
+                Grid::Tile* tile = slot.mutate(grid->tiles_cloned_);
+                for (int r = 0; r < Grid::kTileSize; r++) tile->rows[r] &= r < rows_valid ? mask : 0;
+            }
+        }
+    }
+    
+    grid->tiles_cloned_ = 0;
+    result.grid = std::move(grid);
+    result.memory_mapped = region->isMapped();
+    result.success = true;
+    return result;
+}
+
+// ============================================================================
+// Image Import
+// ============================================================================
+
+bool MapIO::pngSupported() {
+#ifdef AUTODRIVER_HAVE_PNG
+    return true;
+#else
+    return false;
+#endif
+}
+
+MapLoadResult MapIO::importImage(const std::string& path, const ImageImportOptions& options) {
+    std::ifstream file(path, std::ios::binary);
+    unsigned char signature[8] = {};
+    if (!file || !file.read(reinterpret_cast<char*>(signature), sizeof(signature))) {
+        MapLoadResult result;
+        result.error = "cannot read " + path;
+        return result;
+    }
+    file.close();
+    
+    if (signature[0] == 'P' && (signature[1] == '2' || signature[1] == '5')) {
+        return importPgm(path, options);
+    }
+    const unsigned char png_signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+    if (std::memcmp(signature, png_signature, sizeof(png_signature)) == 0) {
+        return importPng(path, options);
+    }
+    
+    MapLoadResult result;
+    result.error = "unrecognised image format";
+    return result;
+}
+
+void MapIO::storeImageRow(Grid& grid, int y, const unsigned char* pixels,
+                          const ImageImportOptions& options) {
+    const int width = grid.getWidth();
+    const size_t row_base = static_cast<size_t>(y >> Grid::kTileShift) * grid.getTilesX();
+    
+    for (int tx = 0; tx < grid.getTilesX(); tx++) {
+        const int x0 = tx << Grid::kTileShift;
+        const int x1 = std::min(width, x0 + Grid::kTileSize);
+        uint64_t bits = 0;
+        for (int x = x0; x < x1; x++) {
+            bool dark = pixels[x] < options.occupied_threshold;
+            if (dark != options.negate) bits |= uint64_t(1) << (x - x0);
+        }
+        if (bits) {
+            // Rows without obstacles leave the shared empty tile in place
+            grid.tiles_[row_base + tx].mutate(grid.tiles_cloned_)->rows[y & (Grid::kTileSize - 1)] = bits;
+        }
+    }
+}
+
+void MapIO::finishImport(MapLoadResult& result) {
+    Grid& grid = *result.grid;
+    grid.tiles_cloned_ = 0;
+    
+    MapFileInfo& info = result.info;
+    info.width = grid.getWidth();
+    info.height = grid.getHeight();
+    info.tiles_x = grid.getTilesX();
+    info.tiles_y = grid.getTilesY();
+    
+    for (const auto& tile : grid.tiles_) {
+        bool empty = true;
+        for (int r = 0; r < Grid::kTileSize; r++) {
+            if (tile.rows()[r] != 0) empty = false;
+        }
+        if (empty) info.empty_tiles++;
+        else info.raw_tiles++;
+    }
+    result.success = true;
+}
+
+namespace {
+
+// Next whitespace-separated token of a PGM header, skipping # comments
+bool readPgmToken(std::istream& in, std::string& token) {
+    token.clear();
+    int c;
+    while ((c = in.get()) != EOF) {
+        if (c == '#') {
+            while ((c = in.get()) != EOF && c != '\n') {}
+        } else if (!std::isspace(c)) {
+            token.push_back(static_cast<char>(c));
+            break;
+        }
+    }
+    while ((c = in.peek()) != EOF && !std::isspace(c) && c != '#') {
+        token.push_back(static_cast<char>(in.get()));
+    }
+    return !token.empty();
+}
+
+bool parseNumber(const std::string& token, long min_value, long max_value, int& value) {
+    if (token.empty() || token.size() > 10) return false;
+    long v = 0;
+    for (char c : token) {
+        if (c < '0' || c > '9') return false;
+        v = v * 10 + (c - '0');
+    }
+    if (v < min_value || v > max_value) return false;
+    value = static_cast<int>(v);
+    return true;
+}
+
+}  // namespace
+
+MapLoadResult MapIO::importPgm(const std::string& path, const ImageImportOptions& options) {
+    MapLoadResult result;
+    std::ifstream file(path, std::ios::binary);
+    
+    std::string magic, token;
+    int width = 0, height = 0, maxval = 0;
+    if (!readPgmToken(file, magic) ||
+        !readPgmToken(file, token) || !parseNumber(token, 1, 0x7fffffff, width) ||
+        !readPgmToken(file, token) || !parseNumber(token, 1, 0x7fffffff, height) ||
+        !readPgmToken(file, token) || !parseNumber(token, 1, 65535, maxval)) {
+        result.error = "malformed PGM header";
+        return result;
+    }
+    const bool binary = magic == "P5";
+    if (binary) file.get();  // Single whitespace before the raster
+    
+    // The header is not trusted until the raster fits in what is left of the
+    // file: a P5 sample takes sample_bytes, a P2 sample a digit and a separator
+    const int sample_bytes = maxval > 255 ? 2 : 1;
+    const std::streamoff raster_start = file.tellg();
+    file.seekg(0, std::ios::end);
+    const std::streamoff file_end = file.tellg();
+    file.seekg(raster_start);
+    uint64_t remaining = 0;
+    if (raster_start >= 0 && file_end > raster_start) remaining = static_cast<uint64_t>(file_end - raster_start);
+    const uint64_t max_samples = binary ? remaining / sample_bytes : (remaining + 1) / 2;
+    if (static_cast<uint64_t>(height) > max_samples / static_cast<uint64_t>(width)) {
+        result.error = "truncated PGM raster";
+        return result;
+    }
+    
+    result.grid = std::make_unique<Grid>(width, height);
+    std::vector<unsigned char> raw(static_cast<size_t>(width) * sample_bytes);
+    std::vector<unsigned char> gray(width);
+    
+    for (int y = 0; y < height; y++) {
+        if (binary) {
+            if (!file.read(reinterpret_cast<char*>(raw.data()), raw.size())) {
+                result.grid.reset();
+                result.error = "truncated PGM raster";
+                return result;
+            }
+        }
+        for (int x = 0; x < width; x++) {
+            int value;
+            if (binary) {
+                value = sample_bytes == 2 ? (raw[2 * x] << 8) | raw[2 * x + 1] : raw[x];
+            } else if (!readPgmToken(file, token) || !parseNumber(token, 0, 65535, value)) {
+                result.grid.reset();
+                result.error = "truncated PGM raster";
+                return result;
+            }
+            gray[x] = static_cast<unsigned char>(std::min(value, maxval) * 255 / maxval);
+        }
+        storeImageRow(*result.grid, y, gray.data(), options);
+    }
+    
+    finishImport(result);
+    return result;
+}
+
+#ifdef AUTODRIVER_HAVE_PNG
+
+namespace {
+
+// libpng reports errors by longjmp; these wrappers keep every setjmp in a
+// frame without C++ objects so nothing with a destructor is skipped.
+bool pngReadHeader(png_structp png, png_infop info, FILE* fp,
+                   png_uint_32& width, png_uint_32& height, bool& supported) {
+    if (setjmp(png_jmpbuf(png))) return false;
+    
+    png_init_io(png, fp);
+    png_read_info(png, info);
+    width = png_get_image_width(png, info);
+    height = png_get_image_height(png, info);
+    supported = png_get_interlace_type(png, info) == PNG_INTERLACE_NONE &&
+                width <= 0x7fffffffu && height <= 0x7fffffffu;
+    if (!supported) return true;
+    
+    // Normalise every colour type to 8-bit gray
+    int color_type = png_get_color_type(png, info);
+    png_set_strip_16(png);
+    png_set_strip_alpha(png);
+    png_set_packing(png);
+    if (color_type == PNG_COLOR_TYPE_PALETTE) png_set_palette_to_rgb(png);
+    if (color_type == PNG_COLOR_TYPE_GRAY) png_set_expand_gray_1_2_4_to_8(png);
+    if ((color_type & PNG_COLOR_MASK_COLOR) || color_type == PNG_COLOR_TYPE_PALETTE) {
+        png_set_rgb_to_gray_fixed(png, 1, -1, -1);
+    }
+    png_read_update_info(png, info);
+    return true;
+}
+
+bool pngReadRow(png_structp png, unsigned char* row) {
+    if (setjmp(png_jmpbuf(png))) return false;
+    png_read_row(png, row, nullptr);
+    return true;
+}
+
+}  // namespace
+
+MapLoadResult MapIO::importPng(const std::string& path, const ImageImportOptions& options) {
+    MapLoadResult result;
+    FILE* fp = std::fopen(path.c_str(), "rb");
+    if (!fp) {
+        result.error = "cannot open " + path;
+        return result;
+    }
+    
+    png_structp png = png_create_read_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
+    png_infop info = png ? png_create_info_struct(png) : nullptr;
+    
+    png_uint_32 width = 0, height = 0;
+    bool supported = false;
+    if (!info) {
+        result.error = "out of memory";
+    } else if (!pngReadHeader(png, info, fp, width, height, supported)) {
+        result.error = "corrupt PNG";
+    } else if (!supported) {
+        result.error = "unsupported PNG layout (interlaced or oversized)";
+    } else {
+        result.grid = std::make_unique<Grid>(static_cast<int>(width), static_cast<int>(height));
+        std::vector<unsigned char> gray(png_get_rowbytes(png, info));
+        for (png_uint_32 y = 0; y < height; y++) {
+            if (!pngReadRow(png, gray.data())) {
+                result.grid.reset();
+                result.error = "corrupt PNG";
+                break;
+            }
+            storeImageRow(*result.grid, static_cast<int>(y), gray.data(), options);
+        }
+    }
+    
+    png_destroy_read_struct(&png, info ? &info : nullptr, nullptr);
+    std::fclose(fp);
+    
+    if (result.grid) finishImport(result);
+    return result;
+}
+
+#else
+
+MapLoadResult MapIO::importPng(const std::string& path, const ImageImportOptions& options) {
+    (void)options;
+    MapLoadResult result;
+    result.error = "PNG support not built in (libpng not found); convert " + path + " to PGM";
+    return result;
+}
+
+#endif
@@ -0,0 +1,76 @@
+#include "core/mapped_file.h"
+#include <fstream>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile() : data_(nullptr), size_(0), mapped_(false) {
+#if defined(_WIN32)
+    file_ = INVALID_HANDLE_VALUE;
+    mapping_ = nullptr;
+#endif
+}
+
+MappedFile::~MappedFile() {
+#if defined(_WIN32)
+    if (mapped_) UnmapViewOfFile(data_);
+    if (mapping_) CloseHandle(mapping_);
+    if (file_ != INVALID_HANDLE_VALUE) CloseHandle(file_);
+#else
+    if (mapped_) munmap(const_cast<unsigned char*>(data_), size_);
+#endif
+}
+
+bool MappedFile::map(const std::string& path) {
+#if defined(_WIN32)
+    file_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file_ == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file_, &size) || size.QuadPart == 0) return false;
+    mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping_) return false;
+    void* view = MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0);
+    if (!view) return false;
+    data_ = static_cast<const unsigned char*>(view);
+    size_ = static_cast<size_t>(size.QuadPart);
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        return false;
+    }
+    void* view = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (view == MAP_FAILED) return false;
+    data_ = static_cast<const unsigned char*>(view);
+    size_ = static_cast<size_t>(st.st_size);
+#endif
+    mapped_ = true;
+    return true;
+}
+
+bool MappedFile::read(const std::string& path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) return false;
+    std::streamoff size = file.tellg();
+    if (size <= 0) return false;
+    
+    // uint64_t storage keeps raw rows aligned
+    buffer_.resize((static_cast<size_t>(size) + 7) / 8);
+    file.seekg(0);
+    if (!file.read(reinterpret_cast<char*>(buffer_.data()), size)) return false;
+    data_ = reinterpret_cast<const unsigned char*>(buffer_.data());
+    size_ = static_cast<size_t>(size);
+    return true;
+}
@@ -1,61 +1,103 @@
 #include "core/multi_agent.h"
 #include <cmath>
 #include <algorithm>
+#include <atomic>
+
+namespace {
+
+const float kAvoidanceRadius = 3.0f;   // Agents closer than this repel each other
+const size_t kAgentsPerChunk = 256;    // Work unit for update() workers
+
+}  // namespace
 
 MultiAgentPlanner::MultiAgentPlanner(const Grid& grid)
-    : grid_(grid) {
+    : grid_(grid), num_threads_(1), bucket_size_(kAvoidanceRadius), bucket_cols_(0), bucket_rows_(0) {
     planner_ = std::make_unique<AStar>(grid);
 }
 
 void MultiAgentPlanner::addAgent(const Agent& agent) {
-    agents_.push_back(agent);
+    ids_.push_back(agent.id);
+    pos_x_.push_back(agent.position.x);
+    pos_y_.push_back(agent.position.y);
+    vel_x_.push_back(agent.velocity.x);
+    vel_y_.push_back(agent.velocity.y);
+    goal_x_.push_back(agent.goal.x);
+    goal_y_.push_back(agent.goal.y);
+    radius_.push_back(agent.radius);
+    path_index_.push_back(agent.path_index);
+    paths_.push_back(agent.planned_path);
+}
+
+void MultiAgentPlanner::reserve(size_t count) {
+    for (auto* v : {&pos_x_, &pos_y_, &vel_x_, &vel_y_, &goal_x_, &goal_y_, &radius_}) v->reserve(count);
+    ids_.reserve(count);
+    path_index_.reserve(count);
+    paths_.reserve(count);
+}
+
+Agent MultiAgentPlanner::getAgent(size_t index) const {
+    Agent agent(ids_[index], Vec2(pos_x_[index], pos_y_[index]), Vec2(goal_x_[index], goal_y_[index]),
+                radius_[index]);
+    agent.velocity = Vec2(vel_x_[index], vel_y_[index]);
+    agent.planned_path = paths_[index];
+    agent.path_index = path_index_[index];
+    return agent;
+}
+
+std::vector<Agent> MultiAgentPlanner::getAgents() const {
+    std::vector<Agent> agents;
+    agents.reserve(size());
+    for (size_t i = 0; i < size(); i++) agents.push_back(getAgent(i));
+    return agents;
+}
+
+void MultiAgentPlanner::planAgent(size_t index) {
+    Vec2i start(static_cast<int>(pos_x_[index]), static_cast<int>(pos_y_[index]));
+    Vec2i goal(static_cast<int>(goal_x_[index]), static_cast<int>(goal_y_[index]));
+    
+    auto result = planner_->findPath(start, goal);
+    
+    if (result.success) {
+        std::vector<Vec2>& path = paths_[index];
+        path.clear();
+        for (const auto& p : result.path) {
+            path.emplace_back(static_cast<float>(p.x), static_cast<float>(p.y));
+        }
+        path_index_[index] = 0;
+    }
 }
 
 void MultiAgentPlanner::planPaths() {
     // Plan path for each agent
-    for (auto& agent : agents_) {
-        Vec2i start(static_cast<int>(agent.position.x), static_cast<int>(agent.position.y));
-        Vec2i goal(static_cast<int>(agent.goal.x), static_cast<int>(agent.goal.y));
-        
-        auto result = planner_->findPath(start, goal);
-        
-        if (result.success) {
-            agent.planned_path.clear();
-            for (const auto& p : result.path) {
-                agent.planned_path.emplace_back(static_cast<float>(p.x), static_cast<float>(p.y));
-            }
-            agent.path_index = 0;
-        }
+    for (size_t i = 0; i < size(); i++) {
+        planAgent(i);
     }
 }
 
 bool MultiAgentPlanner::checkCollision(int agent1, int agent2, float time_horizon) const {
-    if (agent1 >= static_cast<int>(agents_.size()) || 
-        agent2 >= static_cast<int>(agents_.size())) {
+    if (agent1 >= static_cast<int>(size()) ||
+        agent2 >= static_cast<int>(size())) {
         return false;
     }
     
-    const auto& a1 = agents_[agent1];
-    const auto& a2 = agents_[agent2];
-    
     // Simple distance check
-    float dist = a1.position.distanceTo(a2.position);
-    float collision_dist = a1.radius + a2.radius + 0.5f;
+    Vec2 p1(pos_x_[agent1], pos_y_[agent1]);
+    Vec2 p2(pos_x_[agent2], pos_y_[agent2]);
+    float dist = p1.distanceTo(p2);
+    float collision_dist = radius_[agent1] + radius_[agent2] + 0.5f;
     
     return dist < collision_dist;
 }
 
 bool MultiAgentPlanner::isPathSafe(const std::vector<Vec2i>& path, int agent_id) const {
     // Simplified safety check: ensure path doesn't intersect with other agents' current positions
-    const auto& agent = agents_[agent_id];
-    
-    for (size_t i = 0; i < agents_.size(); i++) {
+    for (size_t i = 0; i < size(); i++) {
         if (static_cast<int>(i) == agent_id) continue;
         
-        Vec2 other_pos = agents_[i].position;
+        Vec2 other_pos(pos_x_[i], pos_y_[i]);
         for (const auto& wp : path) {
             Vec2 wp_f(static_cast<float>(wp.x), static_cast<float>(wp.y));
-            if (wp_f.distanceTo(other_pos) < agent.radius + agents_[i].radius + 1.0f) {
+            if (wp_f.distanceTo(other_pos) < radius_[agent_id] + radius_[i] + 1.0f) {
                 return false;
             }
         }
@@ -64,24 +106,66 @@ bool MultiAgentPlanner::isPathSafe(const std::vector<Vec2i>& path, int agent_id)
     return true;
 }
 
-Vec2 MultiAgentPlanner::calculateAvoidanceVelocity(int agent_id) const {
-    if (agent_id >= static_cast<int>(agents_.size())) {
-        return Vec2(0, 0);
+void MultiAgentPlanner::replanAgent(int agent_id) {
+    if (agent_id < 0 || agent_id >= static_cast<int>(size())) {
+        return;
     }
+    planAgent(static_cast<size_t>(agent_id));
+}
+
+// ============================================================================
+// Double-Buffered Update
+// ============================================================================
+
+int MultiAgentPlanner::bucketCoord(float v, int count) const {
+    // Clamping keeps neighbours within one bucket of each other off the map too
+    int c = static_cast<int>(std::floor(v / bucket_size_));
+    return std::max(0, std::min(count - 1, c));
+}
+
+void MultiAgentPlanner::buildBuckets() {
+    bucket_cols_ = std::max(1, static_cast<int>(std::ceil(grid_.getWidth() / bucket_size_)));
+    bucket_rows_ = std::max(1, static_cast<int>(std::ceil(grid_.getHeight() / bucket_size_)));
+    const size_t buckets = static_cast<size_t>(bucket_cols_) * bucket_rows_;
+    
+    // Counting sort in index order, so bucket contents never depend on threads
+    bucket_start_.assign(buckets + 1, 0);
+    std::vector<int> bucket_of(size());
+    for (size_t i = 0; i < size(); i++) {
+        int b = bucketCoord(pos_y_[i], bucket_rows_) * bucket_cols_ + bucketCoord(pos_x_[i], bucket_cols_);
+        bucket_of[i] = b;
+        bucket_start_[b + 1]++;
+    }
+    for (size_t b = 0; b < buckets; b++) bucket_start_[b + 1] += bucket_start_[b];
     
-    const auto& agent = agents_[agent_id];
-    Vec2 desired_velocity = agent.velocity;
+    bucket_agents_.resize(size());
+    std::vector<int> fill(bucket_start_.begin(), bucket_start_.end() - 1);
+    for (size_t i = 0; i < size(); i++) bucket_agents_[fill[bucket_of[i]]++] = static_cast<int>(i);
+}
+
+Vec2 MultiAgentPlanner::calculateAvoidanceVelocity(size_t index, Vec2 desired) const {
+    Vec2 desired_velocity = desired;
+    const float px = pos_x_[index];
+    const float py = pos_y_[index];
+    const int bx = bucketCoord(px, bucket_cols_);
+    const int by = bucketCoord(py, bucket_rows_);
     
     // Simple repulsion from nearby agents
-    for (size_t i = 0; i < agents_.size(); i++) {
-        if (static_cast<int>(i) == agent_id) continue;
-        
-        Vec2 diff = agent.position - agents_[i].position;
-        float dist = diff.length();
-        
-        if (dist < 3.0f && dist > 0.01f) {
-            // Add repulsive force
-            desired_velocity = desired_velocity + diff * (1.0f / dist) * 0.5f;
+    for (int y = std::max(0, by - 1); y <= std::min(bucket_rows_ - 1, by + 1); y++) {
+        for (int x = std::max(0, bx - 1); x <= std::min(bucket_cols_ - 1, bx + 1); x++) {
+            int b = y * bucket_cols_ + x;
+            for (int k = bucket_start_[b]; k < bucket_start_[b + 1]; k++) {
+                size_t j = static_cast<size_t>(bucket_agents_[k]);
+                if (j == index) continue;
+                
+                Vec2 diff(px - pos_x_[j], py - pos_y_[j]);
+                float dist = diff.length();
+                
+                if (dist < kAvoidanceRadius && dist > 0.01f) {
+                    // Add repulsive force
+                    desired_velocity = desired_velocity + diff * (1.0f / dist) * 0.5f;
+                }
+            }
         }
     }
     
@@ -94,57 +178,85 @@ Vec2 MultiAgentPlanner::calculateAvoidanceVelocity(int agent_id) const {
     return desired_velocity;
 }
 
-void MultiAgentPlanner::replanAgent(int agent_id) {
-    if (agent_id < 0 || agent_id >= static_cast<int>(agents_.size())) {
-        return;
-    }
+void MultiAgentPlanner::computeNext(size_t i, float dt) {
+    // Reads only the current step; writes only slot i of the next step
+    next_pos_x_[i] = pos_x_[i];
+    next_pos_y_[i] = pos_y_[i];
+    next_vel_x_[i] = vel_x_[i];
+    next_vel_y_[i] = vel_y_[i];
+    next_path_index_[i] = path_index_[i];
     
-    auto& agent = agents_[agent_id];
-    Vec2i start(static_cast<int>(agent.position.x), static_cast<int>(agent.position.y));
-    Vec2i goal(static_cast<int>(agent.goal.x), static_cast<int>(agent.goal.y));
+    const std::vector<Vec2>& path = paths_[i];
+    size_t path_index = static_cast<size_t>(path_index_[i]);
+    if (path_index >= path.size()) return;
     
-    auto result = planner_->findPath(start, goal);
+    // Move toward next waypoint
+    Vec2 position(pos_x_[i], pos_y_[i]);
+    Vec2 direction = path[path_index] - position;
+    float dist = direction.length();
     
-    if (result.success) {
-        agent.planned_path.clear();
-        for (const auto& p : result.path) {
-            agent.planned_path.emplace_back(static_cast<float>(p.x), static_cast<float>(p.y));
+    if (dist < 0.5f) {
+        path_index++;
+        next_path_index_[i] = static_cast<int>(path_index);
+        if (path_index >= path.size()) {
+            next_vel_x_[i] = 0.0f;
+            next_vel_y_[i] = 0.0f;
+            return;
         }
-        agent.path_index = 0;
+        direction = path[path_index] - position;
+        dist = direction.length();
+    }
+    
+    if (dist > 0.01f) {
+        Vec2 velocity = direction * (1.0f / dist);
+        
+        // Apply collision avoidance
+        Vec2 avoid_vel = calculateAvoidanceVelocity(i, velocity);
+        velocity = velocity * 0.7f + avoid_vel * 0.3f;
+        
+        // Update position
+        Vec2 next = position + velocity * dt;
+        next_pos_x_[i] = next.x;
+        next_pos_y_[i] = next.y;
+        next_vel_x_[i] = velocity.x;
+        next_vel_y_[i] = velocity.y;
     }
 }
 
 void MultiAgentPlanner::update(float dt) {
-    for (auto& agent : agents_) {
-        if (agent.planned_path.empty() || agent.path_index >= agent.planned_path.size()) {
-            continue;
-        }
-        
-        // Move toward next waypoint
-        Vec2 target = agent.planned_path[agent.path_index];
-        Vec2 direction = target - agent.position;
-        float dist = direction.length();
-        
-        if (dist < 0.5f) {
-            agent.path_index++;
-            if (agent.path_index >= agent.planned_path.size()) {
-                agent.velocity = Vec2(0, 0);
-                continue;
-            }
-            target = agent.planned_path[agent.path_index];
-            direction = target - agent.position;
-            dist = direction.length();
-        }
-        
-        if (dist > 0.01f) {
-            agent.velocity = direction * (1.0f / dist);
-            
-            // Apply collision avoidance
-            Vec2 avoid_vel = calculateAvoidanceVelocity(static_cast<int>(&agent - &agents_[0]));
-            agent.velocity = agent.velocity * 0.7f + avoid_vel * 0.3f;
-            
-            // Update position
-            agent.position = agent.position + agent.velocity * dt;
+    const size_t n = size();
+    if (n == 0) return;
+    
+    // Phase 1: snapshot neighbourhoods and size the write buffers
+    buildBuckets();
+    next_pos_x_.resize(n);
+    next_pos_y_.resize(n);
+    next_vel_x_.resize(n);
+    next_vel_y_.resize(n);
+    next_path_index_.resize(n);
+    
+    // Phase 2: compute every agent's next state, chunks pulled by the workers
+    const size_t chunks = (n + kAgentsPerChunk - 1) / kAgentsPerChunk;
+    std::atomic<size_t> next_chunk(0);
+    auto worker = [&](int) {
+        for (size_t c = next_chunk.fetch_add(1); c < chunks; c = next_chunk.fetch_add(1)) {
+            size_t end = std::min(n, (c + 1) * kAgentsPerChunk);
+            for (size_t i = c * kAgentsPerChunk; i < end; i++) computeNext(i, dt);
         }
+    };
+    
+    int workers = static_cast<int>(std::min<size_t>(num_threads_, chunks));
+    if (workers > 1) {
+        if (!pool_ || pool_->getNumThreads() != num_threads_) pool_ = std::make_unique<WorkerPool>(num_threads_);
+        pool_->run(workers, worker);
+    } else {
+        worker(0);
     }
+    
+    // Phase 3: publish
+    pos_x_.swap(next_pos_x_);
+    pos_y_.swap(next_pos_y_);
+    vel_x_.swap(next_vel_x_);
+    vel_y_.swap(next_vel_y_);
+    path_index_.swap(next_path_index_);
 }
@@ -1,69 +1,442 @@
 #include "core/parking_planner.h"
 #include <cmath>
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <thread>
+#include <chrono>
+#include <functional>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace {
+
+const float kFootprintSpacing = 0.5f;   // Footprint sample spacing (m)
+const float kFootprintMargin = 0.1f;    // Safety margin around the vehicle
+const float kPoseQuantum = 0.25f;       // Collision memo position resolution
+const float kSampleStep = 0.25f;        // Reeds-Shepp collision check spacing
+const float kReverseWeight = 1.5f;      // Matches the Hybrid A* reverse primitive
+const float kForwardCost = 1.0f;        // Cheapest cost per metre of travel (forward, no cost map)
+const float kApproachTolerance = 1.0f;  // Matches the Hybrid A* goal position tolerance
+const float kHeadingTolerance = 0.2f;   // Matches the Hybrid A* goal heading tolerance
+const int kMaxApproaches = 3;           // Pre-parking poses tried per spot
+const int kMaxCusps = 2;                // Gear changes allowed in the final approach
+
+float reedsSheppCost(const ReedsSheppPath& path) {
+    float cost = 0.0f;
+    for (const auto& segment : path.segments) {
+        cost += segment.length < 0.0f ? -segment.length * kReverseWeight : segment.length;
+    }
+    return cost;
+}
+
+// Smallest turn between two headings (radians, in [0, pi])
+float headingChange(float from, float to) {
+    return std::abs(std::remainder(to - from, 2.0f * static_cast<float>(M_PI)));
+}
+
+// Cheapest way to turn through angle when a unit of cost turns at most rate
+float turningCost(float angle, float rate) {
+    return angle <= 0.0f ? 0.0f : angle / rate;
+}
+
+// Gear shifts along a pose sequence (direction of travel relative to heading)
+int countReversals(const std::vector<HybridState>& path) {
+    int reversals = 0;
+    int previous = 0;
+    for (size_t i = 1; i < path.size(); i++) {
+        Vec2 delta = path[i].pos - path[i - 1].pos;
+        float along = delta.x * std::cos(path[i - 1].theta) + delta.y * std::sin(path[i - 1].theta);
+        if (std::abs(along) < 1e-4f) continue;
+        
+        int direction = along > 0.0f ? 1 : -1;
+        if (previous != 0 && direction != previous) reversals++;
+        previous = direction;
+    }
+    return reversals;
+}
+
+}  // namespace
 
 ParkingPlanner::ParkingPlanner(const Grid& grid, const VehicleParams& params)
-    : hybrid_planner_(grid, params), vehicle_params_(params) {}
+    : grid_(grid)
+    , hybrid_planner_(grid, params)
+    , vehicle_params_(params)
+    , num_threads_(std::max(1u, std::thread::hardware_concurrency()))
+    , max_approach_iterations_(3000)
+    , collision_cache_(new std::atomic<uint64_t>[kCollisionCacheSize]) {
+    buildFootprint();
+    clearCollisionCache();
+}
+
+// ============================================================================
+// Footprint and collision checks
+// ============================================================================
+
+void ParkingPlanner::buildFootprint() {
+    float half_length = vehicle_params_.length / 2.0f + kFootprintMargin;
+    float half_width = vehicle_params_.width / 2.0f + kFootprintMargin;
+    int nx = static_cast<int>(std::ceil(2.0f * half_length / kFootprintSpacing));
+    int ny = static_cast<int>(std::ceil(2.0f * half_width / kFootprintSpacing));
+    
+    // Body-frame samples covering the whole rectangle, edges included
+    std::vector<Vec2> body;
+    for (int i = 0; i <= nx; i++) {
+        for (int j = 0; j <= ny; j++) {
+            body.emplace_back(-half_length + 2.0f * half_length * i / nx,
+                              -half_width + 2.0f * half_width * j / ny);
+        }
+    }
+    
+    footprint_.assign(kHeadingBins, {});
+    for (int bin = 0; bin < kHeadingBins; bin++) {
+        float theta = bin * 2.0f * static_cast<float>(M_PI) / kHeadingBins;
+        float c = std::cos(theta);
+        float s = std::sin(theta);
+        for (const Vec2& p : body) {
+            footprint_[bin].emplace_back(p.x * c - p.y * s, p.x * s + p.y * c);
+        }
+    }
+}
+
+void ParkingPlanner::clearCollisionCache() {
+    for (size_t i = 0; i < kCollisionCacheSize; i++) {
+        collision_cache_[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+int ParkingPlanner::headingBin(float theta) const {
+    int bin = static_cast<int>(std::lround(theta / (2.0f * M_PI) * kHeadingBins)) % kHeadingBins;
+    return bin < 0 ? bin + kHeadingBins : bin;
+}
+
+bool ParkingPlanner::isPoseCollisionFree(Vec2 pos, float theta) const {
+    // Poses are checked at their quantised value so memo entries are exact
+    int64_t qx = std::lround(pos.x / kPoseQuantum);
+    int64_t qy = std::lround(pos.y / kPoseQuantum);
+    int bin = headingBin(theta);
+    
+    uint64_t key = (static_cast<uint64_t>(qx + (1 << 20)) & 0x1FFFFF) << 28 |
+                   (static_cast<uint64_t>(qy + (1 << 20)) & 0x1FFFFF) << 7 |
+                   static_cast<uint64_t>(bin);
+    size_t slot = static_cast<size_t>((key * 0x9E3779B97F4A7C15ULL) >> 48) & (kCollisionCacheSize - 1);
+    
+    uint64_t entry = collision_cache_[slot].load(std::memory_order_relaxed);
+    if ((entry >> 2) == key && (entry & 3) != 0) {
+        return (entry & 3) == 2;
+    }
+    
+    float cx = qx * kPoseQuantum;
+    float cy = qy * kPoseQuantum;
+    bool free = true;
+    for (const Vec2& offset : footprint_[bin]) {
+        int gx = static_cast<int>(std::round(cx + offset.x));
+        int gy = static_cast<int>(std::round(cy + offset.y));
+        if (grid_.isObstacle(gx, gy)) {
+            free = false;
+            break;
+        }
+    }
+    
+    collision_cache_[slot].store(key << 2 | (free ? 2 : 1), std::memory_order_relaxed);
+    return free;
+}
+
+bool ParkingPlanner::isSegmentCollisionFree(const std::vector<HybridState>& states) const {
+    for (const auto& state : states) {
+        if (!isPoseCollisionFree(state.pos, state.theta)) return false;
+    }
+    return true;
+}
 
 bool ParkingPlanner::isSpotAccessible(const ParkingSpot& spot) const {
-    // Simplified check: spot should be large enough for vehicle
+    // Spot should be large enough for vehicle and currently empty
     return spot.width >= vehicle_params_.width + 0.5f &&
-           spot.length >= vehicle_params_.length + 0.5f;
+           spot.length >= vehicle_params_.length + 0.5f &&
+           isPoseCollisionFree(spot.center, spot.angle);
 }
 
-std::vector<HybridState> ParkingPlanner::generateParkingWaypoints(
-    Vec2 start, float start_theta, const ParkingSpot& spot, bool parallel) {
-    
-    std::vector<HybridState> waypoints;
+// ============================================================================
+// Final approach
+// ============================================================================
+
+std::vector<HybridState> ParkingPlanner::generatePreParkingPoses(const ParkingSpot& spot) const {
+    std::vector<HybridState> poses;
+    Vec2 forward(std::cos(spot.angle), std::sin(spot.angle));
+    Vec2 left(-forward.y, forward.x);
+    auto pose = [&](float along, float side, float theta) {
+        poses.emplace_back(spot.center + forward * along + left * side, theta);
+    };
     
-    if (parallel) {
-        // Parallel parking: approach, align, reverse in
-        waypoints.emplace_back(start, start_theta);
-        waypoints.emplace_back(spot.center + Vec2(-spot.length/2, 2.0f), start_theta);
-        waypoints.emplace_back(spot.center + Vec2(-spot.length/2, 1.0f), start_theta + 0.5f);
-        waypoints.emplace_back(spot.center, spot.angle);
+    if (spot.is_parallel) {
+        // Alongside the spot in the adjacent lane, ahead of / level with / behind it
+        float side = spot.width + 1.0f;
+        for (float s : {side, -side}) {
+            for (float along : {spot.length, 0.0f, -spot.length}) {
+                pose(along, s, spot.angle);
+            }
+        }
     } else {
-        // Perpendicular parking: approach, turn, reverse in
-        waypoints.emplace_back(start, start_theta);
-        waypoints.emplace_back(spot.center + Vec2(0, spot.length), start_theta);
-        waypoints.emplace_back(spot.center + Vec2(0, spot.length/2), spot.angle);
-        waypoints.emplace_back(spot.center, spot.angle);
+        // In the aisle in front of or behind the spot
+        float aisle = spot.length / 2.0f + vehicle_params_.width / 2.0f + 1.5f;
+        float radius = vehicle_params_.min_turn_radius;
+        for (float along : {aisle, -aisle}) {
+            pose(along, 0.0f, spot.angle);
+            for (float heading : {spot.angle + static_cast<float>(M_PI) / 2.0f,
+                                  spot.angle - static_cast<float>(M_PI) / 2.0f}) {
+                for (float side : {-radius, 0.0f, radius}) {
+                    pose(along, side, heading);
+                }
+            }
+        }
     }
     
-    return waypoints;
+    return poses;
 }
 
-ParkingManeuver ParkingPlanner::planParallelParking(
-    Vec2 start, float start_theta, const ParkingSpot& spot) {
+bool ParkingPlanner::finalApproach(Vec2 from, float from_theta, const ParkingSpot& spot,
+                                   ReedsSheppPath& path, std::vector<HybridState>& states) const {
+    path = ReedsShepp::shortestPath(from, from_theta, spot.center, spot.angle,
+                                    vehicle_params_.min_turn_radius);
+    if (!path.valid || path.numCusps() > kMaxCusps) return false;
     
-    ParkingManeuver maneuver;
+    states = ReedsShepp::sample(path, from, from_theta, vehicle_params_.min_turn_radius, kSampleStep);
+    return isSegmentCollisionFree(states);
+}
+
+ParkingPlanner::SpotCandidate ParkingPlanner::screenSpot(Vec2 start, float start_theta,
+                                                         const ParkingSpot& spot, int index) const {
+    SpotCandidate candidate;
+    candidate.spot = index;
+    candidate.direct_cost = std::numeric_limits<float>::infinity();
+    candidate.estimate = std::numeric_limits<float>::infinity();
+    candidate.bound = std::numeric_limits<float>::infinity();
+    
+    if (!isSpotAccessible(spot)) return candidate;
     
-    if (!isSpotAccessible(spot)) {
-        return maneuver;
+    // A free direct curve is a real maneuver with an exact cost, so it is
+    // checked here: findBestSpot starts pruning from the best one before any
+    // search runs
+    const float radius = vehicle_params_.min_turn_radius;
+    ReedsSheppPath direct = ReedsShepp::shortestPath(start, start_theta, spot.center, spot.angle, radius);
+    if (direct.valid && direct.numCusps() <= kMaxCusps &&
+        isSegmentCollisionFree(ReedsShepp::sample(direct, start, start_theta, radius, kSampleStep))) {
+        candidate.direct = direct;
+        candidate.direct_cost = reedsSheppCost(direct);
+        candidate.estimate = candidate.direct_cost;
+        candidate.bound = candidate.direct_cost;
     }
     
-    // Generate simplified parallel parking path
-    maneuver.path = generateParkingWaypoints(start, start_theta, spot, true);
-    maneuver.success = !maneuver.path.empty();
-    maneuver.num_reversals = 2;  // Typical for parallel parking
-    maneuver.total_cost = static_cast<float>(maneuver.path.size()) * 2.0f;
+    // Reeds-Shepp lengths here only cover some path families, so they are
+    // upper bounds on the true length: fine for ordering, not for pruning.
+    // The bound of an approach adds up its two legs, each at least its
+    // distance and at least the cost of the turn it makes: no Hybrid A*
+    // primitive turns faster per unit of cost than getMaxTurnPerCost, and no
+    // Reeds-Shepp arc faster than the turning radius allows. The search may
+    // stop anywhere within tolerance of the pose, in position and heading.
+    const float search_turn = hybrid_planner_.getMaxTurnPerCost();
+    for (const HybridState& pose : generatePreParkingPoses(spot)) {
+        if (pose.pos.x < 0 || pose.pos.x >= grid_.getWidth() ||
+            pose.pos.y < 0 || pose.pos.y >= grid_.getHeight()) {
+            continue;
+        }
+        
+        ReedsSheppPath final_path = ReedsShepp::shortestPath(pose.pos, pose.theta, spot.center, spot.angle, radius);
+        if (!final_path.valid || final_path.numCusps() > kMaxCusps) continue;
+        if (!isPoseCollisionFree(pose.pos, pose.theta)) continue;
+        
+        ReedsSheppPath free_path = ReedsShepp::shortestPath(start, start_theta, pose.pos, pose.theta, radius);
+        float approach = free_path.valid ? free_path.length : start.distanceTo(pose.pos);
+        float estimate = approach + reedsSheppCost(final_path);
+        
+        float search = std::max(
+            (start.distanceTo(pose.pos) - kApproachTolerance) * kForwardCost,
+            turningCost(headingChange(start_theta, pose.theta) - kHeadingTolerance, search_turn));
+        float finish = std::max(
+            (pose.pos.distanceTo(spot.center) - kApproachTolerance) * kForwardCost,
+            turningCost(headingChange(pose.theta, spot.angle) - kHeadingTolerance, kForwardCost / radius));
+        finish = std::max(finish, 0.0f);
+        float bound = std::max(search, 0.0f) + finish;
+        
+        candidate.approaches.push_back({pose.pos, pose.theta, estimate, bound, finish});
+        candidate.estimate = std::min(candidate.estimate, estimate);
+        candidate.bound = std::min(candidate.bound, bound);
+    }
     
+    std::sort(candidate.approaches.begin(), candidate.approaches.end(),
+              [](const Approach& a, const Approach& b) { return a.estimate < b.estimate; });
+    return candidate;
+}
+
+ParkingManeuver ParkingPlanner::directManeuver(Vec2 start, float start_theta,
+                                               const SpotCandidate& candidate) const {
+    ParkingManeuver maneuver;
+    if (!std::isfinite(candidate.direct_cost)) return maneuver;
+    
+    maneuver.path = ReedsShepp::sample(candidate.direct, start, start_theta,
+                                       vehicle_params_.min_turn_radius, kSampleStep);
+    maneuver.total_cost = candidate.direct_cost;
+    maneuver.num_reversals = candidate.direct.numCusps();
+    maneuver.success = true;
     return maneuver;
 }
 
+ParkingManeuver ParkingPlanner::planSpot(Vec2 start, float start_theta, const ParkingSpot& spot,
+                                         const SpotCandidate& candidate, float cutoff) {
+    // Pure analytic maneuver when the spot is reachable without a search
+    ParkingManeuver best = directManeuver(start, start_theta, candidate);
+    
+    // The search budget goes to the first feasible approaches whether or not
+    // they are pruned, so a cutoff never changes which ones are considered
+    int searches = 0;
+    for (const Approach& approach : candidate.approaches) {
+        if (searches == kMaxApproaches) break;
+        
+        ReedsSheppPath path;
+        std::vector<HybridState> states;
+        if (!finalApproach(approach.pos, approach.theta, spot, path, states)) continue;
+        
+        searches++;
+        float limit = best.success ? std::min(cutoff, best.total_cost) : cutoff;
+        if (approach.bound >= limit) continue;
+        
+        // The search only has to find approaches that can still win
+        HybridAStarResult search = hybrid_planner_.findPath(start, start_theta, approach.pos, approach.theta,
+                                                            max_approach_iterations_, limit - approach.finish);
+        if (!search.success || search.path.empty()) continue;
+        
+        // Hybrid A* stops near the pre-parking pose; finish from where it ended
+        const HybridState& end = search.path.back();
+        if (!finalApproach(end.pos, end.theta, spot, path, states)) continue;
+        
+        float cost = search.path_cost + reedsSheppCost(path);
+        if (best.success && cost >= best.total_cost) continue;
+        
+        best = ParkingManeuver();
+        best.path = search.path;
+        best.path.insert(best.path.end(), states.begin() + 1, states.end());
+        for (auto& state : best.path) state.parent = nullptr;  // Search nodes are gone
+        best.total_cost = cost;
+        best.num_reversals = countReversals(best.path);
+        best.success = true;
+    }
+    
+    return best;
+}
+
+// ============================================================================
+// Planning
+// ============================================================================
+
+ParkingManeuver ParkingPlanner::planParking(Vec2 start, float start_theta, const ParkingSpot& spot) {
+    clearCollisionCache();
+    
+    SpotCandidate candidate = screenSpot(start, start_theta, spot, 0);
+    if (!std::isfinite(candidate.bound)) {
+        return ParkingManeuver();
+    }
+    return planSpot(start, start_theta, spot, candidate, std::numeric_limits<float>::infinity());
+}
+
+ParkingManeuver ParkingPlanner::planParallelParking(
+    Vec2 start, float start_theta, const ParkingSpot& spot) {
+    
+    ParkingSpot parallel_spot = spot;
+    parallel_spot.is_parallel = true;
+    return planParking(start, start_theta, parallel_spot);
+}
+
 ParkingManeuver ParkingPlanner::planPerpendicularParking(
     Vec2 start, float start_theta, const ParkingSpot& spot) {
     
-    ParkingManeuver maneuver;
+    ParkingSpot perpendicular_spot = spot;
+    perpendicular_spot.is_parallel = false;
+    return planParking(start, start_theta, perpendicular_spot);
+}
+
+ParkingSearchResult ParkingPlanner::findBestSpot(Vec2 start, float start_theta,
+                                                 const std::vector<ParkingSpot>& spots) {
+    auto start_time = std::chrono::high_resolution_clock::now();
+    ParkingSearchResult result;
+    clearCollisionCache();
+    
+    const int num_spots = static_cast<int>(spots.size());
+    const int num_threads = std::max(1, std::min(num_threads_, num_spots));
+    
+    // Runs fn(i) for i in [0, count) on the worker pool
+    auto parallelFor = [&](int count, const std::function<void(int)>& fn) {
+        std::atomic<int> next(0);
+        auto worker = [&](int) {
+            for (int i = next.fetch_add(1); i < count; i = next.fetch_add(1)) fn(i);
+        };
+        int workers = std::min(num_threads, count);
+        if (workers > 1) {
+            if (!pool_ || pool_->getNumThreads() != num_threads_) pool_ = std::make_unique<WorkerPool>(num_threads_);
+            pool_->run(workers, worker);
+        } else {
+            worker(0);
+        }
+    };
     
-    if (!isSpotAccessible(spot)) {
-        return maneuver;
+    // Screen every spot: footprint at the spot, direct curve and cost bounds
+    std::vector<SpotCandidate> candidates(num_spots);
+    parallelFor(num_spots, [&](int i) {
+        candidates[i] = screenSpot(start, start_theta, spots[i], i);
+    });
+    
+    std::vector<int> order;
+    for (int i = 0; i < num_spots; i++) {
+        if (std::isfinite(candidates[i].bound)) order.push_back(i);
     }
+    std::sort(order.begin(), order.end(),
+              [&](int a, int b) { return candidates[a].estimate < candidates[b].estimate; });
+    result.spots_screened = static_cast<int>(order.size());
     
-    // Generate simplified perpendicular parking path
-    maneuver.path = generateParkingWaypoints(start, start_theta, spot, false);
-    maneuver.success = !maneuver.path.empty();
-    maneuver.num_reversals = 1;  // Typical for perpendicular parking
-    maneuver.total_cost = static_cast<float>(maneuver.path.size()) * 1.5f;
+    // The cheapest free direct curve is the first maneuver to beat
+    float incumbent = std::numeric_limits<float>::infinity();
+    for (int i : order) {
+        if (candidates[i].direct_cost < incumbent) {
+            incumbent = candidates[i].direct_cost;
+            result.spot_index = i;
+        }
+    }
+    if (result.spot_index >= 0) {
+        result.maneuver = directManeuver(start, start_theta, candidates[result.spot_index]);
+    }
     
-    return maneuver;
+    // Plan the most promising spots a wave at a time, skipping any whose
+    // lower bound cannot beat the best maneuver so far
+    size_t next = 0;
+    std::vector<int> wave;
+    while (next < order.size()) {
+        wave.clear();
+        for (; next < order.size() && static_cast<int>(wave.size()) < num_threads; next++) {
+            if (result.maneuver.success && candidates[order[next]].bound >= result.maneuver.total_cost) continue;
+            wave.push_back(order[next]);
+        }
+        
+        int wave_size = static_cast<int>(wave.size());
+        std::vector<ParkingManeuver> maneuvers(wave_size);
+        const float cutoff = result.maneuver.success ? result.maneuver.total_cost
+                                                     : std::numeric_limits<float>::infinity();
+        parallelFor(wave_size, [&](int i) {
+            const SpotCandidate& candidate = candidates[wave[i]];
+            maneuvers[i] = planSpot(start, start_theta, spots[candidate.spot], candidate, cutoff);
+        });
+        result.spots_planned += wave_size;
+        
+        for (int i = 0; i < wave_size; i++) {
+            if (!maneuvers[i].success) continue;
+            if (!result.maneuver.success || maneuvers[i].total_cost < result.maneuver.total_cost) {
+                result.maneuver = std::move(maneuvers[i]);
+                result.spot_index = wave[i];
+            }
+        }
+    }
+    
+    result.planning_time_ms = std::chrono::duration<double, std::milli>(
+        std::chrono::high_resolution_clock::now() - start_time).count();
+    return result;
 }
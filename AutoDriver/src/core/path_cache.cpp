@@ -0,0 +1,151 @@
+#include "core/path_cache.h"
+#include "core/cost_map.h"
+#include <algorithm>
+
+namespace {
+
+uint64_t mix(uint64_t h, uint64_t value) {
+    h ^= value + 0x9E3779B97F4A7C15ull + (h << 6) + (h >> 2);
+    return h;
+}
+
+}  // namespace
+
+size_t PathCache::KeyHash::operator()(const PathCacheKey& key) const {
+    uint64_t h = key.config;
+    h = mix(h, (static_cast<uint64_t>(static_cast<uint32_t>(key.start.x)) << 32) | static_cast<uint32_t>(key.start.y));
+    h = mix(h, (static_cast<uint64_t>(static_cast<uint32_t>(key.goal.x)) << 32) | static_cast<uint32_t>(key.goal.y));
+    return static_cast<size_t>(h);
+}
+
+// ============================================================================
+// PathCache Implementation
+// ============================================================================
+
+PathCache::PathCache(size_t capacity) : capacity_(capacity) {}
+
+bool PathCache::lookup(const Grid& grid, const PathCacheKey& key, AStarResult& out) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto found = index_.find(key);
+    if (found == index_.end() || grid.getVersion() < found->second->version) {
+        stats_.misses++;
+        return false;
+    }
+    
+    const Entry& entry = *found->second;
+    if (grid.changedSince(entry.version, entry.min_tx, entry.min_ty, entry.max_tx, entry.max_ty)) {
+        entries_.erase(found->second);
+        index_.erase(found);
+        stats_.invalidations++;
+        stats_.misses++;
+        return false;
+    }
+    
+    entries_.splice(entries_.begin(), entries_, found->second);
+    stats_.hits++;
+    out = entry.result;
+    return true;
+}
+
+void PathCache::insert(const Grid& grid, const PathCacheKey& key, const AStarResult& result) {
+    Entry entry;
+    entry.key = key;
+    entry.result.path = result.path;
+    entry.result.nodes_expanded = result.nodes_expanded;
+    entry.result.coarse_nodes_expanded = result.coarse_nodes_expanded;
+    entry.result.path_cost = result.path_cost;
+    entry.result.success = result.success;
+    entry.version = grid.getVersion();
+    
+    if (result.success) {
+        // Any edit next to the path can change it, so the box grows by a cell
+        int min_x = std::min(key.start.x, key.goal.x), max_x = std::max(key.start.x, key.goal.x);
+        int min_y = std::min(key.start.y, key.goal.y), max_y = std::max(key.start.y, key.goal.y);
+        for (const Vec2i& cell : result.path) {
+            min_x = std::min(min_x, cell.x);
+            max_x = std::max(max_x, cell.x);
+            min_y = std::min(min_y, cell.y);
+            max_y = std::max(max_y, cell.y);
+        }
+        entry.min_tx = std::max(min_x - 1, 0) >> Grid::kTileShift;
+        entry.min_ty = std::max(min_y - 1, 0) >> Grid::kTileShift;
+        entry.max_tx = (max_x + 1) >> Grid::kTileShift;
+        entry.max_ty = (max_y + 1) >> Grid::kTileShift;
+    } else {
+        entry.min_tx = 0;
+        entry.min_ty = 0;
+        entry.max_tx = grid.getTilesX() - 1;
+        entry.max_ty = grid.getTilesY() - 1;
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (capacity_ == 0) return;
+    auto found = index_.find(key);
+    if (found != index_.end()) {
+        *found->second = std::move(entry);
+        entries_.splice(entries_.begin(), entries_, found->second);
+        return;
+    }
+    entries_.push_front(std::move(entry));
+    index_.emplace(key, entries_.begin());
+    evictOverflow();
+}
+
+AStarResult PathCache::findPath(AStar& planner, Vec2i start, Vec2i goal, uint64_t config) {
+    // The version changes whenever costs do and never repeats, even for a new
+    // map at a reused address
+    if (const CostMap* costs = planner.getCostMap()) {
+        config = mix(config, static_cast<uint64_t>(reinterpret_cast<uintptr_t>(costs)));
+        config = mix(config, costs->getVersion());
+    }
+    const PathCacheKey key(start, goal, config);
+    const Grid& grid = planner.getGrid();
+    
+    AStarResult result;
+    if (lookup(grid, key, result)) {
+        // Nothing was searched for this answer
+        result.nodes_expanded = 0;
+        result.coarse_nodes_expanded = 0;
+        return result;
+    }
+    
+    result = planner.findPath(start, goal);
+    insert(grid, key, result);
+    return result;
+}
+
+void PathCache::setCapacity(size_t capacity) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    capacity_ = capacity;
+    evictOverflow();
+}
+
+size_t PathCache::getCapacity() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return capacity_;
+}
+
+size_t PathCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+void PathCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+    index_.clear();
+    stats_ = PathCacheStats();
+}
+
+PathCacheStats PathCache::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void PathCache::evictOverflow() {
+    while (entries_.size() > capacity_) {
+        index_.erase(entries_.back().key);
+        entries_.pop_back();
+        stats_.evictions++;
+    }
+}
@@ -0,0 +1,389 @@
+#include "core/path_database.h"
+#include "core/mapped_file.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <thread>
+
+namespace {
+
+const char kDatabaseMagic[8] = {'A', 'D', 'C', 'P', 'D', '\r', '\n', '\0'};
+const uint32_t kDatabaseVersion = 2;      // 2: grid content hash in the header
+const size_t kDatabaseHeaderBytes = 128;
+const size_t kSectionAlignment = 64;
+const uint8_t kNoMove = 0xFF;
+const size_t kSourcesPerChunk = 64;   // Work unit for build() workers
+
+const int kDx[] = {0, 0, -1, 1};
+const int kDy[] = {-1, 1, 0, 0};
+
+void putU32(unsigned char* out, uint32_t v) {
+    for (int i = 0; i < 4; i++) out[i] = static_cast<unsigned char>(v >> (8 * i));
+}
+
+void putU64(unsigned char* out, uint64_t v) {
+    for (int i = 0; i < 8; i++) out[i] = static_cast<unsigned char>(v >> (8 * i));
+}
+
+uint32_t getU32(const unsigned char* in) {
+    uint32_t v = 0;
+    for (int i = 0; i < 4; i++) v |= static_cast<uint32_t>(in[i]) << (8 * i);
+    return v;
+}
+
+uint64_t getU64(const unsigned char* in) {
+    uint64_t v = 0;
+    for (int i = 0; i < 8; i++) v |= static_cast<uint64_t>(in[i]) << (8 * i);
+    return v;
+}
+
+bool hostIsLittleEndian() {
+    uint16_t probe = 1;
+    unsigned char first;
+    std::memcpy(&first, &probe, 1);
+    return first == 1;
+}
+
+size_t alignSection(size_t offset) {
+    return (offset + kSectionAlignment - 1) / kSectionAlignment * kSectionAlignment;
+}
+
+// Bits of v spread to the even positions
+uint64_t spreadBits(uint32_t v) {
+    uint64_t x = v;
+    x = (x | (x << 16)) & 0x0000FFFF0000FFFFull;
+    x = (x | (x << 8)) & 0x00FF00FF00FF00FFull;
+    x = (x | (x << 4)) & 0x0F0F0F0F0F0F0F0Full;
+    x = (x | (x << 2)) & 0x3333333333333333ull;
+    x = (x | (x << 1)) & 0x5555555555555555ull;
+    return x;
+}
+
+uint64_t mortonCode(int x, int y) {
+    return spreadBits(static_cast<uint32_t>(x)) | (spreadBits(static_cast<uint32_t>(y)) << 1);
+}
+
+// Arrays of a freshly built database
+struct BuiltArrays {
+    std::vector<uint32_t> node_cells;
+    std::vector<uint32_t> components;
+    std::vector<uint64_t> row_offsets;
+    std::vector<uint32_t> runs;
+};
+
+}  // namespace
+
+// ============================================================================
+// Building
+// ============================================================================
+
+PathDatabase::PathDatabase()
+    : width_(0), height_(0), node_count_(0), run_count_(0), node_cells_(nullptr), components_(nullptr),
+      row_offsets_(nullptr), runs_(nullptr), grid_hash_(0), mapped_(false) {}
+
+PathDatabase PathDatabase::build(const Grid& grid, const PathDatabaseOptions& options) {
+    PathDatabase db;
+    db.width_ = grid.getWidth();
+    db.height_ = grid.getHeight();
+    db.grid_hash_ = grid.contentHash();
+    auto arrays = std::make_shared<BuiltArrays>();
+    
+    // Number free cells in Z-order so nearby targets sit next to each other in a row
+    std::vector<std::pair<uint64_t, uint32_t>> order;
+    for (int y = 0; y < db.height_; y++) {
+        for (int x = 0; x < db.width_; x++) {
+            if (!grid.isObstacle(x, y)) order.emplace_back(mortonCode(x, y), static_cast<uint32_t>(y * db.width_ + x));
+        }
+    }
+    std::sort(order.begin(), order.end());
+    const size_t n = order.size();
+    if (n == 0 || n >= (size_t(1) << 30)) return PathDatabase();   // Run targets have 30 bits
+    for (const auto& entry : order) arrays->node_cells.push_back(entry.second);
+    db.node_count_ = n;
+    db.node_cells_ = arrays->node_cells.data();
+    db.indexCells();
+    
+    // Neighbour table in node ids, in move order
+    std::vector<int32_t> adjacency(n * 4, -1);
+    for (size_t v = 0; v < n; v++) {
+        int x = static_cast<int>(arrays->node_cells[v] % db.width_);
+        int y = static_cast<int>(arrays->node_cells[v] / db.width_);
+        for (int d = 0; d < 4; d++) adjacency[v * 4 + d] = db.nodeAt(Vec2i(x + kDx[d], y + kDy[d]));
+    }
+    
+    // Connected components, so rows need no entries for unreachable targets
+    arrays->components.assign(n, 0xFFFFFFFFu);
+    std::vector<int32_t> queue;
+    uint32_t component = 0;
+    for (size_t s = 0; s < n; s++) {
+        if (arrays->components[s] != 0xFFFFFFFFu) continue;
+        queue.assign(1, static_cast<int32_t>(s));
+        arrays->components[s] = component;
+        for (size_t head = 0; head < queue.size(); head++) {
+            for (int d = 0; d < 4; d++) {
+                int32_t next = adjacency[queue[head] * 4 + d];
+                if (next < 0 || arrays->components[next] != 0xFFFFFFFFu) continue;
+                arrays->components[next] = component;
+                queue.push_back(next);
+            }
+        }
+        component++;
+    }
+    db.components_ = arrays->components.data();
+    
+    // One breadth-first pass per source; every target inherits the first move
+    // of the node that reached it. Rows are encoded per chunk, then joined.
+    const size_t chunks = (n + kSourcesPerChunk - 1) / kSourcesPerChunk;
+    std::vector<std::vector<uint32_t>> chunk_runs(chunks);
+    std::vector<uint64_t> row_lengths(n, 0);
+    std::atomic<size_t> next_chunk(0);
+    auto worker = [&]() {
+        std::vector<uint8_t> first_move;
+        std::vector<int32_t> bfs;
+        for (size_t c = next_chunk.fetch_add(1); c < chunks; c = next_chunk.fetch_add(1)) {
+            size_t end = std::min(n, (c + 1) * kSourcesPerChunk);
+            for (size_t s = c * kSourcesPerChunk; s < end; s++) {
+                first_move.assign(n, kNoMove);
+                bfs.clear();
+                first_move[s] = 0;   // Never looked up; marks the source visited
+                for (int d = 0; d < 4; d++) {
+                    int32_t next = adjacency[s * 4 + d];
+                    if (next < 0) continue;
+                    first_move[next] = static_cast<uint8_t>(d);
+                    bfs.push_back(next);
+                }
+                for (size_t head = 0; head < bfs.size(); head++) {
+                    int32_t v = bfs[head];
+                    for (int d = 0; d < 4; d++) {
+                        int32_t next = adjacency[v * 4 + d];
+                        if (next < 0 || first_move[next] != kNoMove) continue;
+                        first_move[next] = first_move[v];
+                        bfs.push_back(next);
+                    }
+                }
+                
+                // Run-length encode; the source and other components are
+                // wildcards that extend whichever run they fall in
+                std::vector<uint32_t>& runs = chunk_runs[c];
+                size_t row_start = runs.size();
+                uint8_t current = kNoMove;
+                for (size_t t = 0; t < n; t++) {
+                    if (t == s || arrays->components[t] != arrays->components[s]) continue;
+                    if (first_move[t] == current) continue;
+                    current = first_move[t];
+                    uint32_t first_target = runs.size() == row_start ? 0u : static_cast<uint32_t>(t);
+                    runs.push_back((first_target << 2) | current);
+                }
+                row_lengths[s] = runs.size() - row_start;
+            }
+        }
+    };
+    
+    int num_threads = options.num_threads;
+    if (num_threads <= 0) num_threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    int workers = static_cast<int>(std::min<size_t>(num_threads, std::max<size_t>(1, chunks)));
+    std::vector<std::thread> threads;
+    for (int t = 1; t < workers; t++) threads.emplace_back(worker);
+    worker();
+    for (auto& thread : threads) thread.join();
+    
+    arrays->row_offsets.resize(n + 1, 0);
+    for (size_t s = 0; s < n; s++) arrays->row_offsets[s + 1] = arrays->row_offsets[s] + row_lengths[s];
+    arrays->runs.reserve(arrays->row_offsets[n]);
+    for (auto& runs : chunk_runs) {
+        arrays->runs.insert(arrays->runs.end(), runs.begin(), runs.end());
+        std::vector<uint32_t>().swap(runs);
+    }
+    
+    db.row_offsets_ = arrays->row_offsets.data();
+    db.runs_ = arrays->runs.data();
+    db.run_count_ = arrays->runs.size();
+    db.storage_ = arrays;
+    return db;
+}
+
+void PathDatabase::indexCells() {
+    node_of_cell_.assign(static_cast<size_t>(width_) * height_, -1);
+    for (size_t v = 0; v < node_count_; v++) node_of_cell_[node_cells_[v]] = static_cast<int32_t>(v);
+}
+
+size_t PathDatabase::getBytes() const {
+    return node_count_ * 2 * sizeof(uint32_t) + (node_count_ + 1) * sizeof(uint64_t) + run_count_ * sizeof(uint32_t);
+}
+
+// ============================================================================
+// Queries
+// ============================================================================
+
+int PathDatabase::nodeAt(Vec2i p) const {
+    if (p.x < 0 || p.y < 0 || p.x >= width_ || p.y >= height_) return -1;
+    return node_of_cell_[static_cast<size_t>(p.y) * width_ + p.x];
+}
+
+int PathDatabase::lookup(int source, int target) const {
+    // Last run starting at or before target
+    const uint32_t* begin = runs_ + row_offsets_[source];
+    const uint32_t* end = runs_ + row_offsets_[source + 1];
+    const uint32_t key = (static_cast<uint32_t>(target) << 2) | 3u;
+    const uint32_t* run = std::upper_bound(begin, end, key);
+    return run == begin ? -1 : static_cast<int>(run[-1] & 3u);
+}
+
+int PathDatabase::firstMove(Vec2i start, Vec2i goal) const {
+    int s = nodeAt(start);
+    int t = nodeAt(goal);
+    if (s < 0 || t < 0 || s == t || components_[s] != components_[t]) return -1;
+    return lookup(s, t);
+}
+
+AStarResult PathDatabase::findPath(Vec2i start, Vec2i goal) const {
+    AStarResult result;
+    int s = nodeAt(start);
+    const int t = nodeAt(goal);
+    if (s < 0 || t < 0 || components_[s] != components_[t]) return result;
+    
+    result.path.push_back(start);
+    Vec2i p = start;
+    while (s != t) {
+        int move = lookup(s, t);
+        result.nodes_expanded++;
+        if (move >= 0) {
+            p = Vec2i(p.x + kDx[move], p.y + kDy[move]);
+            s = nodeAt(p);
+        }
+        if (move < 0 || s < 0 || result.path.size() > node_count_) {
+            result.path.clear();   // Corrupt table
+            return result;
+        }
+        result.path.push_back(p);
+    }
+    result.path_cost = static_cast<float>(result.path.size() - 1);
+    result.success = true;
+    return result;
+}
+
+int PathDatabase::distance(Vec2i start, Vec2i goal) const {
+    int s = nodeAt(start);
+    const int t = nodeAt(goal);
+    if (s < 0 || t < 0 || components_[s] != components_[t]) return -1;
+    
+    Vec2i p = start;
+    int steps = 0;
+    while (s != t) {
+        int move = lookup(s, t);
+        if (move < 0 || steps > static_cast<int>(node_count_)) return -1;
+        p = Vec2i(p.x + kDx[move], p.y + kDy[move]);
+        s = nodeAt(p);
+        if (s < 0) return -1;
+        steps++;
+    }
+    return steps;
+}
+
+// ============================================================================
+// File I/O
+// ============================================================================
+
+bool PathDatabase::save(const std::string& path) const {
+    if (empty()) return false;
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) return false;
+    
+    // Header, then node cells, components, row offsets and runs, each aligned
+    const size_t cells_offset = kDatabaseHeaderBytes;
+    const size_t components_offset = alignSection(cells_offset + node_count_ * 4);
+    const size_t rows_offset = alignSection(components_offset + node_count_ * 4);
+    const size_t runs_offset = alignSection(rows_offset + (node_count_ + 1) * 8);
+    
+    unsigned char header[kDatabaseHeaderBytes] = {};
+    std::memcpy(header, kDatabaseMagic, sizeof(kDatabaseMagic));
+    putU32(header + 8, kDatabaseVersion);
+    putU32(header + 12, static_cast<uint32_t>(width_));
+    putU32(header + 16, static_cast<uint32_t>(height_));
+    putU64(header + 24, node_count_);
+    putU64(header + 32, run_count_);
+    putU64(header + 40, components_offset);
+    putU64(header + 48, rows_offset);
+    putU64(header + 56, runs_offset);
+    putU64(header + 64, grid_hash_);
+    file.write(reinterpret_cast<const char*>(header), kDatabaseHeaderBytes);
+    
+    // Little-endian regardless of host
+    size_t written = kDatabaseHeaderBytes;
+    std::vector<unsigned char> bytes;
+    auto writeSection = [&](size_t offset, const void* values, size_t count, size_t width) {
+        bytes.assign(offset - written, 0);
+        const unsigned char* in = static_cast<const unsigned char*>(values);
+        for (size_t i = 0; i < count; i++) {
+            uint64_t v = width == 4 ? reinterpret_cast<const uint32_t*>(in)[i] : reinterpret_cast<const uint64_t*>(in)[i];
+            size_t at = bytes.size();
+            bytes.resize(at + width);
+            if (width == 4) putU32(bytes.data() + at, static_cast<uint32_t>(v));
+            else putU64(bytes.data() + at, v);
+        }
+        file.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+        written = offset + count * width;
+    };
+    writeSection(cells_offset, node_cells_, node_count_, 4);
+    writeSection(components_offset, components_, node_count_, 4);
+    writeSection(rows_offset, row_offsets_, node_count_ + 1, 8);
+    writeSection(runs_offset, runs_, run_count_, 4);
+    return static_cast<bool>(file);
+}
+
+bool PathDatabase::load(const std::string& path, PathDatabase& out, bool memory_map) {
+    // Arrays are used in place, so they must already be in host order
+    if (!hostIsLittleEndian()) return false;
+    
+    auto region = std::make_shared<MappedFile>();
+    bool opened = memory_map ? region->map(path) : region->read(path);
+    if (!opened) return false;
+    
+    const unsigned char* data = region->data();
+    const size_t size = region->size();
+    if (size < kDatabaseHeaderBytes || std::memcmp(data, kDatabaseMagic, sizeof(kDatabaseMagic)) != 0 ||
+        getU32(data + 8) != kDatabaseVersion) {
+        return false;
+    }
+    
+    const uint32_t width = getU32(data + 12);
+    const uint32_t height = getU32(data + 16);
+    const uint64_t node_count = getU64(data + 24);
+    const uint64_t run_count = getU64(data + 32);
+    const uint64_t components_offset = getU64(data + 40);
+    const uint64_t rows_offset = getU64(data + 48);
+    const uint64_t runs_offset = getU64(data + 56);
+    const uint64_t cells = static_cast<uint64_t>(width) * height;
+    if (width == 0 || height == 0 || width > 0x7fffffffu || height > 0x7fffffffu ||
+        node_count == 0 || node_count > cells || node_count >= (1u << 30) ||
+        components_offset != alignSection(kDatabaseHeaderBytes + node_count * 4) ||
+        rows_offset != alignSection(components_offset + node_count * 4) ||
+        runs_offset != alignSection(rows_offset + (node_count + 1) * 8) ||
+        runs_offset > size || (size - runs_offset) / 4 < run_count) {
+        return false;
+    }
+    
+    PathDatabase db;
+    db.width_ = static_cast<int>(width);
+    db.height_ = static_cast<int>(height);
+    db.node_count_ = static_cast<size_t>(node_count);
+    db.run_count_ = static_cast<size_t>(run_count);
+    db.grid_hash_ = getU64(data + 64);
+    db.node_cells_ = reinterpret_cast<const uint32_t*>(data + kDatabaseHeaderBytes);
+    db.components_ = reinterpret_cast<const uint32_t*>(data + components_offset);
+    db.row_offsets_ = reinterpret_cast<const uint64_t*>(data + rows_offset);
+    db.runs_ = reinterpret_cast<const uint32_t*>(data + runs_offset);
+    
+    // Queries index straight into these, so check them once here
+    for (size_t v = 0; v < db.node_count_; v++) {
+        if (db.node_cells_[v] >= cells || db.row_offsets_[v] > db.row_offsets_[v + 1]) return false;
+    }
+    if (db.row_offsets_[0] != 0 || db.row_offsets_[db.node_count_] != run_count) return false;
+    
+    db.indexCells();
+    db.mapped_ = region->isMapped();
+    db.storage_ = region;
+    out = std::move(db);
+    return true;
+}
@@ -1,6 +1,16 @@
 #include "core/path_smoothing.h"
 #include <cmath>
 #include <algorithm>
+#include <memory>
+#include <thread>
+#include "core/random.h"
+#include "core/clearance_map.h"
+#include "core/instrumentation.h"
+#include "core/worker_pool.h"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#endif
 
 // ============================================================================
 // Bezier Smoothing
@@ -65,11 +75,21 @@ std::vector<Vec2> PathSmoothing::bezierSmooth(const std::vector<Vec2>& path,
 // ============================================================================
 
 bool PathSmoothing::isLineCollisionFree(Vec2 from, Vec2 to, const Grid& grid) {
+    AUTODRIVER_SCOPE(SMOOTH_LINE_CHECK);
     Vec2 direction = to - from;
     float dist = direction.length();
     
     if (dist < 0.01f) return true;
     
+    // Free bounding box: no need to sample (only cheap with the occupancy pyramid)
+    if (grid.getPyramidLevels() > 0 &&
+        grid.isRegionFree(static_cast<int>(std::round(std::min(from.x, to.x))),
+                          static_cast<int>(std::round(std::min(from.y, to.y))),
+                          static_cast<int>(std::round(std::max(from.x, to.x))),
+                          static_cast<int>(std::round(std::max(from.y, to.y))))) {
+        return true;
+    }
+    
     int num_checks = static_cast<int>(std::ceil(dist * 2.0f));
     for (int i = 0; i <= num_checks; i++) {
         float t = static_cast<float>(i) / num_checks;
@@ -86,31 +106,184 @@ bool PathSmoothing::isLineCollisionFree(Vec2 from, Vec2 to, const Grid& grid) {
     return true;
 }
 
-std::vector<Vec2> PathSmoothing::shortcutSmooth(const std::vector<Vec2>& path,
-                                               const Grid& grid,
-                                               int max_iterations) {
-    if (path.size() < 3) return path;
+// ============================================================================
+// Visibility Cache
+// ============================================================================
+
+VisibilityCache::VisibilityCache(const std::vector<Vec2>& path, const Grid& grid)
+    : path_(path)
+    , grid_(grid)
+    , hits_(0)
+    , misses_(0) {
     
-    std::vector<Vec2> smoothed = path;
+    // A greedy pass plus a few randomized rounds touch O(n log n) pairs
+    size_t capacity = 1024;
+    while (capacity < path.size() * 16 && capacity < (size_t(1) << 22)) capacity <<= 1;
     
-    for (int iter = 0; iter < max_iterations; iter++) {
-        bool improved = false;
+    table_.reset(new std::atomic<uint64_t>[capacity]);
+    for (size_t i = 0; i < capacity; i++) table_[i].store(0, std::memory_order_relaxed);
+    mask_ = capacity - 1;
+}
+
+bool VisibilityCache::isVisible(size_t i, size_t j) {
+    if (i > j) std::swap(i, j);
+    if (j - i <= 1) return true;  // Consecutive waypoints are connected by the path itself
+    
+    const uint64_t key = static_cast<uint64_t>(i) * path_.size() + j;
+    size_t slot = static_cast<size_t>((key * 0x9E3779B97F4A7C15ULL) >> 32) & mask_;
+    
+    // Short linear probe; give up on storing if the neighbourhood is full
+    const int kMaxProbes = 8;
+    for (int probe = 0; probe < kMaxProbes; probe++, slot = (slot + 1) & mask_) {
+        uint64_t entry = table_[slot].load(std::memory_order_acquire);
         
-        for (size_t i = 0; i < smoothed.size(); i++) {
-            for (size_t j = i + 2; j < smoothed.size(); j++) {
-                if (isLineCollisionFree(smoothed[i], smoothed[j], grid)) {
-                    // Can shortcut - remove intermediate points
-                    smoothed.erase(smoothed.begin() + i + 1, smoothed.begin() + j);
-                    improved = true;
-                    break;
-                }
+        if (entry == 0) {
+            bool visible = PathSmoothing::isLineCollisionFree(path_[i], path_[j], grid_);
+            misses_.fetch_add(1, std::memory_order_relaxed);
+            uint64_t expected = 0;
+            table_[slot].compare_exchange_strong(expected, (key << 2) | (visible ? 2 : 1),
+                                                 std::memory_order_release);
+            return visible;
+        }
+        if ((entry >> 2) == key) {
+            hits_.fetch_add(1, std::memory_order_relaxed);
+            return (entry & 3) == 2;
+        }
+    }
+    
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    return PathSmoothing::isLineCollisionFree(path_[i], path_[j], grid_);
+}
+
+// ============================================================================
+// Greedy and Randomized Shortcutting
+// ============================================================================
+
+std::vector<size_t> PathSmoothing::greedyShortcut(VisibilityCache& cache) {
+    const size_t n = cache.size();
+    std::vector<size_t> kept;
+    if (n == 0) return kept;
+    
+    kept.push_back(0);
+    size_t i = 0;
+    
+    while (i < n - 1) {
+        // Gallop: i + 2, i + 4, i + 8, ... until blocked or the end is reached
+        size_t lo = i + 1;  // Farthest index known visible
+        size_t hi = n;      // Nearest index known blocked (n = none)
+        
+        for (size_t step = 2;; step *= 2) {
+            size_t probe = std::min(i + step, n - 1);
+            if (probe <= lo) break;
+            
+            if (cache.isVisible(i, probe)) {
+                lo = probe;
+                if (probe == n - 1) break;
+            } else {
+                hi = probe;
+                break;
+            }
+        }
+        
+        // Binary search between the last visible and first blocked probe
+        while (hi - lo > 1 && hi < n) {
+            size_t mid = lo + (hi - lo) / 2;
+            if (cache.isVisible(i, mid)) {
+                lo = mid;
+            } else {
+                hi = mid;
             }
-            if (improved) break;
         }
         
-        if (!improved) break;
+        kept.push_back(lo);
+        i = lo;
     }
     
+    return kept;
+}
+
+std::vector<size_t> PathSmoothing::randomShortcut(VisibilityCache& cache,
+                                                  const std::vector<size_t>& kept,
+                                                  int rounds,
+                                                  int num_threads,
+                                                  uint64_t seed) {
+    std::vector<size_t> current = kept;
+    if (num_threads <= 0) num_threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    
+    RandomStream rng(seed);
+    
+    struct Candidate {
+        size_t a, b;  // Positions in current
+        bool visible;
+    };
+    std::vector<Candidate> batch;
+    std::vector<size_t> next;
+    std::unique_ptr<WorkerPool> pool;
+    
+    for (int round = 0; round < rounds; round++) {
+        const size_t m = current.size();
+        if (m < 3) break;
+        
+        // Sample pairs at least two positions apart (batch size fixed so the
+        // outcome does not depend on the thread count)
+        const size_t kBatchSize = 256;
+        const size_t batch_size = std::min(m, kBatchSize);
+        batch.resize(batch_size);
+        for (auto& c : batch) {
+            c.a = static_cast<size_t>(rng() % (m - 2));
+            c.b = c.a + 2 + static_cast<size_t>(rng() % (m - c.a - 2));
+            c.visible = false;
+        }
+        std::sort(batch.begin(), batch.end(), [](const Candidate& l, const Candidate& r) {
+            return l.a < r.a || (l.a == r.a && l.b > r.b);
+        });
+        
+        // Visibility checks are the expensive part; spread them over the threads
+        std::atomic<size_t> next_candidate(0);
+        auto worker = [&](int) {
+            for (size_t c = next_candidate.fetch_add(1); c < batch_size; c = next_candidate.fetch_add(1)) {
+                batch[c].visible = cache.isVisible(current[batch[c].a], current[batch[c].b]);
+            }
+        };
+        int workers = std::min(num_threads, static_cast<int>(batch_size));
+        if (workers > 1) {
+            // Started on the first round that needs them, reused by later rounds
+            if (!pool) pool = std::make_unique<WorkerPool>(num_threads);
+            pool->run(workers, worker);
+        } else {
+            worker(0);
+        }
+        
+        // Apply non-overlapping shortcuts in one compaction pass
+        next.clear();
+        size_t pos = 0;
+        for (const auto& c : batch) {
+            if (!c.visible || c.a < pos) continue;
+            while (pos <= c.a) next.push_back(current[pos++]);
+            pos = c.b;
+        }
+        while (pos < m) next.push_back(current[pos++]);
+        
+        current.swap(next);
+    }
+    
+    return current;
+}
+
+std::vector<Vec2> PathSmoothing::shortcutSmooth(const std::vector<Vec2>& path,
+                                               const Grid& grid,
+                                               int max_iterations) {
+    AUTODRIVER_SCOPE(SMOOTH_SHORTCUT);
+    if (path.size() < 3) return path;
+    
+    VisibilityCache cache(path, grid);
+    std::vector<size_t> kept = greedyShortcut(cache);
+    kept = randomShortcut(cache, kept, max_iterations);
+    
+    std::vector<Vec2> smoothed;
+    smoothed.reserve(kept.size());
+    for (size_t index : kept) smoothed.push_back(path[index]);
+    
     return smoothed;
 }
 
@@ -144,46 +317,450 @@ std::vector<Vec2> PathSmoothing::gradientSmooth(const std::vector<Vec2>& path,
                                                const Grid& grid,
                                                int iterations,
                                                float alpha) {
+    GradientSmoothOptions options;
+    options.max_iterations = iterations;
+    options.alpha = alpha;
+    return gradientSmooth(path, grid, options);
+}
+
+namespace {
+
+// out[i] = x[i] + alpha * (0.5 * (x[i - 1] + x[i + 1]) - x[i]) + force[i] for i in [1, n - 1)
+void relaxAxis(const float* x, const float* force, float* out, size_t n, float alpha) {
+    size_t i = 1;
+#if defined(__AVX__)
+    const __m256 va = _mm256_set1_ps(alpha);
+    const __m256 vhalf = _mm256_set1_ps(0.5f);
+    for (; i + 9 <= n; i += 8) {
+        __m256 c = _mm256_loadu_ps(x + i);
+        __m256 mid = _mm256_mul_ps(_mm256_add_ps(_mm256_loadu_ps(x + i - 1), _mm256_loadu_ps(x + i + 1)), vhalf);
+        __m256 step = _mm256_add_ps(c, _mm256_mul_ps(va, _mm256_sub_ps(mid, c)));
+        _mm256_storeu_ps(out + i, _mm256_add_ps(step, _mm256_loadu_ps(force + i)));
+    }
+#endif
+    for (; i + 1 < n; i++) {
+        out[i] = x[i] + alpha * (0.5f * (x[i - 1] + x[i + 1]) - x[i]) + force[i];
+    }
+}
+
+}  // namespace
+
+std::vector<Vec2> PathSmoothing::gradientSmooth(const std::vector<Vec2>& path,
+                                               const Grid& grid,
+                                               const GradientSmoothOptions& options,
+                                               GradientSmoothStats* stats) {
+    AUTODRIVER_SCOPE(SMOOTH_GRADIENT);
+    GradientSmoothStats local_stats;
+    GradientSmoothStats& st = stats ? *stats : local_stats;
+    st = GradientSmoothStats();
+    
     if (path.size() < 3) return path;
     
-    std::vector<Vec2> smoothed = path;
+    const size_t n = path.size();
     
-    for (int iter = 0; iter < iterations; iter++) {
-        std::vector<Vec2> new_path = smoothed;
+    // SoA double buffers; endpoints are written once and never move
+    std::vector<float> buf_x[2], buf_y[2];
+    std::vector<float> force_x(n, 0.0f), force_y(n, 0.0f);
+    for (int b = 0; b < 2; b++) {
+        buf_x[b].resize(n);
+        buf_y[b].resize(n);
+        for (size_t i = 0; i < n; i++) {
+            buf_x[b][i] = path[i].x;
+            buf_y[b][i] = path[i].y;
+        }
+    }
+    
+    // Clearance over the path's bounding box; waypoints only move a little
+    float min_x = path[0].x, max_x = path[0].x, min_y = path[0].y, max_y = path[0].y;
+    for (const auto& p : path) {
+        min_x = std::min(min_x, p.x);
+        max_x = std::max(max_x, p.x);
+        min_y = std::min(min_y, p.y);
+        max_y = std::max(max_y, p.y);
+    }
+    ClearanceMap clearance(grid,
+                           static_cast<int>(std::floor(min_x)) - 2, static_cast<int>(std::floor(min_y)) - 2,
+                           static_cast<int>(std::ceil(max_x)) + 2, static_cast<int>(std::ceil(max_y)) + 2,
+                           std::max(8.0f, options.obstacle_distance + 1.0f));
+    
+    auto isPointFree = [&](Vec2 p) {
+        return !grid.isObstacle(static_cast<int>(std::round(p.x)), static_cast<int>(std::round(p.y)));
+    };
+    auto isSegmentFree = [&](Vec2 a, Vec2 b) {
+        st.segment_checks++;
+        if (clearance.isSegmentClear(a, b)) return true;
+        st.exact_checks++;
+        return isLineCollisionFree(a, b, grid);
+    };
+    
+    int cur = 0;
+    
+    for (int iter = 0; iter < options.max_iterations; iter++) {
+        const float* x = buf_x[cur].data();
+        const float* y = buf_y[cur].data();
+        float* nx = buf_x[1 - cur].data();
+        float* ny = buf_y[1 - cur].data();
         
-        // Don't move start and end points
-        for (size_t i = 1; i < smoothed.size() - 1; i++) {
-            Vec2 prev = smoothed[i - 1];
-            Vec2 curr = smoothed[i];
-            Vec2 next = smoothed[i + 1];
+        // Repulsion from obstacles closer than obstacle_distance
+        for (size_t i = 1; i + 1 < n; i++) {
+            force_x[i] = 0.0f;
+            force_y[i] = 0.0f;
+            
+            float d;
+            Vec2 g;
+            if (!clearance.sample(Vec2(x[i], y[i]), d, g) || d >= options.obstacle_distance) continue;
             
-            // Calculate gradient (direction to reduce curvature)
-            Vec2 midpoint_prev = (prev + curr) * 0.5f;
-            Vec2 midpoint_next = (curr + next) * 0.5f;
-            Vec2 gradient = midpoint_prev + midpoint_next - curr * 2.0f;
+            float len = g.length();
+            if (len < 1e-6f) {
+                if (clearance.at(static_cast<int>(std::round(x[i])), static_cast<int>(std::round(y[i]))) > 0.0f) continue;
+                // Inside an obstacle with no preferred side: push along the path's left normal
+                g = Vec2(y[i - 1] - y[i + 1], x[i + 1] - x[i - 1]);
+                len = g.length();
+                if (len < 1e-6f) continue;
+            }
             
-            // Update position
-            Vec2 new_pos = curr + gradient * alpha;
+            float push = options.obstacle_weight * (options.obstacle_distance - d) / len;
+            force_x[i] = g.x * push;
+            force_y[i] = g.y * push;
+        }
+        
+        // Candidate positions for all waypoints at once
+        relaxAxis(x, force_x.data(), nx, n, options.alpha);
+        relaxAxis(y, force_y.data(), ny, n, options.alpha);
+        
+        // Validate in path order against the already-validated predecessor, so
+        // every segment of the result has been checked in its final form. A
+        // move may not introduce a collision that was not already there.
+        float max_move2 = 0.0f;
+        for (size_t i = 1; i + 1 < n; i++) {
+            Vec2 prev(nx[i - 1], ny[i - 1]);
+            Vec2 curr(x[i], y[i]);
+            Vec2 next(x[i + 1], y[i + 1]);
+            Vec2 cand(nx[i], ny[i]);
             
-            // Check if new position is valid
-            int gx = static_cast<int>(std::round(new_pos.x));
-            int gy = static_cast<int>(std::round(new_pos.y));
+            bool accept = (isPointFree(cand) || !isPointFree(curr)) &&
+                          (isSegmentFree(prev, cand) || !isSegmentFree(prev, curr)) &&
+                          (isSegmentFree(cand, next) || !isSegmentFree(curr, next));
             
-            if (!grid.isObstacle(gx, gy) && grid.isValid(gx, gy)) {
-                // Check if moving doesn't create collision
-                if (isLineCollisionFree(prev, new_pos, grid) &&
-                    isLineCollisionFree(new_pos, next, grid)) {
-                    new_path[i] = new_pos;
-                }
+            if (accept) {
+                Vec2 move = cand - curr;
+                max_move2 = std::max(max_move2, move.x * move.x + move.y * move.y);
+            } else {
+                nx[i] = x[i];
+                ny[i] = y[i];
             }
         }
         
-        smoothed = new_path;
+        cur = 1 - cur;
+        st.iterations = iter + 1;
+        st.max_displacement = std::sqrt(max_move2);
+        
+        if (st.max_displacement < options.tolerance) {
+            st.converged = true;
+            break;
+        }
+    }
+    
+    std::vector<Vec2> smoothed(n);
+    for (size_t i = 0; i < n; i++) {
+        smoothed[i] = Vec2(buf_x[cur][i], buf_y[cur][i]);
     }
     
     return smoothed;
 }
 
+// ============================================================================
+// Spline Fitting
+// ============================================================================
+
+namespace {
+
+/**
+ * Clamped cubic spline x(t), y(t) through the knots, t = cumulative chord length.
+ */
+struct CubicSpline {
+    std::vector<float> t;
+    std::vector<float> x, y;
+    std::vector<float> mx, my;  // Second derivatives at the knots
+    
+    // Knots must be distinct and at least two
+    void fit(const std::vector<Vec2>& knots) {
+        const size_t n = knots.size();
+        t.assign(n, 0.0f);
+        x.resize(n);
+        y.resize(n);
+        for (size_t i = 0; i < n; i++) {
+            x[i] = knots[i].x;
+            y[i] = knots[i].y;
+            if (i > 0) t[i] = t[i - 1] + (knots[i] - knots[i - 1]).length();
+        }
+        
+        // Tridiagonal system for the second derivatives; clamped end slopes
+        // are the first and last chord directions. Both axes share the matrix,
+        // so one forward sweep (Thomas algorithm) serves two right-hand sides.
+        std::vector<float> diag(n), upper(n), rx(n), ry(n);
+        const float h0 = t[1] - t[0];
+        const float hl = t[n - 1] - t[n - 2];
+        const float sx0 = (x[1] - x[0]) / h0, sy0 = (y[1] - y[0]) / h0;
+        const float sxl = (x[n - 1] - x[n - 2]) / hl, syl = (y[n - 1] - y[n - 2]) / hl;
+        
+        diag[0] = 2.0f * h0;
+        upper[0] = h0;
+        rx[0] = 6.0f * ((x[1] - x[0]) / h0 - sx0);
+        ry[0] = 6.0f * ((y[1] - y[0]) / h0 - sy0);
+        for (size_t i = 1; i + 1 < n; i++) {
+            float hp = t[i] - t[i - 1];
+            float hn = t[i + 1] - t[i];
+            diag[i] = 2.0f * (hp + hn);
+            upper[i] = hn;
+            rx[i] = 6.0f * ((x[i + 1] - x[i]) / hn - (x[i] - x[i - 1]) / hp);
+            ry[i] = 6.0f * ((y[i + 1] - y[i]) / hn - (y[i] - y[i - 1]) / hp);
+        }
+        diag[n - 1] = 2.0f * hl;
+        rx[n - 1] = 6.0f * (sxl - (x[n - 1] - x[n - 2]) / hl);
+        ry[n - 1] = 6.0f * (syl - (y[n - 1] - y[n - 2]) / hl);
+        
+        // Forward elimination (sub-diagonal equals the previous upper entry)
+        for (size_t i = 1; i < n; i++) {
+            float w = upper[i - 1] / diag[i - 1];
+            diag[i] -= w * upper[i - 1];
+            rx[i] -= w * rx[i - 1];
+            ry[i] -= w * ry[i - 1];
+        }
+        
+        // Back substitution
+        mx.resize(n);
+        my.resize(n);
+        mx[n - 1] = rx[n - 1] / diag[n - 1];
+        my[n - 1] = ry[n - 1] / diag[n - 1];
+        for (size_t i = n - 1; i-- > 0;) {
+            mx[i] = (rx[i] - upper[i] * mx[i + 1]) / diag[i];
+            my[i] = (ry[i] - upper[i] * my[i + 1]) / diag[i];
+        }
+    }
+    
+    // Position, first and second derivative at offset u into segment i
+    void evaluate(size_t i, float u, Vec2& p, Vec2& d1, Vec2& d2) const {
+        const float h = t[i + 1] - t[i];
+        const float a = h - u;
+        
+        auto axis = [&](const std::vector<float>& v, const std::vector<float>& m,
+                        float& pos, float& der1, float& der2) {
+            float c0 = v[i] / h - m[i] * h / 6.0f;
+            float c1 = v[i + 1] / h - m[i + 1] * h / 6.0f;
+            pos = (m[i] * a * a * a + m[i + 1] * u * u * u) / (6.0f * h) + c0 * a + c1 * u;
+            der1 = (m[i + 1] * u * u - m[i] * a * a) / (2.0f * h) - c0 + c1;
+            der2 = (m[i] * a + m[i + 1] * u) / h;
+        };
+        
+        axis(x, mx, p.x, d1.x, d2.x);
+        axis(y, my, p.y, d1.y, d2.y);
+    }
+};
+
+float signedCurvature(Vec2 d1, Vec2 d2) {
+    float speed2 = d1.x * d1.x + d1.y * d1.y;
+    if (speed2 < 1e-12f) return 0.0f;
+    return (d1.x * d2.y - d1.y * d2.x) / (speed2 * std::sqrt(speed2));
+}
+
+// Drop consecutive duplicates, which would make a zero-length spline segment
+std::vector<Vec2> distinctKnots(const std::vector<Vec2>& path) {
+    std::vector<Vec2> knots;
+    knots.reserve(path.size());
+    for (const auto& p : path) {
+        if (knots.empty() || (p - knots.back()).length() > 1e-4f) knots.push_back(p);
+    }
+    return knots;
+}
+
+/**
+ * Resample the spline at uniform arc length. The arc-length table holds a
+ * fixed number of chord samples per segment; targets are monotonic, so one
+ * forward walk over the table serves all of them. segment_of receives the
+ * spline segment each output sample lies on.
+ */
+void resampleSpline(const CubicSpline& spline, float spacing, SplineResult& result,
+                    std::vector<size_t>& segment_of) {
+    const int kSamplesPerSegment = 16;
+    const size_t segments = spline.t.size() - 1;
+    
+    // Arc-length table: (segment, u, cumulative length)
+    std::vector<size_t> table_seg;
+    std::vector<float> table_u, table_s;
+    table_seg.reserve(segments * kSamplesPerSegment + 1);
+    table_u.reserve(segments * kSamplesPerSegment + 1);
+    table_s.reserve(segments * kSamplesPerSegment + 1);
+    
+    table_seg.push_back(0);
+    table_u.push_back(0.0f);
+    table_s.push_back(0.0f);
+    
+    Vec2 last(spline.x[0], spline.y[0]);
+    float length = 0.0f;
+    for (size_t i = 0; i < segments; i++) {
+        float h = spline.t[i + 1] - spline.t[i];
+        for (int k = 1; k <= kSamplesPerSegment; k++) {
+            float u = h * k / kSamplesPerSegment;
+            Vec2 p, d1, d2;
+            spline.evaluate(i, u, p, d1, d2);
+            length += (p - last).length();
+            last = p;
+            table_seg.push_back(i);
+            table_u.push_back(u);
+            table_s.push_back(length);
+        }
+    }
+    
+    spacing = std::max(spacing, 1e-3f);
+    const size_t count = std::max<size_t>(2, static_cast<size_t>(std::ceil(length / spacing)) + 1);
+    const float step = length / (count - 1);
+    
+    result.length = length;
+    result.points.resize(count);
+    result.curvature.resize(count);
+    segment_of.resize(count);
+    result.max_curvature = 0.0f;
+    
+    size_t row = 1;
+    for (size_t k = 0; k < count; k++) {
+        float target = (k + 1 == count) ? length : k * step;
+        while (row + 1 < table_s.size() && table_s[row] < target) row++;
+        
+        // Interpolate u between the bracketing table rows (same segment unless
+        // the row starts a new one, in which case the previous row is u = 0)
+        size_t seg = table_seg[row];
+        float u0 = (table_seg[row - 1] == seg) ? table_u[row - 1] : 0.0f;
+        float ds = table_s[row] - table_s[row - 1];
+        float f = ds > 1e-9f ? (target - table_s[row - 1]) / ds : 0.0f;
+        f = std::max(0.0f, std::min(1.0f, f));
+        float u = u0 + (table_u[row] - u0) * f;
+        
+        Vec2 p, d1, d2;
+        spline.evaluate(seg, u, p, d1, d2);
+        result.points[k] = p;
+        result.curvature[k] = signedCurvature(d1, d2);
+        result.max_curvature = std::max(result.max_curvature, std::fabs(result.curvature[k]));
+        segment_of[k] = seg;
+    }
+}
+
+}  // namespace
+
+SplineResult PathSmoothing::fitSpline(const std::vector<Vec2>& path,
+                                      const SplineOptions& options,
+                                      const Grid* grid) {
+    AUTODRIVER_SCOPE(SMOOTH_SPLINE);
+    SplineResult result;
+    std::vector<Vec2> knots = distinctKnots(path);
+    
+    if (knots.size() < 2) {
+        result.points = knots;
+        result.curvature.assign(knots.size(), 0.0f);
+        return result;
+    }
+    
+    const bool bounded = options.max_curvature > 0.0f;
+    
+    // Give the relaxation room to bend: collinear knots only slow it down, and
+    // no edge should be longer than the turn radius
+    if (bounded) {
+        std::vector<Vec2> corners;
+        corners.push_back(knots[0]);
+        for (size_t i = 1; i + 1 < knots.size(); i++) {
+            Vec2 a = knots[i] - corners.back();
+            Vec2 b = knots[i + 1] - knots[i];
+            if (std::fabs(a.x * b.y - a.y * b.x) > 1e-4f * a.length() * b.length() ||
+                a.x * b.x + a.y * b.y < 0.0f) {
+                corners.push_back(knots[i]);
+            }
+        }
+        corners.push_back(knots.back());
+        
+        const float max_edge = 1.0f / options.max_curvature;
+        std::vector<Vec2> dense;
+        dense.push_back(corners[0]);
+        for (size_t i = 1; i < corners.size(); i++) {
+            Vec2 edge = corners[i] - corners[i - 1];
+            int pieces = std::max(1, static_cast<int>(std::ceil(edge.length() / max_edge)));
+            for (int k = 1; k <= pieces; k++) {
+                dense.push_back(corners[i - 1] + edge * (static_cast<float>(k) / pieces));
+            }
+        }
+        knots.swap(dense);
+    }
+    
+    CubicSpline spline;
+    std::vector<size_t> segment_of;
+    std::vector<uint8_t> violating;
+    const float bound = options.max_curvature * 1.001f;
+    
+    for (int pass = 0;; pass++) {
+        spline.fit(knots);
+        resampleSpline(spline, options.spacing, result, segment_of);
+        result.refinements = pass;
+        result.curvature_feasible = !bounded || result.max_curvature <= bound;
+        
+        if (result.curvature_feasible || pass >= options.max_refinements || knots.size() < 3) break;
+        
+        // Interior knots bounding any segment with a violating sample
+        violating.assign(knots.size(), 0);
+        for (size_t k = 0; k < result.points.size(); k++) {
+            if (std::fabs(result.curvature[k]) > bound) {
+                violating[segment_of[k]] = 1;
+                violating[segment_of[k] + 1] = 1;
+            }
+        }
+        
+        // Spread the marks so the bend is shared by more knots as passes go on
+        const size_t reach = 1 + pass / 4;
+        std::vector<uint8_t> relax(knots.size(), 0);
+        for (size_t i = 0; i < knots.size(); i++) {
+            if (!violating[i]) continue;
+            size_t lo = i > reach ? i - reach : 0;
+            size_t hi = std::min(knots.size() - 1, i + reach);
+            for (size_t j = lo; j <= hi; j++) relax[j] = 1;
+        }
+        
+        // Relax toward the neighbours' midpoint
+        bool moved = false;
+        for (size_t i = 1; i + 1 < knots.size(); i++) {
+            if (!relax[i]) continue;
+            
+            Vec2 target = (knots[i - 1] + knots[i + 1]) * 0.5f;
+            Vec2 cand = knots[i] + (target - knots[i]) * 0.5f;
+            
+            if (grid && (!isLineCollisionFree(knots[i - 1], cand, *grid) ||
+                         !isLineCollisionFree(cand, knots[i + 1], *grid))) {
+                continue;
+            }
+            
+            moved = moved || (cand - knots[i]).length() > 1e-5f;
+            knots[i] = cand;
+        }
+        
+        if (!moved) break;
+    }
+    
+    return result;
+}
+
+SplineResult PathSmoothing::fitSpline(const std::vector<Vec2>& path,
+                                      const VehicleParams& vehicle,
+                                      float spacing,
+                                      const Grid* grid) {
+    SplineOptions options;
+    options.spacing = spacing;
+    options.max_curvature = vehicle.min_turn_radius > 0.0f ? 1.0f / vehicle.min_turn_radius : 0.0f;
+    return fitSpline(path, options, grid);
+}
+
+std::vector<Vec2> PathSmoothing::splineSmooth(const std::vector<Vec2>& path, float spacing) {
+    SplineOptions options;
+    options.spacing = spacing;
+    return fitSpline(path, options).points;
+}
+
 // ============================================================================
 // Combined Smoothing
 // ============================================================================
@@ -198,8 +775,8 @@ std::vector<Vec2> PathSmoothing::smoothPath(const std::vector<Vec2>& path,
     // Step 2: Apply gradient descent to reduce sharp turns
     smoothed = gradientSmooth(smoothed, grid, 30, 0.15f);
     
-    // Step 3: Final pass with Bezier for visual smoothness
-    smoothed = bezierSmooth(smoothed, 5);
+    // Step 3: Spline through the result, resampled at uniform arc length
+    smoothed = splineSmooth(smoothed, 0.5f);
     
     return smoothed;
 }
@@ -0,0 +1,449 @@
+#include "core/planning_service.h"
+#include "core/astar.h"
+#include "core/rrt.h"
+#include "core/random.h"
+#include <algorithm>
+#include <set>
+#include <cmath>
+
+namespace {
+
+double elapsedMs(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to) {
+    return std::chrono::duration<double, std::milli>(to - from).count();
+}
+
+}  // namespace
+
+// ============================================================================
+// Construction / Shutdown
+// ============================================================================
+
+PlanningService::PlanningService(const Grid& initial_map, int num_workers)
+    : dispatcher_sleeping_(false)
+    , front_(initial_map)
+    , version_(0)
+    , jobs_in_flight_(0)
+    , workers_stop_(false)
+    , running_(true)
+    , producers_(0)
+    , next_request_id_(1)
+    , queries_submitted_(0)
+    , queries_completed_(0)
+    , deltas_received_(0)
+    , cells_edited_(0)
+    , snapshots_published_(0)
+    , tiles_copied_(0) {
+    
+    publish();
+    
+    if (num_workers <= 0) {
+        num_workers = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    }
+    for (int i = 0; i < num_workers; i++) {
+        workers_.emplace_back(&PlanningService::workerLoop, this);
+    }
+    dispatcher_ = std::thread(&PlanningService::dispatcherLoop, this);
+}
+
+PlanningService::~PlanningService() {
+    stop();
+}
+
+void PlanningService::stop() {
+    if (!running_.exchange(false)) return;
+    
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        wake_cv_.notify_one();
+    }
+    dispatcher_.join();
+    
+    {
+        std::lock_guard<std::mutex> lock(jobs_mutex_);
+        workers_stop_ = true;
+    }
+    jobs_cv_.notify_all();
+    for (auto& worker : workers_) worker.join();
+    
+    // A producer that saw running_ before the exchange may still be pushing;
+    // wait for it so the drain below sees its command
+    while (producers_.load() != 0) std::this_thread::yield();
+    
+    // Anything that raced with shutdown is answered as failed
+    Command* command;
+    while (inbox_.tryPop(command)) {
+        if (command->promise) command->promise->set_value(PlanningResponse());
+        if (command->fence) command->fence->set_value();
+        delete command;
+    }
+}
+
+// ============================================================================
+// Producer API
+// ============================================================================
+
+void PlanningService::enqueue(Command* command) {
+    inbox_.push(command);
+    
+    // Pairs with the fence in dispatcherLoop: either the dispatcher sees the
+    // new item before sleeping, or we see that it is asleep
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (dispatcher_sleeping_.load(std::memory_order_relaxed)) {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        wake_cv_.notify_one();
+    }
+}
+
+bool PlanningService::beginProduce() {
+    // Sequentially consistent with stop(): either we see running_ cleared, or
+    // stop() sees us counted and waits until we have pushed
+    producers_.fetch_add(1);
+    if (running_.load()) return true;
+    producers_.fetch_sub(1);
+    return false;
+}
+
+void PlanningService::updateMap(std::vector<CellEdit> edits) {
+    if (edits.empty() || !beginProduce()) return;
+    
+    Command* command = new Command();
+    command->kind = Command::MAP_DELTA;
+    command->edits = std::move(edits);
+    deltas_received_.fetch_add(1, std::memory_order_relaxed);
+    enqueue(command);
+    producers_.fetch_sub(1);
+}
+
+std::future<PlanningResponse> PlanningService::submit(const PlanningRequest& request) {
+    Command* command = new Command();
+    command->kind = Command::QUERY;
+    command->request = request;
+    command->request_id = next_request_id_.fetch_add(1, std::memory_order_relaxed);
+    command->submitted = std::chrono::steady_clock::now();
+    command->promise = std::make_shared<std::promise<PlanningResponse>>();
+    
+    std::future<PlanningResponse> future = command->promise->get_future();
+    
+    if (!beginProduce()) {
+        command->promise->set_value(PlanningResponse());
+        delete command;
+        return future;
+    }
+    
+    queries_submitted_.fetch_add(1, std::memory_order_relaxed);
+    enqueue(command);
+    producers_.fetch_sub(1);
+    return future;
+}
+
+void PlanningService::drain() {
+    if (!beginProduce()) return;
+    
+    Command* command = new Command();
+    command->kind = Command::FENCE;
+    command->fence = std::make_shared<std::promise<void>>();
+    
+    std::future<void> done = command->fence->get_future();
+    enqueue(command);
+    producers_.fetch_sub(1);
+    done.wait();
+}
+
+MapSnapshot PlanningService::snapshot() const {
+    std::shared_ptr<const MapSnapshot> current = std::atomic_load(&published_);
+    return *current;
+}
+
+ServiceStats PlanningService::getStats() const {
+    ServiceStats stats;
+    stats.queries_submitted = queries_submitted_.load();
+    stats.queries_completed = queries_completed_.load();
+    stats.deltas_received = deltas_received_.load();
+    stats.cells_edited = cells_edited_.load();
+    stats.snapshots_published = snapshots_published_.load();
+    stats.tiles_copied = tiles_copied_.load();
+    stats.path_cache = path_cache_.getStats();
+    return stats;
+}
+
+// ============================================================================
+// Dispatcher (single consumer, single map writer)
+// ============================================================================
+
+void PlanningService::dispatcherLoop() {
+    while (true) {
+        Command* command;
+        if (inbox_.tryPop(command)) {
+            handle(command);
+            continue;
+        }
+        
+        // Inbox drained: publish the accumulated deltas as one version
+        publishPending();
+        
+        if (!running_.load()) {
+            if (inbox_.empty()) break;
+            continue;
+        }
+        
+        // Spin briefly before parking; requests often arrive in bursts
+        bool ready = false;
+        for (int spin = 0; spin < 64 && !ready; spin++) {
+            std::this_thread::yield();
+            ready = !inbox_.empty();
+        }
+        if (ready) continue;
+        
+        std::unique_lock<std::mutex> lock(wake_mutex_);
+        dispatcher_sleeping_.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (inbox_.empty() && running_.load()) {
+            // Timeout only guards against a producer pushing mid-link
+            wake_cv_.wait_for(lock, std::chrono::milliseconds(1));
+        }
+        dispatcher_sleeping_.store(false, std::memory_order_relaxed);
+    }
+    
+    publishPending();
+}
+
+void PlanningService::handle(Command* command) {
+    switch (command->kind) {
+        case Command::MAP_DELTA:
+            pending_.insert(pending_.end(), command->edits.begin(), command->edits.end());
+            delete command;
+            break;
+        
+        case Command::QUERY: {
+            // The query must see every delta submitted before it
+            publishPending();
+            jobs_in_flight_.fetch_add(1);
+            {
+                std::lock_guard<std::mutex> lock(jobs_mutex_);
+                jobs_.push_back(command);
+            }
+            jobs_cv_.notify_one();
+            break;
+        }
+        
+        case Command::FENCE:
+            publishPending();
+            while (jobs_in_flight_.load() > 0) std::this_thread::yield();
+            command->fence->set_value();
+            delete command;
+            break;
+    }
+}
+
+void PlanningService::publish() {
+    auto grid = std::make_shared<const Grid>(front_.snapshot());
+    auto snapshot = std::make_shared<const MapSnapshot>(std::move(grid), version_);
+    std::atomic_store(&published_, std::shared_ptr<const MapSnapshot>(std::move(snapshot)));
+}
+
+void PlanningService::publishPending() {
+    if (pending_.empty()) return;
+    
+    // Tiles still shared with published snapshots are cloned on first write
+    size_t cloned_before = front_.getTilesCloned();
+    for (const auto& edit : pending_) front_.setObstacle(edit.x, edit.y, edit.blocked);
+    
+    version_++;
+    publish();
+    
+    cells_edited_.fetch_add(pending_.size(), std::memory_order_relaxed);
+    tiles_copied_.fetch_add(front_.getTilesCloned() - cloned_before, std::memory_order_relaxed);
+    snapshots_published_.fetch_add(1, std::memory_order_relaxed);
+    pending_.clear();
+}
+
+// ============================================================================
+// Worker Pool
+// ============================================================================
+
+void PlanningService::workerLoop() {
+    while (true) {
+        Command* command;
+        {
+            std::unique_lock<std::mutex> lock(jobs_mutex_);
+            jobs_cv_.wait(lock, [this]() { return !jobs_.empty() || workers_stop_; });
+            if (jobs_.empty()) return;
+            command = jobs_.front();
+            jobs_.pop_front();
+        }
+        
+        runQuery(command);
+        delete command;
+        
+        queries_completed_.fetch_add(1, std::memory_order_relaxed);
+        jobs_in_flight_.fetch_sub(1);
+    }
+}
+
+void PlanningService::runQuery(Command* command) {
+    PlanningResponse response;
+    response.request_id = command->request_id;
+    
+    auto start_time = std::chrono::steady_clock::now();
+    response.queue_ms = elapsedMs(command->submitted, start_time);
+    
+    // The snapshot keeps its grid alive for the whole query
+    MapSnapshot map = snapshot();
+    response.map_version = map.version;
+    
+    const PlanningRequest& request = command->request;
+    
+    switch (request.planner) {
+        case ServicePlanner::ASTAR: {
+            AStar astar(*map.grid);
+            AStarResult result = path_cache_.findPath(astar, request.start, request.goal);
+            response.success = result.success;
+            response.path_cost = result.path_cost;
+            response.path.reserve(result.path.size());
+            for (const auto& cell : result.path) {
+                response.path.emplace_back(static_cast<float>(cell.x), static_cast<float>(cell.y));
+            }
+            break;
+        }
+        
+        case ServicePlanner::RRT_STAR: {
+            RRTStar rrt(*map.grid);
+            rrt.setSeed(command->request_id);
+            RRTResult result = rrt.findPath(Vec2(request.start.x, request.start.y),
+                                            Vec2(request.goal.x, request.goal.y),
+                                            request.max_iterations);
+            response.success = result.success;
+            response.path_cost = result.path_cost;
+            response.path = std::move(result.path);
+            break;
+        }
+    }
+    
+    response.planning_ms = elapsedMs(start_time, std::chrono::steady_clock::now());
+    command->promise->set_value(std::move(response));
+}
+
+// ============================================================================
+// Load Generator
+// ============================================================================
+
+LoadTestReport PlanningService::runLoadTest(const LoadTestConfig& config) {
+    LoadTestReport report;
+    
+    MapSnapshot base = snapshot();
+    const int width = base.grid->getWidth();
+    const int height = base.grid->getHeight();
+    RandomStream seed_stream(config.seed);
+    
+    std::atomic<bool> clients_done(false);
+    std::atomic<size_t> updates(0);
+    
+    // Writers: blinking obstacles. Each tick clears the previous tick's cells
+    // and blocks new free ones, so obstacle density stays constant.
+    std::vector<std::thread> writers;
+    for (int w = 0; w < config.update_threads; w++) {
+        writers.emplace_back([&, w]() {
+            RandomStream rng = seed_stream.split(1000 + w);
+            std::vector<CellEdit> previous;
+            auto period = std::chrono::microseconds(1000000 / std::max(1, config.updates_per_second));
+            auto next_tick = std::chrono::steady_clock::now();
+            
+            while (!clients_done.load()) {
+                std::vector<CellEdit> edits;
+                for (const auto& edit : previous) edits.emplace_back(edit.x, edit.y, false);
+                
+                previous.clear();
+                for (int e = 0; e < config.edits_per_update; e++) {
+                    int x = static_cast<int>(rng() % width);
+                    int y = static_cast<int>(rng() % height);
+                    if (base.grid->isObstacle(x, y)) continue;
+                    previous.emplace_back(x, y, true);
+                    edits.emplace_back(x, y, true);
+                }
+                
+                updateMap(std::move(edits));
+                updates.fetch_add(1);
+                
+                next_tick += period;
+                std::this_thread::sleep_until(next_tick);
+            }
+            
+            // Leave the map as it was
+            std::vector<CellEdit> restore;
+            for (const auto& edit : previous) restore.emplace_back(edit.x, edit.y, false);
+            updateMap(std::move(restore));
+        });
+    }
+    
+    // Closed-loop clients: submit, wait, record
+    std::vector<std::vector<double>> latencies(config.query_threads);
+    std::vector<std::vector<uint64_t>> versions(config.query_threads);
+    std::vector<size_t> successes(config.query_threads, 0);
+    
+    auto test_start = std::chrono::steady_clock::now();
+    
+    std::vector<std::thread> clients;
+    for (int c = 0; c < config.query_threads; c++) {
+        clients.emplace_back([&, c]() {
+            RandomStream rng = seed_stream.split(c);
+            
+            auto randomFreeCell = [&]() {
+                for (int attempt = 0; attempt < 100; attempt++) {
+                    Vec2i cell(static_cast<int>(rng() % width), static_cast<int>(rng() % height));
+                    if (!base.grid->isObstacle(cell.x, cell.y)) return cell;
+                }
+                return Vec2i(0, 0);
+            };
+            
+            for (int q = 0; q < config.queries_per_thread; q++) {
+                PlanningRequest request(randomFreeCell(), randomFreeCell(), config.planner);
+                
+                auto t0 = std::chrono::steady_clock::now();
+                PlanningResponse response = submit(request).get();
+                latencies[c].push_back(elapsedMs(t0, std::chrono::steady_clock::now()));
+                versions[c].push_back(response.map_version);
+                if (response.success) successes[c]++;
+            }
+        });
+    }
+    
+    for (auto& client : clients) client.join();
+    report.duration_ms = elapsedMs(test_start, std::chrono::steady_clock::now());
+    
+    clients_done.store(true);
+    for (auto& writer : writers) writer.join();
+    drain();
+    
+    std::vector<double> all;
+    std::set<uint64_t> distinct;
+    for (int c = 0; c < config.query_threads; c++) {
+        all.insert(all.end(), latencies[c].begin(), latencies[c].end());
+        distinct.insert(versions[c].begin(), versions[c].end());
+        report.successful += successes[c];
+    }
+    
+    report.queries = all.size();
+    report.updates = updates.load();
+    report.versions_observed = distinct.size();
+    
+    if (!all.empty()) {
+        std::sort(all.begin(), all.end());
+        
+        // Nearest-rank percentiles
+        auto percentile = [&all](double p) {
+            size_t rank = static_cast<size_t>(std::ceil(p * all.size()));
+            return all[std::min(all.size() - 1, rank > 0 ? rank - 1 : 0)];
+        };
+        
+        double sum = 0.0;
+        for (double value : all) sum += value;
+        
+        report.p50_ms = percentile(0.50);
+        report.p99_ms = percentile(0.99);
+        report.max_ms = all.back();
+        report.mean_ms = sum / all.size();
+        report.queries_per_second = report.duration_ms > 0.0 ? 1000.0 * all.size() / report.duration_ms : 0.0;
+    }
+    
+    return report;
+}
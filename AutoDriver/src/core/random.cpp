@@ -0,0 +1,18 @@
+#include "core/random.h"
+
+RandomStream::RandomStream(uint64_t seed, uint64_t stream)
+    : seed_(seed)
+    , stream_(stream)
+    , key_(mix(seed ^ mix(stream + kGamma)))
+    , counter_(0) {
+}
+
+void RandomStream::fillUniform(float* out, size_t n, float lo, float hi) {
+    // No dependency between iterations, so the compiler can vectorise this
+    const uint64_t base = counter_;
+    const float scale = hi - lo;
+    for (size_t i = 0; i < n; i++) {
+        out[i] = lo + scale * toUnit(at(base + i));
+    }
+    counter_ += n;
+}
@@ -0,0 +1,215 @@
+#include "core/reeds_shepp.h"
+#include <cmath>
+#include <limits>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Formulas follow Reeds & Shepp (1990) in the normalised frame where the
+// start pose is the origin and the turning radius is 1.
+namespace {
+
+const double kZero = 1e-9;
+
+double mod2pi(double angle) {
+    double v = std::fmod(angle, 2.0 * M_PI);
+    if (v < -M_PI) v += 2.0 * M_PI;
+    else if (v > M_PI) v -= 2.0 * M_PI;
+    return v;
+}
+
+void polar(double x, double y, double& r, double& theta) {
+    r = std::sqrt(x * x + y * y);
+    theta = std::atan2(y, x);
+}
+
+struct Candidate {
+    char types[3];
+    double lengths[3];
+    double total;
+};
+
+void consider(Candidate& best, const char* types, double t, double u, double v) {
+    double total = std::abs(t) + std::abs(u) + std::abs(v);
+    if (total < best.total) {
+        for (int i = 0; i < 3; i++) best.types[i] = types[i];
+        best.lengths[0] = t;
+        best.lengths[1] = u;
+        best.lengths[2] = v;
+        best.total = total;
+    }
+}
+
+// L+ S+ L+
+bool LpSpLp(double x, double y, double phi, double& t, double& u, double& v) {
+    polar(x - std::sin(phi), y - 1.0 + std::cos(phi), u, t);
+    if (t >= -kZero) {
+        v = mod2pi(phi - t);
+        if (v >= -kZero) return true;
+    }
+    return false;
+}
+
+// L+ S+ R+
+bool LpSpRp(double x, double y, double phi, double& t, double& u, double& v) {
+    double t1, u1;
+    polar(x + std::sin(phi), y - 1.0 - std::cos(phi), u1, t1);
+    u1 = u1 * u1;
+    if (u1 >= 4.0) {
+        u = std::sqrt(u1 - 4.0);
+        double theta = std::atan2(2.0, u);
+        t = mod2pi(t1 + theta);
+        v = mod2pi(t - phi);
+        return t >= -kZero && v >= -kZero;
+    }
+    return false;
+}
+
+// L+ R- L+
+bool LpRmL(double x, double y, double phi, double& t, double& u, double& v) {
+    double xi = x - std::sin(phi);
+    double eta = y - 1.0 + std::cos(phi);
+    double u1, theta;
+    polar(xi, eta, u1, theta);
+    if (u1 <= 4.0) {
+        u = -2.0 * std::asin(0.25 * u1);
+        t = mod2pi(theta + 0.5 * u + M_PI);
+        v = mod2pi(phi - t + u);
+        return t >= -kZero && u <= kZero;
+    }
+    return false;
+}
+
+void CSC(double x, double y, double phi, Candidate& best) {
+    double t, u, v;
+    if (LpSpLp(x, y, phi, t, u, v)) consider(best, "LSL", t, u, v);
+    if (LpSpLp(-x, y, -phi, t, u, v)) consider(best, "LSL", -t, -u, -v);   // Time flip
+    if (LpSpLp(x, -y, -phi, t, u, v)) consider(best, "RSR", t, u, v);      // Reflect
+    if (LpSpLp(-x, -y, phi, t, u, v)) consider(best, "RSR", -t, -u, -v);   // Time flip + reflect
+    
+    if (LpSpRp(x, y, phi, t, u, v)) consider(best, "LSR", t, u, v);
+    if (LpSpRp(-x, y, -phi, t, u, v)) consider(best, "LSR", -t, -u, -v);
+    if (LpSpRp(x, -y, -phi, t, u, v)) consider(best, "RSL", t, u, v);
+    if (LpSpRp(-x, -y, phi, t, u, v)) consider(best, "RSL", -t, -u, -v);
+}
+
+void CCC(double x, double y, double phi, Candidate& best) {
+    double t, u, v;
+    if (LpRmL(x, y, phi, t, u, v)) consider(best, "LRL", t, u, v);
+    if (LpRmL(-x, y, -phi, t, u, v)) consider(best, "LRL", -t, -u, -v);
+    if (LpRmL(x, -y, -phi, t, u, v)) consider(best, "RLR", t, u, v);
+    if (LpRmL(-x, -y, phi, t, u, v)) consider(best, "RLR", -t, -u, -v);
+    
+    // Backwards: same families traversed from the goal
+    double xb = x * std::cos(phi) + y * std::sin(phi);
+    double yb = x * std::sin(phi) - y * std::cos(phi);
+    if (LpRmL(xb, yb, phi, t, u, v)) consider(best, "LRL", v, u, t);
+    if (LpRmL(-xb, yb, -phi, t, u, v)) consider(best, "LRL", -v, -u, -t);
+    if (LpRmL(xb, -yb, -phi, t, u, v)) consider(best, "RLR", v, u, t);
+    if (LpRmL(-xb, -yb, phi, t, u, v)) consider(best, "RLR", -v, -u, -t);
+}
+
+}  // namespace
+
+int ReedsSheppPath::numCusps() const {
+    int cusps = 0;
+    float previous = 0.0f;
+    for (const auto& segment : segments) {
+        if (segment.length == 0.0f) continue;
+        if (previous != 0.0f && (segment.length > 0.0f) != (previous > 0.0f)) {
+            cusps++;
+        }
+        previous = segment.length;
+    }
+    return cusps;
+}
+
+ReedsSheppPath ReedsShepp::shortestPath(Vec2 start, float start_theta,
+                                        Vec2 goal, float goal_theta,
+                                        float turn_radius) {
+    ReedsSheppPath path;
+    if (turn_radius <= 0.0f) return path;
+    
+    // Goal in the start frame, scaled to unit turning radius
+    double dx = goal.x - start.x;
+    double dy = goal.y - start.y;
+    double c = std::cos(start_theta);
+    double s = std::sin(start_theta);
+    double x = (c * dx + s * dy) / turn_radius;
+    double y = (-s * dx + c * dy) / turn_radius;
+    double phi = mod2pi(goal_theta - start_theta);
+    
+    Candidate best;
+    best.total = std::numeric_limits<double>::infinity();
+    CSC(x, y, phi, best);
+    CCC(x, y, phi, best);
+    
+    if (!std::isfinite(best.total)) return path;
+    
+    for (int i = 0; i < 3; i++) {
+        if (std::abs(best.lengths[i]) < kZero) continue;
+        path.segments.emplace_back(best.types[i], static_cast<float>(best.lengths[i] * turn_radius));
+    }
+    path.length = static_cast<float>(best.total * turn_radius);
+    path.valid = true;
+    return path;
+}
+
+HybridState ReedsShepp::interpolate(const ReedsSheppPath& path, Vec2 start, float start_theta,
+                                    float turn_radius, float distance) {
+    // Integrate in the normalised frame, then map back to the world
+    double x = 0.0, y = 0.0, phi = 0.0;
+    double remaining = std::max(0.0f, distance) / turn_radius;
+    int steering = 0;
+    
+    for (const auto& segment : path.segments) {
+        if (remaining <= 0.0) break;
+        double seg = segment.length / turn_radius;
+        double v = seg < 0.0 ? -std::min(-seg, remaining) : std::min(seg, remaining);
+        remaining -= std::abs(v);
+        
+        switch (segment.type) {
+            case 'L':
+                x += std::sin(phi + v) - std::sin(phi);
+                y += -std::cos(phi + v) + std::cos(phi);
+                phi += v;
+                steering = -1;
+                break;
+            case 'R':
+                x += -std::sin(phi - v) + std::sin(phi);
+                y += std::cos(phi - v) - std::cos(phi);
+                phi -= v;
+                steering = 1;
+                break;
+            default:
+                x += v * std::cos(phi);
+                y += v * std::sin(phi);
+                steering = 0;
+                break;
+        }
+    }
+    
+    double c = std::cos(start_theta);
+    double s = std::sin(start_theta);
+    Vec2 pos(start.x + static_cast<float>((c * x - s * y) * turn_radius),
+             start.y + static_cast<float>((s * x + c * y) * turn_radius));
+    
+    HybridState state(pos, static_cast<float>(mod2pi(start_theta + phi)));
+    state.steering_direction = steering;
+    return state;
+}
+
+std::vector<HybridState> ReedsShepp::sample(const ReedsSheppPath& path, Vec2 start, float start_theta,
+                                            float turn_radius, float step) {
+    std::vector<HybridState> states;
+    if (!path.valid || step <= 0.0f) return states;
+    
+    int count = std::max(1, static_cast<int>(std::ceil(path.length / step)));
+    states.reserve(count + 1);
+    for (int i = 0; i <= count; i++) {
+        float distance = std::min(path.length, i * step);
+        states.push_back(interpolate(path, start, start_theta, turn_radius, distance));
+    }
+    return states;
+}
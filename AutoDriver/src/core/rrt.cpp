@@ -1,7 +1,18 @@
 #include "core/rrt.h"
+#include "core/worker_pool.h"
+#include "core/instrumentation.h"
 #include <cmath>
 #include <algorithm>
 #include <limits>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <unordered_set>
+#include <random>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
 
 // ============================================================================
 // RRT Implementation
@@ -12,15 +23,13 @@ RRT::RRT(const Grid& grid)
     , step_size_(1.0f)
     , goal_bias_(0.1f)
     , goal_threshold_(1.0f)
-    , rng_(std::random_device{}())
-    , dist_x_(0.0f, static_cast<float>(grid.getWidth()))
-    , dist_y_(0.0f, static_cast<float>(grid.getHeight()))
-    , dist_prob_(0.0f, 1.0f) {
+    , rng_((static_cast<uint64_t>(std::random_device{}()) << 32) | std::random_device{}()) {
 }
 
 RRT::~RRT() = default;
 
 RRTResult RRT::findPath(Vec2 start, Vec2 goal, int max_iterations) {
+    AUTODRIVER_SCOPE(RRT_SEARCH);
     RRTResult result;
     nodes_.clear();
     
@@ -33,6 +42,7 @@ RRTResult RRT::findPath(Vec2 start, Vec2 goal, int max_iterations) {
     auto start_node = std::make_unique<RRTNode>(start, nullptr, 0.0f);
     RRTNode* start_ptr = start_node.get();
     nodes_.push_back(std::move(start_node));
+    capture_.emit(SearchEventType::TREE_NODE, start);
     
     RRTNode* best_node = nullptr;
     float best_distance = std::numeric_limits<float>::max();
@@ -40,7 +50,7 @@ RRTResult RRT::findPath(Vec2 start, Vec2 goal, int max_iterations) {
     for (int iter = 0; iter < max_iterations; iter++) {
         // Sample random point (with goal bias)
         Vec2 sample = sampleRandom();
-        if (dist_prob_(rng_) < goal_bias_) {
+        if (rng_.uniform() < goal_bias_) {
             sample = goal;
         }
         
@@ -68,12 +78,7 @@ RRTResult RRT::findPath(Vec2 start, Vec2 goal, int max_iterations) {
             result.path = reconstructPath(new_node);
             result.path.push_back(goal);  // Add actual goal
             result.path_cost = new_node->cost + dist_to_goal;
-            
-            // Collect all tree nodes for visualization
-            for (const auto& node : nodes_) {
-                result.tree_nodes.push_back(node->pos);
-            }
-            
+            collectTree(result);
             return result;
         }
         
@@ -91,19 +96,17 @@ RRTResult RRT::findPath(Vec2 start, Vec2 goal, int max_iterations) {
         result.path_cost = best_node->cost;
     }
     
-    // Collect tree for visualization
-    for (const auto& node : nodes_) {
-        result.tree_nodes.push_back(node->pos);
-    }
-    
+    collectTree(result);
     return result;
 }
 
 Vec2 RRT::sampleRandom() {
-    return Vec2(dist_x_(rng_), dist_y_(rng_));
+    return Vec2(rng_.uniform(0.0f, static_cast<float>(grid_.getWidth())),
+                rng_.uniform(0.0f, static_cast<float>(grid_.getHeight())));
 }
 
 RRTNode* RRT::findNearest(Vec2 sample) {
+    AUTODRIVER_SCOPE(RRT_NEAREST);
     RRTNode* nearest = nullptr;
     float min_dist = std::numeric_limits<float>::max();
     
@@ -131,12 +134,23 @@ Vec2 RRT::steer(Vec2 from, Vec2 to) {
 }
 
 bool RRT::isCollisionFree(Vec2 from, Vec2 to) {
+    AUTODRIVER_SCOPE(RRT_COLLISION);
+    
     // Check line segment from->to for collisions
     Vec2 direction = to - from;
     float dist = direction.length();
     
     if (dist < 0.01f) return true;
     
+    // Free bounding box: no need to sample (only cheap with the occupancy pyramid)
+    if (grid_.getPyramidLevels() > 0 &&
+        grid_.isRegionFree(static_cast<int>(std::round(std::min(from.x, to.x))),
+                           static_cast<int>(std::round(std::min(from.y, to.y))),
+                           static_cast<int>(std::round(std::max(from.x, to.x))),
+                           static_cast<int>(std::round(std::max(from.y, to.y))))) {
+        return true;
+    }
+    
     // Sample points along the line
     int num_checks = static_cast<int>(std::ceil(dist * 2.0f));  // 2 checks per unit
     for (int i = 0; i <= num_checks; i++) {
@@ -156,6 +170,7 @@ bool RRT::isCollisionFree(Vec2 from, Vec2 to) {
 }
 
 RRTNode* RRT::addNode(Vec2 pos, RRTNode* parent) {
+    AUTODRIVER_COUNT(RRT_NODE_ADDED);
     float cost = parent ? parent->cost + distance(parent->pos, pos) : 0.0f;
     auto node = std::make_unique<RRTNode>(pos, parent, cost);
     RRTNode* node_ptr = node.get();
@@ -165,9 +180,18 @@ RRTNode* RRT::addNode(Vec2 pos, RRTNode* parent) {
     }
     
     nodes_.push_back(std::move(node));
+    capture_.emit(SearchEventType::TREE_NODE, pos);
     return node_ptr;
 }
 
+void RRT::collectTree(RRTResult& result) const {
+    if (!capture_.results) return;
+    result.tree_nodes.reserve(result.tree_nodes.size() + nodes_.size());
+    for (const auto& node : nodes_) {
+        result.tree_nodes.push_back(node->pos);
+    }
+}
+
 std::vector<Vec2> RRT::reconstructPath(RRTNode* goal) {
     std::vector<Vec2> path;
     RRTNode* current = goal;
@@ -196,10 +220,13 @@ bool RRT::isInBounds(Vec2 pos) const {
 
 RRTStar::RRTStar(const Grid& grid)
     : RRT(grid)
-    , rewire_radius_(3.0f) {
+    , rewire_radius_(3.0f)
+    , num_threads_(std::max(1u, std::thread::hardware_concurrency()))
+    , batch_size_(64) {
 }
 
 RRTResult RRTStar::findPath(Vec2 start, Vec2 goal, int max_iterations) {
+    AUTODRIVER_SCOPE(RRT_SEARCH);
     RRTResult result;
     nodes_.clear();
     
@@ -211,6 +238,7 @@ RRTResult RRTStar::findPath(Vec2 start, Vec2 goal, int max_iterations) {
     // Initialize tree with start node
     auto start_node = std::make_unique<RRTNode>(start, nullptr, 0.0f);
     nodes_.push_back(std::move(start_node));
+    capture_.emit(SearchEventType::TREE_NODE, start);
     
     RRTNode* best_node = nullptr;
     float best_distance = std::numeric_limits<float>::max();
@@ -218,7 +246,7 @@ RRTResult RRTStar::findPath(Vec2 start, Vec2 goal, int max_iterations) {
     for (int iter = 0; iter < max_iterations; iter++) {
         // Sample random point (with goal bias)
         Vec2 sample = sampleRandom();
-        if (dist_prob_(rng_) < goal_bias_) {
+        if (rng_.uniform() < goal_bias_) {
             sample = goal;
         }
         
@@ -257,12 +285,7 @@ RRTResult RRTStar::findPath(Vec2 start, Vec2 goal, int max_iterations) {
                 result.path = reconstructPath(new_node);
                 result.path.push_back(goal);
                 result.path_cost = new_node->cost + dist_to_goal;
-                
-                // Collect tree for visualization
-                for (const auto& node : nodes_) {
-                    result.tree_nodes.push_back(node->pos);
-                }
-                
+                collectTree(result);
                 return result;
             }
         }
@@ -281,11 +304,7 @@ RRTResult RRTStar::findPath(Vec2 start, Vec2 goal, int max_iterations) {
         result.path_cost = best_node->cost;
     }
     
-    // Collect tree
-    for (const auto& node : nodes_) {
-        result.tree_nodes.push_back(node->pos);
-    }
-    
+    collectTree(result);
     return result;
 }
 
@@ -318,35 +337,448 @@ RRTNode* RRTStar::chooseBestParent(Vec2 pos, const std::vector<RRTNode*>& nearby
 }
 
 void RRTStar::rewire(RRTNode* new_node, const std::vector<RRTNode*>& nearby) {
+    AUTODRIVER_SCOPE(RRT_REWIRE);
     for (RRTNode* node : nearby) {
         if (node == new_node || node == new_node->parent) continue;
         
         float new_cost = new_node->cost + distance(new_node->pos, node->pos);
         
         if (new_cost < node->cost && isCollisionFree(new_node->pos, node->pos)) {
-            // Remove node from old parent's children
-            if (node->parent) {
-                auto& children = node->parent->children;
-                children.erase(std::remove(children.begin(), children.end(), node), 
-                              children.end());
+            reparent(node, new_node, new_cost);
+        }
+    }
+}
+
+void RRTStar::reparent(RRTNode* node, RRTNode* new_parent, float new_cost) {
+    // Remove node from old parent's children
+    if (node->parent) {
+        auto& children = node->parent->children;
+        children.erase(std::remove(children.begin(), children.end(), node), 
+                      children.end());
+    }
+    
+    // Update parent and cost
+    node->parent = new_parent;
+    node->cost = new_cost;
+    new_parent->children.push_back(node);
+    
+    // Recursively update costs of descendants
+    std::vector<RRTNode*> to_update = {node};
+    while (!to_update.empty()) {
+        RRTNode* current = to_update.back();
+        to_update.pop_back();
+        
+        for (RRTNode* child : current->children) {
+            child->cost = current->cost + distance(current->pos, child->pos);
+            to_update.push_back(child);
+        }
+    }
+}
+
+// ============================================================================
+// Anytime RRT* (informed sampling + branch-and-bound pruning)
+// ============================================================================
+
+namespace {
+
+// Node created by a worker during a parallel round, with the collision results
+// needed to rewire its neighbourhood afterwards
+struct AnytimeExtension {
+    std::vector<RRTNode*> nearby;
+    std::vector<uint8_t> edge_free;  // Collision-free flag per nearby node
+    bool reaches_goal;
+};
+
+}  // namespace
+
+Vec2 RRTStar::sampleInformed(Vec2 start, Vec2 goal, float best_cost, float u, float v,
+                             RandomStream& rng) const {
+    // Uniform sample from the ellipse with foci start/goal and major axis best_cost.
+    // (u, v) come from the caller's pre-filled buffer; retries draw from rng.
+    float c_min = distance(start, goal);
+    float a = best_cost * 0.5f;
+    float b = std::sqrt(std::max(0.0f, best_cost * best_cost - c_min * c_min)) * 0.5f;
+    
+    Vec2 center = (start + goal) * 0.5f;
+    float angle = std::atan2(goal.y - start.y, goal.x - start.x);
+    float cos_a = std::cos(angle);
+    float sin_a = std::sin(angle);
+    
+    for (int attempt = 0; attempt < 16; attempt++) {
+        if (attempt > 0) {
+            u = rng.uniform();
+            v = rng.uniform();
+        }
+        float r = std::sqrt(u);
+        float phi = 2.0f * static_cast<float>(M_PI) * v;
+        float lx = a * r * std::cos(phi);
+        float ly = b * r * std::sin(phi);
+        
+        Vec2 sample(center.x + lx * cos_a - ly * sin_a,
+                    center.y + lx * sin_a + ly * cos_a);
+        if (isInBounds(sample)) {
+            return sample;
+        }
+    }
+    
+    // Ellipse mostly outside the map - fall back to uniform sampling
+    return Vec2(rng.uniform() * grid_.getWidth(), rng.uniform() * grid_.getHeight());
+}
+
+void RRTStar::pruneTree(Vec2 goal, float best_cost, RRTNode* best_goal_node) {
+    // Keep only subtrees whose cost-to-come plus straight-line cost-to-go can
+    // still beat the incumbent. The bound is monotone along tree edges, so a
+    // pruned node takes its whole subtree with it. The incumbent path itself is
+    // always kept, whatever rounding did to its accumulated costs.
+    const float bound = best_cost * (1.0f + 1e-5f);
+    std::unordered_set<RRTNode*> incumbent;
+    for (RRTNode* node = best_goal_node; node != nullptr; node = node->parent) {
+        incumbent.insert(node);
+    }
+    
+    std::unordered_set<RRTNode*> kept;
+    std::vector<RRTNode*> stack = {nodes_.front().get()};
+    
+    while (!stack.empty()) {
+        RRTNode* current = stack.back();
+        stack.pop_back();
+        kept.insert(current);
+        
+        auto& children = current->children;
+        children.erase(std::remove_if(children.begin(), children.end(), [&](RRTNode* child) {
+            return incumbent.count(child) == 0 && child->cost + distance(child->pos, goal) > bound;
+        }), children.end());
+        
+        for (RRTNode* child : children) {
+            stack.push_back(child);
+        }
+    }
+    
+    nodes_.erase(std::remove_if(nodes_.begin(), nodes_.end(), [&](const std::unique_ptr<RRTNode>& node) {
+        return kept.count(node.get()) == 0;
+    }), nodes_.end());
+}
+
+RRTResult RRTStar::findPathAnytime(Vec2 start, Vec2 goal, double time_budget_ms,
+                                   int max_iterations) {
+    return runAnytime(start, goal, time_budget_ms, max_iterations, false);
+}
+
+RRTResult RRTStar::findPathDeterministic(Vec2 start, Vec2 goal, int iterations) {
+    return runAnytime(start, goal, 0.0, iterations, true);
+}
+
+RRTResult RRTStar::runAnytime(Vec2 start, Vec2 goal, double time_budget_ms,
+                              int max_iterations, bool deterministic) {
+    AUTODRIVER_SCOPE(RRT_SEARCH);
+    RRTResult result;
+    nodes_.clear();
+    
+    if (!isInBounds(start) || !isInBounds(goal)) {
+        return result;
+    }
+    
+    auto deadline = std::chrono::steady_clock::now() +
+                    std::chrono::duration<double, std::milli>(time_budget_ms);
+    
+    nodes_.push_back(std::make_unique<RRTNode>(start, nullptr, 0.0f));
+    capture_.emit(SearchEventType::TREE_NODE, start);
+    
+    // One counter-based stream per worker, all derived from a single draw of
+    // the planner's stream so repeated calls still differ
+    RandomStream call_rng(rng_());
+    std::vector<RandomStream> worker_rngs;
+    for (int t = 0; t < num_threads_; t++) {
+        worker_rngs.push_back(call_rng.split(static_cast<uint64_t>(t)));
+    }
+    
+    // Nodes added during a round are published into fixed slots. A worker claims
+    // a slot with fetch_add and releases the pointer once the node is fully
+    // written, so appends never take a lock and readers skip unpublished slots.
+    // In deterministic mode each worker owns a fixed slot range instead.
+    const size_t round_capacity = static_cast<size_t>(num_threads_) * batch_size_;
+    std::vector<std::atomic<RRTNode*>> slots(round_capacity);
+    std::vector<AnytimeExtension> extensions(round_capacity);
+    std::atomic<size_t> slot_count(0);
+    
+    std::vector<RRTNode*> goal_nodes;
+    RRTNode* best_goal_node = nullptr;
+    float best_cost = std::numeric_limits<float>::max();
+    int iterations = 0;
+    
+    // Workers are started once per call and woken for each round
+    WorkerPool pool(num_threads_);
+    
+    while (iterations < max_iterations && (deterministic || std::chrono::steady_clock::now() < deadline)) {
+        int round_samples = static_cast<int>(std::min<long long>(
+            static_cast<long long>(round_capacity), static_cast<long long>(max_iterations) - iterations));
+        bool have_solution = best_goal_node != nullptr;
+        
+        for (auto& slot : slots) {
+            slot.store(nullptr, std::memory_order_relaxed);
+        }
+        slot_count.store(0, std::memory_order_relaxed);
+        
+        // Visit every node a worker may connect to: the tree as of the start of
+        // the round plus nodes published since. In deterministic mode a worker
+        // only sees its own publications, which do not depend on scheduling.
+        auto forEachNode = [&](size_t own_begin, size_t own_end, auto&& visit) {
+            for (const auto& node : nodes_) {
+                visit(node.get());
             }
+            size_t begin = deterministic ? own_begin : 0;
+            size_t end = deterministic ? own_end
+                                       : std::min(slot_count.load(std::memory_order_acquire), round_capacity);
+            for (size_t i = begin; i < end; i++) {
+                RRTNode* node = slots[i].load(std::memory_order_acquire);
+                if (node) visit(node);
+            }
+        };
+        
+        // Parallel phase: sample, connect to the cheapest collision-free
+        // neighbour and publish. Costs and parents are not modified here.
+        auto worker = [&](int thread_id, int samples, size_t slot_base) {
+            RandomStream& rng = worker_rngs[thread_id];
             
-            // Update parent and cost
-            node->parent = new_node;
-            node->cost = new_cost;
-            new_node->children.push_back(node);
+            // Draw the whole batch of uniforms up front
+            std::vector<float> u_bias(samples), u_x(samples), u_y(samples);
+            rng.fillUniform(u_bias.data(), samples);
+            rng.fillUniform(u_x.data(), samples);
+            rng.fillUniform(u_y.data(), samples);
             
-            // Recursively update costs of descendants
-            std::vector<RRTNode*> to_update = {node};
-            while (!to_update.empty()) {
-                RRTNode* current = to_update.back();
-                to_update.pop_back();
+            for (int i = 0; i < samples; i++) {
+                Vec2 sample;
+                if (have_solution) {
+                    sample = sampleInformed(start, goal, best_cost, u_x[i], u_y[i], rng);
+                } else if (u_bias[i] < goal_bias_) {
+                    sample = goal;
+                } else {
+                    sample = Vec2(u_x[i] * grid_.getWidth(), u_y[i] * grid_.getHeight());
+                }
                 
-                for (RRTNode* child : current->children) {
-                    child->cost = current->cost + distance(current->pos, child->pos);
-                    to_update.push_back(child);
+                RRTNode* nearest = nullptr;
+                float nearest_dist = std::numeric_limits<float>::max();
+                forEachNode(slot_base, slot_base + i, [&](RRTNode* node) {
+                    float d = distance(node->pos, sample);
+                    if (d < nearest_dist) {
+                        nearest_dist = d;
+                        nearest = node;
+                    }
+                });
+                
+                Vec2 new_pos = steer(nearest->pos, sample);
+                
+                // Branch-and-bound on the sample itself
+                if (have_solution && distance(start, new_pos) + distance(new_pos, goal) > best_cost) {
+                    continue;
+                }
+                if (!isCollisionFree(nearest->pos, new_pos)) {
+                    continue;
                 }
+                
+                AnytimeExtension extension;
+                forEachNode(slot_base, slot_base + i, [&](RRTNode* node) {
+                    if (distance(node->pos, new_pos) < rewire_radius_) {
+                        extension.nearby.push_back(node);
+                    }
+                });
+                
+                RRTNode* parent = nearest;
+                float parent_cost = nearest->cost + distance(nearest->pos, new_pos);
+                extension.edge_free.reserve(extension.nearby.size());
+                for (RRTNode* node : extension.nearby) {
+                    bool free = node == nearest || isCollisionFree(node->pos, new_pos);
+                    extension.edge_free.push_back(free ? 1 : 0);
+                    float cost = node->cost + distance(node->pos, new_pos);
+                    if (free && cost < parent_cost) {
+                        parent_cost = cost;
+                        parent = node;
+                    }
+                }
+                extension.reaches_goal = distance(new_pos, goal) < goal_threshold_ &&
+                                         isCollisionFree(new_pos, goal);
+                
+                size_t slot = deterministic ? slot_base + i
+                                            : slot_count.fetch_add(1, std::memory_order_relaxed);
+                extensions[slot] = std::move(extension);
+                slots[slot].store(new RRTNode(new_pos, parent, parent_cost), std::memory_order_release);
             }
+        };
+        
+        int per_thread = (round_samples + num_threads_ - 1) / num_threads_;
+        int workers = (round_samples + per_thread - 1) / per_thread;
+        pool.run(workers, [&](int t) {
+            worker(t, std::min(per_thread, round_samples - t * per_thread), static_cast<size_t>(t) * per_thread);
+        });
+        iterations += round_samples;
+        
+        // Serial phase: take ownership and link children first so that cost
+        // propagation during rewiring reaches every node of this round
+        std::vector<size_t> filled;
+        for (size_t i = 0; i < round_capacity; i++) {
+            RRTNode* node = slots[i].load(std::memory_order_acquire);
+            if (!node) continue;
+            filled.push_back(i);
+            nodes_.emplace_back(node);
+            node->parent->children.push_back(node);
+            capture_.emit(SearchEventType::TREE_NODE, node->pos);
         }
+        
+        for (size_t i : filled) {
+            RRTNode* new_node = slots[i].load(std::memory_order_relaxed);
+            const AnytimeExtension& extension = extensions[i];
+            
+            for (size_t k = 0; k < extension.nearby.size(); k++) {
+                RRTNode* node = extension.nearby[k];
+                if (!extension.edge_free[k] || node == new_node->parent) continue;
+                float new_cost = new_node->cost + distance(new_node->pos, node->pos);
+                if (new_cost < node->cost) {
+                    reparent(node, new_node, new_cost);
+                }
+            }
+            
+            if (extension.reaches_goal) {
+                goal_nodes.push_back(new_node);
+            }
+        }
+        
+        // Rewiring may have lowered the cost of any goal-connected node
+        RRTNode* round_best = best_goal_node;
+        float round_cost = best_cost;
+        for (RRTNode* node : goal_nodes) {
+            float cost = node->cost + distance(node->pos, goal);
+            if (cost < round_cost) {
+                round_cost = cost;
+                round_best = node;
+            }
+        }
+        
+        if (round_best && round_cost < best_cost) {
+            best_cost = round_cost;
+            best_goal_node = round_best;
+            
+            pruneTree(goal, best_cost, best_goal_node);
+            std::unordered_set<RRTNode*> alive;
+            for (const auto& node : nodes_) {
+                alive.insert(node.get());
+            }
+            goal_nodes.erase(std::remove_if(goal_nodes.begin(), goal_nodes.end(), [&](RRTNode* node) {
+                return alive.count(node) == 0;
+            }), goal_nodes.end());
+        }
+    }
+    
+    result.iterations = iterations;
+    if (best_goal_node) {
+        result.success = true;
+        result.path = reconstructPath(best_goal_node);
+        result.path.push_back(goal);
+        result.path_cost = best_cost;
     }
+    
+    collectTree(result);
+    return result;
+}
+
+// ============================================================================
+// RRT-Connect Implementation
+// ============================================================================
+
+RRTConnect::RRTConnect(const Grid& grid)
+    : RRT(grid) {
+}
+
+RRTNode* RRTConnect::extend(Vec2 target) {
+    RRTNode* nearest = findNearest(target);
+    if (!nearest) return nullptr;
+    
+    Vec2 new_pos = steer(nearest->pos, target);
+    if (!isCollisionFree(nearest->pos, new_pos)) {
+        return nullptr;
+    }
+    
+    return addNode(new_pos, nearest);
+}
+
+RRTNode* RRTConnect::connect(Vec2 target) {
+    RRTNode* last = nullptr;
+    
+    while (true) {
+        RRTNode* next = extend(target);
+        if (!next) return last;
+        
+        last = next;
+        if (distance(last->pos, target) < 1e-4f) {
+            return last;
+        }
+    }
+}
+
+RRTResult RRTConnect::findPath(Vec2 start, Vec2 goal, int max_iterations) {
+    AUTODRIVER_SCOPE(RRT_SEARCH);
+    RRTResult result;
+    nodes_.clear();
+    other_tree_.clear();
+    
+    // Validate start and goal
+    if (!isInBounds(start) || !isInBounds(goal)) {
+        return result;
+    }
+    
+    nodes_.push_back(std::make_unique<RRTNode>(start, nullptr, 0.0f));
+    other_tree_.push_back(std::make_unique<RRTNode>(goal, nullptr, 0.0f));
+    capture_.emit(SearchEventType::TREE_NODE, start);
+    capture_.emit(SearchEventType::TREE_NODE, goal);
+    
+    bool active_is_start = true;  // Which tree nodes_ currently holds
+    
+    for (int iter = 0; iter < max_iterations; iter++) {
+        Vec2 sample = sampleRandom();
+        RRTNode* new_node = extend(sample);
+        
+        // Swap: the other tree now tries to reach the new node (and will
+        // extend toward the next sample)
+        nodes_.swap(other_tree_);
+        active_is_start = !active_is_start;
+        
+        if (!new_node) continue;
+        
+        RRTNode* reached = connect(new_node->pos);
+        if (reached && distance(reached->pos, new_node->pos) < 1e-4f) {
+            RRTNode* start_side = active_is_start ? reached : new_node;
+            RRTNode* goal_side = active_is_start ? new_node : reached;
+            
+            // Start tree root -> meeting point, then meeting point -> goal root
+            result.path = reconstructPath(start_side);
+            for (RRTNode* node = goal_side->parent; node != nullptr; node = node->parent) {
+                result.path.push_back(node->pos);
+            }
+            
+            result.success = true;
+            result.iterations = iter + 1;
+            result.path_cost = start_side->cost + goal_side->cost;
+            break;
+        }
+    }
+    
+    if (!active_is_start) {
+        nodes_.swap(other_tree_);
+    }
+    
+    if (!result.success) {
+        // Max iterations reached - return path to start-tree node closest to goal
+        result.iterations = max_iterations;
+        RRTNode* best_node = findNearest(goal);
+        if (best_node) {
+            result.path = reconstructPath(best_node);
+            result.path_cost = best_node->cost;
+        }
+    }
+    
+    // Both trees are shown
+    collectTree(result);
+    nodes_.swap(other_tree_);
+    collectTree(result);
+    nodes_.swap(other_tree_);
+    return result;
 }
@@ -0,0 +1,27 @@
+#include "core/search_capture.h"
+
+// ============================================================================
+// RingBufferSink Implementation
+// ============================================================================
+
+RingBufferSink::RingBufferSink(size_t capacity)
+    : buffer_(capacity), head_(0), total_(0) {}
+
+void RingBufferSink::clear() {
+    head_ = 0;
+    total_ = 0;
+}
+
+const SearchEvent& RingBufferSink::at(size_t i) const {
+    // Before the buffer wraps the oldest event is in slot 0, afterwards at head_
+    size_t oldest = total_ < buffer_.size() ? 0 : head_;
+    size_t index = oldest + i;
+    return buffer_[index >= buffer_.size() ? index - buffer_.size() : index];
+}
+
+std::vector<SearchEvent> RingBufferSink::events() const {
+    std::vector<SearchEvent> out;
+    out.reserve(size());
+    for (size_t i = 0; i < size(); i++) out.push_back(at(i));
+    return out;
+}
@@ -0,0 +1,323 @@
+#include "core/simulation.h"
+#include "core/random.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <thread>
+
+namespace {
+
+const char kTraceMagic[8] = {'A', 'D', 'T', 'R', 'A', 'C', 'E', '\0'};
+const uint32_t kTraceVersion = 1;
+const size_t kTraceHeaderBytes = 32;
+
+void putU32(unsigned char* out, uint32_t v) {
+    for (int i = 0; i < 4; i++) out[i] = static_cast<unsigned char>(v >> (8 * i));
+}
+
+uint32_t getU32(const unsigned char* in) {
+    uint32_t v = 0;
+    for (int i = 0; i < 4; i++) v |= static_cast<uint32_t>(in[i]) << (8 * i);
+    return v;
+}
+
+uint32_t floatBits(float f) {
+    uint32_t bits;
+    std::memcpy(&bits, &f, sizeof(bits));
+    return bits;
+}
+
+float bitsFloat(uint32_t bits) {
+    float f;
+    std::memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+int16_t quantize(float v, float scale) {
+    float q = std::round(v * scale);
+    return static_cast<int16_t>(std::max(-32768.0f, std::min(32767.0f, q)));
+}
+
+bool allFinished(const MultiAgentPlanner& planner) {
+    for (size_t i = 0; i < planner.size(); i++) {
+        if (!planner.isFinished(i)) return false;
+    }
+    return true;
+}
+
+double elapsedMs(std::chrono::steady_clock::time_point since) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - since).count();
+}
+
+}  // namespace
+
+// ============================================================================
+// SimulationTrace Implementation
+// ============================================================================
+
+Vec2 SimulationTrace::position(size_t frame, size_t body) const {
+    size_t bodies = static_cast<size_t>(num_agents) + num_obstacles;
+    size_t i = (frame * bodies + body) * 2;
+    return Vec2(coords[i] / scale, coords[i + 1] / scale);
+}
+
+bool SimulationTrace::save(const std::string& path) const {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) return false;
+    
+    unsigned char header[kTraceHeaderBytes] = {};
+    std::memcpy(header, kTraceMagic, sizeof(kTraceMagic));
+    putU32(header + 8, kTraceVersion);
+    putU32(header + 12, num_agents);
+    putU32(header + 16, num_obstacles);
+    putU32(header + 20, static_cast<uint32_t>(steps.size()));
+    putU32(header + 24, floatBits(dt));
+    putU32(header + 28, floatBits(scale));
+    file.write(reinterpret_cast<const char*>(header), kTraceHeaderBytes);
+    
+    // Little-endian regardless of host
+    std::vector<unsigned char> body(steps.size() * 4 + coords.size() * 2);
+    unsigned char* out = body.data();
+    for (uint32_t step : steps) {
+        putU32(out, step);
+        out += 4;
+    }
+    for (int16_t c : coords) {
+        uint16_t u = static_cast<uint16_t>(c);
+        out[0] = static_cast<unsigned char>(u);
+        out[1] = static_cast<unsigned char>(u >> 8);
+        out += 2;
+    }
+    file.write(reinterpret_cast<const char*>(body.data()), body.size());
+    return static_cast<bool>(file);
+}
+
+bool SimulationTrace::load(const std::string& path, SimulationTrace& out) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return false;
+    
+    unsigned char header[kTraceHeaderBytes];
+    if (!file.read(reinterpret_cast<char*>(header), kTraceHeaderBytes)) return false;
+    if (std::memcmp(header, kTraceMagic, sizeof(kTraceMagic)) != 0 || getU32(header + 8) != kTraceVersion) {
+        return false;
+    }
+    
+    SimulationTrace trace;
+    trace.num_agents = getU32(header + 12);
+    trace.num_obstacles = getU32(header + 16);
+    uint32_t frames = getU32(header + 20);
+    trace.dt = bitsFloat(getU32(header + 24));
+    trace.scale = bitsFloat(getU32(header + 28));
+    if (!(trace.scale > 0.0f)) return false;
+    
+    // Validate the counts against what is actually left in the file before
+    // sizing anything from them
+    const std::streamoff header_end = file.tellg();
+    file.seekg(0, std::ios::end);
+    const std::streamoff file_end = file.tellg();
+    file.seekg(header_end);
+    if (header_end < 0 || file_end < header_end) return false;
+    const uint64_t remaining = static_cast<uint64_t>(file_end - header_end);
+    const uint64_t bodies = static_cast<uint64_t>(trace.num_agents) + trace.num_obstacles;
+    const uint64_t frame_bytes = 4 + bodies * 4;   // Step number plus int16 x, y per body
+    if (frames > remaining / frame_bytes) return false;
+    
+    size_t values = static_cast<size_t>(frames) * static_cast<size_t>(bodies) * 2;
+    std::vector<unsigned char> body(static_cast<size_t>(frames) * 4 + values * 2);
+    if (!file.read(reinterpret_cast<char*>(body.data()), body.size())) return false;
+    
+    const unsigned char* in = body.data();
+    trace.steps.resize(frames);
+    for (uint32_t f = 0; f < frames; f++, in += 4) trace.steps[f] = getU32(in);
+    trace.coords.resize(values);
+    for (size_t i = 0; i < values; i++, in += 2) {
+        trace.coords[i] = static_cast<int16_t>(static_cast<uint16_t>(in[0] | (in[1] << 8)));
+    }
+    
+    out = std::move(trace);
+    return true;
+}
+
+// ============================================================================
+// SimulationEngine Implementation
+// ============================================================================
+
+SimulationEngine::SimulationEngine(const Grid& grid, const SimulationConfig& config)
+    : grid_(grid), config_(config) {
+}
+
+EpisodeResult SimulationEngine::runEpisode(const EpisodeSpec& spec) const {
+    auto started = std::chrono::steady_clock::now();
+    EpisodeResult result;
+    result.seed = spec.seed;
+    
+    MultiAgentPlanner planner(grid_);
+    for (const Agent& agent : spec.agents) planner.addAgent(agent);
+    planner.planPaths();
+    
+    DynamicObstacleManager obstacles;
+    obstacles.reserve(spec.obstacles.size());
+    for (const DynamicObstacle& obstacle : spec.obstacles) obstacles.addObstacle(obstacle);
+    
+    const size_t n = planner.size();
+    for (size_t i = 0; i < n; i++) {
+        if (planner.getPath(i).empty()) result.agents_unplanned++;
+    }
+    
+    // Contact flags so that a touching pair counts once, not once per step
+    std::vector<uint8_t> agent_contact(n * n, 0);
+    std::vector<uint8_t> obstacle_contact(n, 0);
+    const std::vector<float>& ax = planner.positionsX();   // update() swaps contents, so these stay current
+    const std::vector<float>& ay = planner.positionsY();
+    const std::vector<float>& arad = planner.radii();
+    const std::vector<float>& ox = obstacles.positionsX();
+    const std::vector<float>& oy = obstacles.positionsY();
+    const std::vector<float>& orad = obstacles.radii();
+    
+    if (config_.record_trace) {
+        SimulationTrace& trace = result.trace;
+        trace.num_agents = static_cast<uint32_t>(n);
+        trace.num_obstacles = static_cast<uint32_t>(obstacles.size());
+        trace.dt = config_.dt * std::max(1, config_.trace_stride);
+        trace.scale = std::max(1.0f, std::floor(32000.0f / std::max(1, std::max(grid_.getWidth(), grid_.getHeight()))));
+        recordFrame(trace, 0, planner, obstacles);
+    }
+    
+    int step = 0;
+    while (step < config_.max_steps &&
+           !allFinished(planner)) {
+        planner.update(config_.dt);
+        obstacles.updateAll(config_.dt);
+        step++;
+        
+        for (size_t i = 0; i < n; i++) {
+            for (size_t j = i + 1; j < n; j++) {
+                float dx = ax[i] - ax[j];
+                float dy = ay[i] - ay[j];
+                float reach = arad[i] + arad[j];
+                bool touching = dx * dx + dy * dy < reach * reach;
+                uint8_t& flag = agent_contact[i * n + j];
+                if (touching && !flag) result.agent_collisions++;
+                flag = touching;
+            }
+            
+            bool hit = false;
+            for (size_t k = 0; k < ox.size() && !hit; k++) {
+                float dx = ax[i] - ox[k];
+                float dy = ay[i] - oy[k];
+                float reach = arad[i] + orad[k];
+                hit = dx * dx + dy * dy < reach * reach;
+            }
+            if (hit && !obstacle_contact[i]) result.obstacle_collisions++;
+            obstacle_contact[i] = hit;
+        }
+        
+        if (config_.record_trace && step % std::max(1, config_.trace_stride) == 0) {
+            recordFrame(result.trace, step, planner, obstacles);
+        }
+    }
+    
+    for (size_t i = 0; i < n; i++) {
+        Vec2 position(ax[i], ay[i]);
+        if (position.distanceTo(Vec2(planner.goalsX()[i], planner.goalsY()[i])) <= config_.goal_tolerance) {
+            result.agents_arrived++;
+        }
+    }
+    result.steps = step;
+    result.sim_time = step * config_.dt;
+    result.success = result.agents_arrived == static_cast<int>(n) &&
+                     result.agent_collisions == 0 && result.obstacle_collisions == 0;
+    result.wall_ms = elapsedMs(started);
+    return result;
+}
+
+void SimulationEngine::recordFrame(SimulationTrace& trace, int step, const MultiAgentPlanner& agents,
+                                   const DynamicObstacleManager& obstacles) const {
+    trace.steps.push_back(static_cast<uint32_t>(step));
+    for (size_t i = 0; i < agents.size(); i++) {
+        trace.coords.push_back(quantize(agents.positionsX()[i], trace.scale));
+        trace.coords.push_back(quantize(agents.positionsY()[i], trace.scale));
+    }
+    for (size_t k = 0; k < obstacles.size(); k++) {
+        trace.coords.push_back(quantize(obstacles.positionsX()[k], trace.scale));
+        trace.coords.push_back(quantize(obstacles.positionsY()[k], trace.scale));
+    }
+}
+
+std::vector<EpisodeResult> SimulationEngine::runBatch(const std::vector<EpisodeSpec>& specs, int num_threads,
+                                                      SimulationSummary* summary) const {
+    auto started = std::chrono::steady_clock::now();
+    std::vector<EpisodeResult> results(specs.size());
+    if (num_threads <= 0) num_threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    
+    // Episodes are independent; each worker pulls the next unclaimed one
+    std::atomic<size_t> next(0);
+    auto worker = [&]() {
+        for (size_t i = next.fetch_add(1); i < specs.size(); i = next.fetch_add(1)) {
+            results[i] = runEpisode(specs[i]);
+        }
+    };
+    
+    int workers = static_cast<int>(std::min<size_t>(num_threads, specs.size()));
+    std::vector<std::thread> threads;
+    for (int t = 1; t < workers; t++) threads.emplace_back(worker);
+    worker();
+    for (auto& thread : threads) thread.join();
+    
+    if (summary) *summary = summarize(results, elapsedMs(started));
+    return results;
+}
+
+EpisodeSpec SimulationEngine::randomEpisode(const Grid& grid, uint64_t seed, int num_agents, int num_obstacles) {
+    EpisodeSpec spec;
+    spec.seed = seed;
+    RandomStream rng(seed);
+    const int width = grid.getWidth();
+    const int height = grid.getHeight();
+    if (width <= 0 || height <= 0) return spec;
+    
+    auto randomFreeCell = [&](Vec2& cell) {
+        for (int tries = 0; tries < 64; tries++) {
+            int x = static_cast<int>(rng() % width);
+            int y = static_cast<int>(rng() % height);
+            if (!grid.isObstacle(x, y)) {
+                cell = Vec2(static_cast<float>(x), static_cast<float>(y));
+                return true;
+            }
+        }
+        return false;
+    };
+    
+    for (int i = 0; i < num_agents; i++) {
+        Vec2 start, goal;
+        if (!randomFreeCell(start) || !randomFreeCell(goal)) continue;
+        spec.agents.emplace_back(static_cast<int>(spec.agents.size()), start, goal, 0.4f);
+    }
+    for (int i = 0; i < num_obstacles; i++) {
+        Vec2 pos(rng.uniform(0.0f, static_cast<float>(width)), rng.uniform(0.0f, static_cast<float>(height)));
+        Vec2 vel(rng.uniform(-1.0f, 1.0f), rng.uniform(-1.0f, 1.0f));
+        spec.obstacles.emplace_back(pos, vel, 0.5f);
+    }
+    return spec;
+}
+
+SimulationSummary SimulationEngine::summarize(const std::vector<EpisodeResult>& results, double wall_ms) {
+    SimulationSummary summary;
+    summary.episodes = static_cast<int>(results.size());
+    summary.wall_ms = wall_ms;
+    for (const EpisodeResult& r : results) {
+        if (r.success) summary.successes++;
+        summary.agent_collisions += r.agent_collisions;
+        summary.obstacle_collisions += r.obstacle_collisions;
+        summary.total_steps += static_cast<uint64_t>(r.steps);
+        summary.sim_seconds += r.sim_time;
+    }
+    if (wall_ms > 0.0) {
+        summary.episodes_per_minute = summary.episodes * 60000.0 / wall_ms;
+        summary.realtime_factor = summary.sim_seconds * 1000.0 / wall_ms;
+    }
+    return summary;
+}
@@ -0,0 +1,96 @@
+#include "core/spatial_index.h"
+
+namespace {
+
+// Sort-Tile-Recursive ordering: sort by x, cut into vertical slices holding a
+// whole number of groups, then sort each slice by y
+template<typename T, typename BoxFn>
+void strOrder(std::vector<T>& items, int capacity, BoxFn box_of) {
+    std::sort(items.begin(), items.end(), [&](const T& a, const T& b) {
+        return box_of(a).center().x < box_of(b).center().x;
+    });
+    
+    size_t groups = (items.size() + capacity - 1) / capacity;
+    size_t slices = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(groups))));
+    size_t slice_size = std::max<size_t>(1, (groups + slices - 1) / slices) * capacity;
+    
+    for (size_t begin = 0; begin < items.size(); begin += slice_size) {
+        size_t end = std::min(items.size(), begin + slice_size);
+        std::sort(items.begin() + begin, items.begin() + end, [&](const T& a, const T& b) {
+            return box_of(a).center().y < box_of(b).center().y;
+        });
+    }
+}
+
+}  // namespace
+
+RTree::RTree(int node_capacity)
+    : node_capacity_(std::max(2, node_capacity)), root_(-1) {}
+
+void RTree::build(std::vector<Entry> entries) {
+    entries_ = std::move(entries);
+    nodes_.clear();
+    root_ = -1;
+    if (entries_.empty()) return;
+    
+    strOrder(entries_, node_capacity_, [](const Entry& e) -> const BoundingBox& { return e.box; });
+    
+    // Leaf level
+    std::vector<TreeNode> level;
+    for (size_t i = 0; i < entries_.size(); i += node_capacity_) {
+        TreeNode leaf;
+        leaf.first = static_cast<int>(i);
+        leaf.count = static_cast<int>(std::min<size_t>(node_capacity_, entries_.size() - i));
+        leaf.leaf = true;
+        for (int c = leaf.first; c < leaf.first + leaf.count; c++) {
+            leaf.box.expand(entries_[c].box);
+        }
+        level.push_back(leaf);
+    }
+    
+    // Pack each level into parents until a single root remains; children of a
+    // parent are stored contiguously in nodes_
+    while (level.size() > 1) {
+        strOrder(level, node_capacity_, [](const TreeNode& n) -> const BoundingBox& { return n.box; });
+        
+        int base = static_cast<int>(nodes_.size());
+        nodes_.insert(nodes_.end(), level.begin(), level.end());
+        
+        std::vector<TreeNode> parents;
+        for (size_t i = 0; i < level.size(); i += node_capacity_) {
+            TreeNode parent;
+            parent.first = base + static_cast<int>(i);
+            parent.count = static_cast<int>(std::min<size_t>(node_capacity_, level.size() - i));
+            parent.leaf = false;
+            for (int c = 0; c < parent.count; c++) {
+                parent.box.expand(level[i + c].box);
+            }
+            parents.push_back(parent);
+        }
+        level = std::move(parents);
+    }
+    
+    root_ = static_cast<int>(nodes_.size());
+    nodes_.push_back(level.front());
+}
+
+void RTree::query(const BoundingBox& box, std::vector<int>& out) const {
+    if (root_ < 0) return;
+    
+    std::vector<int> stack = {root_};
+    while (!stack.empty()) {
+        const TreeNode& node = nodes_[stack.back()];
+        stack.pop_back();
+        if (!node.box.intersects(box)) continue;
+        
+        for (int c = node.first; c < node.first + node.count; c++) {
+            if (node.leaf) {
+                if (entries_[c].box.intersects(box)) {
+                    out.push_back(entries_[c].id);
+                }
+            } else {
+                stack.push_back(c);
+            }
+        }
+    }
+}
@@ -0,0 +1,64 @@
+#include "core/worker_pool.h"
+#include <algorithm>
+
+// ============================================================================
+// WorkerPool Implementation
+// ============================================================================
+
+WorkerPool::WorkerPool(int num_threads)
+    : task_(nullptr), round_(0), active_(0), pending_(0), stop_(false) {
+    
+    if (num_threads <= 0) num_threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    for (int worker = 1; worker < num_threads; worker++) {
+        helpers_.emplace_back(&WorkerPool::helperLoop, this, worker);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    start_cv_.notify_all();
+    for (auto& helper : helpers_) helper.join();
+}
+
+void WorkerPool::run(int workers, const std::function<void(int)>& task) {
+    workers = std::max(1, std::min(workers, getNumThreads()));
+    if (workers == 1) {
+        task(0);
+        return;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        task_ = &task;
+        active_ = workers;
+        pending_ = workers - 1;
+        round_++;
+    }
+    start_cv_.notify_all();
+    
+    task(0);
+    
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_cv_.wait(lock, [this]() { return pending_ == 0; });
+    task_ = nullptr;
+}
+
+void WorkerPool::helperLoop(int worker) {
+    uint64_t seen = 0;
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        start_cv_.wait(lock, [&]() { return stop_ || round_ != seen; });
+        if (stop_) return;
+        seen = round_;
+        if (worker >= active_) continue;   // Not needed this round
+        
+        const std::function<void(int)>* task = task_;
+        lock.unlock();
+        (*task)(worker);
+        lock.lock();
+        if (--pending_ == 0) done_cv_.notify_one();
+    }
+}
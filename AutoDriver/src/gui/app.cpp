@@ -1,5 +1,7 @@
 #include "gui/app.h"
 #include "core/path_smoothing.h"
+#include "core/simulation.h"
+#include <algorithm>
 #include <iostream>
 #include <random>
 
@@ -7,6 +9,8 @@ App::App(int window_width, int window_height, int grid_width, int grid_height)
     : is_dragging_(false)
     , is_erasing_(false)
     , current_planner_(PlannerType::ASTAR)
+    , search_events_(1 << 18)
+    , events_shown_(0)
     , show_smoothed_(false)
     , paused_(false)
     , simulation_time_(0.0f) {
@@ -19,6 +23,11 @@ App::App(int window_width, int window_height, int grid_width, int grid_height)
     astar_planner_ = std::make_unique<AStar>(*grid_);
     rrt_planner_ = std::make_unique<RRT>(*grid_);
     rrt_star_planner_ = std::make_unique<RRTStar>(*grid_);
+    
+    // Searches stream into the ring buffer so they can be animated
+    astar_planner_->setCapture(SearchCapture::intoSink(&search_events_));
+    rrt_planner_->setCapture(SearchCapture::intoSink(&search_events_));
+    rrt_star_planner_->setCapture(SearchCapture::intoSink(&search_events_));
     dynamic_obstacles_ = std::make_unique<DynamicObstacleManager>();
     
     std::cout << "===================================================\n";
@@ -50,18 +59,26 @@ App::~App() = default;
 void App::run() {
     bool running = true;
     Uint32 last_time = SDL_GetTicks();
+    const float step = SimulationConfig().dt;
+    float accumulator = 0.0f;
     
     while (running) {
         Uint32 current_time = SDL_GetTicks();
-        float dt = (current_time - last_time) / 1000.0f;
+        float frame_time = std::min((current_time - last_time) / 1000.0f, 0.25f);
         last_time = current_time;
         
         handleEvents(running);
         
+        // Same fixed step as SimulationEngine, so the view matches headless runs
         if (!paused_) {
-            updateSimulation(dt);
+            accumulator += frame_time;
+            while (accumulator >= step) {
+                updateSimulation(step);
+                accumulator -= step;
+            }
         }
         
+        advanceReplay();
         render();
         SDL_Delay(16);  // ~60 FPS
     }
@@ -72,6 +89,12 @@ void App::updateSimulation(float dt) {
     dynamic_obstacles_->updateAll(dt);
 }
 
+void App::advanceReplay() {
+    // Any search replays in about two seconds
+    size_t step = std::max<size_t>(1, search_events_.size() / 120);
+    events_shown_ = std::min(search_events_.size(), events_shown_ + step);
+}
+
 void App::handleEvents(bool& running) {
     SDL_Event event;
     
@@ -195,6 +218,9 @@ void App::runPathfinding() {
     Vec2 start_f(static_cast<float>(start_->x), static_cast<float>(start_->y));
     Vec2 goal_f(static_cast<float>(goal_->x), static_cast<float>(goal_->y));
     
+    search_events_.clear();
+    events_shown_ = 0;
+    
     switch (current_planner_) {
         case PlannerType::ASTAR: {
             std::cout << "Running A* from (" << start_->x << ", " << start_->y 
@@ -221,7 +247,7 @@ void App::runPathfinding() {
                 std::cout << "  Path length: " << rrt_result_.path.size() << " waypoints\n";
                 std::cout << "  Path cost: " << rrt_result_.path_cost << "\n";
                 std::cout << "  Iterations: " << rrt_result_.iterations << "\n";
-                std::cout << "  Tree size: " << rrt_result_.tree_nodes.size() << " nodes\n";
+                std::cout << "  Tree size: " << search_events_.getTotalRecorded() << " nodes\n";
             } else {
                 std::cout << "RRT did not reach goal (partial path shown).\n";
                 std::cout << "  Iterations: " << rrt_result_.iterations << "\n";
@@ -238,7 +264,7 @@ void App::runPathfinding() {
                 std::cout << "  Path length: " << rrt_result_.path.size() << " waypoints\n";
                 std::cout << "  Path cost: " << rrt_result_.path_cost << "\n";
                 std::cout << "  Iterations: " << rrt_result_.iterations << "\n";
-                std::cout << "  Tree size: " << rrt_result_.tree_nodes.size() << " nodes\n";
+                std::cout << "  Tree size: " << search_events_.getTotalRecorded() << " nodes\n";
             } else {
                 std::cout << "RRT* did not reach goal (partial path shown).\n";
             }
@@ -298,6 +324,8 @@ void App::clearAll() {
     goal_.reset();
     astar_result_ = AStarResult();
     rrt_result_ = RRTResult();
+    search_events_.clear();
+    events_shown_ = 0;
     dynamic_obstacles_->clear();
     simulation_time_ = 0.0f;
     std::cout << "Cleared everything.\n";
@@ -311,6 +339,8 @@ void App::clearObstacles() {
 void App::clearPath() {
     astar_result_ = AStarResult();
     rrt_result_ = RRTResult();
+    search_events_.clear();
+    events_shown_ = 0;
     std::cout << "Cleared path.\n";
 }
 
@@ -318,13 +348,11 @@ void App::render() {
     renderer_->clear();
     renderer_->drawGrid(*grid_);
     
+    // Search animation (closed/open cells for A*, tree nodes for RRT)
+    renderer_->drawSearchEvents(search_events_, events_shown_);
+    
     // Draw based on current planner
     if (current_planner_ == PlannerType::ASTAR) {
-        // Draw A* search visualization
-        if (!astar_result_.visited.empty()) {
-            renderer_->drawSearchProgress(astar_result_.visited, astar_result_.explored);
-        }
-        
         // Draw A* path
         if (!astar_result_.path.empty()) {
             if (show_smoothed_) {
@@ -340,11 +368,7 @@ void App::render() {
             }
         }
     } else {
-        // Draw RRT/RRT* tree and path
-        if (!rrt_result_.tree_nodes.empty()) {
-            renderer_->drawRRTTree(rrt_result_.tree_nodes);
-        }
-        
+        // Draw RRT/RRT* path
         if (!rrt_result_.path.empty()) {
             if (show_smoothed_) {
                 auto smoothed = PathSmoothing::smoothPath(rrt_result_.path, *grid_);
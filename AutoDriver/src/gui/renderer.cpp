@@ -1,4 +1,5 @@
 #include "gui/renderer.h"
+#include <algorithm>
 #include <iostream>
 
 Renderer::Renderer(int window_width, int window_height, int cell_size)
@@ -82,6 +83,29 @@ void Renderer::drawSearchProgress(const std::vector<Vec2i>& visited,
     }
 }
 
+void Renderer::drawSearchEvents(const RingBufferSink& events, size_t count) {
+    count = std::min(count, events.size());
+    for (size_t i = 0; i < count; i++) {
+        const SearchEvent& e = events.at(i);
+        switch (e.type) {
+            case SearchEventType::VISITED:
+                fillCell(static_cast<int>(e.pos.x), static_cast<int>(e.pos.y), 200, 220, 255, 180);
+                break;
+            case SearchEventType::EXPLORED:
+                fillCell(static_cast<int>(e.pos.x), static_cast<int>(e.pos.y), 255, 255, 150, 200);
+                break;
+            case SearchEventType::TREE_NODE: {
+                SDL_SetRenderDrawColor(renderer_, 150, 150, 150, 100);
+                int x = static_cast<int>(e.pos.x * cell_size_);
+                int y = static_cast<int>(e.pos.y * cell_size_);
+                SDL_Rect dot = {x - 1, y - 1, 3, 3};
+                SDL_RenderFillRect(renderer_, &dot);
+                break;
+            }
+        }
+    }
+}
+
 void Renderer::drawPath(const std::vector<Vec2i>& path) {
     if (path.empty()) return;
     
@@ -100,9 +100,48 @@ TEST_F(AStarTest, ManhattanDistanceCorrect) {
 }
 
 TEST_F(AStarTest, VisitedNodesTracked) {
+    planner->setCapture(SearchCapture::intoResults());
     auto result = planner->findPath(Vec2i(0, 0), Vec2i(2, 2));
     
     EXPECT_TRUE(result.success);
     EXPECT_GT(result.visited.size(), 0);
     EXPECT_EQ(result.nodes_expanded, result.visited.size());
 }
+
+TEST(AStarCoarseToFineTest, MatchesFullSearchWithFewerExpansions) {
+    // Open map with a thick wall and a single gap far from the straight line
+    Grid grid(256, 256);
+    for (int y = 0; y < 256; y++) {
+        for (int x = 128; x < 136; x++) {
+            if (y < 200 || y > 204) grid.setObstacle(x, y, true);
+        }
+    }
+    grid.enablePyramid();
+    
+    AStar planner(grid);
+    auto full = planner.findPath(Vec2i(10, 20), Vec2i(245, 30));
+    auto coarse = planner.findPathCoarseToFine(Vec2i(10, 20), Vec2i(245, 30));
+    
+    ASSERT_TRUE(full.success);
+    ASSERT_TRUE(coarse.success);
+    EXPECT_GT(coarse.coarse_nodes_expanded, 0);
+    EXPECT_LT(coarse.nodes_expanded, full.nodes_expanded);
+    EXPECT_LE(coarse.path_cost, full.path_cost * 1.05f);
+    
+    // Path is 4-connected and collision-free
+    for (size_t i = 0; i < coarse.path.size(); i++) {
+        EXPECT_FALSE(grid.isObstacle(coarse.path[i].x, coarse.path[i].y));
+        if (i > 0) {
+            EXPECT_EQ(std::abs(coarse.path[i].x - coarse.path[i - 1].x) +
+                      std::abs(coarse.path[i].y - coarse.path[i - 1].y), 1);
+        }
+    }
+    
+    // Closing the gap fully blocks the coarse wall cells
+    for (int y = 200; y <= 204; y++) {
+        for (int x = 128; x < 136; x++) grid.setObstacle(x, y, true);
+    }
+    auto blocked = planner.findPathCoarseToFine(Vec2i(10, 20), Vec2i(245, 30));
+    EXPECT_FALSE(blocked.success);
+    EXPECT_EQ(blocked.nodes_expanded, blocked.coarse_nodes_expanded);
+}
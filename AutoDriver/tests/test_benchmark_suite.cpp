@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+#include "benchmark/benchmark_suite.h"
+#include <cstdio>
+
+namespace {
+
+std::string tempPath(const std::string& name) {
+    return ::testing::TempDir() + "autodriver_" + name;
+}
+
+BenchmarkResult makeResult(const std::string& name, double centre, double spread) {
+    std::vector<double> times;
+    for (int i = 0; i < 100; i++) times.push_back(centre + spread * ((i * 37) % 100) / 100.0);
+    
+    BenchmarkResult result(name, "A*");
+    result.time_stats = BenchmarkStats::compute(times);
+    result.time_ms = result.time_stats.median;
+    return result;
+}
+
+}  // namespace
+
+TEST(BenchmarkSuiteTest, StatsReportQuantilesWithIntervals) {
+    std::vector<double> values;
+    for (int i = 100; i >= 1; i--) values.push_back(i);
+    
+    BenchmarkStats stats = BenchmarkStats::compute(values, 0.95);
+    EXPECT_EQ(stats.samples, 100);
+    EXPECT_DOUBLE_EQ(stats.min, 1.0);
+    EXPECT_DOUBLE_EQ(stats.max, 100.0);
+    EXPECT_DOUBLE_EQ(stats.mean, 50.5);
+    EXPECT_DOUBLE_EQ(stats.median, 50.5);
+    EXPECT_NEAR(stats.p90, 90.1, 1e-9);
+    EXPECT_NEAR(stats.p99, 99.01, 1e-9);
+    
+    // Roughly +-10 ranks around the median at 95%
+    EXPECT_LT(stats.median_ci_low, stats.median);
+    EXPECT_GT(stats.median_ci_high, stats.median);
+    EXPECT_NEAR(stats.median_ci_low, 40.0, 1.0);
+    EXPECT_NEAR(stats.median_ci_high, 61.0, 1.0);
+    EXPECT_LE(stats.p99_ci_low, stats.p99);
+    EXPECT_DOUBLE_EQ(stats.p99_ci_high, 100.0);
+    
+    // Wider confidence, wider interval
+    BenchmarkStats wide = BenchmarkStats::compute(values, 0.99);
+    EXPECT_LT(wide.median_ci_low, stats.median_ci_low);
+    
+    BenchmarkStats single = BenchmarkStats::compute({3.0});
+    EXPECT_DOUBLE_EQ(single.p99, 3.0);
+    EXPECT_DOUBLE_EQ(single.median_ci_low, 3.0);
+    EXPECT_EQ(BenchmarkStats::compute({}).samples, 0);
+}
+
+TEST(BenchmarkSuiteTest, JsonRoundTripAndRegressionVerdicts) {
+    BenchmarkConfig config;
+    config.grid_sizes = {10};
+    config.num_trials = 2;
+    config.warmup_runs = 1;
+    config.repetitions = 5;
+    BenchmarkSuite suite(config);
+    suite.benchmarkAStar();
+    ASSERT_EQ(suite.getResults().size(), 1u);
+    EXPECT_EQ(suite.getResults()[0].iterations, 10);
+    EXPECT_EQ(suite.getResults()[0].time_stats.samples, 10);
+    
+    std::string path = tempPath("bench.json");
+    ASSERT_TRUE(suite.generateJSON(path));
+    std::vector<BenchmarkResult> loaded;
+    ASSERT_TRUE(BenchmarkSuite::loadJSON(path, loaded));
+    ASSERT_EQ(loaded.size(), 1u);
+    EXPECT_EQ(loaded[0].test_name, suite.getResults()[0].test_name);
+    EXPECT_NEAR(loaded[0].time_stats.p90, suite.getResults()[0].time_stats.p90, 1e-6);
+    EXPECT_EQ(loaded[0].nodes_expanded, suite.getResults()[0].nodes_expanded);
+    std::remove(path.c_str());
+    
+    std::vector<BenchmarkResult> baseline = {
+        makeResult("fast", 10.0, 1.0), makeResult("noisy", 10.0, 20.0),
+        makeResult("same", 10.0, 1.0), makeResult("gone", 10.0, 1.0)};
+    std::vector<BenchmarkResult> current = {
+        makeResult("fast", 5.0, 1.0), makeResult("noisy", 13.0, 20.0), makeResult("same", 10.2, 1.0)};
+    
+    auto comparisons = BenchmarkSuite::compare(baseline, current, 0.10);
+    ASSERT_EQ(comparisons.size(), 4u);
+    EXPECT_EQ(comparisons[0].verdict, BenchmarkVerdict::IMPROVED);
+    EXPECT_EQ(comparisons[1].verdict, BenchmarkVerdict::INCONCLUSIVE);  // +15%, overlapping intervals
+    EXPECT_EQ(comparisons[2].verdict, BenchmarkVerdict::UNCHANGED);
+    EXPECT_EQ(comparisons[3].verdict, BenchmarkVerdict::MISSING);
+    
+    // The same data read the other way round is a clear regression
+    auto reverse = BenchmarkSuite::compare({current[0]}, {baseline[0]}, 0.10);
+    EXPECT_EQ(reverse[0].verdict, BenchmarkVerdict::REGRESSED);
+    EXPECT_NEAR(reverse[0].change, 10.5 / 5.5 - 1.0, 0.05);
+}
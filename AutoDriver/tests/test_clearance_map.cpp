@@ -0,0 +1,53 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include "core/clearance_map.h"
+#include "core/grid.h"
+
+TEST(ClearanceMapTest, MatchesBruteForceDistance) {
+    Grid grid(30, 20);
+    grid.setObstacle(5, 5, true);
+    grid.setObstacle(20, 12, true);
+    for (int x = 10; x < 15; x++) grid.setObstacle(x, 15, true);
+    
+    const float cap = 6.0f;
+    ClearanceMap map(grid, cap);
+    
+    for (int y = 0; y < grid.getHeight(); y++) {
+        for (int x = 0; x < grid.getWidth(); x++) {
+            // Nearest obstacle cell, with the grid border as a ring of obstacles
+            float best = std::min(std::min(x + 1, grid.getWidth() - x),
+                                  std::min(y + 1, grid.getHeight() - y));
+            for (int oy = 0; oy < grid.getHeight(); oy++) {
+                for (int ox = 0; ox < grid.getWidth(); ox++) {
+                    if (grid.isObstacle(ox, oy)) {
+                        best = std::min(best, std::hypot(static_cast<float>(x - ox), static_cast<float>(y - oy)));
+                    }
+                }
+            }
+            EXPECT_NEAR(map.at(x, y), std::min(best, cap), 1e-4f) << "cell " << x << "," << y;
+        }
+    }
+    
+    EXPECT_FLOAT_EQ(map.at(-5, 0), -1.0f);
+}
+
+TEST(ClearanceMapTest, WindowIsConservative) {
+    Grid grid(50, 50);
+    grid.setObstacle(30, 10, true);
+    
+    ClearanceMap full(grid);
+    ClearanceMap window(grid, 10, 10, 15, 15, 4.0f);
+    
+    // Never more optimistic than the full map, exact near the area of interest
+    for (int y = window.getOriginY(); y < window.getOriginY() + window.getHeight(); y++) {
+        for (int x = window.getOriginX(); x < window.getOriginX() + window.getWidth(); x++) {
+            EXPECT_LE(window.at(x, y), std::min(full.at(x, y), 4.0f) + 1e-4f);
+        }
+    }
+    EXPECT_FLOAT_EQ(window.at(12, 12), 4.0f);
+    
+    // Segments proven clear by the map really are clear
+    EXPECT_TRUE(window.isSegmentClear(Vec2(11.0f, 11.0f), Vec2(14.0f, 14.0f)));
+    EXPECT_FALSE(full.isSegmentClear(Vec2(28.0f, 10.0f), Vec2(32.0f, 10.0f)));
+    EXPECT_FLOAT_EQ(full.clearance(Vec2(30.0f, 10.0f)), 0.0f);
+}
@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+#include "core/cost_map.h"
+#include "core/astar.h"
+#include "core/grid.h"
+#include <cmath>
+
+namespace {
+
+// Horizontal aisle of free rows [1, 11] between two walls
+Grid makeAisle(int length) {
+    Grid grid(length, 13);
+    for (int x = 0; x < length; x++) {
+        grid.setObstacle(x, 0, true);
+        grid.setObstacle(x, 12, true);
+    }
+    return grid;
+}
+
+}  // namespace
+
+TEST(CostMapTest, EncodingsRoundTripWithinPrecision) {
+    CostLayer bytes(4, 4, CostEncoding::UINT8, 10.0f);
+    CostLayer halves(4, 4, CostEncoding::HALF, 100.0f);
+    EXPECT_EQ(bytes.getBytes(), 16u);
+    EXPECT_EQ(halves.getBytes(), 32u);
+
+    for (float value : {0.0f, 0.01f, 0.37f, 1.0f, 3.3f, 9.99f}) {
+        bytes.set(1, 1, value);
+        halves.set(1, 1, value);
+        EXPECT_NEAR(bytes.get(1, 1), value, 10.0f / 255.0f * 0.5f + 1e-6f);
+        EXPECT_NEAR(halves.get(1, 1), value, std::abs(value) * 1e-3f + 1e-6f);
+    }
+
+    // Clamping, out-of-range reads and non-zero bookkeeping
+    bytes.set(2, 2, 50.0f);
+    EXPECT_FLOAT_EQ(bytes.get(2, 2), 10.0f);
+    EXPECT_EQ(bytes.get(-1, 0), 0.0f);
+    EXPECT_EQ(bytes.getNonZeroCells(), 2u);
+    bytes.set(2, 2, 0.0f);
+    EXPECT_EQ(bytes.getNonZeroCells(), 1u);
+
+    for (uint16_t h : {uint16_t(0x0001), uint16_t(0x03ff), uint16_t(0x3c00), uint16_t(0x7bff)}) {
+        EXPECT_EQ(CostLayer::floatToHalf(CostLayer::halfToFloat(h)), h);
+    }
+}
+
+TEST(CostMapTest, InflationFollowsDistanceAndIgnoresThreadCount) {
+    Grid grid(90, 70);
+    for (int i = 0; i < 40; i++) grid.setObstacle(20 + i, 30, true);
+    grid.setObstacle(70, 10, true);
+
+    InflationOptions options;
+    options.radius = 6.0f;
+    options.encoding = CostEncoding::HALF;
+    options.num_threads = 1;
+    CostLayer single = CostMap::buildInflationLayer(grid, options);
+    options.num_threads = 4;
+    CostLayer parallel = CostMap::buildInflationLayer(grid, options);
+
+    for (int y = 0; y < grid.getHeight(); y++) {
+        for (int x = 0; x < grid.getWidth(); x++) {
+            ASSERT_EQ(single.get(x, y), parallel.get(x, y));
+        }
+    }
+
+    // Next to the wall the cost is maximal, and it decays with distance
+    EXPECT_NEAR(single.get(40, 31), options.max_cost, 1e-2f);
+    EXPECT_NEAR(single.get(40, 33), options.max_cost * std::exp(-options.decay * 2.0f), 1e-2f);
+    EXPECT_GT(single.get(40, 32), single.get(40, 34));
+    EXPECT_EQ(single.get(40, 45), 0.0f);
+    EXPECT_NEAR(single.get(73, 14), options.max_cost * std::exp(-options.decay * 4.0f), 1e-2f);
+}
+
+TEST(CostMapTest, AStarPrefersAisleCentre) {
+    Grid grid = makeAisle(60);
+    AStar planner(grid);
+
+    // Without costs the shortest path may hug the wall
+    auto plain = planner.findPath(Vec2i(2, 1), Vec2i(57, 1));
+    ASSERT_TRUE(plain.success);
+    EXPECT_FLOAT_EQ(plain.path_cost, 55.0f);
+
+    CostMap costs(grid.getWidth(), grid.getHeight());
+    EXPECT_TRUE(costs.isUniform());
+    planner.setCostMap(&costs);
+    auto uniform = planner.findPath(Vec2i(2, 1), Vec2i(57, 1));
+    EXPECT_EQ(uniform.path, plain.path);
+
+    InflationOptions options;
+    options.radius = 8.0f;
+    ASSERT_TRUE(costs.setLayer("inflation", CostMap::buildInflationLayer(grid, options)));
+    EXPECT_FALSE(costs.isUniform());
+
+    auto centred = planner.findPath(Vec2i(2, 1), Vec2i(57, 1));
+    ASSERT_TRUE(centred.success);
+    int centre_cells = 0;
+    for (const Vec2i& p : centred.path) {
+        if (p.y == 6) centre_cells++;
+    }
+    EXPECT_GT(centre_cells, 40);
+
+    // Zero weight restores the uniform fast path
+    EXPECT_TRUE(costs.setWeight("inflation", 0.0f));
+    EXPECT_TRUE(costs.isUniform());
+    EXPECT_EQ(planner.findPath(Vec2i(2, 1), Vec2i(57, 1)).path, plain.path);
+}
@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+#include "core/cost_matrix.h"
+#include "core/astar.h"
+#include "core/cost_map.h"
+#include "core/grid.h"
+
+namespace {
+
+// Two aisles joined at one end, plus a sealed pocket
+Grid depot() {
+    Grid grid(30, 20);
+    for (int x = 0; x < 26; x++) grid.setObstacle(x, 10, true);
+    for (int y = 0; y < 5; y++) grid.setObstacle(24, y, true);
+    for (int x = 24; x < 30; x++) grid.setObstacle(x, 5, true);
+    return grid;
+}
+
+void expectMatchesAStar(const Grid& grid, const CostMap* costs, const std::vector<Vec2i>& sources,
+                        const std::vector<Vec2i>& targets, const CostMatrix& matrix) {
+    AStar astar(grid);
+    astar.setCostMap(costs);
+    ASSERT_EQ(matrix.rows, static_cast<int>(sources.size()));
+    ASSERT_EQ(matrix.cols, static_cast<int>(targets.size()));
+    for (size_t i = 0; i < sources.size(); i++) {
+        for (size_t j = 0; j < targets.size(); j++) {
+            AStarResult path = astar.findPath(sources[i], targets[j]);
+            float cost = matrix.at(static_cast<int>(i), static_cast<int>(j));
+            if (path.success) {
+                EXPECT_NEAR(cost, path.path_cost, 1e-3f) << "source " << i << " target " << j;
+            } else {
+                EXPECT_EQ(cost, CostMatrix::kUnreachable) << "source " << i << " target " << j;
+            }
+        }
+    }
+}
+
+}  // namespace
+
+TEST(CostMatrixTest, MatchesAStarInBothDirections) {
+    Grid grid = depot();
+    std::vector<Vec2i> robots = {Vec2i(0, 0), Vec2i(5, 15), Vec2i(28, 19), Vec2i(12, 3), Vec2i(0, 10), Vec2i(12, 3)};
+    std::vector<Vec2i> tasks = {Vec2i(2, 18), Vec2i(27, 2), Vec2i(20, 0)};   // Second one is in the pocket
+    
+    CostMatrixPlanner planner(grid);
+    planner.setNumThreads(2);
+    
+    CostMatrix by_task = planner.computeCostMatrix(robots, tasks);
+    EXPECT_TRUE(by_task.per_target);
+    EXPECT_EQ(by_task.searches, 3);
+    expectMatchesAStar(grid, nullptr, robots, tasks, by_task);
+    
+    CostMatrix by_robot = planner.computeCostMatrix(tasks, robots);
+    EXPECT_FALSE(by_robot.per_target);
+    EXPECT_EQ(by_robot.searches, 3);
+    expectMatchesAStar(grid, nullptr, tasks, robots, by_robot);
+    
+    EXPECT_EQ(by_task.at(1, 0), 6.0f);
+    EXPECT_EQ(by_task.at(4, 0), CostMatrix::kUnreachable);   // Robot inside a wall
+}
+
+TEST(CostMatrixTest, ReverseSearchesChargeTheForwardPath) {
+    Grid grid = depot();
+    CostMap costs(grid.getWidth(), grid.getHeight());
+    CostLayer ramp(grid.getWidth(), grid.getHeight(), CostEncoding::HALF);
+    for (int y = 0; y < grid.getHeight(); y++) {
+        for (int x = 0; x < grid.getWidth(); x++) ramp.set(x, y, 0.25f * (x % 7) + (y == 15 ? 3.0f : 0.0f));
+    }
+    ASSERT_TRUE(costs.setLayer("ramp", ramp));
+    
+    std::vector<Vec2i> robots = {Vec2i(1, 1), Vec2i(6, 14), Vec2i(29, 19), Vec2i(15, 8)};
+    std::vector<Vec2i> tasks = {Vec2i(3, 17), Vec2i(22, 2)};
+    
+    CostMatrixPlanner planner(grid);
+    planner.setCostMap(&costs);
+    CostMatrix by_task = planner.computeCostMatrix(robots, tasks);
+    CostMatrix by_robot = planner.computeCostMatrix(tasks, robots);
+    ASSERT_TRUE(by_task.per_target);
+    ASSERT_FALSE(by_robot.per_target);
+    expectMatchesAStar(grid, &costs, robots, tasks, by_task);
+    expectMatchesAStar(grid, &costs, tasks, robots, by_robot);
+}
+
+TEST(CostMatrixTest, StopsEarlyAndReusesContexts) {
+    Grid grid(200, 200);
+    std::vector<Vec2i> robots = {Vec2i(10, 10), Vec2i(12, 10)};
+    std::vector<Vec2i> near = {Vec2i(11, 11), Vec2i(14, 9)};
+    
+    CostMatrixPlanner planner(grid);
+    planner.setNumThreads(1);
+    CostMatrix local = planner.computeCostMatrix(robots, near);
+    EXPECT_EQ(local.searches, 2);
+    EXPECT_LT(local.cells_settled, 200u);   // Nowhere near the 40000 free cells
+    EXPECT_EQ(local.at(0, 0), 2.0f);
+    EXPECT_EQ(local.at(1, 1), 3.0f);
+    
+    // Goal marks from the previous call are gone; results independent of thread count
+    std::vector<Vec2i> far = {Vec2i(199, 199), Vec2i(0, 150), Vec2i(11, 11)};
+    CostMatrix serial = planner.computeCostMatrix(robots, far);
+    planner.setNumThreads(3);
+    CostMatrix parallel = planner.computeCostMatrix(robots, far);
+    EXPECT_EQ(serial.costs, parallel.costs);
+    EXPECT_EQ(serial.at(0, 0), 378.0f);
+    EXPECT_EQ(serial.at(1, 2), 2.0f);
+    
+    // Later calls reuse the pool, and a new thread count replaces it
+    for (int i = 0; i < 3; i++) EXPECT_EQ(planner.computeCostMatrix(robots, far).costs, serial.costs);
+    planner.setNumThreads(2);
+    EXPECT_EQ(planner.computeCostMatrix(robots, far).costs, serial.costs);
+    
+    CostMatrix none = planner.computeCostMatrix(robots, {});
+    EXPECT_EQ(none.rows, 2);
+    EXPECT_TRUE(none.costs.empty());
+}
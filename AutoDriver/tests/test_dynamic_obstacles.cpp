@@ -79,3 +79,52 @@ TEST(DynamicObstacleManagerTest, ClearRemovesAll) {
     
     EXPECT_EQ(manager.size(), 0);
 }
+
+TEST(DynamicObstacleManagerTest, VectorisedUpdateMatchesScalar) {
+    DynamicObstacleManager manager;
+    std::vector<DynamicObstacle> reference;
+    
+    // Odd count so the scalar tail of the kernel is exercised too
+    for (int i = 0; i < 1003; i++) {
+        DynamicObstacle obs(Vec2(i * 0.1f, i * 0.2f), Vec2((i % 7) - 3.0f, (i % 5) - 2.0f), 0.5f);
+        manager.addObstacle(obs);
+        reference.push_back(obs);
+    }
+    
+    for (int step = 0; step < 10; step++) {
+        manager.updateAll(0.05f);
+        for (auto& obs : reference) {
+            obs.update(0.05f);
+        }
+    }
+    
+    for (size_t i = 0; i < reference.size(); i++) {
+        EXPECT_FLOAT_EQ(manager.getObstacles()[i].getPosition().x, reference[i].getPosition().x);
+        EXPECT_FLOAT_EQ(manager.getObstacles()[i].getPosition().y, reference[i].getPosition().y);
+    }
+}
+
+TEST(DynamicObstacleManagerTest, BatchQueriesMatchSingleQueries) {
+    DynamicObstacleManager manager;
+    for (int i = 0; i < 20; i++) {
+        manager.addObstacle(DynamicObstacle(Vec2(i * 3.0f, 0.0f), Vec2(0.0f, 1.0f), 1.0f));
+    }
+    
+    std::vector<Vec2> predicted;
+    manager.predictPositions(2.0f, predicted);
+    ASSERT_EQ(predicted.size(), manager.size());
+    EXPECT_FLOAT_EQ(predicted[4].x, 12.0f);
+    EXPECT_FLOAT_EQ(predicted[4].y, 2.0f);
+    
+    std::vector<Vec2> queries = {Vec2(12.0f, 2.2f), Vec2(13.5f, 2.0f), Vec2(57.0f, 2.5f)};
+    std::vector<uint8_t> hits;
+    manager.checkCollisions(queries, 2.0f, hits);
+    
+    ASSERT_EQ(hits.size(), queries.size());
+    for (size_t q = 0; q < queries.size(); q++) {
+        EXPECT_EQ(hits[q] != 0, manager.checkCollision(queries[q], 2.0f));
+    }
+    EXPECT_EQ(hits[0], 1);
+    EXPECT_EQ(hits[1], 0);
+    EXPECT_EQ(hits[2], 1);
+}
@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+#include "core/frenet_planner.h"
+#include <cmath>
+
+namespace {
+
+Lane straightLane(float length, float speed_limit) {
+    Lane lane(0, 3.5f, speed_limit);
+    for (float x = 0.0f; x <= length; x += 10.0f) {
+        lane.centerline.push_back(Vec2(x, 20.0f));
+    }
+    return lane;
+}
+
+}  // namespace
+
+TEST(FrenetPlannerTest, PolynomialsMeetBoundaryConditions) {
+    QuinticPolynomial lat(0.5f, 0.2f, -0.1f, 3.0f, 0.0f, 0.0f, 4.0f);
+    EXPECT_NEAR(lat.position(0.0f), 0.5f, 1e-5f);
+    EXPECT_NEAR(lat.velocity(0.0f), 0.2f, 1e-5f);
+    EXPECT_NEAR(lat.acceleration(0.0f), -0.1f, 1e-5f);
+    EXPECT_NEAR(lat.position(4.0f), 3.0f, 1e-4f);
+    EXPECT_NEAR(lat.velocity(4.0f), 0.0f, 1e-4f);
+    EXPECT_NEAR(lat.acceleration(4.0f), 0.0f, 1e-4f);
+    
+    QuarticPolynomial lon(10.0f, 20.0f, 1.0f, 25.0f, 0.0f, 3.0f);
+    EXPECT_NEAR(lon.position(0.0f), 10.0f, 1e-5f);
+    EXPECT_NEAR(lon.velocity(0.0f), 20.0f, 1e-5f);
+    EXPECT_NEAR(lon.acceleration(0.0f), 1.0f, 1e-5f);
+    EXPECT_NEAR(lon.velocity(3.0f), 25.0f, 1e-4f);
+    EXPECT_NEAR(lon.acceleration(3.0f), 0.0f, 1e-4f);
+}
+
+TEST(FrenetPlannerTest, FrenetCartesianRoundTrip) {
+    Lane lane(0);
+    lane.centerline = {Vec2(0, 0), Vec2(10, 0), Vec2(10, 10)};
+    DynamicObstacleManager obstacles;
+    FrenetPlanner planner(lane, obstacles);
+    
+    EXPECT_FLOAT_EQ(planner.getReferenceLength(), 20.0f);
+    
+    // Left of the first segment is +y
+    Vec2 p = planner.toCartesian(4.0f, 1.5f);
+    EXPECT_NEAR(p.x, 4.0f, 1e-5f);
+    EXPECT_NEAR(p.y, 1.5f, 1e-5f);
+    
+    FrenetState state = planner.toFrenet(Vec2(9.0f, 6.0f));
+    EXPECT_NEAR(state.s, 16.0f, 1e-4f);
+    EXPECT_NEAR(state.d, 1.0f, 1e-4f);
+}
+
+TEST(FrenetPlannerTest, KeepsLaneAtSpeedLimitOnEmptyRoad) {
+    Lane lane = straightLane(500.0f, 20.0f);
+    DynamicObstacleManager obstacles;
+    FrenetPlanner planner(lane, obstacles);
+    
+    FrenetResult result = planner.plan(FrenetState(10.0f, 20.0f, 0.0f));
+    
+    ASSERT_TRUE(result.success);
+    EXPECT_GT(result.candidates_generated, 100);
+    EXPECT_NEAR(result.trajectory.target_offset, 0.0f, 1e-4f);
+    EXPECT_NEAR(result.trajectory.target_speed, 20.0f, 1e-4f);
+    ASSERT_FALSE(result.trajectory.points.empty());
+    EXPECT_NEAR(result.trajectory.points.front().y, 20.0f, 1e-4f);
+    EXPECT_NEAR(result.trajectory.points.back().y, 20.0f, 1e-3f);
+}
+
+TEST(FrenetPlannerTest, AvoidsObstacleInLane) {
+    Lane lane = straightLane(500.0f, 15.0f);
+    DynamicObstacleManager obstacles;
+    // Stopped vehicle ahead in the lane
+    obstacles.addObstacle(DynamicObstacle(Vec2(50.0f, 20.0f), Vec2(0.0f, 0.0f), 1.5f));
+    
+    FrenetPlanner planner(lane, obstacles);
+    FrenetResult result = planner.plan(FrenetState(10.0f, 15.0f, 0.0f));
+    
+    ASSERT_TRUE(result.success);
+    EXPECT_GT(result.candidates_rejected, 0);
+    
+    float radius = 1.5f + planner.getConfig().vehicle_radius;
+    for (const Vec2& p : result.trajectory.points) {
+        EXPECT_GT(p.distanceTo(Vec2(50.0f, 20.0f)), radius);
+    }
+}
+
+TEST(FrenetPlannerTest, RespectsTimeBudget) {
+    Lane lane = straightLane(500.0f, 15.0f);
+    DynamicObstacleManager obstacles;
+    // Wall of obstacles blocks every candidate
+    for (float y = 10.0f; y <= 30.0f; y += 1.0f) {
+        obstacles.addObstacle(DynamicObstacle(Vec2(30.0f, y), Vec2(0.0f, 0.0f), 1.0f));
+    }
+    
+    FrenetPlanner planner(lane, obstacles);
+    FrenetConfig config;
+    config.lateral_samples = 21;
+    config.speed_samples = 21;
+    config.horizon_samples = 10;
+    planner.setConfig(config);
+    
+    FrenetResult result = planner.plan(FrenetState(10.0f, 15.0f, 0.0f), 0.0);
+    
+    EXPECT_FALSE(result.success);
+    EXPECT_TRUE(result.budget_exceeded);
+    EXPECT_LT(result.candidates_checked, result.candidates_generated);
+}
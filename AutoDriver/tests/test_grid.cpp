@@ -1,5 +1,8 @@
 #include <gtest/gtest.h>
 #include "core/grid.h"
+#include "core/random.h"
+#include <thread>
+#include <atomic>
 
 class GridTest : public ::testing::Test {
 protected:
@@ -64,3 +67,183 @@ TEST_F(GridTest, SetObstacleOutOfBoundsIgnored) {
     grid->setObstacle(-1, -1, true);
     grid->setObstacle(100, 100, true);
 }
+
+TEST(GridSnapshotTest, SnapshotIsIsolatedFromLaterEdits) {
+    Grid grid(200, 150);
+    grid.setObstacle(10, 10, true);
+    uint64_t version = grid.getVersion();
+    
+    Grid snapshot = grid.snapshot();
+    grid.setObstacle(10, 10, false);
+    grid.setObstacle(150, 100, true);
+    
+    EXPECT_TRUE(snapshot.isObstacle(10, 10));
+    EXPECT_FALSE(snapshot.isObstacle(150, 100));
+    EXPECT_EQ(snapshot.getVersion(), version);
+    
+    EXPECT_FALSE(grid.isObstacle(10, 10));
+    EXPECT_TRUE(grid.isObstacle(150, 100));
+    EXPECT_EQ(grid.getVersion(), version + 2);
+    
+    // Setting a cell to its current value is not a change
+    grid.setObstacle(150, 100, true);
+    EXPECT_EQ(grid.getVersion(), version + 2);
+}
+
+TEST(GridSnapshotTest, TileJournalRecordsChangedTiles) {
+    Grid grid(256, 192);  // 4 x 3 tiles
+    EXPECT_EQ(grid.getTileVersion(1, 1), 0u);
+    grid.setObstacle(70, 70, true);
+    uint64_t version = grid.getVersion();
+    EXPECT_EQ(grid.getTileVersion(1, 1), version);
+    
+    Grid snapshot = grid.snapshot();
+    grid.setObstacle(200, 10, true);   // Tile (3, 0)
+    grid.setObstacle(200, 10, true);   // No change
+    EXPECT_EQ(grid.getTileVersion(3, 0), version + 1);
+    EXPECT_EQ(snapshot.getTileVersion(3, 0), 0u);
+    
+    EXPECT_TRUE(grid.changedSince(version));
+    EXPECT_FALSE(snapshot.changedSince(version));
+    EXPECT_TRUE(grid.changedSince(version, 2, 0, 3, 1));
+    EXPECT_FALSE(grid.changedSince(version, 0, 0, 2, 2));
+    EXPECT_TRUE(grid.changedSince(version - 1, -5, -5, 1, 1));   // Clamped to the grid
+    
+    std::vector<Vec2i> changed = grid.getChangedTiles(version - 1);
+    ASSERT_EQ(changed.size(), 2u);
+    EXPECT_EQ(changed[0], Vec2i(3, 0));
+    EXPECT_EQ(changed[1], Vec2i(1, 1));
+    EXPECT_TRUE(grid.getChangedTiles(grid.getVersion()).empty());
+    
+    // Clearing changes every tile
+    grid.clear();
+    EXPECT_EQ(grid.getChangedTiles(version + 1).size(), 12u);
+}
+
+TEST(GridSnapshotTest, UnchangedTilesAreShared) {
+    Grid grid(256, 256);  // 4 x 4 tiles
+    ASSERT_EQ(grid.getTilesX(), 4);
+    ASSERT_EQ(grid.getTilesY(), 4);
+    
+    Grid snapshot = grid.snapshot();
+    EXPECT_EQ(grid.countSharedTiles(snapshot), 16u);
+    
+    // A batch of edits inside one tile clones exactly that tile
+    for (int i = 0; i < 20; i++) grid.setObstacle(70 + i, 140, true);
+    EXPECT_EQ(grid.getTilesCloned(), 1u);
+    EXPECT_EQ(grid.countSharedTiles(snapshot), 15u);
+    EXPECT_FALSE(grid.sharesTile(snapshot, 1, 2));
+    EXPECT_TRUE(grid.sharesTile(snapshot, 0, 0));
+    
+    // Once the snapshot is gone the writer owns its tiles again
+    Grid unshared(256, 256);
+    unshared.setObstacle(5, 5, true);
+    size_t cloned = unshared.getTilesCloned();
+    unshared.setObstacle(6, 5, true);
+    EXPECT_EQ(unshared.getTilesCloned(), cloned);
+}
+
+TEST(GridSnapshotTest, ReadersSeeConsistentVersionsWhileWriterEdits) {
+    Grid grid(128, 128);
+    std::atomic<int> inconsistent(0);
+    
+    // Writer fills row after row; each reader snapshot must contain a prefix
+    // of whole rows and nothing else
+    std::vector<Grid> snapshots;
+    snapshots.reserve(129);
+    snapshots.push_back(grid.snapshot());
+    for (int y = 0; y < 128; y++) {
+        for (int x = 0; x < 128; x++) grid.setObstacle(x, y, true);
+        snapshots.push_back(grid.snapshot());
+    }
+    
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 4; r++) {
+        readers.emplace_back([&, r]() {
+            for (size_t s = r; s < snapshots.size(); s += 4) {
+                const Grid& view = snapshots[s];
+                for (int y = 0; y < 128; y++) {
+                    for (int x = 0; x < 128; x++) {
+                        if (view.isObstacle(x, y) != (y < static_cast<int>(s))) inconsistent++;
+                    }
+                }
+            }
+        });
+    }
+    
+    // Keep editing the live grid while the readers run
+    for (int y = 0; y < 128; y++) grid.setObstacle(y, y, false);
+    for (auto& reader : readers) reader.join();
+    
+    EXPECT_EQ(inconsistent.load(), 0);
+}
+
+TEST(GridPyramidTest, IncrementalUpdatesMatchRebuild) {
+    Grid grid(150, 100);  // Partial edge tiles in both directions
+    grid.enablePyramid();
+    RandomStream rng(3);
+    for (int i = 0; i < 3000; i++) {
+        int x = static_cast<int>(rng.uniform(0.0f, 150.0f));
+        int y = static_cast<int>(rng.uniform(0.0f, 100.0f));
+        grid.setObstacle(std::min(x, 149), std::min(y, 99), rng.uniform() < 0.6f);
+    }
+    
+    Grid rebuilt = grid.snapshot();
+    rebuilt.enablePyramid();
+    Grid plain = grid.snapshot();
+    plain.disablePyramid();
+    
+    for (int level = 1; level <= Grid::kMaxPyramidLevels; level++) {
+        for (int cy = 0; cy < grid.getLevelHeight(level); cy++) {
+            for (int cx = 0; cx < grid.getLevelWidth(level); cx++) {
+                int size = 1 << level;
+                int expected = 0;
+                for (int y = cy * size; y < (cy + 1) * size; y++) {
+                    for (int x = cx * size; x < (cx + 1) * size; x++) {
+                        if (grid.isValid(x, y) && grid.isObstacle(x, y)) expected++;
+                    }
+                }
+                ASSERT_EQ(grid.getBlockedCount(level, cx, cy), expected);
+                ASSERT_EQ(rebuilt.getBlockedCount(level, cx, cy), expected);
+                ASSERT_EQ(plain.getBlockedCount(level, cx, cy), expected);
+            }
+        }
+    }
+    
+    // Partial edge cell: occupancy is relative to the cells inside the grid
+    Grid edge(10, 10);
+    edge.enablePyramid();
+    edge.setObstacle(8, 8, true);
+    edge.setObstacle(9, 9, true);
+    EXPECT_FLOAT_EQ(edge.getOccupancy(3, 1, 1), 0.5f);
+    EXPECT_TRUE(edge.isCoarseBlocked(3, 5, 0));  // Outside the grid
+}
+
+TEST(GridPyramidTest, RegionQueriesAgreeWithCells) {
+    Grid grid(200, 200);
+    grid.setObstacle(100, 37, true);
+    grid.setObstacle(12, 150, true);
+    
+    Grid with_pyramid = grid.snapshot();
+    with_pyramid.enablePyramid();
+    
+    RandomStream rng(11);
+    for (int i = 0; i < 500; i++) {
+        int x0 = static_cast<int>(rng.uniform(-5.0f, 200.0f));
+        int y0 = static_cast<int>(rng.uniform(-5.0f, 200.0f));
+        int x1 = x0 + static_cast<int>(rng.uniform(0.0f, 90.0f));
+        int y1 = y0 + static_cast<int>(rng.uniform(0.0f, 90.0f));
+        
+        bool expected = true;
+        for (int y = y0; y <= y1 && expected; y++) {
+            for (int x = x0; x <= x1; x++) {
+                if (grid.isObstacle(x, y)) {
+                    expected = false;
+                    break;
+                }
+            }
+        }
+        ASSERT_EQ(grid.isRegionFree(x0, y0, x1, y1), expected);
+        ASSERT_EQ(with_pyramid.isRegionFree(x0, y0, x1, y1), expected);
+    }
+}
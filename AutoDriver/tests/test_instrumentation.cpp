@@ -0,0 +1,164 @@
+#include <gtest/gtest.h>
+#include "core/instrumentation.h"
+#include "core/astar.h"
+#include "core/hybrid_astar.h"
+#include "core/rrt.h"
+#include "core/path_smoothing.h"
+#include "core/grid.h"
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <cstdio>
+
+namespace {
+
+uint64_t countOf(Probe probe) {
+    for (const ProbeStats& s : Instrumentation::snapshot()) {
+        if (s.probe == probe) return s.count;
+    }
+    return 0;
+}
+
+// Hits a phase probe from thread-local teardown, after the thread's slot is retired
+struct LateProbe {
+    ~LateProbe() { AUTODRIVER_SCOPE(ASTAR_SEARCH); }
+};
+
+}  // namespace
+
+TEST(InstrumentationTest, ProbesHaveNames) {
+    for (int i = 0; i < static_cast<int>(Probe::COUNT); i++) {
+        EXPECT_STRNE(Instrumentation::name(static_cast<Probe>(i)), "unknown");
+    }
+    EXPECT_TRUE(Instrumentation::isPhase(Probe::ASTAR_SEARCH));
+    EXPECT_FALSE(Instrumentation::isPhase(Probe::ASTAR_HEAP_POP));
+    EXPECT_EQ(Instrumentation::snapshot().size(), static_cast<size_t>(Probe::COUNT));
+}
+
+TEST(InstrumentationTest, PlannersFeedProbes) {
+    Instrumentation::reset();
+    Grid grid(40, 40);
+    for (int y = 5; y < 35; y++) grid.setObstacle(20, y, true);
+    
+    AStar astar(grid);
+    AStarResult path = astar.findPath(Vec2i(2, 20), Vec2i(38, 20));
+    ASSERT_TRUE(path.success);
+    
+    HybridAStar hybrid(grid);
+    HybridAStarResult hybrid_path = hybrid.findPath(Vec2(5.0f, 2.0f), 0.0f, Vec2(12.0f, 2.0f), 0.0f, 2000);
+    EXPECT_GE(hybrid_path.iterations, hybrid_path.nodes_expanded);
+    
+    RRTStar rrt(grid);
+    rrt.setSeed(3);
+    rrt.findPath(Vec2(2.0f, 2.0f), Vec2(38.0f, 38.0f), 500);
+    
+    std::vector<Vec2> waypoints;
+    for (const Vec2i& p : path.path) waypoints.push_back(Vec2(static_cast<float>(p.x), static_cast<float>(p.y)));
+    PathSmoothing::shortcutSmooth(waypoints, grid);
+    
+    if (!Instrumentation::enabled()) {
+        // Compiled out: nothing is ever recorded
+        for (const ProbeStats& s : Instrumentation::snapshot()) EXPECT_EQ(s.count, 0u) << s.name;
+        return;
+    }
+    
+    EXPECT_EQ(countOf(Probe::ASTAR_SEARCH), 1u);
+    EXPECT_EQ(countOf(Probe::ASTAR_EXPAND), static_cast<uint64_t>(path.nodes_expanded));
+    EXPECT_GE(countOf(Probe::ASTAR_HEAP_POP), countOf(Probe::ASTAR_EXPAND));
+    EXPECT_GT(countOf(Probe::ASTAR_HEAP_PUSH), 0u);
+    EXPECT_EQ(countOf(Probe::HYBRID_EXPAND), static_cast<uint64_t>(hybrid_path.nodes_expanded));
+    EXPECT_EQ(countOf(Probe::HYBRID_HEAP_POP), static_cast<uint64_t>(hybrid_path.iterations));
+    EXPECT_GT(countOf(Probe::HYBRID_COLLISION), 0u);
+    EXPECT_EQ(countOf(Probe::RRT_SEARCH), 1u);
+    EXPECT_GT(countOf(Probe::RRT_NEAREST), 0u);
+    EXPECT_GT(countOf(Probe::RRT_COLLISION), 0u);
+    EXPECT_GT(countOf(Probe::RRT_REWIRE), 0u);
+    EXPECT_EQ(countOf(Probe::SMOOTH_SHORTCUT), 1u);
+    EXPECT_GT(countOf(Probe::SMOOTH_LINE_CHECK), 0u);
+    
+    Instrumentation::reset();
+    EXPECT_EQ(countOf(Probe::ASTAR_SEARCH), 0u);
+}
+
+TEST(InstrumentationTest, CountersSumAcrossThreadsAndTraceExports) {
+    if (!Instrumentation::enabled()) GTEST_SKIP() << "built without AUTODRIVER_INSTRUMENTATION";
+    
+    Instrumentation::reset();
+    Instrumentation::startTrace();
+    Grid grid(30, 30);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 4; t++) {
+        workers.emplace_back([&grid]() {
+            AStar planner(grid);
+            for (int i = 0; i < 5; i++) planner.findPath(Vec2i(0, 0), Vec2i(29, 29));
+        });
+    }
+    for (auto& worker : workers) worker.join();
+    Instrumentation::stopTrace();
+    
+    // Threads have exited; their totals remain
+    EXPECT_EQ(countOf(Probe::ASTAR_SEARCH), 20u);
+    
+    std::string path = ::testing::TempDir() + "autodriver_trace.json";
+    ASSERT_TRUE(Instrumentation::writeChromeTrace(path));
+    std::ifstream in(path);
+    std::stringstream text;
+    text << in.rdbuf();
+    std::string trace = text.str();
+    
+    size_t events = 0;
+    for (size_t pos = trace.find("\"ph\": \"X\""); pos != std::string::npos; pos = trace.find("\"ph\": \"X\"", pos + 1)) {
+        events++;
+    }
+    EXPECT_EQ(events, 20u);
+    EXPECT_NE(trace.find("\"astar.heap_pop\""), std::string::npos);
+    EXPECT_EQ(trace.rfind("]}"), trace.size() - 3);
+    std::remove(path.c_str());
+}
+
+TEST(InstrumentationTest, ExitedThreadsRecycleTheirSlots) {
+    if (!Instrumentation::enabled()) GTEST_SKIP() << "built without AUTODRIVER_INSTRUMENTATION";
+    
+    Instrumentation::reset();
+    Grid grid(10, 10);
+    std::thread([&grid]() { AStar(grid).findPath(Vec2i(0, 0), Vec2i(9, 9)); }).join();
+    size_t slots = Instrumentation::getThreadSlots();
+    
+    // Threads started one after another keep reusing the freed slot
+    for (int t = 0; t < 50; t++) {
+        std::thread([&grid]() { AStar(grid).findPath(Vec2i(0, 0), Vec2i(9, 9)); }).join();
+    }
+    EXPECT_EQ(Instrumentation::getThreadSlots(), slots);
+    EXPECT_EQ(countOf(Probe::ASTAR_SEARCH), 51u);
+}
+
+TEST(InstrumentationTest, ProbesAfterSlotRetirementCountWithoutEvents) {
+    if (!Instrumentation::enabled()) GTEST_SKIP() << "built without AUTODRIVER_INSTRUMENTATION";
+    
+    Instrumentation::reset();
+    Instrumentation::startTrace();
+    Grid grid(10, 10);
+    std::thread([&grid]() {
+        // Constructed before the slot owner, so destroyed after it
+        static thread_local LateProbe late;
+        (void)late;
+        AStar(grid).findPath(Vec2i(0, 0), Vec2i(9, 9));
+    }).join();
+    Instrumentation::stopTrace();
+    EXPECT_EQ(countOf(Probe::ASTAR_SEARCH), 2u);
+    
+    std::string path = ::testing::TempDir() + "autodriver_late_trace.json";
+    ASSERT_TRUE(Instrumentation::writeChromeTrace(path));
+    std::ifstream in(path);
+    std::stringstream text;
+    text << in.rdbuf();
+    std::string trace = text.str();
+    
+    // Only the search made while the thread still owned its slot is traced
+    size_t events = 0;
+    for (size_t pos = trace.find("\"ph\": \"X\""); pos != std::string::npos; pos = trace.find("\"ph\": \"X\"", pos + 1)) {
+        events++;
+    }
+    EXPECT_EQ(events, 1u);
+    std::remove(path.c_str());
+}
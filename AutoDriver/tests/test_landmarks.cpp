@@ -0,0 +1,169 @@
+#include <gtest/gtest.h>
+#include "core/landmarks.h"
+#include "core/astar.h"
+#include "core/grid.h"
+#include <cstdio>
+
+namespace {
+
+// Horizontal walls every 4 rows, gaps alternating between the two ends
+Grid serpentine(int size) {
+    Grid grid(size, size);
+    for (int y = 4, row = 0; y < size - 1; y += 4, row++) {
+        for (int x = 0; x < size; x++) {
+            bool gap = row % 2 == 0 ? x >= size - 2 : x < 2;
+            if (!gap) grid.setObstacle(x, y, true);
+        }
+    }
+    return grid;
+}
+
+}  // namespace
+
+TEST(LandmarkTest, BoundsAreAdmissible) {
+    Grid grid = serpentine(33);
+    grid.setObstacle(10, 10, true);
+    grid.setObstacle(20, 22, true);
+    
+    LandmarkOptions options;
+    options.count = 6;
+    LandmarkTable table = LandmarkTable::build(grid, options);
+    ASSERT_EQ(table.getLandmarkCount(), 6u);
+    EXPECT_TRUE(table.matches(grid));
+    for (uint32_t step : table.getSteps()) EXPECT_EQ(step, 1u);
+    
+    AStar astar(grid);
+    const Vec2i cells[] = {Vec2i(0, 0), Vec2i(32, 0), Vec2i(5, 13), Vec2i(31, 31), Vec2i(16, 27), Vec2i(0, 30)};
+    for (const Vec2i& a : cells) {
+        for (const Vec2i& b : cells) {
+            AStarResult exact = astar.findPath(a, b);
+            ASSERT_TRUE(exact.success);
+            EXPECT_LE(table.lowerBound(a, b), exact.path_cost);
+        }
+    }
+    
+    // Distances from a landmark are exact, so the bound to it is tight
+    Vec2i landmark = table.getLandmarks()[0];
+    AStarResult to_landmark = astar.findPath(Vec2i(5, 13), landmark);
+    ASSERT_TRUE(to_landmark.success);
+    EXPECT_FLOAT_EQ(table.lowerBound(Vec2i(5, 13), landmark), to_landmark.path_cost);
+    EXPECT_EQ(table.distance(0, 5, 13), static_cast<int>(to_landmark.path_cost));
+}
+
+TEST(LandmarkTest, CutsExpansionsAroundTraps) {
+    // Cup opening away from the goal: straight-line guidance floods it
+    Grid grid(64, 64);
+    for (int y = 10; y <= 54; y++) grid.setObstacle(40, y, true);
+    for (int x = 16; x <= 40; x++) {
+        grid.setObstacle(x, 10, true);
+        grid.setObstacle(x, 54, true);
+    }
+    LandmarkTable table = LandmarkTable::build(grid);
+    
+    AStar plain(grid);
+    AStar alt(grid);
+    alt.setLandmarks(&table);
+    
+    AStarResult base = plain.findPath(Vec2i(36, 32), Vec2i(60, 32));
+    AStarResult fast = alt.findPath(Vec2i(36, 32), Vec2i(60, 32));
+    ASSERT_TRUE(base.success);
+    ASSERT_TRUE(fast.success);
+    EXPECT_FLOAT_EQ(fast.path_cost, base.path_cost);
+    EXPECT_LT(fast.nodes_expanded * 2, base.nodes_expanded);
+    
+    // A table for another map size is ignored
+    Grid other(10, 10);
+    AStar mismatched(other);
+    mismatched.setLandmarks(&table);
+    EXPECT_TRUE(mismatched.findPath(Vec2i(0, 0), Vec2i(9, 9)).success);
+}
+
+TEST(LandmarkTest, OnlyMatchesTheMapItWasBuiltFrom) {
+    Grid grid = serpentine(40);
+    LandmarkTable table = LandmarkTable::build(grid);
+    ASSERT_TRUE(table.matches(grid));
+    
+    // Same size, one more wall: the stored distances no longer describe it
+    Grid edited = grid.snapshot();
+    edited.setObstacle(1, 1, true);
+    EXPECT_FALSE(table.matches(edited));
+    
+    AStar plain(edited);
+    AStar alt(edited);
+    alt.setLandmarks(&table);
+    AStarResult base = plain.findPath(Vec2i(0, 0), Vec2i(39, 39));
+    AStarResult ignored = alt.findPath(Vec2i(0, 0), Vec2i(39, 39));
+    ASSERT_TRUE(base.success);
+    EXPECT_EQ(ignored.nodes_expanded, base.nodes_expanded);
+    
+    // Undoing the edit brings the table back, also after a save and load
+    edited.setObstacle(1, 1, false);
+    EXPECT_TRUE(table.matches(edited));
+    EXPECT_LT(alt.findPath(Vec2i(0, 0), Vec2i(39, 39)).nodes_expanded, base.nodes_expanded);
+    
+    const std::string path = "test_landmarks_match.alt";
+    ASSERT_TRUE(table.save(path));
+    LandmarkTable loaded;
+    ASSERT_TRUE(LandmarkTable::load(path, loaded));
+    std::remove(path.c_str());
+    EXPECT_EQ(loaded.getGridHash(), grid.contentHash());
+    EXPECT_TRUE(loaded.matches(edited));
+    edited.setObstacle(1, 1, true);
+    EXPECT_FALSE(loaded.matches(edited));
+}
+
+TEST(LandmarkTest, UnreachableCellsGiveNoBound) {
+    Grid grid(20, 10);
+    for (int y = 0; y < 10; y++) grid.setObstacle(10, y, true);
+    
+    // Explicit landmarks, built in parallel; the blocked one is dropped
+    LandmarkTable table = LandmarkTable::build(grid, {Vec2i(0, 0), Vec2i(10, 5), Vec2i(19, 9)}, 2);
+    ASSERT_EQ(table.getLandmarkCount(), 2u);
+    EXPECT_EQ(table.distancesAt(15, 5)[0], LandmarkTable::kUnreachable);
+    EXPECT_EQ(table.distance(0, 15, 5), -1);
+    EXPECT_EQ(table.distance(1, 15, 5), 8);
+    
+    // Only landmarks reaching both cells contribute
+    EXPECT_FLOAT_EQ(table.lowerBound(Vec2i(0, 0), Vec2i(9, 9)), 18.0f);
+    EXPECT_FLOAT_EQ(table.lowerBound(Vec2i(15, 5), Vec2i(19, 9)), 8.0f);
+    
+    // Farthest selection covers both halves
+    LandmarkOptions options;
+    options.count = 2;
+    LandmarkTable farthest = LandmarkTable::build(grid, options);
+    ASSERT_EQ(farthest.getLandmarkCount(), 2u);
+    EXPECT_NE(farthest.getLandmarks()[0].x < 10, farthest.getLandmarks()[1].x < 10);
+}
+
+TEST(LandmarkTest, FileRoundTrips) {
+    Grid grid = serpentine(40);
+    LandmarkOptions options;
+    options.count = 5;
+    options.selection = LandmarkSelection::PERIMETER;
+    LandmarkTable table = LandmarkTable::build(grid, options);
+    ASSERT_EQ(table.getLandmarkCount(), 5u);
+    
+    const std::string path = "test_landmarks.alt";
+    ASSERT_TRUE(table.save(path));
+    
+    for (bool memory_map : {true, false}) {
+        LandmarkTable loaded;
+        ASSERT_TRUE(LandmarkTable::load(path, loaded, memory_map));
+        EXPECT_EQ(loaded.isMapped(), memory_map);
+        EXPECT_TRUE(loaded.matches(grid));
+        EXPECT_EQ(loaded.getLandmarks(), table.getLandmarks());
+        EXPECT_EQ(loaded.getSteps(), table.getSteps());
+        for (int y = 0; y < grid.getHeight(); y++) {
+            for (int x = 0; x < grid.getWidth(); x++) {
+                for (size_t k = 0; k < table.getLandmarkCount(); k++) {
+                    ASSERT_EQ(loaded.distancesAt(x, y)[k], table.distancesAt(x, y)[k]);
+                }
+            }
+        }
+    }
+    std::remove(path.c_str());
+    
+    LandmarkTable missing;
+    EXPECT_FALSE(LandmarkTable::load("no_such_table.alt", missing));
+    EXPECT_TRUE(missing.empty());
+}
@@ -0,0 +1,155 @@
+#include <gtest/gtest.h>
+#include "core/lane_planner.h"
+#include "core/spatial_index.h"
+#include <vector>
+
+namespace {
+
+// Three parallel straight lanes along x at y = 10, 13.5, 17
+void addHighway(LanePlanner& planner, float length) {
+    for (int i = 0; i < 3; i++) {
+        Lane lane(i);
+        for (float x = 0.0f; x <= length; x += 10.0f) {
+            lane.centerline.push_back(Vec2(x, 10.0f + i * 3.5f));
+        }
+        if (i > 0) lane.left_lanes.push_back(i - 1);
+        if (i < 2) lane.right_lanes.push_back(i + 1);
+        planner.addLane(lane);
+    }
+}
+
+}  // namespace
+
+TEST(LanePlannerTest, ArcLengthLookup) {
+    Grid grid(100, 100);
+    LanePlanner planner(grid);
+    
+    Lane lane(0);
+    lane.centerline = {Vec2(0, 0), Vec2(3, 4), Vec2(3, 14)};
+    planner.addLane(lane);
+    
+    EXPECT_FLOAT_EQ(planner.getLaneLength(0), 15.0f);
+    
+    Vec2 mid = planner.getLanePosition(0, 2.5f);
+    EXPECT_NEAR(mid.x, 1.5f, 1e-4f);
+    EXPECT_NEAR(mid.y, 2.0f, 1e-4f);
+    
+    Vec2 later = planner.getLanePosition(0, 10.0f);
+    EXPECT_NEAR(later.x, 3.0f, 1e-4f);
+    EXPECT_NEAR(later.y, 9.0f, 1e-4f);
+    
+    // Clamped past the end
+    Vec2 end = planner.getLanePosition(0, 100.0f);
+    EXPECT_NEAR(end.y, 14.0f, 1e-4f);
+}
+
+TEST(LanePlannerTest, ProjectionFindsClosestLane) {
+    Grid grid(200, 50);
+    LanePlanner planner(grid);
+    addHighway(planner, 100.0f);
+    
+    EXPECT_EQ(planner.findClosestLane(Vec2(42.0f, 10.5f)), 0);
+    EXPECT_EQ(planner.findClosestLane(Vec2(42.0f, 13.0f)), 1);
+    EXPECT_EQ(planner.findClosestLane(Vec2(42.0f, 30.0f)), 2);
+    
+    LaneProjection projection = planner.projectOntoLane(2, Vec2(42.0f, 10.0f));
+    EXPECT_EQ(projection.lane_id, 2);
+    EXPECT_NEAR(projection.s, 42.0f, 1e-3f);
+    EXPECT_NEAR(projection.distance, 7.0f, 1e-3f);
+}
+
+TEST(LanePlannerTest, SameLaneRouteHasNoLaneChanges) {
+    Grid grid(200, 50);
+    LanePlanner planner(grid);
+    addHighway(planner, 100.0f);
+    
+    LanePath path = planner.findPath(Vec2(5.0f, 13.5f), Vec2(90.0f, 13.5f));
+    
+    ASSERT_FALSE(path.waypoints.empty());
+    ASSERT_EQ(path.lane_sequence.size(), 1u);
+    EXPECT_EQ(path.lane_sequence[0], 1);
+    EXPECT_TRUE(path.lane_changes.empty());
+    EXPECT_NEAR(path.total_cost, 85.0f, 1e-3f);
+    EXPECT_NEAR(path.waypoints.front().x, 5.0f, 1e-3f);
+    EXPECT_NEAR(path.waypoints.back().x, 90.0f, 1e-3f);
+}
+
+TEST(LanePlannerTest, RouteChangesLanesToReachGoal) {
+    Grid grid(200, 50);
+    LanePlanner planner(grid);
+    addHighway(planner, 100.0f);
+    
+    LanePath path = planner.findPath(Vec2(5.0f, 10.0f), Vec2(95.0f, 17.0f));
+    
+    ASSERT_FALSE(path.waypoints.empty());
+    EXPECT_EQ(path.lane_sequence.front(), 0);
+    EXPECT_EQ(path.lane_sequence.back(), 2);
+    EXPECT_EQ(path.lane_changes.size(), path.lane_sequence.size() - 1);
+    EXPECT_NEAR(path.waypoints.back().x, 95.0f, 1e-3f);
+    EXPECT_NEAR(path.waypoints.back().y, 17.0f, 1e-3f);
+    
+    // Waypoints advance along the road without jumping between lanes
+    for (size_t i = 1; i < path.waypoints.size(); i++) {
+        EXPECT_GE(path.waypoints[i].x, path.waypoints[i - 1].x - 1e-3f);
+        EXPECT_LT(path.waypoints[i].distanceTo(path.waypoints[i - 1]), 12.0f);
+    }
+}
+
+TEST(LanePlannerTest, FollowsSuccessorLanes) {
+    Grid grid(200, 50);
+    LanePlanner planner(grid);
+    
+    Lane first(10);
+    first.centerline = {Vec2(0, 5), Vec2(30, 5)};
+    first.successors.push_back(11);
+    Lane second(11);
+    second.centerline = {Vec2(30, 5), Vec2(30, 35)};
+    planner.addLane(first);
+    planner.addLane(second);
+    
+    LanePath path = planner.findPath(Vec2(2, 5), Vec2(30, 30));
+    
+    ASSERT_EQ(path.lane_sequence.size(), 2u);
+    EXPECT_EQ(path.lane_sequence[0], 10);
+    EXPECT_EQ(path.lane_sequence[1], 11);
+    EXPECT_NEAR(path.waypoints.back().y, 30.0f, 1e-3f);
+    
+    // No successor link backwards, so the reverse trip is impossible
+    LanePath reverse = planner.findPath(Vec2(30, 30), Vec2(2, 5));
+    EXPECT_TRUE(reverse.waypoints.empty());
+}
+
+TEST(LanePlannerTest, RTreeQueriesMatchBruteForce) {
+    std::vector<RTree::Entry> entries;
+    std::vector<BoundingBox> boxes;
+    for (int i = 0; i < 500; i++) {
+        float x = static_cast<float>((i * 37) % 101);
+        float y = static_cast<float>((i * 53) % 97);
+        boxes.emplace_back(x, y, x + 1.0f + i % 3, y + 1.0f + i % 5);
+        entries.emplace_back(boxes.back(), i);
+    }
+    
+    RTree tree(8);
+    tree.build(entries);
+    ASSERT_EQ(tree.size(), 500u);
+    
+    BoundingBox window(20.0f, 30.0f, 45.0f, 50.0f);
+    std::vector<int> found;
+    tree.query(window, found);
+    
+    std::vector<int> expected;
+    for (int i = 0; i < 500; i++) {
+        if (boxes[i].intersects(window)) expected.push_back(i);
+    }
+    std::sort(found.begin(), found.end());
+    EXPECT_EQ(found, expected);
+    
+    Vec2 p(57.3f, 12.9f);
+    float distance = 0.0f;
+    int nearest = tree.nearest(p, [&](int id) { return boxes[id].distanceTo(p); }, &distance);
+    
+    float best = std::numeric_limits<float>::max();
+    for (const auto& box : boxes) best = std::min(best, box.distanceTo(p));
+    ASSERT_GE(nearest, 0);
+    EXPECT_FLOAT_EQ(distance, best);
+}
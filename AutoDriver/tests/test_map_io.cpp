@@ -0,0 +1,245 @@
+#include <gtest/gtest.h>
+#include "core/map_io.h"
+#include "core/grid.h"
+#include "core/random.h"
+#include <fstream>
+#include <cstdio>
+
+namespace {
+
+std::string tempPath(const std::string& name) {
+    return ::testing::TempDir() + "autodriver_" + name;
+}
+
+// Mix of empty, full, sparse and noisy tiles with partial edge tiles
+Grid makeMixedGrid(int width, int height) {
+    Grid grid(width, height);
+    RandomStream rng(7);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            bool full_block = x >= 64 && x < 128 && y < 64;
+            bool wall = y == 100 && x < 150;
+            bool noise = x >= 128 && y >= 64 && rng.uniform(0.0f, 1.0f) < 0.3f;
+            if (full_block || wall || noise) grid.setObstacle(x, y, true);
+        }
+    }
+    return grid;
+}
+
+void expectSameCells(const Grid& a, const Grid& b) {
+    ASSERT_EQ(a.getWidth(), b.getWidth());
+    ASSERT_EQ(a.getHeight(), b.getHeight());
+    int mismatches = 0;
+    for (int y = 0; y < a.getHeight(); y++) {
+        for (int x = 0; x < a.getWidth(); x++) {
+            if (a.isObstacle(x, y) != b.isObstacle(x, y)) mismatches++;
+        }
+    }
+    EXPECT_EQ(mismatches, 0);
+}
+
+// Minimal 8-bit grayscale PNG writer using stored (uncompressed) deflate blocks
+void writeGrayPng(const std::string& path, int width, int height, const std::vector<unsigned char>& pixels) {
+    auto crc32 = [](const std::vector<unsigned char>& data) {
+        uint32_t crc = 0xffffffffu;
+        for (unsigned char byte : data) {
+            crc ^= byte;
+            for (int k = 0; k < 8; k++) crc = (crc >> 1) ^ (0xedb88320u & (0u - (crc & 1u)));
+        }
+        return crc ^ 0xffffffffu;
+    };
+    auto put32 = [](std::vector<unsigned char>& out, uint32_t v) {
+        for (int i = 3; i >= 0; i--) out.push_back(static_cast<unsigned char>(v >> (8 * i)));
+    };
+    
+    std::vector<unsigned char> raw;
+    for (int y = 0; y < height; y++) {
+        raw.push_back(0);  // Filter: none
+        raw.insert(raw.end(), pixels.begin() + y * width, pixels.begin() + (y + 1) * width);
+    }
+    
+    std::vector<unsigned char> zlib = {0x78, 0x01};
+    uint32_t a = 1, b = 0;
+    for (unsigned char byte : raw) {
+        a = (a + byte) % 65521;
+        b = (b + a) % 65521;
+    }
+    for (size_t pos = 0; pos < raw.size(); pos += 65535) {
+        size_t len = std::min<size_t>(65535, raw.size() - pos);
+        zlib.push_back(pos + len == raw.size() ? 1 : 0);
+        zlib.push_back(len & 0xff);
+        zlib.push_back(len >> 8);
+        zlib.push_back(~len & 0xff);
+        zlib.push_back((~len >> 8) & 0xff);
+        zlib.insert(zlib.end(), raw.begin() + pos, raw.begin() + pos + len);
+    }
+    put32(zlib, (b << 16) | a);
+    
+    std::vector<unsigned char> png = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+    auto chunk = [&](const char* type, const std::vector<unsigned char>& data) {
+        put32(png, static_cast<uint32_t>(data.size()));
+        std::vector<unsigned char> body(type, type + 4);
+        body.insert(body.end(), data.begin(), data.end());
+        png.insert(png.end(), body.begin(), body.end());
+        put32(png, crc32(body));
+    };
+    std::vector<unsigned char> ihdr;
+    put32(ihdr, width);
+    put32(ihdr, height);
+    ihdr.insert(ihdr.end(), {8, 0, 0, 0, 0});  // 8-bit gray, no interlace
+    chunk("IHDR", ihdr);
+    chunk("IDAT", zlib);
+    chunk("IEND", {});
+    
+    std::ofstream(path, std::ios::binary).write(reinterpret_cast<const char*>(png.data()), png.size());
+}
+
+}  // namespace
+
+TEST(MapIOTest, RoundTripPreservesCells) {
+    Grid grid = makeMixedGrid(200, 150);
+    
+    for (bool compress : {false, true}) {
+        std::string path = tempPath(compress ? "rle.map" : "raw.map");
+        MapSaveOptions save_options;
+        save_options.compress = compress;
+        MapFileInfo saved;
+        ASSERT_TRUE(MapIO::save(grid, path, save_options, &saved));
+        EXPECT_EQ(saved.empty_tiles + saved.full_tiles + saved.raw_tiles + saved.rle_tiles, 12u);
+        EXPECT_EQ(saved.full_tiles, 1u);
+        EXPECT_GT(compress ? saved.rle_tiles : saved.raw_tiles, 0u);
+        
+        for (bool memory_map : {true, false}) {
+            MapLoadOptions load_options;
+            load_options.memory_map = memory_map;
+            MapLoadResult loaded = MapIO::load(path, load_options);
+            ASSERT_TRUE(loaded.success) << loaded.error;
+            EXPECT_EQ(loaded.memory_mapped, memory_map);
+            EXPECT_EQ(loaded.info.raw_tiles, saved.raw_tiles);
+            EXPECT_EQ(loaded.info.rle_tiles, saved.rle_tiles);
+            expectSameCells(grid, *loaded.grid);
+        }
+        std::remove(path.c_str());
+    }
+}
+
+TEST(MapIOTest, MappedTilesAreCopiedOnWrite) {
+    Grid grid = makeMixedGrid(200, 150);
+    std::string path = tempPath("cow.map");
+    ASSERT_TRUE(MapIO::save(grid, path));
+    
+    {
+        MapLoadResult loaded = MapIO::load(path);
+        ASSERT_TRUE(loaded.success) << loaded.error;
+        Grid& map = *loaded.grid;
+        Grid before = map.snapshot();
+        
+        EXPECT_EQ(map.getTilesCloned(), 0u);
+        map.setObstacle(150, 80, !map.isObstacle(150, 80));
+        EXPECT_EQ(map.getTilesCloned(), 1u);
+        EXPECT_EQ(map.countSharedTiles(before), 11u);
+        EXPECT_NE(map.isObstacle(150, 80), before.isObstacle(150, 80));
+        
+        // Snapshots keep the mapping alive after the loaded grid is gone
+        loaded.grid.reset();
+        expectSameCells(grid, before);
+    }
+    
+    // The file itself is never written through the mapping
+    MapLoadResult reloaded = MapIO::load(path);
+    ASSERT_TRUE(reloaded.success);
+    expectSameCells(grid, *reloaded.grid);
+    std::remove(path.c_str());
+}
+
+TEST(MapIOTest, RejectsCorruptFiles) {
+    Grid grid = makeMixedGrid(200, 150);
+    std::string path = tempPath("corrupt.map");
+    ASSERT_TRUE(MapIO::save(grid, path));
+    
+    std::ifstream in(path, std::ios::binary);
+    std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    in.close();
+    
+    // Truncated data section
+    std::ofstream(path, std::ios::binary).write(bytes.data(), bytes.size() - 100);
+    EXPECT_FALSE(MapIO::load(path).success);
+    
+    // Wrong magic
+    std::string bad = bytes;
+    bad[0] = 'X';
+    std::ofstream(path, std::ios::binary).write(bad.data(), bad.size());
+    EXPECT_FALSE(MapIO::load(path).success);
+    
+    EXPECT_FALSE(MapIO::load(tempPath("missing.map")).success);
+    std::remove(path.c_str());
+}
+
+TEST(MapIOTest, ImportsPgmOccupancyImage) {
+    const int width = 70, height = 3;
+    std::string path = tempPath("map.pgm");
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << "P5\n# occupancy\n" << width << " " << height << "\n255\n";
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) out.put(static_cast<char>(x % 3 == y ? 0 : 254));
+        }
+    }
+    
+    MapLoadResult result = MapIO::importImage(path);
+    ASSERT_TRUE(result.success) << result.error;
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            EXPECT_EQ(result.grid->isObstacle(x, y), x % 3 == y);
+        }
+    }
+    
+    ImageImportOptions negated;
+    negated.negate = true;
+    MapLoadResult inverse = MapIO::importImage(path, negated);
+    ASSERT_TRUE(inverse.success);
+    EXPECT_FALSE(inverse.grid->isObstacle(0, 0));
+    EXPECT_TRUE(inverse.grid->isObstacle(1, 0));
+    std::remove(path.c_str());
+}
+
+TEST(MapIOTest, RejectsPgmLargerThanItsFile) {
+    std::string path = tempPath("huge.pgm");
+    
+    // Header dimensions are checked against the file before the grid exists
+    std::ofstream(path, std::ios::binary) << "P5 2000000000 2000000000 255\n";
+    MapLoadResult binary = MapIO::importImage(path);
+    EXPECT_FALSE(binary.success);
+    EXPECT_FALSE(binary.grid);
+    EXPECT_EQ(binary.error, "truncated PGM raster");
+    
+    std::ofstream(path, std::ios::binary) << "P2 100000 100000 255\n0 0 0 0\n";
+    MapLoadResult ascii = MapIO::importImage(path);
+    EXPECT_FALSE(ascii.success);
+    EXPECT_EQ(ascii.error, "truncated PGM raster");
+    
+    // The tightest ASCII raster still fits
+    std::ofstream(path, std::ios::binary) << "P2 3 1 255 0 0 0";
+    MapLoadResult tight = MapIO::importImage(path);
+    ASSERT_TRUE(tight.success) << tight.error;
+    EXPECT_TRUE(tight.grid->isObstacle(2, 0));
+    std::remove(path.c_str());
+}
+
+TEST(MapIOTest, ImportsPngOccupancyImage) {
+    if (!MapIO::pngSupported()) GTEST_SKIP() << "built without libpng";
+    
+    const int width = 100, height = 80;
+    std::vector<unsigned char> pixels(width * height, 255);
+    for (int y = 10; y < 70; y++) pixels[y * width + 50] = 0;
+    std::string path = tempPath("map.png");
+    writeGrayPng(path, width, height, pixels);
+    
+    MapLoadResult result = MapIO::importImage(path);
+    ASSERT_TRUE(result.success) << result.error;
+    EXPECT_EQ(result.grid->getWidth(), width);
+    EXPECT_TRUE(result.grid->isObstacle(50, 40));
+    EXPECT_FALSE(result.grid->isObstacle(50, 5));
+    EXPECT_FALSE(result.grid->isObstacle(51, 40));
+    std::remove(path.c_str());
+}
@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+#include "core/multi_agent.h"
+#include "core/random.h"
+#include "core/grid.h"
+
+namespace {
+
+void addCrowd(MultiAgentPlanner& planner, const Grid& grid, int count, uint64_t seed) {
+    RandomStream rng(seed);
+    float w = static_cast<float>(grid.getWidth());
+    float h = static_cast<float>(grid.getHeight());
+    for (int i = 0; i < count; i++) {
+        Agent agent(i, Vec2(rng.uniform(0.0f, w), rng.uniform(0.0f, h)), Vec2(0.0f, 0.0f));
+        // Short straight paths, so no planning is needed
+        Vec2 target(rng.uniform(0.0f, w), rng.uniform(0.0f, h));
+        agent.planned_path = {agent.position + (target - agent.position) * 0.5f, target};
+        planner.addAgent(agent);
+    }
+}
+
+}  // namespace
+
+TEST(MultiAgentTest, HeadOnAgentsStaySymmetric) {
+    Grid grid(20, 20);
+    MultiAgentPlanner planner(grid);
+    planner.addAgent(Agent(0, Vec2(4.0f, 10.0f), Vec2(16.0f, 10.0f)));
+    planner.addAgent(Agent(1, Vec2(16.0f, 10.0f), Vec2(4.0f, 10.0f)));
+    planner.planPaths();
+    
+    // Both agents see the same snapshot, so neither gets to move first
+    for (int t = 0; t < 60; t++) {
+        planner.update(0.1f);
+        const auto& x = planner.positionsX();
+        const auto& y = planner.positionsY();
+        ASSERT_NEAR(x[0] - 4.0f, 16.0f - x[1], 1e-4f) << "step " << t;
+        ASSERT_NEAR(y[0], y[1], 1e-4f) << "step " << t;
+    }
+    EXPECT_GT(planner.positionsX()[0], 4.0f);
+}
+
+TEST(MultiAgentTest, BitIdenticalForAnyThreadCount) {
+    Grid grid(200, 200);
+    MultiAgentPlanner serial(grid);
+    MultiAgentPlanner parallel(grid);
+    addCrowd(serial, grid, 3000, 17);
+    addCrowd(parallel, grid, 3000, 17);
+    parallel.setNumThreads(4);
+    
+    for (int t = 0; t < 20; t++) {
+        serial.update(0.1f);
+        parallel.update(0.1f);
+    }
+    
+    ASSERT_EQ(serial.size(), parallel.size());
+    for (size_t i = 0; i < serial.size(); i++) {
+        ASSERT_EQ(serial.positionsX()[i], parallel.positionsX()[i]);
+        ASSERT_EQ(serial.positionsY()[i], parallel.positionsY()[i]);
+        ASSERT_EQ(serial.velocitiesX()[i], parallel.velocitiesX()[i]);
+        ASSERT_EQ(serial.pathIndices()[i], parallel.pathIndices()[i]);
+    }
+}
+
+TEST(MultiAgentTest, AgentsFollowPathsToTheEnd) {
+    Grid grid(20, 20);
+    MultiAgentPlanner planner(grid);
+    planner.addAgent(Agent(7, Vec2(2.0f, 2.0f), Vec2(12.0f, 2.0f)));
+    planner.planPaths();
+    ASSERT_FALSE(planner.getPath(0).empty());
+    
+    for (int t = 0; t < 400 && !planner.isFinished(0); t++) planner.update(0.1f);
+    
+    EXPECT_TRUE(planner.isFinished(0));
+    Agent agent = planner.getAgent(0);
+    EXPECT_EQ(agent.id, 7);
+    EXPECT_LT(agent.position.distanceTo(agent.goal), 0.5f);
+    EXPECT_EQ(agent.velocity.x, 0.0f);
+    EXPECT_EQ(planner.getAgents().size(), 1u);
+}
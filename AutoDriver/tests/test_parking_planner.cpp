@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+#include "core/parking_planner.h"
+#include <cmath>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace {
+
+// Rows of perpendicular spots (4 cells wide, 7 deep) separated by aisles.
+// Every spot whose index is not a multiple of free_every holds a parked car.
+std::vector<ParkingSpot> buildLot(Grid& grid, int rows, int spots_per_row, int free_every) {
+    std::vector<ParkingSpot> spots;
+    for (int r = 0; r < rows; r++) {
+        int y0 = 2 + r * 20;
+        for (int i = 0; i < spots_per_row; i++) {
+            int x0 = 2 + i * 4;
+            ParkingSpot spot(Vec2(x0 + 1.5f, y0 + 3.0f), 4.0f, 7.0f, static_cast<float>(M_PI) / 2.0f, false);
+            
+            int index = static_cast<int>(spots.size());
+            if (index % free_every != 0) {
+                for (int x = x0 + 1; x <= x0 + 2; x++) {
+                    for (int y = y0 + 1; y <= y0 + 5; y++) grid.setObstacle(x, y, true);
+                }
+            }
+            spots.push_back(spot);
+        }
+    }
+    return spots;
+}
+
+}  // namespace
+
+TEST(ParkingPlannerTest, ReedsSheppReachesGoalPose) {
+    Vec2 start(2.0f, 3.0f);
+    Vec2 goal(-4.0f, 7.5f);
+    
+    ReedsSheppPath path = ReedsShepp::shortestPath(start, 0.3f, goal, 2.0f, 4.0f);
+    ASSERT_TRUE(path.valid);
+    EXPECT_GE(path.length, start.distanceTo(goal));
+    
+    HybridState end = ReedsShepp::interpolate(path, start, 0.3f, 4.0f, path.length);
+    EXPECT_NEAR(end.pos.x, goal.x, 1e-3f);
+    EXPECT_NEAR(end.pos.y, goal.y, 1e-3f);
+    EXPECT_NEAR(std::remainder(end.theta - 2.0f, 2.0f * static_cast<float>(M_PI)), 0.0f, 1e-3f);
+    
+    // Pure reverse along a straight line
+    ReedsSheppPath reverse = ReedsShepp::shortestPath(Vec2(10, 0), 0.0f, Vec2(4, 0), 0.0f, 4.0f);
+    ASSERT_TRUE(reverse.valid);
+    EXPECT_NEAR(reverse.length, 6.0f, 1e-3f);
+    EXPECT_EQ(reverse.numCusps(), 0);
+    EXPECT_LT(reverse.segments[0].length, 0.0f);
+}
+
+TEST(ParkingPlannerTest, ParallelParkingEndsInSpot) {
+    Grid grid(40, 30);
+    // Parked cars ahead of and behind the spot
+    for (int x = 4; x <= 9; x++) grid.setObstacle(x, 10, true);
+    for (int x = 21; x <= 26; x++) grid.setObstacle(x, 10, true);
+    
+    VehicleParams params;
+    ParkingPlanner planner(grid, params);
+    ParkingSpot spot(Vec2(15.5f, 10.0f), 2.5f, 9.0f, 0.0f, true);
+    
+    ParkingManeuver maneuver = planner.planParallelParking(Vec2(5.0f, 16.0f), 0.0f, spot);
+    
+    ASSERT_TRUE(maneuver.success);
+    ASSERT_GE(maneuver.path.size(), 2u);
+    EXPECT_NEAR(maneuver.path.back().pos.x, spot.center.x, 1e-2f);
+    EXPECT_NEAR(maneuver.path.back().pos.y, spot.center.y, 1e-2f);
+    EXPECT_GT(maneuver.total_cost, 0.0f);
+}
+
+TEST(ParkingPlannerTest, OccupiedSpotIsRejected) {
+    Grid grid(30, 30);
+    grid.setObstacle(15, 10, true);
+    
+    VehicleParams params;
+    ParkingPlanner planner(grid, params);
+    ParkingSpot spot(Vec2(15.0f, 10.0f), 2.5f, 6.0f, 0.0f, true);
+    
+    EXPECT_FALSE(planner.isSpotAccessible(spot));
+    EXPECT_FALSE(planner.planParallelParking(Vec2(5.0f, 20.0f), 0.0f, spot).success);
+}
+
+TEST(ParkingPlannerTest, FindBestSpotPicksReachableFreeSpot) {
+    Grid grid(100, 60);
+    std::vector<ParkingSpot> spots = buildLot(grid, 3, 24, 7);
+    
+    VehicleParams params;
+    ParkingPlanner planner(grid, params);
+    Vec2 start(30.0f, 15.5f);
+    
+    ParkingSearchResult result = planner.findBestSpot(start, 0.0f, spots);
+    
+    ASSERT_TRUE(result.maneuver.success);
+    ASSERT_GE(result.spot_index, 0);
+    EXPECT_EQ(result.spot_index % 7, 0);
+    EXPECT_GT(result.spots_screened, 0);
+    EXPECT_LE(result.spots_planned, result.spots_screened);
+    
+    const ParkingSpot& spot = spots[result.spot_index];
+    EXPECT_NEAR(result.maneuver.path.back().pos.x, spot.center.x, 1e-2f);
+    EXPECT_NEAR(result.maneuver.path.back().pos.y, spot.center.y, 1e-2f);
+    
+    // Every free spot in the list was screened as reachable or not, but the
+    // chosen one must be at least as cheap as planning it on its own
+    ParkingManeuver single = planner.planPerpendicularParking(start, 0.0f, spot);
+    ASSERT_TRUE(single.success);
+    EXPECT_NEAR(single.total_cost, result.maneuver.total_cost, 1e-3f);
+    
+    // Pruning only skips spots that cannot win
+    for (const ParkingSpot& other : spots) {
+        if (!planner.isSpotAccessible(other)) continue;
+        ParkingManeuver alone = planner.planPerpendicularParking(start, 0.0f, other);
+        if (!alone.success) continue;
+        EXPECT_GE(alone.total_cost, result.maneuver.total_cost - 1e-3f);
+    }
+}
+
+TEST(ParkingPlannerTest, TwoHundredSpotLotFitsTheBudget) {
+    Grid grid(164, 100);
+    std::vector<ParkingSpot> spots = buildLot(grid, 5, 40, 7);
+    ASSERT_EQ(spots.size(), 200u);
+    
+    VehicleParams params;
+    ParkingPlanner planner(grid, params);
+    planner.setNumThreads(1);
+    
+    // Single core, starts spread over the aisles
+    for (Vec2 start : {Vec2(30.0f, 15.5f), Vec2(100.0f, 55.5f), Vec2(150.0f, 95.5f), Vec2(5.0f, 35.5f)}) {
+        ParkingSearchResult result = planner.findBestSpot(start, 0.0f, spots);
+        EXPECT_TRUE(result.maneuver.success);
+        EXPECT_LT(result.planning_time_ms, 100.0);
+    }
+}
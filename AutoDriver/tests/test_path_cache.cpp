@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+#include "core/path_cache.h"
+#include "core/astar.h"
+#include "core/cost_map.h"
+#include "core/grid.h"
+
+TEST(PathCacheTest, RepeatedQueriesSkipTheSearch) {
+    Grid grid(128, 128);
+    AStar astar(grid);
+    PathCache cache;
+    
+    AStarResult planned = cache.findPath(astar, Vec2i(3, 3), Vec2i(40, 20));
+    AStarResult cached = cache.findPath(astar, Vec2i(3, 3), Vec2i(40, 20));
+    ASSERT_TRUE(planned.success);
+    EXPECT_GT(planned.nodes_expanded, 0);
+    EXPECT_TRUE(cached.success);
+    EXPECT_EQ(cached.nodes_expanded, 0);
+    EXPECT_EQ(cached.path, planned.path);
+    EXPECT_FLOAT_EQ(cached.path_cost, planned.path_cost);
+    
+    // Another config is another entry
+    cache.findPath(astar, Vec2i(3, 3), Vec2i(40, 20), 7);
+    CostMap costs(128, 128);
+    astar.setCostMap(&costs);
+    cache.findPath(astar, Vec2i(3, 3), Vec2i(40, 20));
+    
+    PathCacheStats stats = cache.getStats();
+    EXPECT_EQ(stats.hits, 1u);
+    EXPECT_EQ(stats.misses, 3u);
+    EXPECT_EQ(cache.size(), 3u);
+}
+
+TEST(PathCacheTest, CostEditsForceAFreshSearch) {
+    Grid grid(64, 64);
+    CostMap costs(64, 64);
+    CostLayer layer(64, 64);
+    costs.setLayer("zone", layer);
+    AStar astar(grid);
+    astar.setCostMap(&costs);
+    PathCache cache;
+    
+    AStarResult planned = cache.findPath(astar, Vec2i(0, 10), Vec2i(40, 10));
+    EXPECT_EQ(cache.findPath(astar, Vec2i(0, 10), Vec2i(40, 10)).nodes_expanded, 0);
+    
+    // Same map object, new costs: the cached path no longer applies
+    costs.getMutableLayer("zone")->set(20, 10, 5.0f);
+    costs.rebuild();
+    AStarResult replanned = cache.findPath(astar, Vec2i(0, 10), Vec2i(40, 10));
+    ASSERT_TRUE(replanned.success);
+    EXPECT_GT(replanned.nodes_expanded, 0);
+    EXPECT_EQ(cache.getStats().hits, 1u);
+    EXPECT_LE(replanned.path_cost, planned.path_cost + 5.0f);
+    EXPECT_NE(replanned.path, planned.path);
+}
+
+TEST(PathCacheTest, OnlyEditsNearThePathInvalidate) {
+    Grid grid(256, 256);   // 4 x 4 tiles
+    AStar astar(grid);
+    PathCache cache;
+    const PathCacheKey key(Vec2i(5, 5), Vec2i(63, 50));
+    
+    cache.insert(grid, key, astar.findPath(key.start, key.goal));
+    
+    // Far tiles, and a snapshot taken after the edit, still hit
+    grid.setObstacle(200, 200, true);
+    grid.setObstacle(130, 10, true);
+    Grid snapshot = grid.snapshot();
+    AStarResult out;
+    EXPECT_TRUE(cache.lookup(grid, key, out));
+    EXPECT_TRUE(cache.lookup(snapshot, key, out));
+    
+    // Just past the tile border counts: the box grows by one cell
+    grid.setObstacle(64, 30, true);
+    EXPECT_FALSE(cache.lookup(grid, key, out));
+    EXPECT_EQ(cache.size(), 0u);
+    EXPECT_EQ(cache.getStats().invalidations, 1u);
+    
+    // The stale snapshot still sees the old map, but the entry is gone
+    EXPECT_FALSE(cache.lookup(snapshot, key, out));
+}
+
+TEST(PathCacheTest, FailuresExpireOnAnyEdit) {
+    Grid grid(200, 100);
+    for (int y = 0; y < 100; y++) grid.setObstacle(100, y, true);
+    AStar astar(grid);
+    PathCache cache;
+    const PathCacheKey key(Vec2i(10, 50), Vec2i(190, 50));
+    
+    Grid before = grid.snapshot();
+    cache.insert(grid, key, astar.findPath(key.start, key.goal));
+    AStarResult out;
+    ASSERT_TRUE(cache.lookup(grid, key, out));
+    EXPECT_FALSE(out.success);
+    
+    // Grids older than the entry miss
+    Grid older(200, 100);
+    EXPECT_FALSE(cache.lookup(older, key, out));
+    EXPECT_TRUE(cache.lookup(before, key, out));
+    
+    grid.setObstacle(199, 0, true);
+    EXPECT_FALSE(cache.lookup(grid, key, out));
+}
+
+TEST(PathCacheTest, EvictsLeastRecentlyUsed) {
+    Grid grid(64, 64);
+    AStar astar(grid);
+    PathCache cache(2);
+    
+    cache.findPath(astar, Vec2i(0, 0), Vec2i(10, 0));
+    cache.findPath(astar, Vec2i(0, 0), Vec2i(20, 0));
+    cache.findPath(astar, Vec2i(0, 0), Vec2i(10, 0));   // Refreshes the first
+    cache.findPath(astar, Vec2i(0, 0), Vec2i(30, 0));   // Evicts the second
+    
+    AStarResult out;
+    EXPECT_TRUE(cache.lookup(grid, PathCacheKey(Vec2i(0, 0), Vec2i(10, 0)), out));
+    EXPECT_FALSE(cache.lookup(grid, PathCacheKey(Vec2i(0, 0), Vec2i(20, 0)), out));
+    EXPECT_TRUE(cache.lookup(grid, PathCacheKey(Vec2i(0, 0), Vec2i(30, 0)), out));
+    EXPECT_EQ(cache.getStats().evictions, 1u);
+    
+    cache.setCapacity(0);
+    EXPECT_EQ(cache.size(), 0u);
+    cache.findPath(astar, Vec2i(0, 0), Vec2i(10, 0));
+    EXPECT_EQ(cache.size(), 0u);
+}
@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+#include "core/path_database.h"
+#include "core/astar.h"
+#include "core/grid.h"
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+// Rooms joined by doors, plus a walled-off pocket in the corner
+Grid warehouse() {
+    Grid grid(24, 18);
+    for (int y = 0; y < 18; y++) {
+        if (y != 4 && y != 13) grid.setObstacle(8, y, true);
+        if (y != 9) grid.setObstacle(16, y, true);
+    }
+    for (int x = 0; x < 8; x++) {
+        if (x != 3) grid.setObstacle(x, 9, true);
+    }
+    for (int x = 20; x < 24; x++) grid.setObstacle(x, 14, true);
+    for (int y = 14; y < 18; y++) grid.setObstacle(20, y, true);
+    return grid;
+}
+
+bool isConnected(const Grid& grid, const std::vector<Vec2i>& path) {
+    for (size_t i = 0; i < path.size(); i++) {
+        if (grid.isObstacle(path[i].x, path[i].y)) return false;
+        if (i > 0 && std::abs(path[i].x - path[i - 1].x) + std::abs(path[i].y - path[i - 1].y) != 1) return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+TEST(PathDatabaseTest, MatchesAStarOnEveryPair) {
+    Grid grid = warehouse();
+    PathDatabase db = PathDatabase::build(grid);
+    ASSERT_TRUE(db.matches(grid));
+    EXPECT_LT(db.getRunCount(), db.getNodeCount() * db.getNodeCount() / 8);   // Rows compress
+    
+    AStar astar(grid);
+    std::vector<Vec2i> cells;
+    for (int y = 0; y < grid.getHeight(); y += 3) {
+        for (int x = 0; x < grid.getWidth(); x += 2) {
+            if (!grid.isObstacle(x, y)) cells.push_back(Vec2i(x, y));
+        }
+    }
+    cells.push_back(Vec2i(22, 16));   // Inside the pocket
+    
+    for (const Vec2i& a : cells) {
+        for (const Vec2i& b : cells) {
+            AStarResult expected = astar.findPath(a, b);
+            AStarResult path = db.findPath(a, b);
+            ASSERT_EQ(path.success, expected.success);
+            if (!expected.success) {
+                EXPECT_EQ(db.distance(a, b), -1);
+                continue;
+            }
+            EXPECT_FLOAT_EQ(path.path_cost, expected.path_cost);
+            EXPECT_EQ(db.distance(a, b), static_cast<int>(expected.path_cost));
+            EXPECT_EQ(path.path.front(), a);
+            EXPECT_EQ(path.path.back(), b);
+            EXPECT_TRUE(isConnected(grid, path.path));
+            EXPECT_EQ(path.nodes_expanded, static_cast<int>(path.path.size()) - 1);
+        }
+    }
+}
+
+TEST(PathDatabaseTest, RejectsBlockedAndTrivialQueries) {
+    Grid grid = warehouse();
+    PathDatabase db = PathDatabase::build(grid);
+    
+    EXPECT_FALSE(db.findPath(Vec2i(8, 0), Vec2i(0, 0)).success);     // Start in a wall
+    EXPECT_FALSE(db.findPath(Vec2i(0, 0), Vec2i(99, 0)).success);    // Goal off the map
+    EXPECT_FALSE(db.findPath(Vec2i(0, 0), Vec2i(22, 16)).success);   // Other component
+    EXPECT_EQ(db.firstMove(Vec2i(0, 0), Vec2i(22, 16)), -1);
+    
+    AStarResult same = db.findPath(Vec2i(5, 5), Vec2i(5, 5));
+    ASSERT_TRUE(same.success);
+    EXPECT_EQ(same.path.size(), 1u);
+    EXPECT_EQ(db.distance(Vec2i(5, 5), Vec2i(5, 5)), 0);
+    EXPECT_EQ(db.firstMove(Vec2i(5, 5), Vec2i(6, 5)), 3);   // Right
+    
+    EXPECT_TRUE(PathDatabase::build(Grid(0, 0)).empty());
+}
+
+TEST(PathDatabaseTest, BuildIsIndependentOfThreadCount) {
+    Grid grid = warehouse();
+    PathDatabaseOptions serial;
+    serial.num_threads = 1;
+    PathDatabaseOptions parallel;
+    parallel.num_threads = 4;
+    PathDatabase a = PathDatabase::build(grid, serial);
+    PathDatabase b = PathDatabase::build(grid, parallel);
+    
+    ASSERT_EQ(a.getRunCount(), b.getRunCount());
+    for (int y = 0; y < grid.getHeight(); y++) {
+        for (int x = 0; x < grid.getWidth(); x++) {
+            EXPECT_EQ(a.firstMove(Vec2i(1, 1), Vec2i(x, y)), b.firstMove(Vec2i(1, 1), Vec2i(x, y)));
+            EXPECT_EQ(a.firstMove(Vec2i(x, y), Vec2i(23, 0)), b.firstMove(Vec2i(x, y), Vec2i(23, 0)));
+        }
+    }
+}
+
+TEST(PathDatabaseTest, FileRoundTrips) {
+    Grid grid = warehouse();
+    PathDatabase db = PathDatabase::build(grid);
+    const std::string path = "test_path_database.cpd";
+    ASSERT_TRUE(db.save(path));
+    
+    for (bool memory_map : {true, false}) {
+        PathDatabase loaded;
+        ASSERT_TRUE(PathDatabase::load(path, loaded, memory_map));
+        EXPECT_EQ(loaded.isMapped(), memory_map);
+        EXPECT_TRUE(loaded.matches(grid));
+        EXPECT_TRUE(loaded.matches(grid.snapshot()));
+        EXPECT_EQ(loaded.getNodeCount(), db.getNodeCount());
+        EXPECT_EQ(loaded.getRunCount(), db.getRunCount());
+        for (int y = 0; y < grid.getHeight(); y++) {
+            for (int x = 0; x < grid.getWidth(); x++) {
+                ASSERT_EQ(loaded.distance(Vec2i(0, 17), Vec2i(x, y)), db.distance(Vec2i(0, 17), Vec2i(x, y)));
+            }
+        }
+    }
+    std::remove(path.c_str());
+    
+    // A map of the same size with other walls is not the one it answers for
+    Grid other = warehouse();
+    other.setObstacle(12, 2, true);
+    EXPECT_FALSE(db.matches(other));
+    other.setObstacle(12, 2, false);
+    EXPECT_TRUE(db.matches(other));
+    
+    PathDatabase missing;
+    EXPECT_FALSE(PathDatabase::load("no_such_database.cpd", missing));
+    EXPECT_TRUE(missing.empty());
+}
@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 #include "core/path_smoothing.h"
 #include "core/grid.h"
+#include "core/astar.h"
 
 TEST(PathSmoothingTest, BezierCreatesMorePoints) {
     std::vector<Vec2> path = {
@@ -115,3 +116,154 @@ TEST(PathSmoothingTest, CombinedSmoothingWorks) {
     EXPECT_FALSE(smoothed.empty());
     EXPECT_GT(smoothed.size(), 0);
 }
+
+// Serpentine corridor: long A* path with many collinear waypoints
+static std::vector<Vec2> serpentinePath(Grid& grid) {
+    for (int y = 10; y < grid.getHeight(); y += 10) {
+        for (int x = 0; x < grid.getWidth(); x++) grid.setObstacle(x, y, true);
+        grid.setObstacle((y / 10) % 2 ? grid.getWidth() - 5 : 4, y, false);
+    }
+    
+    AStar astar(grid);
+    auto result = astar.findPath(Vec2i(0, 0), Vec2i(grid.getWidth() - 1, grid.getHeight() - 1));
+    
+    std::vector<Vec2> path;
+    for (const auto& cell : result.path) path.push_back(Vec2(cell.x, cell.y));
+    return path;
+}
+
+TEST(PathSmoothingTest, GreedyShortcutKeepsPathCollisionFree) {
+    Grid grid(100, 100);
+    auto path = serpentinePath(grid);
+    ASSERT_GT(path.size(), 500u);
+    
+    VisibilityCache cache(path, grid);
+    auto kept = PathSmoothing::greedyShortcut(cache);
+    
+    ASSERT_GE(kept.size(), 2u);
+    EXPECT_EQ(kept.front(), 0u);
+    EXPECT_EQ(kept.back(), path.size() - 1);
+    EXPECT_LT(kept.size(), 60u);  // Roughly two corners per corridor
+    
+    // Kept indices increase and every shortcut is clear of obstacles
+    for (size_t k = 1; k < kept.size(); k++) {
+        EXPECT_LT(kept[k - 1], kept[k]);
+        Vec2 a = path[kept[k - 1]];
+        Vec2 b = path[kept[k]];
+        for (int s = 0; s <= 100; s++) {
+            Vec2 p = a + (b - a) * (s / 100.0f);
+            EXPECT_FALSE(grid.isObstacle(static_cast<int>(std::round(p.x)),
+                                         static_cast<int>(std::round(p.y))));
+        }
+    }
+    
+    // Queries repeated by the randomized pass are served from the cache
+    size_t misses = cache.getMisses();
+    auto refined = PathSmoothing::randomShortcut(cache, kept, 8, 2, 1);
+    EXPECT_LE(refined.size(), kept.size());
+    EXPECT_GT(cache.getHits(), 0u);
+    EXPECT_GE(cache.getMisses(), misses);
+}
+
+TEST(PathSmoothingTest, RandomShortcutIndependentOfThreadCount) {
+    Grid grid(60, 60);
+    auto path = serpentinePath(grid);
+    
+    std::vector<size_t> all(path.size());
+    for (size_t i = 0; i < all.size(); i++) all[i] = i;
+    
+    VisibilityCache cache_a(path, grid);
+    VisibilityCache cache_b(path, grid);
+    auto single = PathSmoothing::randomShortcut(cache_a, all, 16, 1, 42);
+    auto multi = PathSmoothing::randomShortcut(cache_b, all, 16, 4, 42);
+    
+    EXPECT_EQ(single, multi);
+    EXPECT_LT(single.size(), path.size());
+    EXPECT_EQ(single.front(), 0u);
+    EXPECT_EQ(single.back(), path.size() - 1);
+}
+
+TEST(PathSmoothingTest, GradientSmoothConvergesEarly) {
+    Grid grid(40, 40);
+    for (int y = 0; y < 25; y++) grid.setObstacle(20, y, true);
+    
+    // Dense staircase around the end of a wall
+    std::vector<Vec2> path;
+    for (int x = 2; x <= 18; x++) path.push_back(Vec2(x, 5.0f));
+    for (int y = 6; y <= 28; y++) path.push_back(Vec2(18.0f, y));
+    for (int x = 19; x <= 36; x++) path.push_back(Vec2(x, 28.0f));
+    
+    GradientSmoothOptions options;
+    options.max_iterations = 2000;
+    options.alpha = 0.5f;
+    options.tolerance = 2e-3f;
+    
+    GradientSmoothStats stats;
+    auto smoothed = PathSmoothing::gradientSmooth(path, grid, options, &stats);
+    
+    ASSERT_EQ(smoothed.size(), path.size());
+    EXPECT_TRUE(stats.converged);
+    EXPECT_LT(stats.iterations, options.max_iterations);
+    EXPECT_LT(stats.exact_checks, stats.segment_checks);
+    
+    // Endpoints fixed, no waypoint or segment inside the wall
+    EXPECT_FLOAT_EQ(smoothed.front().x, path.front().x);
+    EXPECT_FLOAT_EQ(smoothed.back().y, path.back().y);
+    for (size_t i = 0; i + 1 < smoothed.size(); i++) {
+        Vec2 a = smoothed[i];
+        Vec2 b = smoothed[i + 1];
+        for (int s = 0; s <= 10; s++) {
+            Vec2 p = a + (b - a) * (s / 10.0f);
+            EXPECT_FALSE(grid.isObstacle(static_cast<int>(std::round(p.x)),
+                                         static_cast<int>(std::round(p.y))));
+        }
+    }
+}
+
+TEST(PathSmoothingTest, SplineOutputDependsOnLengthNotDensity) {
+    std::vector<Vec2> sparse = {Vec2(0.0f, 0.0f), Vec2(30.0f, 0.0f), Vec2(30.0f, 30.0f)};
+    std::vector<Vec2> dense;
+    for (int x = 0; x <= 30; x++) dense.push_back(Vec2(x, 0.0f));
+    for (int y = 1; y <= 30; y++) dense.push_back(Vec2(30.0f, y));
+    
+    SplineOptions options;
+    options.spacing = 0.5f;
+    auto a = PathSmoothing::fitSpline(sparse, options);
+    auto b = PathSmoothing::fitSpline(dense, options);
+    
+    // About length / spacing samples either way
+    EXPECT_NEAR(static_cast<float>(a.points.size()), a.length / 0.5f + 1.0f, 1.0f);
+    EXPECT_NEAR(static_cast<float>(b.points.size()), b.length / 0.5f + 1.0f, 1.0f);
+    EXPECT_LT(std::abs(static_cast<int>(a.points.size()) - static_cast<int>(b.points.size())), 10);
+    
+    // Interpolates the endpoints with near-uniform spacing
+    EXPECT_NEAR(a.points.front().x, 0.0f, 1e-4f);
+    EXPECT_NEAR(a.points.back().y, 30.0f, 1e-4f);
+    for (size_t i = 1; i < a.points.size(); i++) {
+        EXPECT_NEAR((a.points[i] - a.points[i - 1]).length(), 0.5f, 0.05f);
+    }
+    EXPECT_EQ(a.curvature.size(), a.points.size());
+    EXPECT_TRUE(a.curvature_feasible);
+}
+
+TEST(PathSmoothingTest, SplineRespectsMinTurnRadius) {
+    Grid grid(50, 50);
+    std::vector<Vec2> path;
+    for (int x = 5; x <= 35; x++) path.push_back(Vec2(x, 5.0f));
+    for (int y = 6; y <= 35; y++) path.push_back(Vec2(35.0f, y));
+    
+    VehicleParams vehicle;
+    vehicle.min_turn_radius = 5.0f;
+    
+    auto unbounded = PathSmoothing::fitSpline(path);
+    EXPECT_GT(unbounded.max_curvature, 1.0f / vehicle.min_turn_radius);
+    
+    auto bounded = PathSmoothing::fitSpline(path, vehicle, 0.5f, &grid);
+    EXPECT_TRUE(bounded.curvature_feasible);
+    EXPECT_LE(bounded.max_curvature, 1.001f / vehicle.min_turn_radius);
+    EXPECT_GT(bounded.refinements, 0);
+    
+    // Endpoints stay put
+    EXPECT_NEAR(bounded.points.front().x, 5.0f, 1e-4f);
+    EXPECT_NEAR(bounded.points.back().y, 35.0f, 1e-4f);
+}
@@ -0,0 +1,147 @@
+#include <gtest/gtest.h>
+#include "core/planning_service.h"
+#include "core/grid.h"
+#include <atomic>
+#include <memory>
+#include <thread>
+
+TEST(PlanningServiceTest, QueriesSeePrecedingMapDeltas) {
+    Grid grid(30, 30);
+    PlanningService service(grid, 2);
+    
+    auto open = service.submit(PlanningRequest(Vec2i(2, 15), Vec2i(27, 15))).get();
+    EXPECT_TRUE(open.success);
+    EXPECT_EQ(open.map_version, 0u);
+    
+    // Wall across the whole map: the next query must be planned on it
+    std::vector<CellEdit> wall;
+    for (int y = 0; y < 30; y++) wall.emplace_back(15, y, true);
+    service.updateMap(wall);
+    
+    auto blocked = service.submit(PlanningRequest(Vec2i(2, 15), Vec2i(27, 15))).get();
+    EXPECT_FALSE(blocked.success);
+    EXPECT_EQ(blocked.map_version, 1u);
+    EXPECT_GT(blocked.request_id, open.request_id);
+    
+    // Opening a gap is again visible to the following query
+    service.updateMap({CellEdit(15, 3, false)});
+    auto detour = service.submit(PlanningRequest(Vec2i(2, 15), Vec2i(27, 15))).get();
+    EXPECT_TRUE(detour.success);
+    EXPECT_EQ(detour.map_version, 2u);
+    EXPECT_GT(detour.path_cost, open.path_cost);
+}
+
+TEST(PlanningServiceTest, SnapshotsAreImmutableAndShareTiles) {
+    Grid grid(20, 20);
+    PlanningService service(grid, 1);
+    
+    MapSnapshot held = service.snapshot();
+    
+    for (int i = 0; i < 10; i++) {
+        service.updateMap({CellEdit(i, 5, true)});
+        service.drain();
+    }
+    
+    // The held version never changes under the reader
+    for (int i = 0; i < 10; i++) EXPECT_FALSE(held.grid->isObstacle(i, 5));
+    
+    MapSnapshot current = service.snapshot();
+    EXPECT_EQ(current.version, 10u);
+    for (int i = 0; i < 10; i++) EXPECT_TRUE(current.grid->isObstacle(i, 5));
+    
+    // Each batch clones only the tile it touched, and only while an older
+    // version still holds that tile
+    ServiceStats stats = service.getStats();
+    EXPECT_EQ(stats.snapshots_published, 10u);
+    EXPECT_EQ(stats.cells_edited, 10u);
+    EXPECT_LE(stats.tiles_copied, 10u);
+}
+
+TEST(PlanningServiceTest, LoadGeneratorReportsLatencyUnderUpdates) {
+    Grid grid(64, 64);
+    for (int y = 10; y < 54; y++) grid.setObstacle(32, y, true);
+    PlanningService service(grid, 2);
+    
+    LoadTestConfig config;
+    config.query_threads = 3;
+    config.queries_per_thread = 20;
+    config.update_threads = 1;
+    config.updates_per_second = 1000;
+    config.edits_per_update = 8;
+    config.seed = 7;
+    
+    LoadTestReport report = service.runLoadTest(config);
+    
+    EXPECT_EQ(report.queries, 60u);
+    EXPECT_GT(report.successful, 0u);
+    EXPECT_GT(report.updates, 0u);
+    EXPECT_GE(report.versions_observed, 1u);
+    EXPECT_LE(report.p50_ms, report.p99_ms);
+    EXPECT_LE(report.p99_ms, report.max_ms);
+    EXPECT_GT(report.queries_per_second, 0.0);
+    
+    // Blinking obstacles are cleared again at the end
+    service.drain();
+    MapSnapshot after = service.snapshot();
+    for (int y = 0; y < 64; y++) {
+        for (int x = 0; x < 64; x++) {
+            EXPECT_EQ(after.grid->isObstacle(x, y), grid.isObstacle(x, y));
+        }
+    }
+    
+    ServiceStats stats = service.getStats();
+    EXPECT_EQ(stats.queries_completed, stats.queries_submitted);
+}
+
+TEST(PlanningServiceTest, RepeatedRoutesComeFromThePathCache) {
+    Grid grid(200, 200);
+    PlanningService service(grid, 1);
+    const PlanningRequest route(Vec2i(5, 5), Vec2i(50, 40));
+    
+    auto first = service.submit(route).get();
+    auto second = service.submit(route).get();
+    ASSERT_TRUE(first.success);
+    EXPECT_EQ(second.path.size(), first.path.size());
+    EXPECT_FLOAT_EQ(second.path_cost, first.path_cost);
+    EXPECT_EQ(service.getStats().path_cache.hits, 1u);
+    
+    // An edit in a far tile keeps the entry, one next to the route drops it
+    service.updateMap({CellEdit(150, 150, true)});
+    EXPECT_TRUE(service.submit(route).get().success);
+    EXPECT_EQ(service.getStats().path_cache.hits, 2u);
+    
+    service.updateMap({CellEdit(60, 60, true)});
+    auto replanned = service.submit(route).get();
+    EXPECT_TRUE(replanned.success);
+    ServiceStats stats = service.getStats();
+    EXPECT_EQ(stats.path_cache.hits, 2u);
+    EXPECT_EQ(stats.path_cache.invalidations, 1u);
+}
+
+TEST(PlanningServiceTest, StopAnswersProducersRacingWithIt) {
+    Grid grid(20, 20);
+    auto service = std::make_unique<PlanningService>(grid, 2);
+    
+    std::atomic<bool> go(false);
+    std::vector<std::vector<std::future<PlanningResponse>>> futures(4);
+    std::vector<std::thread> producers;
+    for (size_t p = 0; p < futures.size(); p++) {
+        producers.emplace_back([&, p]() {
+            while (!go.load()) std::this_thread::yield();
+            for (int i = 0; i < 200; i++) {
+                futures[p].push_back(service->submit(PlanningRequest(Vec2i(0, 0), Vec2i(19, 19))));
+                if (i % 50 == 0) service->drain();   // Must return, not hang
+            }
+        });
+    }
+    go = true;
+    service->stop();
+    for (auto& producer : producers) producer.join();
+    
+    // Every future resolves, answered or failed
+    for (auto& list : futures) {
+        for (auto& future : list) {
+            ASSERT_EQ(future.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+        }
+    }
+}
@@ -0,0 +1,59 @@
+#include <gtest/gtest.h>
+#include "core/random.h"
+#include <vector>
+
+TEST(RandomStreamTest, SameSeedSameSequence) {
+    RandomStream a(1234);
+    RandomStream b(1234);
+    
+    for (int i = 0; i < 100; i++) {
+        EXPECT_EQ(a(), b());
+    }
+}
+
+TEST(RandomStreamTest, DifferentStreamsDiffer) {
+    RandomStream base(1234);
+    RandomStream s0 = base.split(0);
+    RandomStream s1 = base.split(1);
+    
+    int equal = 0;
+    for (int i = 0; i < 100; i++) {
+        if (s0() == s1()) equal++;
+    }
+    EXPECT_EQ(equal, 0);
+}
+
+TEST(RandomStreamTest, CounterAddressable) {
+    RandomStream rng(7, 3);
+    uint64_t fifth = rng.at(5);
+    
+    for (int i = 0; i < 5; i++) rng();
+    EXPECT_EQ(rng(), fifth);
+    EXPECT_EQ(rng.getCounter(), 6u);
+}
+
+TEST(RandomStreamTest, BulkFillMatchesSequentialDraws) {
+    RandomStream bulk(99);
+    RandomStream single(99);
+    
+    std::vector<float> buffer(37);
+    bulk.fillUniform(buffer.data(), buffer.size(), -2.0f, 3.0f);
+    
+    for (float value : buffer) {
+        EXPECT_FLOAT_EQ(value, single.uniform(-2.0f, 3.0f));
+    }
+    EXPECT_EQ(bulk.getCounter(), single.getCounter());
+}
+
+TEST(RandomStreamTest, UniformInRange) {
+    RandomStream rng(5);
+    double sum = 0.0;
+    
+    for (int i = 0; i < 10000; i++) {
+        float u = rng.uniform();
+        EXPECT_GE(u, 0.0f);
+        EXPECT_LT(u, 1.0f);
+        sum += u;
+    }
+    EXPECT_NEAR(sum / 10000.0, 0.5, 0.02);
+}
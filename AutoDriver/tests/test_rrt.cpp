@@ -8,6 +8,8 @@ protected:
         grid = std::make_unique<Grid>(20, 20);
         rrt_planner = std::make_unique<RRT>(*grid);
         rrt_star_planner = std::make_unique<RRTStar>(*grid);
+        rrt_planner->setCapture(SearchCapture::intoResults());
+        rrt_star_planner->setCapture(SearchCapture::intoResults());
     }
     
     std::unique_ptr<Grid> grid;
@@ -101,3 +103,123 @@ TEST_F(RRTTest, PathIsConnected) {
         }
     }
 }
+
+TEST_F(RRTTest, AnytimeRRTStarRefinesTowardOptimal) {
+    Vec2 start(2.0f, 2.0f);
+    Vec2 goal(18.0f, 18.0f);
+    
+    rrt_star_planner->setNumThreads(2);
+    auto result = rrt_star_planner->findPathAnytime(start, goal, 200.0, 20000);
+    
+    ASSERT_TRUE(result.success);
+    EXPECT_EQ(result.path.front().x, start.x);
+    EXPECT_EQ(result.path.back().x, goal.x);
+    
+    // Empty map: refined path should be close to the straight line
+    EXPECT_LT(result.path_cost, start.distanceTo(goal) * 1.1f);
+}
+
+TEST_F(RRTTest, AnytimeRRTStarPathStaysCollisionFree) {
+    for (int y = 0; y < 15; y++) {
+        grid->setObstacle(10, y, true);
+    }
+    
+    Vec2 start(5.0f, 5.0f);
+    Vec2 goal(15.0f, 5.0f);
+    
+    rrt_star_planner->setNumThreads(3);
+    auto result = rrt_star_planner->findPathAnytime(start, goal, 100.0, 20000);
+    
+    ASSERT_TRUE(result.success);
+    for (size_t i = 0; i + 1 < result.path.size(); i++) {
+        Vec2 a = result.path[i];
+        Vec2 b = result.path[i + 1];
+        // Same sampling resolution as RRT::isCollisionFree (2 checks per unit)
+        int checks = std::max(1, static_cast<int>(std::ceil(a.distanceTo(b) * 2.0f)));
+        for (int k = 0; k <= checks; k++) {
+            Vec2 p = a + (b - a) * (static_cast<float>(k) / checks);
+            EXPECT_FALSE(grid->isObstacle(static_cast<int>(std::round(p.x)),
+                                          static_cast<int>(std::round(p.y))));
+        }
+    }
+}
+
+TEST_F(RRTTest, RRTConnectFindsPathInEmptyGrid) {
+    RRTConnect planner(*grid);
+    Vec2 start(2.0f, 2.0f);
+    Vec2 goal(18.0f, 18.0f);
+    
+    auto result = planner.findPath(start, goal, 2000);
+    
+    ASSERT_TRUE(result.success);
+    EXPECT_FLOAT_EQ(result.path.front().x, start.x);
+    EXPECT_FLOAT_EQ(result.path.front().y, start.y);
+    EXPECT_FLOAT_EQ(result.path.back().x, goal.x);
+    EXPECT_FLOAT_EQ(result.path.back().y, goal.y);
+}
+
+TEST_F(RRTTest, RRTConnectThroughNarrowPassage) {
+    // Wall with a two-cell gap
+    for (int y = 0; y < 20; y++) {
+        if (y != 15 && y != 16) {
+            grid->setObstacle(10, y, true);
+        }
+    }
+    
+    RRTConnect planner(*grid);
+    Vec2 start(3.0f, 5.0f);
+    Vec2 goal(17.0f, 5.0f);
+    
+    auto result = planner.findPath(start, goal, 5000);
+    
+    ASSERT_TRUE(result.success);
+    float length = 0.0f;
+    for (size_t i = 0; i + 1 < result.path.size(); i++) {
+        float step = result.path[i].distanceTo(result.path[i + 1]);
+        EXPECT_LE(step, 1.0f + 1e-4f);  // Default step size
+        length += step;
+    }
+    EXPECT_NEAR(result.path_cost, length, 1e-3f);
+}
+
+TEST_F(RRTTest, SeededRunsAreReproducible) {
+    Vec2 start(2.0f, 2.0f);
+    Vec2 goal(18.0f, 18.0f);
+    
+    RRT a(*grid);
+    RRT b(*grid);
+    a.setSeed(2024);
+    b.setSeed(2024);
+    a.setCapture(SearchCapture::intoResults());
+    b.setCapture(SearchCapture::intoResults());
+    
+    auto ra = a.findPath(start, goal, 2000);
+    auto rb = b.findPath(start, goal, 2000);
+    
+    EXPECT_EQ(ra.iterations, rb.iterations);
+    ASSERT_EQ(ra.tree_nodes.size(), rb.tree_nodes.size());
+    for (size_t i = 0; i < ra.tree_nodes.size(); i++) {
+        EXPECT_EQ(ra.tree_nodes[i].x, rb.tree_nodes[i].x);
+        EXPECT_EQ(ra.tree_nodes[i].y, rb.tree_nodes[i].y);
+    }
+}
+
+TEST_F(RRTTest, DeterministicAnytimeAtFixedThreadCount) {
+    Vec2 start(2.0f, 2.0f);
+    Vec2 goal(18.0f, 18.0f);
+    
+    auto run = [&]() {
+        RRTStar planner(*grid);
+        planner.setSeed(77);
+        planner.setNumThreads(3);
+        planner.setCapture(SearchCapture::intoResults());
+        return planner.findPathDeterministic(start, goal, 3000);
+    };
+    
+    auto first = run();
+    auto second = run();
+    
+    ASSERT_TRUE(first.success);
+    EXPECT_EQ(first.path_cost, second.path_cost);
+    EXPECT_EQ(first.tree_nodes.size(), second.tree_nodes.size());
+}
@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+#include "benchmark/scenario_corpus.h"
+#include "benchmark/benchmark_suite.h"
+#include <fstream>
+#include <cmath>
+#include <cstdio>
+
+namespace {
+
+std::string tempPath(const std::string& name) {
+    return ::testing::TempDir() + "autodriver_" + name;
+}
+
+// Rooms separated by walls with doorways
+Grid makeRooms(int size) {
+    Grid grid(size, size);
+    for (int i = 0; i < size; i++) {
+        if (i % 8 != 3) {
+            grid.setObstacle(size / 2, i, true);
+            grid.setObstacle(i, size / 2, true);
+        }
+    }
+    return grid;
+}
+
+}  // namespace
+
+TEST(ScenarioCorpusTest, LoadsMapTerrainAndHeaders) {
+    std::string path = tempPath("terrain.map");
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << "type octile\r\nwidth 5\r\nheight 3\r\nmap\r\n"
+            << ".G@S.\r\n"
+            << "OTW..\r\n"
+            << ".....\r\n";
+    }
+    MapLoadResult map = MovingAI::loadMap(path);
+    ASSERT_TRUE(map.success) << map.error;
+    EXPECT_EQ(map.grid->getWidth(), 5);
+    EXPECT_EQ(map.grid->getHeight(), 3);
+    EXPECT_FALSE(map.grid->isObstacle(1, 0));
+    EXPECT_TRUE(map.grid->isObstacle(2, 0));
+    EXPECT_FALSE(map.grid->isObstacle(3, 0));
+    EXPECT_TRUE(map.grid->isObstacle(0, 1));
+    EXPECT_TRUE(map.grid->isObstacle(2, 1));
+    EXPECT_FALSE(map.grid->isObstacle(4, 2));
+    
+    {
+        std::ofstream out(path);
+        out << "type octile\nheight 3\nwidth 5\nmap\n.....\n...\n";
+    }
+    EXPECT_FALSE(MovingAI::loadMap(path).success);
+    
+    // A header far larger than the file fails on the rows, not the allocation
+    {
+        std::ofstream out(path);
+        out << "type octile\nheight 2000000000\nwidth 2000000000\nmap\n";
+    }
+    MapLoadResult huge = MovingAI::loadMap(path);
+    EXPECT_FALSE(huge.success);
+    EXPECT_EQ(huge.error, "map ends after 0 of 2000000000 rows");
+    std::remove(path.c_str());
+}
+
+TEST(ScenarioCorpusTest, ShortestPathLengthsFollowMotionModel) {
+    Grid open(10, 10);
+    EXPECT_NEAR(MovingAI::shortestPathLength(open, Vec2i(0, 0), Vec2i(3, 5), true), 2.0 + 3.0 * std::sqrt(2.0), 1e-9);
+    EXPECT_DOUBLE_EQ(MovingAI::shortestPathLength(open, Vec2i(0, 0), Vec2i(3, 5), false), 8.0);
+    
+    // No corner cutting past a single blocked cell
+    open.setObstacle(1, 0, true);
+    EXPECT_DOUBLE_EQ(MovingAI::shortestPathLength(open, Vec2i(0, 0), Vec2i(2, 2), true), 2.0 + std::sqrt(2.0));
+    
+    Grid walled(10, 10);
+    for (int y = 0; y < 10; y++) walled.setObstacle(5, y, true);
+    EXPECT_LT(MovingAI::shortestPathLength(walled, Vec2i(0, 0), Vec2i(9, 9), true), 0.0);
+}
+
+TEST(ScenarioCorpusTest, GeneratedScenariosRoundTrip) {
+    Grid grid = makeRooms(40);
+    ScenarioGenerationOptions options;
+    options.count = 30;
+    auto scenarios = MovingAI::generateScenarios(grid, "rooms.map", options);
+    ASSERT_EQ(scenarios.size(), 30u);
+    for (size_t i = 1; i < scenarios.size(); i++) EXPECT_LE(scenarios[i - 1].bucket, scenarios[i].bucket);
+    EXPECT_EQ(scenarios[0].bucket, static_cast<int>(scenarios[0].optimal_length / 4.0));
+    
+    std::string path = tempPath("rooms.map.scen");
+    ASSERT_TRUE(MovingAI::saveScenarios(scenarios, path));
+    ScenarioLoadResult loaded = MovingAI::loadScenarios(path);
+    ASSERT_TRUE(loaded.success) << loaded.error;
+    ASSERT_EQ(loaded.scenarios.size(), scenarios.size());
+    for (size_t i = 0; i < scenarios.size(); i++) {
+        EXPECT_EQ(loaded.scenarios[i].map_name, "rooms.map");
+        EXPECT_EQ(loaded.scenarios[i].start, scenarios[i].start);
+        EXPECT_EQ(loaded.scenarios[i].goal, scenarios[i].goal);
+        EXPECT_NEAR(loaded.scenarios[i].optimal_length, scenarios[i].optimal_length, 1e-6);
+    }
+    std::remove(path.c_str());
+}
+
+TEST(ScenarioCorpusTest, SuiteRunsBucketsOnWorkerPool) {
+    Grid grid = makeRooms(48);
+    std::string map_path = tempPath("corpus.map");
+    std::string scen_path = tempPath("corpus.map.scen");
+    ASSERT_TRUE(MovingAI::saveMap(grid, map_path));
+    ScenarioGenerationOptions options;
+    options.count = 24;
+    ASSERT_TRUE(MovingAI::saveScenarios(MovingAI::generateScenarios(grid, "autodriver_corpus.map", options), scen_path));
+    
+    BenchmarkConfig config;
+    config.scenario_files = {scen_path};
+    config.scenario_threads = 3;
+    BenchmarkSuite suite(config);
+    suite.benchmarkScenarios();
+    
+    const auto& buckets = suite.getScenarioResults();
+    ASSERT_FALSE(buckets.empty());
+    int astar_scenarios = 0;
+    for (const auto& bucket : buckets) {
+        EXPECT_EQ(bucket.map_name, "autodriver_corpus");
+        if (bucket.planner != "A*" && bucket.planner != "A* (ALT)") continue;
+        if (bucket.planner == "A*") astar_scenarios += bucket.scenarios;
+        EXPECT_EQ(bucket.solved, bucket.scenarios);
+        EXPECT_NEAR(bucket.mean_optimality, 1.0, 1e-5);   // A* is optimal for its own moves
+    }
+    EXPECT_EQ(astar_scenarios, 24);
+    
+    // One summary per planner joins the regular results
+    EXPECT_EQ(suite.getResults().size(), 4u);
+    EXPECT_EQ(suite.getResults()[0].iterations, 24);
+    std::remove(map_path.c_str());
+    std::remove(scen_path.c_str());
+}
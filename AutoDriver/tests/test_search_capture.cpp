@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+#include "core/search_capture.h"
+#include "core/astar.h"
+#include "core/hybrid_astar.h"
+#include "core/rrt.h"
+#include "core/grid.h"
+
+namespace {
+
+size_t countOf(const RingBufferSink& sink, SearchEventType type) {
+    size_t n = 0;
+    for (const SearchEvent& e : sink.events()) {
+        if (e.type == type) n++;
+    }
+    return n;
+}
+
+}  // namespace
+
+TEST(SearchCaptureTest, NothingRecordedByDefault) {
+    Grid grid(30, 30);
+    for (int y = 0; y < 25; y++) grid.setObstacle(15, y, true);
+    
+    AStar astar(grid);
+    AStarResult path = astar.findPath(Vec2i(2, 2), Vec2i(28, 2));
+    ASSERT_TRUE(path.success);
+    EXPECT_TRUE(path.visited.empty());
+    EXPECT_TRUE(path.explored.empty());
+    
+    HybridAStar hybrid(grid);
+    HybridAStarResult hybrid_path = hybrid.findPath(Vec2(3.0f, 27.0f), 0.0f, Vec2(25.0f, 27.0f), 0.0f);
+    EXPECT_TRUE(hybrid_path.explored.empty());
+    
+    RRT rrt(grid);
+    rrt.setSeed(5);
+    RRTResult tree = rrt.findPath(Vec2(2.0f, 2.0f), Vec2(28.0f, 2.0f), 2000);
+    EXPECT_GT(tree.iterations, 0);
+    EXPECT_TRUE(tree.tree_nodes.empty());
+}
+
+TEST(SearchCaptureTest, SinkMatchesResultVectors) {
+    Grid grid(30, 30);
+    for (int y = 0; y < 25; y++) grid.setObstacle(15, y, true);
+    
+    RingBufferSink sink;
+    SearchCapture capture = SearchCapture::intoResults();
+    capture.sink = &sink;
+    
+    AStar astar(grid);
+    astar.setCapture(capture);
+    AStarResult path = astar.findPath(Vec2i(2, 2), Vec2i(28, 2));
+    ASSERT_TRUE(path.success);
+    EXPECT_EQ(path.visited.size(), static_cast<size_t>(path.nodes_expanded));
+    EXPECT_EQ(countOf(sink, SearchEventType::VISITED), path.visited.size());
+    EXPECT_EQ(countOf(sink, SearchEventType::EXPLORED), path.explored.size());
+    EXPECT_EQ(sink.events().front().pos.x, 2.0f);   // Start is closed first
+    
+    sink.clear();
+    RRT rrt(grid);
+    rrt.setSeed(11);
+    rrt.setCapture(capture);
+    RRTResult tree = rrt.findPath(Vec2(2.0f, 2.0f), Vec2(28.0f, 2.0f), 2000);
+    ASSERT_FALSE(tree.tree_nodes.empty());
+    EXPECT_EQ(sink.size(), tree.tree_nodes.size());
+    EXPECT_EQ(countOf(sink, SearchEventType::TREE_NODE), sink.size());
+}
+
+TEST(SearchCaptureTest, RingBufferKeepsNewestEvents) {
+    RingBufferSink sink(4);
+    EXPECT_EQ(sink.size(), 0u);
+    
+    for (int i = 0; i < 10; i++) sink.record({Vec2(static_cast<float>(i), 0.0f), SearchEventType::VISITED});
+    EXPECT_EQ(sink.size(), 4u);
+    EXPECT_EQ(sink.getTotalRecorded(), 10u);
+    EXPECT_EQ(sink.getDropped(), 6u);
+    
+    std::vector<SearchEvent> events = sink.events();
+    ASSERT_EQ(events.size(), 4u);
+    for (size_t i = 0; i < events.size(); i++) EXPECT_EQ(events[i].pos.x, static_cast<float>(6 + i));
+    
+    sink.clear();
+    sink.record({Vec2(42.0f, 0.0f), SearchEventType::TREE_NODE});
+    ASSERT_EQ(sink.size(), 1u);
+    EXPECT_EQ(sink.at(0).pos.x, 42.0f);
+}
@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+#include "core/simulation.h"
+#include "core/grid.h"
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+TEST(SimulationTest, AgentsReachGoalsOnFixedSteps) {
+    Grid grid(20, 20);
+    for (int y = 0; y < 15; y++) grid.setObstacle(10, y, true);
+    
+    EpisodeSpec spec;
+    spec.seed = 1;
+    spec.agents.emplace_back(0, Vec2(2.0f, 2.0f), Vec2(17.0f, 2.0f));
+    spec.agents.emplace_back(1, Vec2(2.0f, 18.0f), Vec2(17.0f, 18.0f));
+    
+    SimulationEngine engine(grid);
+    EpisodeResult result = engine.runEpisode(spec);
+    
+    EXPECT_TRUE(result.success);
+    EXPECT_EQ(result.agents_arrived, 2);
+    EXPECT_EQ(result.agents_unplanned, 0);
+    EXPECT_GT(result.steps, 0);
+    EXPECT_LT(result.steps, engine.getConfig().max_steps);
+    EXPECT_FLOAT_EQ(result.sim_time, result.steps * engine.getConfig().dt);
+}
+
+TEST(SimulationTest, BatchIsDeterministicAcrossThreadCounts) {
+    Grid grid(32, 32);
+    for (int y = 4; y < 28; y++) grid.setObstacle(16, y, true);
+    
+    std::vector<EpisodeSpec> specs;
+    for (uint64_t seed = 0; seed < 24; seed++) specs.push_back(SimulationEngine::randomEpisode(grid, seed, 4, 3));
+    
+    SimulationEngine engine(grid);
+    SimulationSummary summary;
+    auto serial = engine.runBatch(specs, 1);
+    auto parallel = engine.runBatch(specs, 4, &summary);
+    
+    ASSERT_EQ(serial.size(), specs.size());
+    ASSERT_EQ(parallel.size(), specs.size());
+    for (size_t i = 0; i < specs.size(); i++) {
+        EXPECT_EQ(serial[i].seed, specs[i].seed);
+        EXPECT_EQ(serial[i].steps, parallel[i].steps);
+        EXPECT_EQ(serial[i].agents_arrived, parallel[i].agents_arrived);
+        EXPECT_EQ(serial[i].agent_collisions, parallel[i].agent_collisions);
+        EXPECT_EQ(serial[i].obstacle_collisions, parallel[i].obstacle_collisions);
+    }
+    EXPECT_EQ(summary.episodes, 24);
+    EXPECT_GT(summary.total_steps, 0u);
+    EXPECT_GT(summary.realtime_factor, 1.0);   // Far faster than real time
+}
+
+TEST(SimulationTest, ObstacleContactIsCountedOnce) {
+    Grid grid(20, 20);
+    
+    // Agents plan on the static grid only, so this one drives through a
+    // parked obstacle: several steps in contact, one collision
+    EpisodeSpec spec;
+    spec.agents.emplace_back(0, Vec2(2.0f, 10.0f), Vec2(18.0f, 10.0f));
+    spec.obstacles.emplace_back(Vec2(10.0f, 10.0f), Vec2(0.0f, 0.0f), 0.5f);
+    
+    SimulationEngine engine(grid);
+    EpisodeResult result = engine.runEpisode(spec);
+    
+    EXPECT_EQ(result.agents_arrived, 1);
+    EXPECT_EQ(result.obstacle_collisions, 1);
+    EXPECT_FALSE(result.success);
+}
+
+TEST(SimulationTest, TraceRoundTrips) {
+    Grid grid(20, 20);
+    EpisodeSpec spec = SimulationEngine::randomEpisode(grid, 9, 3, 2);
+    ASSERT_EQ(spec.agents.size(), 3u);
+    
+    SimulationConfig config;
+    config.record_trace = true;
+    config.trace_stride = 2;
+    SimulationEngine engine(grid, config);
+    EpisodeResult result = engine.runEpisode(spec);
+    
+    const SimulationTrace& trace = result.trace;
+    ASSERT_EQ(trace.frameCount(), static_cast<size_t>(result.steps / 2 + 1));
+    EXPECT_EQ(trace.coords.size(), trace.frameCount() * 5 * 2);
+    EXPECT_NEAR(trace.position(0, 0).x, spec.agents[0].position.x, 1.0f / trace.scale);
+    EXPECT_NEAR(trace.position(0, 3).y, spec.obstacles[0].getPosition().y, 1.0f / trace.scale);
+    
+    const std::string path = "test_simulation_trace.bin";
+    ASSERT_TRUE(trace.save(path));
+    SimulationTrace loaded;
+    ASSERT_TRUE(SimulationTrace::load(path, loaded));
+    
+    // Counts that do not fit in the file are rejected before allocating
+    {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        const unsigned char huge[4] = {0xFF, 0xFF, 0xFF, 0xFF};
+        file.seekp(12);
+        file.write(reinterpret_cast<const char*>(huge), 4);   // num_agents
+        file.seekp(20);
+        file.write(reinterpret_cast<const char*>(huge), 4);   // frames
+    }
+    SimulationTrace corrupt;
+    EXPECT_FALSE(SimulationTrace::load(path, corrupt));
+    EXPECT_TRUE(corrupt.coords.empty());
+    
+    // Truncated body
+    ASSERT_TRUE(trace.save(path));
+    {
+        std::ifstream in(path, std::ios::binary);
+        std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        std::ofstream(path, std::ios::binary | std::ios::trunc).write(bytes.data(), bytes.size() - 3);
+    }
+    EXPECT_FALSE(SimulationTrace::load(path, corrupt));
+    std::remove(path.c_str());
+    
+    EXPECT_EQ(loaded.num_agents, 3u);
+    EXPECT_EQ(loaded.num_obstacles, 2u);
+    EXPECT_FLOAT_EQ(loaded.dt, trace.dt);
+    EXPECT_EQ(loaded.steps, trace.steps);
+    EXPECT_EQ(loaded.coords, trace.coords);
+}
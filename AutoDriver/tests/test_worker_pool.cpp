@@ -0,0 +1,45 @@
+#include <gtest/gtest.h>
+#include "core/worker_pool.h"
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <thread>
+
+TEST(WorkerPoolTest, EveryWorkerRunsEachRound) {
+    WorkerPool pool(4);
+    ASSERT_EQ(pool.getNumThreads(), 4);
+    
+    for (int round = 0; round < 100; round++) {
+        std::atomic<int> calls(0);
+        std::atomic<int> mask(0);
+        int workers = 1 + round % 4;
+        pool.run(workers, [&](int worker) {
+            calls++;
+            mask |= 1 << worker;
+        });
+        // run() is a barrier: every participant has finished here
+        ASSERT_EQ(calls.load(), workers);
+        ASSERT_EQ(mask.load(), (1 << workers) - 1);
+    }
+}
+
+TEST(WorkerPoolTest, CallerIsWorkerZeroAndHelpersPersist) {
+    WorkerPool pool(3);
+    const std::thread::id caller = std::this_thread::get_id();
+    std::set<std::thread::id> first, second;
+    std::mutex mutex;
+    auto collect = [&](std::set<std::thread::id>& ids) {
+        pool.run(8, [&](int worker) {
+            std::lock_guard<std::mutex> lock(mutex);
+            ids.insert(std::this_thread::get_id());
+            if (worker == 0) {
+                EXPECT_EQ(std::this_thread::get_id(), caller);
+            }
+        });
+    };
+    collect(first);
+    collect(second);
+    EXPECT_EQ(first.size(), 3u);   // Clamped to the pool size
+    EXPECT_EQ(first, second);
+    EXPECT_TRUE(first.count(caller));
+}